@@ -1,14 +1,17 @@
 #ifndef AVLTREE_H
 #define AVLTREE_H
 
-#include "Stack.h"
+#include "Augments.h"
 
 namespace Xc
 {
-    template <typename T>
+    // TAugment keeps a summary of every subtree in its root node, see Augments.h.
+    template <typename T, typename TAugment = NoAugment<T> >
     class AVLTree
     {
     public:
+        typedef typename TAugment::Summary Summary;
+
         struct Node
         {
             T value;
@@ -18,6 +21,7 @@ namespace Xc
             Node *father;
             int count;
             int height; // Height is updated dymatically.
+            Summary summary; // of the subtree, updated with the height
 
             Node(T value, int height  = 0, Node *father = nullptr, Node *left = nullptr, Node *right = nullptr);
         };
@@ -29,9 +33,9 @@ namespace Xc
         public:
 
         protected:
-            ConstantIterator(AVLTree<T> &tree, typename AVLTree<T>::Node *node) {}
+            ConstantIterator(AVLTree<T, TAugment> &tree, typename AVLTree<T, TAugment>::Node *node) {}
             
-            friend class AVLTree<T>;
+            friend class AVLTree<T, TAugment>;
         };
 
         class Iterator 
@@ -51,12 +55,12 @@ namespace Xc
             inline AVLTree *tree() { return mTree; }
 
         private:
-            Iterator(AVLTree *tree, typename AVLTree<T>::Node *node);
-            AVLTree<T> *mTree;
-            typename AVLTree<T>::Node *mNode;
+            Iterator(AVLTree *tree, typename AVLTree<T, TAugment>::Node *node);
+            AVLTree<T, TAugment> *mTree;
+            typename AVLTree<T, TAugment>::Node *mNode;
 
             
-            friend class AVLTree<T>;
+            friend class AVLTree<T, TAugment>;
         };
 
     public:
@@ -64,25 +68,31 @@ namespace Xc
         ~AVLTree();
         AVLTree(const AVLTree &rhs);
         AVLTree &operator =(const AVLTree &rhs);
-        int count(const T &value) const { return count(mRoot, value); }
+        int count(const T &value) const;
+        Iterator find(const T &value);
+        Iterator lowerBound(const T &value); // the first value not less than value
         Iterator insert(const T &value);
-        void erase(const T &value) { erase(mRoot, value); }
+        bool erase(const T &value);
         Iterator erase(const Iterator &rhs);
         inline bool empty() const { return mRoot == nullptr; }
+        inline int size() const { return mSize; } // distinct values
         Node *root() const { return mRoot; }
         T &min();
         T &max();
         Iterator begin();
         Iterator end();
         inline int height() const { return height(mRoot); }
+        inline Summary summarize() const { return summary(mRoot); }
+        Summary summarize(const T &low, const T &high) const { return summarize(mRoot, &low, &high); } // of values in [low, high]
+        static inline Summary summary(const Node *node) { return node == nullptr ? TAugment::identity() : node->summary; }
 
+    // Nothing below recurses except summarize, which is bounded by the height.
+    // Paths are walked back up through the fathers instead of the call stack.
     private:
-        Iterator insert(NodePointer &node, const T &value); // help function
-        Iterator insertStack(NodePointer &node, const T &value); // using stark instead of 
-        void erase(Node * &node, const T &value); // help function
-        T eraseMin(Node * &root, const T &value); // second delete
-        void eraseMax(Node * &root, const T &value); // second erase
-        int count(const Node *root, const T &value); // help function
+        Node *findNode(const T &value) const;
+        Node *lowerBoundNode(const T &value) const;
+        NodePointer &link(Node *node); // the pointer in the father (or mRoot) that points to node
+        void rebalance(Node *node); // from node up to the root
         Node *clone(const Node *root) const;
         void erase(Node * &root);
         inline int height(const Node *node) const { return node == nullptr ? -1 : node->height; }
@@ -90,6 +100,9 @@ namespace Xc
         void rotateWithRightChild(NodePointer &node);
         void doubleWithLeftChild(NodePointer &node);
         void doubleWithRightChild(NodePointer &node);
+        void balance(NodePointer &node);
+        void update(Node *node); // height and summary from the children
+        Summary summarize(const Node *node, const T *low, const T *high) const; // a null bound is open
 
         Node *findMin(Node *root) const;
         Node *findMax(Node *root) const;
@@ -107,212 +120,151 @@ namespace Xc
         friend class Iterator;
     };
 
-    template <typename T>
-    AVLTree<T>::Node::Node(T value, int height, Node *father, Node *left, Node *right)
-        : value(value), height(height), father(father), left(left), right(right), count(1)
+    template <typename T, typename TAugment>
+    AVLTree<T, TAugment>::Node::Node(T value, int height, Node *father, Node *left, Node *right)
+        : value(value), height(height), father(father), left(left), right(right), count(1), summary(TAugment::make(value, 1))
     {
     }
 
-    template <typename T>
-    AVLTree<T>::AVLTree() :
+    template <typename T, typename TAugment>
+    AVLTree<T, TAugment>::AVLTree() :
         mRoot(nullptr), mSize(0)
     {
     }
 
-    template<typename T>
-    inline AVLTree<T>::~AVLTree()
+    template<typename T, typename TAugment>
+    inline AVLTree<T, TAugment>::~AVLTree()
     {
         erase(mRoot);
     }
 
-    template<typename T>
-    AVLTree<T>::AVLTree(const AVLTree & rhs)
+    template<typename T, typename TAugment>
+    AVLTree<T, TAugment>::AVLTree(const AVLTree & rhs) :
+        mSize(rhs.mSize)
     {
         mRoot = clone(rhs.root());
     }
 
-    template<typename T>
-    AVLTree<T> &AVLTree<T>::operator =(const AVLTree & rhs)
+    template<typename T, typename TAugment>
+    AVLTree<T, TAugment> &AVLTree<T, TAugment>::operator =(const AVLTree & rhs)
     {
-        erase(mRoot);
-        mRoot = rhs.clone();
+        if (this != &rhs)
+        {
+            erase(mRoot);
+            mRoot = clone(rhs.root());
+            mSize = rhs.mSize;
+        }
+
         return *this;
     }
 
-    template<typename T>
-    typename AVLTree<T>::Iterator AVLTree<T>::insert(const T & value)
+    template<typename T, typename TAugment>
+    typename AVLTree<T, TAugment>::Iterator AVLTree<T, TAugment>::insert(const T & value)
     {
-        Iterator ans = insertStack(mRoot, value);
-        if (mRoot != nullptr)
+        Node *father = nullptr;
+        Node *node = mRoot;
+        while (node != nullptr)
         {
-            mRoot->father = nullptr;
+            if (value < node->value)
+            {
+                father = node;
+                node = node->left;
+            }
+            else if (value > node->value)
+            {
+                father = node;
+                node = node->right;
+            }
+            else // same value, just count++
+            {
+                node->count++;
+                rebalance(node); // the summaries above change too
+                return Iterator(this, node);
+            }
         }
 
-        return ans;
-    }
-
-    template<typename T>
-    typename AVLTree<T>::Iterator AVLTree<T>::erase(const Iterator & rhs)
-    {
-        Iterator ans = rhs + 1;
-        Node *father = rhs.mNode->father;
+        node = new Node(value, 0, father);
         if (father == nullptr)
         {
-            erase(mRoot, rhs.mNode->value);
-            mRoot->father = nullptr;
+            mRoot = node;
+        }
+        else if (value < father->value)
+        {
+            father->left = node;
         }
         else
         {
-            NodePointer &node = father->left == rhs.mNode ? father->left : father->right;
-            erase(node, rhs.mNode->value);
-            updateDoubleChildsFather(father);
+            father->right = node;
         }
 
-        return ans;
+        mSize++;
+        rebalance(father);
+        return Iterator(this, node);
     }
 
-    template<typename T>
-    typename AVLTree<T>::Iterator AVLTree<T>::insert(typename AVLTree<T>::NodePointer & node, const T & value)
+    template<typename T, typename TAugment>
+    bool AVLTree<T, TAugment>::erase(const T & value)
     {
-        Iterator ans;
+        Node *node = findNode(value);
         if (node == nullptr)
         {
-            node = new Node(value);
-            ans = Iterator(this, node);
+            return false;
         }
-        else if (value < node->value)
-        {
-            ans = insert(node->left, value);
-            if (height(node->left) - height(node->right) >= 2) // Start rotation because rotation starts from bottom.
-            {
-                if (value < node->left->value) // on the very left
-                {
-                    rotateWithLeftChild(node);
-                }
-                else
-                {
-                    doubleWithLeftChild(node);
-                }
-            }
 
-            updateLeftChildFather(node);
-            // node->left->father = node;
-        }
-        else if (value > node->value)
+        if (node->count > 1)
         {
-            ans = insert(node->right, value);
-            if (height(node->right) - height(node->left) >= 2)
-            {
-                if (value > node->right->value)
-                {
-                    rotateWithRightChild(node);
-                }
-                else
-                {
-                    rotateWithRightChild(node);
-                }
-            }
-
-            updateRightChildFather(node);
+            node->count--;
+            rebalance(node);
+            return true;
         }
-        else // value == node->value
+
+        if (node->left != nullptr && node->right != nullptr) // start delete, the successor takes this place
         {
-            node->count++; // like set;
+            Node *successor = findMin(node->right);
+            node->value = successor->value;
+            node->count = successor->count; // duplicates move along
+            node = successor;
+        }
 
+        Node *father = node->father; // just one child, delete
+        Node *child = node->left != nullptr ? node->left : node->right;
+        link(node) = child;
+        if (child != nullptr)
+        {
+            child->father = father;
         }
 
-        node->height = max(height(node->left), height(node->right)) + 1; // update height from bottom to top
-    
-        return Iterator(this, node);                                  // mRoot->father = nullptr;
+        delete node;
+        mSize--;
+        rebalance(father);
+        return true;
     }
 
-    template<typename T>
-    typename AVLTree<T>::Iterator AVLTree<T>::insertStack(typename AVLTree<T>::NodePointer & node, const T & value)
+    template<typename T, typename TAugment>
+    typename AVLTree<T, TAugment>::Iterator AVLTree<T, TAugment>::erase(const Iterator & rhs)
     {
-        Stack<NodePointer> stack;
-        stack.push(node);
-
-        while (true)
+        // Erasing from the root keeps the whole path balanced and summarized,
+        // nodes may move meanwhile, so the next one is searched again by value.
+        T erased = rhs.mNode->value; // the node may be reused or deleted
+        if (rhs.mNode->count > 1)
         {
-            NodePointer &curNode = stack.top();
-            
-            if (curNode == nullptr)
-            {
-                curNode = new Node(value);
-                break;
-            }
-
-            if (value < curNode->value)
-            {
-                stack.push(curNode->left);
-            }
-            else if (value > curNode->value)
-            {
-                stack.push(curNode->right);
-            }
-            else // same value, just count++
-            {
-                curNode->count++;
-                return Iterator(this, node);
-            }
+            erase(erased);
+            return rhs; // one duplicate less, the node stays
         }
 
-        while (true)
+        Iterator next = rhs + 1;
+        if (next == end())
         {
-            NodePointer child = stack.top();
-            stack.pop();
-            if (stack.isEmpty())
-            {
-                mRoot = child;
-                break;
-            }
-
-            NodePointer father = stack.top();
-            stack.pop();
-
-            child->father = father; // useful???
-            if (value < father->value)
-            {
-                father->left = child;
-                if (height(father->left) - height(father->right) >= 2)
-                {
-                    if (value < father->left->value)
-                    {
-                        rotateWithLeftChild(father);
-                    }
-                    else
-                    {
-                        doubleWithLeftChild(father);
-                    }
-                }
-       
-                updateLeftChildFather(father); // must update
-                stack.push(father); // must push
-            }
-            else if (value > father->value)
-            {
-                father->right = child;
-
-                if (height(father->right) - height(father->left) >= 2)
-                {
-                    if (value > father->right->value)
-                    {
-                        rotateWithRightChild(father);
-                    }
-                    else
-                    {
-                        doubleWithRightChild(father);
-                    }
-                }
-
-                updateRightChildFather(father);
-                stack.push(father);
-            }
-            else // impossible
-            {
-            }
+            erase(erased);
+            return next;
+        }
 
-            father->height = max(height(father->left), height(father->right)) + 1;
+        T value = next.mNode->value;
+        erase(erased);
+        Node *node = mRoot;
+        while (value < node->value || value > node->value)
+        {
+            node = value < node->value ? node->left : node->right;
         }
 
         return Iterator(this, node);
@@ -325,8 +277,8 @@ namespace Xc
     //        /  \                      /  \
     //      1111  0                    0    0
     //--------------------------------------------------------
-    template<typename T>
-    inline void AVLTree<T>::rotateWithLeftChild(NodePointer & node)
+    template<typename T, typename TAugment>
+    inline void AVLTree<T, TAugment>::rotateWithLeftChild(NodePointer & node)
     {
         NodePointer &k2 = node;
         Node *k1 = k2->left;
@@ -338,8 +290,8 @@ namespace Xc
         k2->left = k1->right;
         k1->right = k2;
         
-        k2->height = max(height(k2->left), height(k2->right)) + 1; // height update here!!! From bottom to top.
-        k1->height = max(height(k1->left), height(k1->right)) + 1; // height update here!!!
+        update(k2); // height update here!!! From bottom to top.
+        update(k1); // height update here!!!
 
         // update fathers
         updateLeftChildFather(k2);
@@ -357,8 +309,8 @@ namespace Xc
     //             /  \             /  \     
     //            0  1111          0    0  
     //--------------------------------------------------------
-    template<typename T>
-    void AVLTree<T>::rotateWithRightChild(NodePointer & node)
+    template<typename T, typename TAugment>
+    void AVLTree<T, TAugment>::rotateWithRightChild(NodePointer & node)
     {
         NodePointer &k1 = node;
         Node *k2 = k1->right;
@@ -370,8 +322,8 @@ namespace Xc
         k1->right = k2->left;
         k2->left = k1;
 
-        k1->height = max(height(k1->left), height(k1->right)) + 1;
-        k2->height = max(height(k2->left), height(k2->right)) + 1;
+        update(k1);
+        update(k2);
 
         // update fathers
         updateRightChildFather(k1);
@@ -392,8 +344,8 @@ namespace Xc
     //         /  \              /
     //        B    C            A
     //--------------------------------------------------------
-    template<typename T>
-    void AVLTree<T>::doubleWithLeftChild(NodePointer & node)
+    template<typename T, typename TAugment>
+    void AVLTree<T, TAugment>::doubleWithLeftChild(NodePointer & node)
     {
         NodePointer &k3 = node;
         NodePointer &k1 = k3->left;
@@ -425,8 +377,8 @@ namespace Xc
     //            /  \                       /  \
     //           B    C                     C    D
     //--------------------------------------------------------
-    template<typename T>
-    void AVLTree<T>::doubleWithRightChild(NodePointer & node)
+    template<typename T, typename TAugment>
+    void AVLTree<T, TAugment>::doubleWithRightChild(NodePointer & node)
     {
         NodePointer &k1 = node;
         NodePointer &k3 = k1->right;
@@ -441,8 +393,8 @@ namespace Xc
         updateDoubleChildsFather(k3);
     }
 
-    template<typename T>
-    T & AVLTree<T>::min()
+    template<typename T, typename TAugment>
+    T & AVLTree<T, TAugment>::min()
     {
         Node *node = mRoot;    
         while (node->left != nullptr)
@@ -453,8 +405,8 @@ namespace Xc
         return node->value;
     }
 
-    template<typename T>
-    T & AVLTree<T>::max()
+    template<typename T, typename TAugment>
+    T & AVLTree<T, TAugment>::max()
     {
         Node *node = mRoot;
         while (node->right != nullptr)
@@ -465,141 +417,256 @@ namespace Xc
         return node->value;
     }
 
-    template<typename T>
-    typename AVLTree<T>::Iterator AVLTree<T>::begin()
+    template<typename T, typename TAugment>
+    typename AVLTree<T, TAugment>::Iterator AVLTree<T, TAugment>::begin()
     {
         return Iterator(this, findMin(mRoot));
     }
 
-    template<typename T>
-    typename AVLTree<T>::Iterator AVLTree<T>::end()
+    template<typename T, typename TAugment>
+    typename AVLTree<T, TAugment>::Iterator AVLTree<T, TAugment>::end()
     {
         Iterator ans(this, nullptr);
         return ans;
     }
 
-    template<typename T>
-    void AVLTree<T>::erase(Node * &node, const T & value)
+    template<typename T, typename TAugment>
+    typename AVLTree<T, TAugment>::Node * AVLTree<T, TAugment>::findNode(const T & value) const
     {
-        if (node == nullptr)
+        Node *node = mRoot;
+        while (node != nullptr)
         {
-            return;
+            if (value < node->value)
+            {
+                node = node->left;
+            }
+            else if (value > node->value)
+            {
+                node = node->right;
+            }
+            else
+            {
+                return node;
+            }
         }
 
-        if (value < node->value)
-        {
-            erase(node->left, value);
-        }
-        else if (value > node->value)
-        {
-            erase(node->right, value);
-        }
-        else if (node->count > 1)
-        {
-            node->count--;
-        }
-        else if (node->left != nullptr && node->right != nullptr) // start delete
-        {
-            node->value = eraseMin(node->right, value);
-        }
-        else // just one, delete
+        return nullptr;
+    }
+
+    template<typename T, typename TAugment>
+    typename AVLTree<T, TAugment>::Iterator AVLTree<T, TAugment>::find(const T & value)
+    {
+        return Iterator(this, findNode(value));
+    }
+
+    template<typename T, typename TAugment>
+    typename AVLTree<T, TAugment>::Node * AVLTree<T, TAugment>::lowerBoundNode(const T & value) const
+    {
+        Node *ans = nullptr;
+        Node *node = mRoot;
+        while (node != nullptr)
         {
-            Node *oldNode = node;
-            node = node->left != nullptr ? node->left : node->right;
-            if (node != nullptr)
+            if (node->value < value)
+            {
+                node = node->right;
+            }
+            else
             {
-                node->father = oldNode->father; // update father
+                ans = node;
+                node = node->left;
             }
-
-            delete oldNode;
         }
+
+        return ans;
     }
 
-    template<typename T>
-    inline void AVLTree<T>::erase(Node * &root)
+    template<typename T, typename TAugment>
+    typename AVLTree<T, TAugment>::Iterator AVLTree<T, TAugment>::lowerBound(const T & value)
     {
-        if (root == nullptr)
+        return Iterator(this, lowerBoundNode(value));
+    }
+
+    template<typename T, typename TAugment>
+    int AVLTree<T, TAugment>::count(const T & value) const
+    {
+        Node *node = findNode(value);
+        return node == nullptr ? 0 : node->count;
+    }
+
+    template<typename T, typename TAugment>
+    typename AVLTree<T, TAugment>::NodePointer & AVLTree<T, TAugment>::link(Node * node)
+    {
+        Node *father = node->father;
+        if (father == nullptr)
         {
-            return;
+            return mRoot;
         }
 
-        erase(root->left);
-        delete root->left;
-        erase(root->right);
-        delete root->right;
-        root = nullptr;
+        return father->left == node ? father->left : father->right;
     }
 
-    template<typename T>
-    T AVLTree<T>::eraseMin(Node * &root, const T & value)
+    // Every node on the way gets its height and summary back, a node two levels out of balance is rotated.
+    template<typename T, typename TAugment>
+    void AVLTree<T, TAugment>::rebalance(Node * node)
     {
-        if (root->left != nullptr)
+        while (node != nullptr)
         {
-            return eraseMin(root->left, value);
+            Node *father = node->father;
+            NodePointer &slot = link(node);
+            balance(slot);
+            slot->father = father;
+            node = father;
         }
-        else
+    }
+
+    // Frees the nodes as BinarySearchTree does, by right rotations into a list along the right links.
+    // The fathers, heights and summaries go stale on the way, nothing reads them before the node is freed.
+    template<typename T, typename TAugment>
+    void AVLTree<T, TAugment>::erase(Node * &root)
+    {
+        while (root != nullptr)
         {
-            T ans = root->value;
-            Node *oldNode = root;
-            root = root->right;
-            delete oldNode;
-            return ans;
+            if (root->left != nullptr)
+            {
+                Node *left = root->left;
+                root->left = left->right;
+                left->right = root;
+                root = left;
+            }
+            else
+            {
+                Node *right = root->right;
+                delete root;
+                root = right;
+            }
         }
     }
 
-    template<typename T>
-    inline void AVLTree<T>::eraseMax(Node * &root, const T & value)
+    template<typename T, typename TAugment>
+    void AVLTree<T, TAugment>::balance(NodePointer & node)
     {
-        if (root->right != nullptr)
+        updateDoubleChildsFather(node); // a child may have been replaced below, rotations keep only the moved fathers
+        if (height(node->left) - height(node->right) >= 2)
         {
-            return eraseMin(root->right, value);
+            if (height(node->left->left) >= height(node->left->right))
+            {
+                rotateWithLeftChild(node);
+            }
+            else
+            {
+                doubleWithLeftChild(node);
+            }
+        }
+        else if (height(node->right) - height(node->left) >= 2)
+        {
+            if (height(node->right->right) >= height(node->right->left))
+            {
+                rotateWithRightChild(node);
+            }
+            else
+            {
+                doubleWithRightChild(node);
+            }
         }
         else
         {
-            T ans = root->value;
-            Node *oldNode = root;
-            root = root->left;
-            delete oldNode;
-            return ans;
+            update(node);
         }
+
+        updateDoubleChildsFather(node);
     }
 
-    template<typename T>
-    int AVLTree<T>::count(const Node * root, const T & value)
+    template<typename T, typename TAugment>
+    inline void AVLTree<T, TAugment>::update(Node * node)
     {
-        if (root == nullptr)
+        node->height = max(height(node->left), height(node->right)) + 1;
+        node->summary = TAugment::combine(TAugment::combine(summary(node->left), TAugment::make(node->value, node->count)), summary(node->right));
+    }
+
+    // Goes down to the first node inside [low, high], below it every subtree on the inner side
+    // of the two boundary paths is inside as a whole and contributes its stored summary.
+    template<typename T, typename TAugment>
+    typename AVLTree<T, TAugment>::Summary AVLTree<T, TAugment>::summarize(const Node * node, const T * low, const T * high) const
+    {
+        if (node == nullptr)
         {
-            return 0;
+            return TAugment::identity();
         }
 
-        if (value < root->value)
+        if (low == nullptr && high == nullptr)
         {
-            return count(root->left, value);
+            return node->summary;
         }
-        else if (value > root->value)
+
+        if (low != nullptr && node->value < *low)
         {
-            return count(root->right, value);
+            return summarize(node->right, low, high);
         }
-        else
+
+        if (high != nullptr && *high < node->value)
         {
-            return root->count;
+            return summarize(node->left, low, high);
         }
+
+        Summary left = summarize(node->left, low, nullptr);
+        Summary right = summarize(node->right, nullptr, high);
+        return TAugment::combine(TAugment::combine(left, TAugment::make(node->value, node->count)), right);
     }
 
-    template<typename T>
-    typename AVLTree<T>::Node * AVLTree<T>::clone(const Node *root) const
+    // Walks the source through its fathers and the copy through its own, in lock step.
+    // A child is copied the first time its father is reached, so the walk needs no stack.
+    template<typename T, typename TAugment>
+    typename AVLTree<T, TAugment>::Node * AVLTree<T, TAugment>::clone(const Node *root) const
     {
         if (root == nullptr)
         {
             return nullptr;
         }
 
-        return new Node(root->value, clone(root->left), clone(root->right));
-    }
+        Node *ans = new Node(root->value, root->height);
+        ans->count = root->count;
+        ans->summary = root->summary;
+        const Node *source = root;
+        Node *copy = ans;
+        while (true)
+        {
+            const Node *next = nullptr;
+            NodePointer *slot = nullptr;
+            if (source->left != nullptr && copy->left == nullptr)
+            {
+                next = source->left;
+                slot = &copy->left;
+            }
+            else if (source->right != nullptr && copy->right == nullptr)
+            {
+                next = source->right;
+                slot = &copy->right;
+            }
 
+            if (next != nullptr)
+            {
+                *slot = new Node(next->value, next->height, copy);
+                (*slot)->count = next->count;
+                (*slot)->summary = next->summary;
+                source = next;
+                copy = *slot;
+            }
+            else if (source == root)
+            {
+                break;
+            }
+            else
+            {
+                source = source->father;
+                copy = copy->father;
+            }
+        }
+
+        return ans;
+    }
 
-    template<typename T>
-    typename AVLTree<T>::Node * AVLTree<T>::findMin(Node * root) const
+    template<typename T, typename TAugment>
+    typename AVLTree<T, TAugment>::Node * AVLTree<T, TAugment>::findMin(Node * root) const
     {
         if (root == nullptr)
         {
@@ -614,8 +681,8 @@ namespace Xc
         return root;
     }
 
-    template<typename T>
-    typename AVLTree<T>::Node *AVLTree<T>::findMax(Node * root) const
+    template<typename T, typename TAugment>
+    typename AVLTree<T, TAugment>::Node *AVLTree<T, TAugment>::findMax(Node * root) const
     {
         if (root == nullptr)
         {
@@ -630,8 +697,8 @@ namespace Xc
         return root;
     }
 
-    template<typename T>
-    inline void AVLTree<T>::updateLeftChildFather(Node * node)
+    template<typename T, typename TAugment>
+    inline void AVLTree<T, TAugment>::updateLeftChildFather(Node * node)
     {
         if (node != nullptr && node->left != nullptr)
         {
@@ -639,8 +706,8 @@ namespace Xc
         }
     }
 
-    template<typename T>
-    inline void AVLTree<T>::updateRightChildFather(Node * node)
+    template<typename T, typename TAugment>
+    inline void AVLTree<T, TAugment>::updateRightChildFather(Node * node)
     {
         if (node != nullptr && node->right != nullptr)
         {
@@ -648,21 +715,21 @@ namespace Xc
         }
     }
 
-    template<typename T>
-    inline void AVLTree<T>::updateDoubleChildsFather(Node * node)
+    template<typename T, typename TAugment>
+    inline void AVLTree<T, TAugment>::updateDoubleChildsFather(Node * node)
     {
         updateLeftChildFather(node);
         updateRightChildFather(node);
     }
 
-    template <typename T>
-    AVLTree<T>::Iterator::Iterator(AVLTree<T> *tree, typename AVLTree<T>::Node * node) :
+    template <typename T, typename TAugment>
+    AVLTree<T, TAugment>::Iterator::Iterator(AVLTree<T, TAugment> *tree, typename AVLTree<T, TAugment>::Node * node) :
         mTree(tree), mNode(node)
     {
     }
 
-    template <typename T>
-    typename AVLTree<T>::Iterator &AVLTree<T>::Iterator::operator ++()
+    template <typename T, typename TAugment>
+    typename AVLTree<T, TAugment>::Iterator &AVLTree<T, TAugment>::Iterator::operator ++()
     {
         if (mNode == nullptr)
         {
@@ -683,9 +750,11 @@ namespace Xc
         }
         else
         {
-            Node *father = mNode->father;
-            while (father != nullptr && father->value < mNode->value)
+            Node *node = mNode; // up until coming from a left child
+            Node *father = node->father;
+            while (father != nullptr && node == father->right)
             {
+                node = father;
                 father = father->father;
             }
 
@@ -696,8 +765,8 @@ namespace Xc
         return *this;
     }
 
-    template <typename T>
-    typename AVLTree<T>::Iterator &AVLTree<T>::Iterator::operator --()
+    template <typename T, typename TAugment>
+    typename AVLTree<T, TAugment>::Iterator &AVLTree<T, TAugment>::Iterator::operator --()
     {
         if (mNode == nullptr)
         {
@@ -718,9 +787,11 @@ namespace Xc
         }
         else
         {
-            Node *father = mNode->father;
-            while (father != nullptr && father->value > mNode->value)
+            Node *node = mNode;
+            Node *father = node->father;
+            while (father != nullptr && node == father->left)
             {
+                node = father;
                 father = father->father;
             }
 
@@ -729,24 +800,24 @@ namespace Xc
         }
     }
 
-    template <typename T>
-    typename AVLTree<T>::Iterator AVLTree<T>::Iterator::operator ++(int)
+    template <typename T, typename TAugment>
+    typename AVLTree<T, TAugment>::Iterator AVLTree<T, TAugment>::Iterator::operator ++(int)
     {
         Iterator ans = *this;
         ++(*this);
         return ans;
     }
 
-    template <typename T>
-    typename AVLTree<T>::Iterator AVLTree<T>::Iterator::operator --(int) 
+    template <typename T, typename TAugment>
+    typename AVLTree<T, TAugment>::Iterator AVLTree<T, TAugment>::Iterator::operator --(int) 
     {
         Iterator ans = *this;
         --(*this);
         return ans;
     }
 
-    template <typename T>
-    typename AVLTree<T>::Iterator AVLTree<T>::Iterator::operator +(int count) const
+    template <typename T, typename TAugment>
+    typename AVLTree<T, TAugment>::Iterator AVLTree<T, TAugment>::Iterator::operator +(int count) const
     {
         Iterator ans = *this;
         while (count--)
@@ -757,8 +828,8 @@ namespace Xc
         return ans;
     }
 
-    template <typename T>
-    typename AVLTree<T>::Iterator AVLTree<T>::Iterator::operator -(int count) const
+    template <typename T, typename TAugment>
+    typename AVLTree<T, TAugment>::Iterator AVLTree<T, TAugment>::Iterator::operator -(int count) const
     {
         Iterator ans = *this;
         while (count--)
@@ -0,0 +1,5 @@
+#include "Augments.h"
+
+namespace Xc
+{
+}
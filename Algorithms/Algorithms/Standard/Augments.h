@@ -0,0 +1,82 @@
+#ifndef AUGMENTS_H
+#define AUGMENTS_H
+
+#include <limits>
+
+namespace Xc
+{
+    // An augment tells a tree which summary to keep in every node.
+    // The summary of a node combines the summaries of its left subtree, of its own value and of its right subtree,
+    // so combine must be associative and identity must be its neutral element.
+    // The tree rebuilds the summary of a node whenever its children change, rotations included.
+    //
+    //     typedef ... Summary;
+    //     static Summary make(const T &value, int count); // count is the number of duplicates of value
+    //     static Summary combine(const Summary &lhs, const Summary &rhs);
+    //     static Summary identity();
+
+    // The default, keeps nothing.
+    template <typename T>
+    struct NoAugment
+    {
+        struct Summary {};
+
+        static inline Summary make(const T &, int) { return Summary(); }
+        static inline Summary combine(const Summary &, const Summary &) { return Summary(); }
+        static inline Summary identity() { return Summary(); }
+    };
+
+    // Number of values, duplicates included.
+    template <typename T>
+    struct SizeAugment
+    {
+        typedef int Summary;
+
+        static inline Summary make(const T &, int count) { return count; }
+        static inline Summary combine(const Summary &lhs, const Summary &rhs) { return lhs + rhs; }
+        static inline Summary identity() { return 0; }
+    };
+
+    // What the following augments summarize, the value itself by default.
+    // A tree of records ordered by one member can summarize another member with its own selector.
+    template <typename T>
+    struct SelectValue
+    {
+        typedef T Value;
+
+        inline const T &operator ()(const T &value) const { return value; }
+    };
+
+    // Sum of the selected values, duplicates included.
+    template <typename T, typename Select = SelectValue<T> >
+    struct SumAugment
+    {
+        typedef typename Select::Value Summary;
+
+        static inline Summary make(const T &value, int count) { return Select()(value) * count; }
+        static inline Summary combine(const Summary &lhs, const Summary &rhs) { return lhs + rhs; }
+        static inline Summary identity() { return Summary(); }
+    };
+
+    template <typename T, typename Select = SelectValue<T> >
+    struct MinAugment
+    {
+        typedef typename Select::Value Summary;
+
+        static inline Summary make(const T &value, int) { return Select()(value); }
+        static inline Summary combine(const Summary &lhs, const Summary &rhs) { return rhs < lhs ? rhs : lhs; }
+        static inline Summary identity() { return std::numeric_limits<Summary>::max(); }
+    };
+
+    template <typename T, typename Select = SelectValue<T> >
+    struct MaxAugment
+    {
+        typedef typename Select::Value Summary;
+
+        static inline Summary make(const T &value, int) { return Select()(value); }
+        static inline Summary combine(const Summary &lhs, const Summary &rhs) { return lhs < rhs ? rhs : lhs; }
+        static inline Summary identity() { return std::numeric_limits<Summary>::lowest(); }
+    };
+}
+
+#endif // AUGMENTS_H
@@ -0,0 +1,152 @@
+#include "AugmentsTest.h"
+
+#include <climits>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+#include "IntervalTree.h"
+
+using namespace std;
+
+namespace Xc
+{
+    namespace
+    {
+        bool check(bool condition, const char *what)
+        {
+            if (!condition)
+            {
+                printf("Augments: %s\n", what);
+            }
+
+            return condition;
+        }
+
+        // the summary of the values in [low, high], made one value at a time
+        template <typename TAugment>
+        typename TAugment::Summary summarize(const multiset<int> &values, int low, int high)
+        {
+            typename TAugment::Summary ans = TAugment::identity();
+            for (multiset<int>::const_iterator it = values.lower_bound(low); it != values.end() && *it <= high; ++it)
+            {
+                ans = TAugment::combine(ans, TAugment::make(*it, 1));
+            }
+
+            return ans;
+        }
+
+        template <typename TAugment>
+        bool testAugment(const char *what)
+        {
+            mt19937 random(2017);
+            AVLTree<int, TAugment> tree;
+            multiset<int> values;
+            bool ans = true;
+            for (int i = 0; i < 4000 && ans; ++i)
+            {
+                int value = int(random() % 300);
+                if (random() % 3 == 0)
+                {
+                    multiset<int>::iterator it = values.find(value);
+                    ans &= check(tree.erase(value) == (it != values.end()), what);
+                    if (it != values.end())
+                    {
+                        values.erase(it);
+                    }
+                }
+                else
+                {
+                    tree.insert(value);
+                    values.insert(value);
+                }
+
+                int low = int(random() % 320) - 10;
+                int high = low + int(random() % 100);
+                ans &= check(tree.summarize(low, high) == summarize<TAugment>(values, low, high), what);
+                ans &= check(tree.summarize() == summarize<TAugment>(values, INT_MIN, INT_MAX), what);
+            }
+
+            return ans;
+        }
+
+        typedef pair<int, int> Bounds;
+
+        struct Collect
+        {
+            vector<Bounds> *intervals;
+
+            void operator ()(const Interval<int> &interval) const { intervals->push_back(Bounds(interval.low, interval.high)); }
+        };
+
+        // the intervals of values overlapping [low, high], in order
+        vector<Bounds> overlap(const multiset<Bounds> &values, int low, int high)
+        {
+            vector<Bounds> ans;
+            for (multiset<Bounds>::const_iterator it = values.begin(); it != values.end() && it->first <= high; ++it)
+            {
+                if (it->second >= low)
+                {
+                    ans.push_back(*it);
+                }
+            }
+
+            return ans;
+        }
+
+        bool testIntervalTree()
+        {
+            mt19937 random(2018);
+            IntervalTree<int> tree;
+            multiset<Bounds> values;
+            bool ans = true;
+            for (int i = 0; i < 3000 && ans; ++i)
+            {
+                int low = int(random() % 200);
+                Bounds interval(low, low + int(random() % 30));
+                if (random() % 3 == 0)
+                {
+                    multiset<Bounds>::iterator it = values.find(interval);
+                    if (it != values.end())
+                    {
+                        tree.erase(interval.first, interval.second);
+                        values.erase(it);
+                    }
+                }
+                else
+                {
+                    tree.insert(interval.first, interval.second);
+                    values.insert(interval);
+                }
+
+                int point = int(random() % 240) - 20;
+                vector<Bounds> stabbed;
+                tree.stab(point, Collect{ &stabbed });
+                ans &= check(stabbed == overlap(values, point, point), "stab finds the intervals containing the point");
+
+                int from = int(random() % 240) - 20;
+                int to = from + int(random() % 20);
+                vector<Bounds> overlapping;
+                tree.overlap(from, to, Collect{ &overlapping });
+                vector<Bounds> expected = overlap(values, from, to);
+                ans &= check(overlapping == expected, "overlap finds the intervals overlapping the range in order");
+                ans &= check(tree.overlaps(from, to) == !expected.empty(), "overlaps tells whether any interval overlaps the range");
+                ans &= check(tree.count(interval.first, interval.second) == (int)values.count(interval), "count of an interval");
+            }
+
+            return ans;
+        }
+    }
+
+    bool testAugments()
+    {
+        bool ans = true;
+        ans &= testAugment<SizeAugment<int> >("SizeAugment summarizes like a multiset");
+        ans &= testAugment<SumAugment<int> >("SumAugment summarizes like a multiset");
+        ans &= testAugment<MinAugment<int> >("MinAugment summarizes like a multiset");
+        ans &= testAugment<MaxAugment<int> >("MaxAugment summarizes like a multiset");
+        ans &= testIntervalTree();
+        return ans;
+    }
+}
@@ -0,0 +1,12 @@
+#ifndef AUGMENTSTEST_H
+#define AUGMENTSTEST_H
+
+namespace Xc
+{
+    // Checks the summaries of AVLTree with every augment of Augments.h, and the queries of IntervalTree,
+    // against a std::multiset through random inserts and erases, and prints a line for every check that
+    // fails. Returns false if any did.
+    bool testAugments();
+}
+
+#endif // AUGMENTSTEST_H
@@ -1,6 +1,8 @@
 #ifndef BINARYTREE_H
 #define BINARYTREE_H
 
+#include "Stack.h"
+
 namespace Xc
 {
     template <typename T>
@@ -15,7 +17,7 @@ namespace Xc
             Node *right;
             int count;
 
-            Node(T value, Node *left = nullptr, Node *right = nullptr);
+            Node(T value, Node *left = nullptr, Node *right = nullptr, int count = 1);
         };
 
         typedef Node *NodePointer;
@@ -25,21 +27,22 @@ namespace Xc
         ~BinarySearchTree();
         BinarySearchTree(const BinarySearchTree &rhs);
         BinarySearchTree &operator =(const BinarySearchTree &rhs);
-        int count(const T &value) const { return count(mRoot, value); }
-        void insert(const T &value) { return insert(mRoot, value); }
-        void erase(const T &value) { return erase(mRoot, value); }
+        int count(const T &value) const;
+        void insert(const T &value);
+        bool erase(const T &value);
+        Node *find(const T &value) const;
         Node *root() const { return mRoot; }
         Node *findMin(Node *root) const;
         Node *findMax(Node *root) const;
+        inline int size() const { return mSize; } // distinct values
         void print();
-       
+        // in order, visit(const T &value, int count)
+        template <typename Visitor> void traverse(Visitor visit); // threads through the tree meanwhile, see below
+        template <typename Visitor> void traverse(Visitor visit) const; // leaves the tree alone, keeps a stack of the path
 
+    // Nothing below recurses, a sorted insertion order degenerates the tree into a list
+    // of millions of levels and that must not overflow the call stack.
     private:
-        void insert(Node * &root, const T &value); // help function
-        void erase(Node * &root, const T &value); // help function
-        T eraseMin(Node * &root, const T &value); // second delete
-        void eraseMax(Node * &root, const T &value); // second erase
-        int count(const Node *root, const T &value); // help function
         Node *clone(const Node *root) const;
         void erase(Node * &root);
 
@@ -48,8 +51,8 @@ namespace Xc
     };
 
     template <typename T>
-    BinarySearchTree<T>::Node::Node(T value, Node *left, Node *right)
-        : value(value), left(left), right(right), count(0)
+    BinarySearchTree<T>::Node::Node(T value, Node *left, Node *right, int count)
+        : value(value), left(left), right(right), count(count)
     {
     }
 
@@ -67,7 +70,8 @@ namespace Xc
     }
 
     template<typename T>
-    BinarySearchTree<T>::BinarySearchTree(const BinarySearchTree & rhs)
+    BinarySearchTree<T>::BinarySearchTree(const BinarySearchTree & rhs) :
+        mSize(rhs.mSize)
     {
         mRoot = clone(rhs.root());
     }
@@ -75,8 +79,13 @@ namespace Xc
     template<typename T>
     BinarySearchTree<T> &BinarySearchTree<T>::operator =(const BinarySearchTree & rhs)
     {
-        erase(mRoot);
-        mRoot = rhs.clone();
+        if (this != &rhs)
+        {
+            erase(mRoot);
+            mRoot = clone(rhs.root());
+            mSize = rhs.mSize;
+        }
+
         return *this;
     }
 
@@ -119,127 +128,223 @@ namespace Xc
     }
     
     template<typename T>
-    void BinarySearchTree<T>::insert(Node * &root, const T & value)
+    void BinarySearchTree<T>::insert(const T & value)
     {
-        if (root == nullptr)
+        Node **link = &mRoot;
+        while (*link != nullptr)
         {
-            root = new Node(value);
+            Node *node = *link;
+            if (value < node->value)
+            {
+                link = &node->left;
+            }
+            else if (value > node->value)
+            {
+                link = &node->right;
+            }
+            else
+            {
+                node->count++;
+                return;
+            }
         }
 
-        if (value < root->value)
-        {
-            insert(root->left, value);
-        }
-        else if (value > root->value)
-        {
-            insert(root->right, value);
-        }
-        else
-        {
-            root->count++;
-        }
+        *link = new Node(value);
+        mSize++;
     }
 
     template<typename T>
-    void BinarySearchTree<T>::erase(Node * &root, const T & value)
+    bool BinarySearchTree<T>::erase(const T & value)
     {
-        if (root == nullptr)
+        Node **link = &mRoot;
+        while (*link != nullptr && ((*link)->value < value || (*link)->value > value))
         {
-            return;
+            link = value < (*link)->value ? &(*link)->left : &(*link)->right;
         }
 
-        if (value < root->value)
-        {
-            erase(root->left, value);
-        }
-        else if (value > root->value)
+        Node *node = *link;
+        if (node == nullptr)
         {
-            erase(root->right, value);
+            return false;
         }
-        else if (root->count > 1)
+
+        if (node->count > 1)
         {
-            root->count--;
+            node->count--;
+            return true;
         }
-        else if (root->left != nullptr && root->right != nullptr) // start delete
+
+        if (node->left != nullptr && node->right != nullptr) // start delete, the successor takes this place
         {
-            root->value = eraseMin(root->right, value);
+            Node **successorLink = &node->right;
+            while ((*successorLink)->left != nullptr)
+            {
+                successorLink = &(*successorLink)->left;
+            }
+
+            Node *successor = *successorLink;
+            node->value = successor->value;
+            node->count = successor->count;
+            *successorLink = successor->right;
+            delete successor;
         }
         else // have only one child, just delete it.
         {
-            Node *oldNode = root;
-            root = root->left != nullptr ? root->left : root->right;
-            delete oldNode;
+            *link = node->left != nullptr ? node->left : node->right;
+            delete node;
         }
+
+        mSize--;
+        return true;
     }
 
     template<typename T>
-    inline void BinarySearchTree<T>::erase(Node * &root)
+    typename BinarySearchTree<T>::Node * BinarySearchTree<T>::find(const T & value) const
     {
-        if (root == nullptr)
+        Node *node = mRoot;
+        while (node != nullptr)
         {
-            return;
+            if (value < node->value)
+            {
+                node = node->left;
+            }
+            else if (value > node->value)
+            {
+                node = node->right;
+            }
+            else
+            {
+                return node;
+            }
         }
 
-        erase(root->left);
-        delete root->left;
-        erase(root->right);
-        delete root->right;
-        root = nullptr;
+        return nullptr;
     }
 
     template<typename T>
-    T BinarySearchTree<T>::eraseMin(Node * &root, const T & value)
+    int BinarySearchTree<T>::count(const T & value) const
     {
-        if (root->left != nullptr)
-        {
-            return eraseMin(root->left, value);
-        }
-        else
-        {
-            T ans = root->value;
-            Node *oldNode = root;
-            root = root->right;
-            delete oldNode;
-            return ans;
-        }
+        Node *node = find(value);
+        return node == nullptr ? 0 : node->count;
     }
 
+    // Rotates every left child up until the tree is a right leaning list, then frees it front to back.
+    // No stack at all, every node is rotated at most once and freed once.
     template<typename T>
-    inline void BinarySearchTree<T>::eraseMax(Node * &root, const T & value)
+    void BinarySearchTree<T>::erase(Node * &root)
     {
+        while (root != nullptr)
+        {
+            if (root->left != nullptr)
+            {
+                Node *left = root->left;
+                root->left = left->right;
+                left->right = root;
+                root = left;
+            }
+            else
+            {
+                Node *right = root->right;
+                delete root;
+                root = right;
+            }
+        }
     }
 
+    // Morris traversal: the rightmost node of a left subtree temporarily points back to its successor.
+    // Uses no stack, every link is restored before returning, so the tree must not be read meanwhile,
+    // by another thread or by visit.
     template<typename T>
-    int BinarySearchTree<T>::count(const Node * root, const T & value)
+    template<typename Visitor>
+    void BinarySearchTree<T>::traverse(Visitor visit)
     {
-        if (root == nullptr)
+        Node *node = mRoot;
+        while (node != nullptr)
         {
-            return 0;
-        }
+            if (node->left == nullptr)
+            {
+                visit(const_cast<const T &>(node->value), node->count);
+                node = node->right;
+                continue;
+            }
 
-        if (value < root->value)
-        {
-            return count(root->left, value);
-        }
-        else
-        {
-            return count(root->right, value);
+            Node *predecessor = node->left;
+            while (predecessor->right != nullptr && predecessor->right != node)
+            {
+                predecessor = predecessor->right;
+            }
+
+            if (predecessor->right == nullptr)
+            {
+                predecessor->right = node; // thread back, then go down
+                node = node->left;
+            }
+            else
+            {
+                predecessor->right = nullptr; // second visit, the left subtree is done
+                visit(const_cast<const T &>(node->value), node->count);
+                node = node->right;
+            }
         }
-        else
+    }
+
+    // The stack holds the nodes whose left subtree is being visited, at most the height of the tree.
+    template<typename T>
+    template<typename Visitor>
+    void BinarySearchTree<T>::traverse(Visitor visit) const
+    {
+        Stack<const Node *> stack;
+        const Node *node = mRoot;
+        while (node != nullptr || !stack.isEmpty())
         {
-            return root->count;
+            while (node != nullptr)
+            {
+                stack.push(node);
+                node = node->left;
+            }
+
+            node = stack.top();
+            stack.pop();
+            visit(node->value, node->count);
+            node = node->right;
         }
     }
 
+    // Copies in preorder, the stack holds the right subtrees still to copy and where they go.
     template<typename T>
     typename BinarySearchTree<T>::Node * BinarySearchTree<T>::clone(const Node *root) const
     {
-        if (root == nullptr)
+        struct Pending
         {
-            return nullptr;
+            const Node *source;
+            Node **link;
+        };
+
+        Node *ans = nullptr;
+        Stack<Pending> stack;
+        stack.push(Pending{ root, &ans });
+        while (!stack.isEmpty())
+        {
+            Pending pending = stack.top();
+            stack.pop();
+
+            const Node *source = pending.source;
+            Node **link = pending.link;
+            while (source != nullptr) // down the left spine, the right children wait on the stack
+            {
+                Node *copy = new Node(source->value, nullptr, nullptr, source->count);
+                *link = copy;
+                if (source->right != nullptr)
+                {
+                    stack.push(Pending{ source->right, &copy->right });
+                }
+
+                source = source->left;
+                link = &copy->left;
+            }
         }
 
-        return new Node(root->value, clone(root->left), clone(root->right));
+        return ans;
     }
 
 }
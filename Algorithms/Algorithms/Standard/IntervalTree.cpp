@@ -0,0 +1,5 @@
+#include "IntervalTree.h"
+
+namespace Xc
+{
+}
@@ -0,0 +1,114 @@
+#ifndef INTERVALTREE_H
+#define INTERVALTREE_H
+
+#include "AVLTree.h"
+
+namespace Xc
+{
+    // A closed interval [low, high].
+    template <typename T>
+    struct Interval
+    {
+        T low;
+        T high;
+
+        Interval(const T &low = T(), const T &high = T()) : low(low), high(high) {}
+        inline bool operator <(const Interval &rhs) const { return low < rhs.low || (!(rhs.low < low) && high < rhs.high); }
+        inline bool operator >(const Interval &rhs) const { return rhs < *this; }
+        inline bool contains(const T &point) const { return !(point < low) && !(high < point); }
+        inline bool overlaps(const T &low, const T &high) const { return !(high < this->low) && !(this->high < low); }
+    };
+
+    template <typename T>
+    struct SelectHigh
+    {
+        typedef T Value;
+
+        inline const T &operator ()(const Interval<T> &interval) const { return interval.high; }
+    };
+
+    // Intervals ordered by their low end, every subtree knows the largest high end below it.
+    // A subtree whose largest high end is left of the query is skipped as a whole,
+    // and so is every subtree right of a node that starts after the query.
+    // Reporting k intervals visits O(log n + k log(n / k)) nodes instead of all n.
+    template <typename T>
+    class IntervalTree
+    {
+    public:
+        typedef Interval<T> Value;
+        typedef AVLTree<Value, MaxAugment<Value, SelectHigh<T> > > Tree;
+        typedef typename Tree::Node Node;
+        typedef typename Tree::Iterator Iterator;
+
+    public:
+        void insert(const T &low, const T &high) { mTree.insert(Value(low, high)); }
+        void erase(const T &low, const T &high) { mTree.erase(Value(low, high)); }
+        int count(const T &low, const T &high) const { return mTree.count(Value(low, high)); }
+        inline bool empty() const { return mTree.empty(); }
+        Iterator begin() { return mTree.begin(); }
+        Iterator end() { return mTree.end(); }
+
+        // visit(const Interval<T> &) for every interval containing point, duplicates included
+        template <typename Visitor>
+        void stab(const T &point, Visitor visit) const { overlap(mTree.root(), point, point, visit); }
+
+        // visit(const Interval<T> &) for every interval overlapping [low, high], in order
+        template <typename Visitor>
+        void overlap(const T &low, const T &high, Visitor visit) const { overlap(mTree.root(), low, high, visit); }
+
+        bool overlaps(const T &low, const T &high) const;
+
+    private:
+        template <typename Visitor>
+        static void overlap(const Node *node, const T &low, const T &high, Visitor &visit);
+
+        Tree mTree;
+    };
+
+    template <typename T>
+    template <typename Visitor>
+    void IntervalTree<T>::overlap(const Node *node, const T &low, const T &high, Visitor &visit)
+    {
+        if (node == nullptr || node->summary < low) // everything below ends before low
+        {
+            return;
+        }
+
+        overlap(node->left, low, high, visit);
+        if (high < node->value.low) // this one and the right subtree start after high
+        {
+            return;
+        }
+
+        if (!(node->value.high < low))
+        {
+            for (int i = 0; i < node->count; ++i)
+            {
+                visit(node->value);
+            }
+        }
+
+        overlap(node->right, low, high, visit);
+    }
+
+    // One path from the root: if the left subtree reaches low, either it overlaps or nothing does,
+    // because everything right of it starts even later.
+    template <typename T>
+    bool IntervalTree<T>::overlaps(const T &low, const T &high) const
+    {
+        const Node *node = mTree.root();
+        while (node != nullptr)
+        {
+            if (node->value.overlaps(low, high))
+            {
+                return true;
+            }
+
+            node = node->left != nullptr && !(node->left->summary < low) ? node->left : node->right;
+        }
+
+        return false;
+    }
+}
+
+#endif // INTERVALTREE_H
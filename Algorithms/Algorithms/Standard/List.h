@@ -108,6 +108,12 @@ namespace Xc
     {
     }
 
+    template <typename T>
+    List<T>::Node::~Node()
+    {
+        delete value; // nullptr in the two end nodes
+    }
+
 
     // ConstantIterator functions
     template <typename T>
@@ -0,0 +1,5 @@
+#include "PersistentAVLTree.h"
+
+namespace Xc
+{
+}
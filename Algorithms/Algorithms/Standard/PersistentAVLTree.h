@@ -0,0 +1,467 @@
+#ifndef PERSISTENTAVLTREE_H
+#define PERSISTENTAVLTREE_H
+
+#include <atomic>
+
+namespace Xc
+{
+    // An AVL tree whose versions share nodes.
+    // Copying the tree (or snapshot()) only takes a reference to the root, so it costs O(1).
+    // insert and erase copy the nodes on the search path that are shared with another version
+    // and change the rest in place, so an unshared tree pays no copies at all.
+    // Old versions stay valid and readable from other threads while a newer version is written,
+    // one version object itself must not be written by two threads at once.
+    template <typename T>
+    class PersistentAVLTree
+    {
+    public:
+        struct Node
+        {
+            T value;
+
+            Node *left;
+            Node *right;
+            int count;
+            int height;
+            std::atomic<int> references; // versions and parents pointing here
+
+            Node(const T &value, Node *left = nullptr, Node *right = nullptr, int count = 1, int height = 0);
+        };
+
+        typedef Node *NodePointer;
+
+        // In order, read only. Keeps its version alive, so it stays valid while the tree is changed.
+        class Iterator
+        {
+        public:
+            Iterator();
+            Iterator(const Iterator &rhs);
+            ~Iterator();
+            Iterator &operator =(const Iterator &rhs);
+            Iterator &operator ++();
+            Iterator operator ++(int);
+            inline bool operator ==(const Iterator &rhs) const { return top() == rhs.top(); }
+            inline bool operator !=(const Iterator &rhs) const { return !(*this == rhs); }
+            inline const T &operator *() const { return top()->value; }
+            inline const T *operator ->() const { return &top()->value; }
+            inline int count() const { return top()->count; } // duplicates of this value
+
+        private:
+            static const int MaxDepth = 96; // an AVL tree of 2^64 nodes is less than 92 high
+
+            explicit Iterator(Node *root);
+            inline Node *top() const { return mDepth == 0 ? nullptr : mPath[mDepth - 1]; }
+            void pushLeft(Node *node);
+
+            Node *mRoot;
+            Node *mPath[MaxDepth];
+            int mDepth;
+
+            friend class PersistentAVLTree<T>;
+        };
+
+    public:
+        PersistentAVLTree();
+        ~PersistentAVLTree();
+        PersistentAVLTree(const PersistentAVLTree &rhs);
+        PersistentAVLTree &operator =(const PersistentAVLTree &rhs);
+        inline PersistentAVLTree snapshot() const { return *this; }
+        int count(const T &value) const;
+        void insert(const T &value) { insert(mRoot, value); }
+        bool erase(const T &value) { return count(value) > 0 && erase(mRoot, value); } // a missing value copies no node
+        void clear();
+        inline bool empty() const { return mRoot == nullptr; }
+        inline int size() const { return mSize; } // distinct values
+        inline int height() const { return height(mRoot); }
+        const T &min() const;
+        const T &max() const;
+        Iterator begin() const { return Iterator(mRoot); }
+        Iterator end() const { return Iterator(); }
+
+    private:
+        void insert(NodePointer &node, const T &value);
+        bool erase(NodePointer &node, const T &value);
+        void eraseMin(NodePointer &node, T &value, int &count);
+        void balance(NodePointer &node);
+        void rotateWithLeftChild(NodePointer &node);
+        void rotateWithRightChild(NodePointer &node);
+        void doubleWithLeftChild(NodePointer &node);
+        void doubleWithRightChild(NodePointer &node);
+        void own(NodePointer &node);
+        inline void updateHeight(Node *node) { node->height = max(height(node->left), height(node->right)) + 1; }
+        static inline int height(const Node *node) { return node == nullptr ? -1 : node->height; }
+        static inline int max(int a, int b) { return a > b ? a : b; }
+        static void retain(Node *node);
+        static void release(Node *node);
+
+        int mSize;
+        Node *mRoot;
+    };
+
+    template <typename T>
+    PersistentAVLTree<T>::Node::Node(const T &value, Node *left, Node *right, int count, int height)
+        : value(value), left(left), right(right), count(count), height(height), references(1)
+    {
+    }
+
+    template <typename T>
+    PersistentAVLTree<T>::PersistentAVLTree() :
+        mSize(0), mRoot(nullptr)
+    {
+    }
+
+    template <typename T>
+    PersistentAVLTree<T>::~PersistentAVLTree()
+    {
+        release(mRoot);
+    }
+
+    template <typename T>
+    PersistentAVLTree<T>::PersistentAVLTree(const PersistentAVLTree &rhs) :
+        mSize(rhs.mSize), mRoot(rhs.mRoot)
+    {
+        retain(mRoot);
+    }
+
+    template <typename T>
+    PersistentAVLTree<T> &PersistentAVLTree<T>::operator =(const PersistentAVLTree &rhs)
+    {
+        retain(rhs.mRoot); // first, rhs may be this
+        release(mRoot);
+        mRoot = rhs.mRoot;
+        mSize = rhs.mSize;
+        return *this;
+    }
+
+    template <typename T>
+    void PersistentAVLTree<T>::clear()
+    {
+        release(mRoot);
+        mRoot = nullptr;
+        mSize = 0;
+    }
+
+    template <typename T>
+    int PersistentAVLTree<T>::count(const T &value) const
+    {
+        const Node *node = mRoot;
+        while (node != nullptr)
+        {
+            if (value < node->value)
+            {
+                node = node->left;
+            }
+            else if (node->value < value)
+            {
+                node = node->right;
+            }
+            else
+            {
+                return node->count;
+            }
+        }
+
+        return 0;
+    }
+
+    template <typename T>
+    const T &PersistentAVLTree<T>::min() const
+    {
+        const Node *node = mRoot;
+        while (node->left != nullptr)
+        {
+            node = node->left;
+        }
+
+        return node->value;
+    }
+
+    template <typename T>
+    const T &PersistentAVLTree<T>::max() const
+    {
+        const Node *node = mRoot;
+        while (node->right != nullptr)
+        {
+            node = node->right;
+        }
+
+        return node->value;
+    }
+
+    template <typename T>
+    void PersistentAVLTree<T>::insert(NodePointer &node, const T &value)
+    {
+        if (node == nullptr)
+        {
+            node = new Node(value);
+            ++mSize;
+            return;
+        }
+
+        own(node);
+        if (value < node->value)
+        {
+            insert(node->left, value);
+        }
+        else if (node->value < value)
+        {
+            insert(node->right, value);
+        }
+        else
+        {
+            node->count++; // like AVLTree, duplicates are counted
+            return;
+        }
+
+        balance(node);
+    }
+
+    template <typename T>
+    bool PersistentAVLTree<T>::erase(NodePointer &node, const T &value)
+    {
+        if (node == nullptr)
+        {
+            return false;
+        }
+
+        own(node);
+        if (value < node->value || node->value < value)
+        {
+            bool ans = erase(value < node->value ? node->left : node->right, value);
+            balance(node);
+            return ans;
+        }
+
+        if (node->count > 1)
+        {
+            node->count--;
+            return true;
+        }
+
+        if (node->left != nullptr && node->right != nullptr)
+        {
+            eraseMin(node->right, node->value, node->count); // the successor takes this place
+        }
+        else
+        {
+            Node *oldNode = node;
+            node = node->left != nullptr ? node->left : node->right; // the reference moves with the pointer
+            oldNode->left = nullptr;
+            oldNode->right = nullptr;
+            release(oldNode);
+            --mSize;
+            return true;
+        }
+
+        balance(node);
+        return true;
+    }
+
+    // removes the leftmost node below node and hands out its value
+    template <typename T>
+    void PersistentAVLTree<T>::eraseMin(NodePointer &node, T &value, int &count)
+    {
+        own(node);
+        if (node->left != nullptr)
+        {
+            eraseMin(node->left, value, count);
+            balance(node);
+            return;
+        }
+
+        value = node->value;
+        count = node->count;
+        Node *oldNode = node;
+        node = node->right;
+        oldNode->right = nullptr;
+        release(oldNode);
+        --mSize;
+    }
+
+    template <typename T>
+    void PersistentAVLTree<T>::balance(NodePointer &node)
+    {
+        if (height(node->left) - height(node->right) >= 2)
+        {
+            if (height(node->left->left) >= height(node->left->right))
+            {
+                rotateWithLeftChild(node);
+            }
+            else
+            {
+                doubleWithLeftChild(node);
+            }
+        }
+        else if (height(node->right) - height(node->left) >= 2)
+        {
+            if (height(node->right->right) >= height(node->right->left))
+            {
+                rotateWithRightChild(node);
+            }
+            else
+            {
+                doubleWithRightChild(node);
+            }
+        }
+        else
+        {
+            updateHeight(node);
+        }
+    }
+
+    // Same rotations as AVLTree, the moved nodes are made private to this version first.
+    template <typename T>
+    void PersistentAVLTree<T>::rotateWithLeftChild(NodePointer &node)
+    {
+        own(node->left);
+        Node *k2 = node;
+        Node *k1 = k2->left;
+        k2->left = k1->right;
+        k1->right = k2;
+        updateHeight(k2);
+        updateHeight(k1);
+        node = k1;
+    }
+
+    template <typename T>
+    void PersistentAVLTree<T>::rotateWithRightChild(NodePointer &node)
+    {
+        own(node->right);
+        Node *k1 = node;
+        Node *k2 = k1->right;
+        k1->right = k2->left;
+        k2->left = k1;
+        updateHeight(k1);
+        updateHeight(k2);
+        node = k2;
+    }
+
+    template <typename T>
+    void PersistentAVLTree<T>::doubleWithLeftChild(NodePointer &node)
+    {
+        own(node->left);
+        rotateWithRightChild(node->left);
+        rotateWithLeftChild(node);
+    }
+
+    template <typename T>
+    void PersistentAVLTree<T>::doubleWithRightChild(NodePointer &node)
+    {
+        own(node->right);
+        rotateWithLeftChild(node->right);
+        rotateWithRightChild(node);
+    }
+
+    // After own, node is referenced only by the slot it is in, so it may be changed in place.
+    // A shared node is copied, the copy shares both children with the original.
+    template <typename T>
+    void PersistentAVLTree<T>::own(NodePointer &node)
+    {
+        if (node->references.load(std::memory_order_acquire) == 1)
+        {
+            return;
+        }
+
+        Node *copy = new Node(node->value, node->left, node->right, node->count, node->height);
+        retain(copy->left);
+        retain(copy->right);
+        release(node);
+        node = copy;
+    }
+
+    template <typename T>
+    void PersistentAVLTree<T>::retain(Node *node)
+    {
+        if (node != nullptr)
+        {
+            node->references.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // frees the nodes no version points to any more, the recursion is bounded by the height
+    template <typename T>
+    void PersistentAVLTree<T>::release(Node *node)
+    {
+        while (node != nullptr && node->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            release(node->left);
+            Node *right = node->right;
+            delete node;
+            node = right;
+        }
+    }
+
+    template <typename T>
+    PersistentAVLTree<T>::Iterator::Iterator() :
+        mRoot(nullptr), mDepth(0)
+    {
+    }
+
+    template <typename T>
+    PersistentAVLTree<T>::Iterator::Iterator(Node *root) :
+        mRoot(root), mDepth(0)
+    {
+        retain(mRoot);
+        pushLeft(mRoot);
+    }
+
+    template <typename T>
+    PersistentAVLTree<T>::Iterator::Iterator(const Iterator &rhs) :
+        mRoot(rhs.mRoot), mDepth(rhs.mDepth)
+    {
+        retain(mRoot);
+        for (int i = 0; i < mDepth; ++i)
+        {
+            mPath[i] = rhs.mPath[i];
+        }
+    }
+
+    template <typename T>
+    PersistentAVLTree<T>::Iterator::~Iterator()
+    {
+        release(mRoot);
+    }
+
+    template <typename T>
+    typename PersistentAVLTree<T>::Iterator &PersistentAVLTree<T>::Iterator::operator =(const Iterator &rhs)
+    {
+        retain(rhs.mRoot);
+        release(mRoot);
+        mRoot = rhs.mRoot;
+        mDepth = rhs.mDepth;
+        for (int i = 0; i < mDepth; ++i)
+        {
+            mPath[i] = rhs.mPath[i];
+        }
+
+        return *this;
+    }
+
+    template <typename T>
+    void PersistentAVLTree<T>::Iterator::pushLeft(Node *node)
+    {
+        while (node != nullptr)
+        {
+            mPath[mDepth++] = node;
+            node = node->left;
+        }
+    }
+
+    template <typename T>
+    typename PersistentAVLTree<T>::Iterator &PersistentAVLTree<T>::Iterator::operator ++()
+    {
+        Node *node = mPath[--mDepth];
+        pushLeft(node->right);
+        return *this;
+    }
+
+    template <typename T>
+    typename PersistentAVLTree<T>::Iterator PersistentAVLTree<T>::Iterator::operator ++(int)
+    {
+        Iterator ans = *this;
+        ++(*this);
+        return ans;
+    }
+}
+
+#endif // PERSISTENTAVLTREE_H
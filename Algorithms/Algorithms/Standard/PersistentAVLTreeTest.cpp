@@ -0,0 +1,66 @@
+#include "PersistentAVLTreeTest.h"
+
+#include <cstdio>
+#include <vector>
+#include "PersistentAVLTree.h"
+
+using namespace std;
+
+namespace Xc
+{
+    namespace
+    {
+        // the values in order, by address, so two versions share a node exactly where they hold the same address
+        vector<const int *> nodesOf(const PersistentAVLTree<int> &tree)
+        {
+            vector<const int *> ans;
+            for (PersistentAVLTree<int>::Iterator it = tree.begin(); it != tree.end(); ++it)
+            {
+                ans.push_back(&*it);
+            }
+
+            return ans;
+        }
+
+        bool check(bool condition, const char *what)
+        {
+            if (!condition)
+            {
+                printf("PersistentAVLTree: %s\n", what);
+            }
+
+            return condition;
+        }
+    }
+
+    bool testPersistentAVLTree()
+    {
+        bool ans = true;
+        PersistentAVLTree<int> tree;
+        for (int i = 0; i < 100; ++i)
+        {
+            tree.insert(i * 2);
+        }
+
+        PersistentAVLTree<int> snapshot = tree.snapshot();
+        vector<const int *> shared = nodesOf(snapshot);
+        ans &= check(nodesOf(tree) == shared, "a snapshot shares every node");
+
+        bool erased = false;
+        for (int i = -1; i <= 201; i += 2)
+        {
+            erased |= tree.erase(i);
+        }
+        ans &= check(!erased && tree.size() == 100, "erasing a missing value reports it");
+        ans &= check(nodesOf(tree) == shared, "erasing a missing value copies no node");
+
+        ans &= check(tree.erase(100) && tree.count(100) == 0 && tree.size() == 99, "erasing a value removes it");
+        ans &= check(snapshot.count(100) == 1 && snapshot.size() == 100 && nodesOf(snapshot) == shared,
+            "erasing from a version leaves its snapshot as it was");
+
+        vector<const int *> partly = nodesOf(tree);
+        ans &= check(!tree.erase(101) && nodesOf(tree) == partly, "a missing value copies no node of a partly shared tree");
+
+        return ans;
+    }
+}
@@ -0,0 +1,11 @@
+#ifndef PERSISTENTAVLTREETEST_H
+#define PERSISTENTAVLTREETEST_H
+
+namespace Xc
+{
+    // Checks which nodes PersistentAVLTree shares between versions after insert and erase, and prints
+    // a line for every check that fails. Returns false if any did.
+    bool testPersistentAVLTree();
+}
+
+#endif // PERSISTENTAVLTREETEST_H
@@ -46,15 +46,15 @@ namespace Xc
             inline bool operator != (const ConstantIterator &rhs) const { return !(*this == rhs); }
             inline bool operator < (const ConstantIterator &rhs) const { return mNode->value() < rhs.mNode->value(); }
             inline bool operator > (const ConstantIterator &rhs) const { return mNode->value() > rhs.mNode->value(); }
-            ConstantIterator operator ++ (int) const;
-            ConstantIterator operator -- (int) const;
+            ConstantIterator operator ++ (int);
+            ConstantIterator operator -- (int);
 			inline int GetTimes() const { return mNode->mTimes; }
 			inline void SetTimes(int times) { mNode->mTimes = times; }
 
         protected:
-            ConstantIterator(RedBlackTree<T> *tree, typename RedBlackTree<T>::Node *node);
+            ConstantIterator(const RedBlackTree<T> *tree, typename RedBlackTree<T>::Node *node);
 
-            typename RedBlackTree<T> *mTree;
+            const RedBlackTree<T> *mTree;
             Node *mNode;                            // these variables will also used by Iterator class
 
             friend class RedBlackTree<T>;
@@ -65,32 +65,34 @@ namespace Xc
         public:
             inline Iterator() {}
             inline ~Iterator() {}
-            inline T &operator *() { return mNode->value(); }
-            inline T &Get() { return mNode->value(); }
+            inline T &operator *() { return this->mNode->value(); }
+            inline T &Get() { return this->mNode->value(); }
             Iterator &operator ++ ();
             Iterator &operator -- ();
-            bool operator == (const Iterator &rhs) const { return mNode == rhs.mNode; }
+            bool operator == (const Iterator &rhs) const { return this->mNode == rhs.mNode; }
             inline bool operator != (const Iterator &rhs) const { return !(*this == rhs); }
-            inline bool operator < (const Iterator &rhs) const { return mNode->value() < rhs.mNode->value(); }
-            inline bool operator > (const Iterator &rhs) const { return mNode->value() > rhs.mNode->value(); }
-            Iterator operator ++ (int) const;
-            Iterator operator -- (int) const;
+            inline bool operator < (const Iterator &rhs) const { return this->mNode->value() < rhs.mNode->value(); }
+            inline bool operator > (const Iterator &rhs) const { return this->mNode->value() > rhs.mNode->value(); }
+            Iterator operator ++ (int);
+            Iterator operator -- (int);
         
         private:
-            Iterator(RedBlackTree<T> *tree, typename RedBlackTree<T>::Node *node);
+            Iterator(const RedBlackTree<T> *tree, typename RedBlackTree<T>::Node *node);
 
             friend class RedBlackTree<T>;
         };
 
     public:
-        inline RedBlackTree() : mRoot(nullptr) {}
+        inline RedBlackTree() : mRoot(nullptr), mSize(0) {}
         inline ~RedBlackTree() { eraseAll(); }
+        RedBlackTree(const RedBlackTree &rhs);
+        RedBlackTree &operator =(const RedBlackTree &rhs);
         inline Iterator insert(const T & value) { return Iterator(this, insert(mRoot, value)); }
         inline NodePointer UNSAFERoot() { return mRoot; } // unsafe function
         inline bool isRoot(NodePointer node) const { return node->mParent == nullptr; }
         typename Node::ColorType color(NodePointer node) const;
         bool erase(const T &value);
-        inline void eraseAll() { erase(mRoot); }
+        inline void eraseAll() { erase(mRoot); mSize = 0; }
         void print(NodePointer node);
         bool test(Node * cur, Node * root);
         Iterator begin();
@@ -99,14 +101,20 @@ namespace Xc
         ConstantIterator end() const;
         inline ConstantIterator invalidConstantIterator() const { return ConstantIterator(this, nullptr); }
         inline Iterator invalidIterator() const { return Iterator(this, nullptr); }
-        bool isExist(const T &element) const;
-
+        bool isExist(const T &element) const { return findNode(element) != nullptr; }
+        Iterator find(const T &element) { return Iterator(this, findNode(element)); }
+        Iterator lowerBound(const T &element) { return Iterator(this, lowerBoundNode(element)); } // the first value not less than element
+        ConstantIterator lowerBound(const T &element) const { return ConstantIterator(this, lowerBoundNode(element)); }
+        int count(const T &element) const;
+        inline int size() const { return mSize; } // distinct values
+
+    // Nothing below recurses, the fixes walk up through mParent.
     private:
         NodePointer insert(NodePointer & node, const T & value);
+        NodePointer findNode(const T &element) const;
+        NodePointer lowerBoundNode(const T &element) const;
         void insertFix(NodePointer node);
-        void eraseFix(NodePointer node);
-        void eraseLeftLackFix(NodePointer node);
-        void eraseRightLackFix(NodePointer node);
+        void eraseFix(NodePointer node, NodePointer parent); // node may be nullptr, so its parent is passed too
         NodePointer sibling(NodePointer node);
         NodePointer uncle(NodePointer node);
         NodePointer leftRotate(NodePointer fulcrum);
@@ -119,12 +127,14 @@ namespace Xc
         NodePointer minimumChild(NodePointer root) const;
         NodePointer maximumChild(NodePointer root) const;
         void erase(NodePointer root);
+        NodePointer clone(const Node *root) const;
 
         // help functions
         template <typename U> void swap(U & a, U & b);
         void swapExceptValue(NodePointer a, NodePointer b);
 
         Node * mRoot;
+        int mSize;
 
         friend struct Node;
         friend class Iterator;
@@ -260,25 +270,122 @@ namespace Xc
     }
 
     template<typename T>
-    bool RedBlackTree<T>::isExist(const T & element) const
+    typename RedBlackTree<T>::NodePointer RedBlackTree<T>::findNode(const T & element) const
     {
-        int ans = false;
-        auto lf = [=](Node *node) {
-            if (ans == true)
+        NodePointer cur = mRoot;
+        while (cur != nullptr)
+        {
+            if (element < cur->value())
+            {
+                cur = cur->mLeft;
+            }
+            else if (element > cur->value())
+            {
+                cur = cur->mRight;
+            }
+            else
             {
-                return;
+                return cur;
             }
+        }
 
-            if (node->value() == element)
+        return nullptr;
+    }
+
+    template<typename T>
+    typename RedBlackTree<T>::NodePointer RedBlackTree<T>::lowerBoundNode(const T & element) const
+    {
+        NodePointer ans = nullptr;
+        NodePointer cur = mRoot;
+        while (cur != nullptr)
+        {
+            if (cur->value() < element)
             {
-                ans = true;
-                return;
+                cur = cur->mRight;
             }
-            
-            lf(node->mLeft);
-            lf(node->mRight);
-        };
-        lf(mRoot);
+            else
+            {
+                ans = cur;
+                cur = cur->mLeft;
+            }
+        }
+
+        return ans;
+    }
+
+    template<typename T>
+    int RedBlackTree<T>::count(const T & element) const
+    {
+        NodePointer node = findNode(element);
+        return node == nullptr ? 0 : node->mTimes;
+    }
+
+    template<typename T>
+    RedBlackTree<T>::RedBlackTree(const RedBlackTree & rhs) :
+        mRoot(clone(rhs.mRoot)), mSize(rhs.mSize)
+    {
+    }
+
+    template<typename T>
+    RedBlackTree<T> & RedBlackTree<T>::operator =(const RedBlackTree & rhs)
+    {
+        if (this != &rhs)
+        {
+            eraseAll();
+            mRoot = clone(rhs.mRoot);
+            mSize = rhs.mSize;
+        }
+
+        return *this;
+    }
+
+    // Walks the source through mParent and the copy through its own, in lock step.
+    // A child is copied the first time its parent is reached, so the walk needs no stack.
+    template<typename T>
+    typename RedBlackTree<T>::NodePointer RedBlackTree<T>::clone(const Node * root) const
+    {
+        if (root == nullptr)
+        {
+            return nullptr;
+        }
+
+        NodePointer ans = new Node(*root->mValue, root->mColor);
+        ans->mTimes = root->mTimes;
+        const Node *source = root;
+        NodePointer copy = ans;
+        while (true)
+        {
+            const Node *next = nullptr;
+            NodePointer *slot = nullptr;
+            if (source->mLeft != nullptr && copy->mLeft == nullptr)
+            {
+                next = source->mLeft;
+                slot = &copy->mLeft;
+            }
+            else if (source->mRight != nullptr && copy->mRight == nullptr)
+            {
+                next = source->mRight;
+                slot = &copy->mRight;
+            }
+
+            if (next != nullptr)
+            {
+                *slot = new Node(*next->mValue, next->mColor, copy);
+                (*slot)->mTimes = next->mTimes;
+                source = next;
+                copy = *slot;
+            }
+            else if (source == root)
+            {
+                break;
+            }
+            else
+            {
+                source = source->mParent;
+                copy = copy->mParent;
+            }
+        }
+
         return ans;
     }
 
@@ -288,6 +395,7 @@ namespace Xc
         if (node == nullptr)
         {
             mRoot = new Node(value, Node::BLACK, nullptr);
+            mSize++;
             return mRoot;
         }
         else
@@ -328,74 +436,68 @@ namespace Xc
                 }
             }
 
+            mSize++;
             insertFix(cur);
             return cur;
         }
     }
 
+    // The situations are the same as before, only situation 3 moves up to the grand parent
+    // in a loop instead of calling itself again.
     template <typename T>
     void RedBlackTree<T>::insertFix(typename RedBlackTree<T>::NodePointer node)
     {
-        Node *parent = node->mParent;
-        Node *grand = nullptr;
-        if (parent != nullptr)
+        while (true)
         {
-            grand = parent->mParent;
-        }
+            Node *parent = node->mParent;
+            if (parent == nullptr) // situation 1
+            {
+                node->mColor = Node::BLACK;
+                return; // finished
+            }
 
-        if (parent == nullptr) // situation 1
-        {
-            node->mColor = Node::BLACK;
-            return; // finished
-        }
-        else if (color(parent) == Node::BLACK && parent != nullptr) // situation 2, "parent != nullptr" is not a must.
-        {
-            return; // finished
-        }
-        else if (color(parent) == Node::RED
-            && color(uncle(node)) == Node::RED) // situation 3
-        {
-            // Solution: Change the tree nodes colors.
-            parent->mColor = Node::BLACK;
-            uncle(node)->mColor = Node::BLACK;
-            grand->mColor = Node::RED;
-            insertFix(grand); // do it again
-        }
-        else if (color(parent) == Node::RED
-            && color(uncle(node)) == Node::BLACK
-            && node == parent->mRight
-            && parent == grand->mLeft) // situation 4
-        {
-            leftRotate(parent);
-            insertFix(parent);
-        }
-        else if (color(parent) == Node::RED
-            && color(uncle(node)) == Node::BLACK
-            && node == parent->mLeft
-            && parent == grand->mRight) // situation 4
-        {
-            rightRotate(parent);
-            insertFix(parent);
-        }
-        else if (color(parent) == Node::RED
-            && color(uncle(node)) == Node::BLACK 
-            && node == parent->mLeft 
-            && parent == grand->mLeft) // situation 5
-        {
-            parent->mColor = Node::BLACK;
-            grand->mColor = Node::RED;
-            rightRotate(grand);
-            insertFix(grand);
-        }
-        else if (color(parent) == Node::RED
-            && color(uncle(node)) == Node::BLACK
-            && node == parent->mRight
-            && parent == grand->mRight) // situatuin 5
-        {
-            parent->mColor = Node::BLACK;
+            if (color(parent) == Node::BLACK) // situation 2
+            {
+                return; // finished
+            }
+
+            Node *grand = parent->mParent; // parent is red, so it is not the root
+            Node *curUncle = uncle(node);
+            if (color(curUncle) == Node::RED) // situation 3
+            {
+                // Solution: Change the tree nodes colors.
+                parent->mColor = Node::BLACK;
+                curUncle->mColor = Node::BLACK;
+                grand->mColor = Node::RED;
+                node = grand; // do it again
+                continue;
+            }
+
+            if (node == parent->mRight && parent == grand->mLeft) // situation 4
+            {
+                leftRotate(parent);
+                node = parent;
+                parent = node->mParent;
+            }
+            else if (node == parent->mLeft && parent == grand->mRight) // situation 4
+            {
+                rightRotate(parent);
+                node = parent;
+                parent = node->mParent;
+            }
+
+            parent->mColor = Node::BLACK; // situation 5
             grand->mColor = Node::RED;
-            leftRotate(grand);
-            insertFix(grand);
+            if (node == parent->mLeft)
+            {
+                rightRotate(grand);
+            }
+            else
+            {
+                leftRotate(grand);
+            }
+
+            return; // finished
         }
     }
 
@@ -439,19 +541,17 @@ namespace Xc
     template <typename T>
     typename RedBlackTree<T>::NodePointer RedBlackTree<T>::leftRotate(NodePointer fulcrum)
     {
-        Node *masterParent = fulcrum->mParent;
-        NodePointer &k1 = reference(fulcrum);
+        NodePointer k1 = fulcrum;
         Node *k2 = k1->mRight; // k2 is must not nullptr
+        reference(k1) = k2;
+        k2->mParent = k1->mParent;
 
         k1->mRight = k2->mLeft;
         k2->mLeft = k1;
 
-        updateParentDoubleChilds(k1);
-        updateParentDoubleChilds(k2);        
-        k1 = k2;
-        updateParentDoubleChilds(masterParent);
-        test(mRoot, nullptr);
-        return k1;
+        updateParentRightChild(k1);
+        updateParentLeftChild(k2);
+        return k2;
     }
 
     // Rotate Description: 
@@ -464,20 +564,17 @@ namespace Xc
     template <typename T>
     typename RedBlackTree<T>::NodePointer RedBlackTree<T>::rightRotate(NodePointer fulcrum)
     {
-        Node *masterParent = fulcrum->mParent;
         NodePointer k2 = fulcrum;
-        NodePointer k1 = k2->mLeft;
+        NodePointer k1 = k2->mLeft; // k1 is must not nullptr
         reference(k2) = k1;
+        k1->mParent = k2->mParent;
 
         k2->mLeft = k1->mRight;
         k1->mRight = k2;
 
-        updateParentDoubleChilds(k1);
-        updateParentDoubleChilds(k2);
-      //  k2 = k1;
-        updateParentDoubleChilds(masterParent);
-        test(mRoot, nullptr);
-        return k2;
+        updateParentLeftChild(k2);
+        updateParentRightChild(k1);
+        return k1;
     }
 
     template <typename T>
@@ -511,7 +608,7 @@ namespace Xc
     {
         if (node == nullptr)
         {
-            return false;
+            return nullptr;
         }
 
         NodePointer parent = node->mParent;
@@ -563,6 +660,8 @@ namespace Xc
         return root;
     }
 
+    // Unlinks the subtree from its parent, then flattens it along mRight and frees it as
+    // BinarySearchTree does; parents and colors are not kept up on the way.
     template<typename T>
     void RedBlackTree<T>::erase(NodePointer root)
     {
@@ -571,10 +670,23 @@ namespace Xc
             return;
         }
 
-        erase(root->mLeft);
-        erase(root->mRight);
         reference(root) = nullptr;
-        delete root;
+        while (root != nullptr)
+        {
+            if (root->mLeft != nullptr)
+            {
+                Node *left = root->mLeft;
+                root->mLeft = left->mRight;
+                left->mRight = root;
+                root = left;
+            }
+            else
+            {
+                Node *right = root->mRight;
+                delete root;
+                root = right;
+            }
+        }
     }
 
     template<typename T>
@@ -589,185 +701,140 @@ namespace Xc
     template <typename T>
     bool RedBlackTree<T>::erase(const T & value)
     {
-       // reference(mRoot->mLeft) = nullptr;
-       /// return true;
-        NodePointer cur = mRoot;
-        while (true)
+        NodePointer cur = findNode(value);
+        if (cur == nullptr)
         {
-            if (cur == nullptr)
-            {
-                return false; // value not exist
-            }
-            else if (value < cur->value())
-            {
-                cur = cur->mLeft;
-            }
-            else if (value > cur->value())
-            {
-                cur = cur->mRight;
-            }
-            else // value == cur->value
-            {
-                break;
-            }
+            return false; // value not exist
         }
 
-        Node *erasePos = nullptr;
-        if (cur->mLeft == nullptr && cur->mRight == nullptr)
+        if (cur->mTimes > 1)
         {
-            erasePos = cur;
+            cur->mTimes--;
+            return true;
         }
-        else if (cur->mRight != nullptr)
+
+        Node *erasePos = cur;
+        if (cur->mLeft != nullptr && cur->mRight != nullptr)
         {
-            Node * rightMin = minimumChild(cur->mRight);
+            Node * rightMin = minimumChild(cur->mRight); // it has no left child
             swap(cur->mValue, rightMin->mValue);
-           // erasePos = cur;
-            // swap(cur->value(), rightMin->value());
-            test(mRoot, nullptr);
+            swap(cur->mTimes, rightMin->mTimes);
             erasePos = rightMin;
         }
-        else if (cur->mLeft != nullptr)
-        {
-            Node *leftMax = maximumChild(cur->mLeft);
-            swap(cur->mValue, leftMax->mValue);
-            //erasePos = cur;
-            // swap(cur->value(), leftMax->value());
-            test(mRoot, nullptr);
-            erasePos =leftMax;
-        }
 
-        if (color(erasePos) == Node::RED)
+        // erasePos has one child at most, it takes the place of erasePos
+        Node *parent = erasePos->mParent;
+        Node *fixPos = erasePos->mLeft != nullptr ? erasePos->mLeft : erasePos->mRight;
+        reference(erasePos) = fixPos;
+        if (fixPos != nullptr)
         {
-            reference(erasePos) = nullptr;
-            delete erasePos;
+            fixPos->mParent = parent;
         }
-        else 
-        {
-            Node *oldNode = erasePos;
 
-            eraseFix(oldNode);
-            Node *parent = erasePos->mParent;
-            
-            Node *fixPos = erasePos->mLeft != nullptr ? erasePos->mLeft : erasePos->mRight;
-            reference(erasePos) = fixPos;
-            updateParentDoubleChilds(parent);
-            delete erasePos;
+        if (color(erasePos) == Node::BLACK)
+        {
+            eraseFix(fixPos, parent); // the path through fixPos lacks one black
         }
 
+        delete erasePos;
+        mSize--;
         return true;
     }
 
     template<typename T>
-    void RedBlackTree<T>::eraseFix(NodePointer node)
+    void RedBlackTree<T>::eraseFix(NodePointer node, NodePointer parent)
     {
-        Node *curSibling = sibling(node); // sibling is must not nullptr
-        if (node == nullptr)
-        {
-            return;
-        }
-        else if (node == mRoot)
-        {
-            node->mColor = Node::BLACK;
-            return;
-        }
-        else if (color(node) == Node::RED)
+        while (node != mRoot && color(node) == Node::BLACK)
         {
-            node->mColor = Node::BLACK;
-            return;
-        }
-        else if (curSibling == nullptr)
-        {
-            eraseFix(node->mParent);
-            return;
-        }
-        else
-        {
-            Node *curSibling = sibling(node); // sibling is must not nullptr
-            Node *curParent = node->mParent;
-            if (node == curParent->mLeft)
+            if (node == parent->mLeft)
             {
+                Node *curSibling = parent->mRight; // sibling is must not nullptr, its side has one black more
                 if (color(curSibling) == Node::RED)
                 {
                     curSibling->mColor = Node::BLACK;
-                    curParent->mColor = Node::RED;
-                    leftRotate(curParent);
-                    eraseFix(node);
+                    parent->mColor = Node::RED;
+                    leftRotate(parent);
+                    curSibling = parent->mRight;
                 }
-                else if (color(curSibling->mLeft) == Node::BLACK
+
+                if (color(curSibling->mLeft) == Node::BLACK
                     && color(curSibling->mRight) == Node::BLACK)
                 {
                     curSibling->mColor = Node::RED;
-                    eraseFix(curParent);
+                    node = parent; // the lack moves up
+                    parent = node->mParent;
                 }
                 else
                 {
                     if (color(curSibling->mRight) == Node::BLACK)
                     {
-                        swap(curSibling->mColor, curSibling->mLeft->mColor);
+                        curSibling->mLeft->mColor = Node::BLACK;
+                        curSibling->mColor = Node::RED;
                         rightRotate(curSibling);
+                        curSibling = parent->mRight;
                     }
 
-                    swap(node->mParent->mColor, node->mParent->mRight->mColor);
-                    node->mParent->mRight->mRight->mColor = Node::BLACK;
-                    leftRotate(node->mParent);
-                    return;
+                    curSibling->mColor = parent->mColor;
+                    parent->mColor = Node::BLACK;
+                    curSibling->mRight->mColor = Node::BLACK;
+                    leftRotate(parent);
+                    node = mRoot; // finished
                 }
             }
-            else // node == curParent->mRight
+            else // node == parent->mRight
             {
+                Node *curSibling = parent->mLeft;
                 if (color(curSibling) == Node::RED)
                 {
                     curSibling->mColor = Node::BLACK;
-                    curParent->mColor = Node::RED;
-                    rightRotate(curParent);
-                    eraseFix(node);
+                    parent->mColor = Node::RED;
+                    rightRotate(parent);
+                    curSibling = parent->mLeft;
                 }
-                else if (color(curSibling->mLeft) == Node::BLACK
+
+                if (color(curSibling->mLeft) == Node::BLACK
                     && color(curSibling->mRight) == Node::BLACK)
                 {
                     curSibling->mColor = Node::RED;
-                    eraseFix(curParent);
+                    node = parent;
+                    parent = node->mParent;
                 }
                 else
                 {
                     if (color(curSibling->mLeft) == Node::BLACK)
                     {
-                        swap(curSibling->mColor, curSibling->mRight->mColor);
+                        curSibling->mRight->mColor = Node::BLACK;
+                        curSibling->mColor = Node::RED;
                         leftRotate(curSibling);
+                        curSibling = parent->mLeft;
                     }
 
-                    swap(node->mParent->mColor, node->mParent->mLeft->mColor);
-                    rightRotate(node->mParent);
-                    return;
+                    curSibling->mColor = parent->mColor;
+                    parent->mColor = Node::BLACK;
+                    curSibling->mLeft->mColor = Node::BLACK;
+                    rightRotate(parent);
+                    node = mRoot;
                 }
             }
         }
-    }
-
-    template <typename T>
-    void RedBlackTree<T>::eraseLeftLackFix(NodePointer node)
-    {
-        for (int i = 0)
-    }
 
-    template<typename T>
-    inline void RedBlackTree<T>::eraseRightLackFix(NodePointer node)
-    {
+        if (node != nullptr)
+        {
+            node->mColor = Node::BLACK;
+        }
     }
 
-
     template <typename T>
     template <typename U>
     void RedBlackTree<T>::swap(U & a, U & b)
     {
-        test(mRoot, nullptr);
         U oldA = a;
         a = b;
         b = oldA;
     }
 
     template <typename T>
-    RedBlackTree<T>::Iterator::Iterator(RedBlackTree<T> *tree, typename RedBlackTree<T>::Node *node) :
+    RedBlackTree<T>::Iterator::Iterator(const RedBlackTree<T> *tree, typename RedBlackTree<T>::Node *node) :
         ConstantIterator(tree, node)
     {
     }
@@ -775,63 +842,19 @@ namespace Xc
     template <typename T>
     typename RedBlackTree<T>::Iterator &RedBlackTree<T>::Iterator::operator ++ ()
     {
-        if (mNode == nullptr)
-        {
-            mNode = mTree->minimumChild(mTree->mRoot);
-            return *this;
-        }
-
-        if (mNode->mRight != nullptr)
-        {
-            mNode = mNode->mRight;
-            return *this;
-        }
-        else
-        {
-            Node *ans = mNode->mParent;
-            while (ans != nullptr && ans->value() < mNode->value())
-            {
-                ans = ans->mParent;
-            }
-
-            mNode = ans;
-            return *this;
-        }
-
+        ConstantIterator::operator ++ ();
         return *this;
     }
 
     template <typename T>
     typename RedBlackTree<T>::Iterator &RedBlackTree<T>::Iterator::operator -- ()
     {
-        if (mNode == nullptr)
-        {
-            mNode = mTree->maximumChild(mTree->mRoot);
-            return *this;
-        }
-
-        if (mNode->mLeft != nullptr)
-        {
-            mNode = mNode->mLeft;
-            return *this;
-        }
-        else
-        {
-            Node *ans = mNode->mParent;
-            while (ans != nullptr && ans->value() > mNode->value())
-            {
-                ans = ans->mParent;
-            }
-
-            mNode = ans;
-            return *this;
-        }
-
+        ConstantIterator::operator -- ();
         return *this;
     }
 
     template <typename T>
-    typename RedBlackTree<T>::Iterator RedBlackTree<T>::Iterator::operator ++ (int) const
+    typename RedBlackTree<T>::Iterator RedBlackTree<T>::Iterator::operator ++ (int)
     {
         Iterator ans = *this;
         ++(*this);
@@ -839,7 +862,7 @@ namespace Xc
     }
 
     template <typename T>
-    typename RedBlackTree<T>::Iterator RedBlackTree<T>::Iterator::operator -- (int) const
+    typename RedBlackTree<T>::Iterator RedBlackTree<T>::Iterator::operator -- (int)
     {
         Iterator ans = *this;
         --(*this);
@@ -848,11 +871,12 @@ namespace Xc
 
 
     template <typename T>
-    RedBlackTree<T>::ConstantIterator::ConstantIterator(RedBlackTree<T> *tree, typename RedBlackTree<T>::Node *node) :
+    RedBlackTree<T>::ConstantIterator::ConstantIterator(const RedBlackTree<T> *tree, typename RedBlackTree<T>::Node *node) :
         mTree(tree), mNode(node)
     {
     }
 
+    // the leftmost node of the right subtree, otherwise the first parent reached from a left child
     template <typename T>
     typename RedBlackTree<T>::ConstantIterator &RedBlackTree<T>::ConstantIterator::operator ++ ()
     {
@@ -864,21 +888,19 @@ namespace Xc
 
         if (mNode->mRight != nullptr)
         {
-            mNode = mNode->mRight;
+            mNode = mTree->minimumChild(mNode->mRight);
             return *this;
         }
-        else
-        {
-            Node *ans = mNode->mParent;
-            while (ans != nullptr && ans->value() < mNode->value())
-            {
-                ans = ans->mParent;
-            }
 
-            mNode = ans;
-            return *this;
+        Node *node = mNode;
+        Node *ans = node->mParent;
+        while (ans != nullptr && node == ans->mRight)
+        {
+            node = ans;
+            ans = ans->mParent;
         }
 
+        mNode = ans;
         return *this;
     }
 
@@ -893,26 +915,24 @@ namespace Xc
 
         if (mNode->mLeft != nullptr)
         {
-            mNode = mNode->mLeft;
+            mNode = mTree->maximumChild(mNode->mLeft);
             return *this;
         }
-        else
-        {
-            Node *ans = mNode->mParent;
-            while (ans != nullptr && ans->value() > mNode->value())
-            {
-                ans = ans->mParent;
-            }
 
-            mNode = ans;
-            return *this;
+        Node *node = mNode;
+        Node *ans = node->mParent;
+        while (ans != nullptr && node == ans->mLeft)
+        {
+            node = ans;
+            ans = ans->mParent;
         }
 
+        mNode = ans;
         return *this;
     }
 
     template <typename T>
-    typename RedBlackTree<T>::ConstantIterator RedBlackTree<T>::ConstantIterator::operator ++ (int) const
+    typename RedBlackTree<T>::ConstantIterator RedBlackTree<T>::ConstantIterator::operator ++ (int)
     {
         ConstantIterator ans = *this;
         ++(*this);
@@ -920,7 +940,7 @@ namespace Xc
     }
 
     template <typename T>
-    typename RedBlackTree<T>::ConstantIterator RedBlackTree<T>::ConstantIterator::operator -- (int) const
+    typename RedBlackTree<T>::ConstantIterator RedBlackTree<T>::ConstantIterator::operator -- (int)
     {
         ConstantIterator ans = *this;
         --(*this);
@@ -1,7 +1,10 @@
 #ifndef STACK_H
 #define STACK_H
 
+#include <new>
+#include <utility>
 #include "List.h"
+#include "UnrolledList.h"
 
 namespace Xc
 {
@@ -17,29 +20,140 @@ namespace Xc
         virtual bool isEmpty() const = 0;
     };
 
-    template <typename T>
+    // One heap node per push with the default List, ListStack<T, UnrolledList<T> > allocates once per block.
+    template <typename T, typename TList = List<T> >
     class ListStack : public AbstractStack<T>
     {
     public:
-        virtual const T &top() const final { return *--mList.end(); }
-        virtual T &top() final { return *--mList.end(); }
+        virtual const T &top() const final { return mList.back(); }
+        virtual T &top() final { return mList.back(); }
         virtual void pop() final { mList.popBack(); }
         virtual void push(const T &value) final { mList.pushBack(value); }
         virtual bool isEmpty() const final { return mList.isEmpty(); }
 
     private:
-        List<T> mList;
+        TList mList;
     };
 
-    // Equals typedef, but templates do not support typedef.
-    template <typename T> class Stack : public ListStack<T> {}; 
-
+    // Contiguous, the capacity doubles when full, so a push allocates only O(log n) times in total.
     template <typename T> 
-    class VertorStack : public AbstractStack<T>
+    class VectorStack : public AbstractStack<T>
     {
     public:
+        VectorStack();
+        ~VectorStack();
+        VectorStack(const VectorStack &rhs);
+        VectorStack &operator =(const VectorStack &rhs);
+        virtual const T &top() const final { return mData[mSize - 1]; }
+        virtual T &top() final { return mData[mSize - 1]; }
+        virtual void pop() final { mData[--mSize].~T(); }
+        virtual void push(const T &value) final;
+        virtual bool isEmpty() const final { return mSize == 0; }
+        inline int size() const { return mSize; }
+        inline int capacity() const { return mCapacity; }
+        void reserve(int capacity);
+        void clear();
+
+    private:
+        static const int InitialCapacity = 16;
 
+        T *mData; // raw storage, only [0, mSize) is constructed
+        int mSize;
+        int mCapacity;
     };
+
+    // Equals typedef, but templates do not support typedef.
+    template <typename T> class Stack : public VectorStack<T> {}; 
+
+    template <typename T>
+    VectorStack<T>::VectorStack() :
+        mData(nullptr), mSize(0), mCapacity(0)
+    {
+    }
+
+    template <typename T>
+    VectorStack<T>::~VectorStack()
+    {
+        clear();
+        ::operator delete(mData);
+    }
+
+    template <typename T>
+    VectorStack<T>::VectorStack(const VectorStack &rhs) :
+        mData(nullptr), mSize(0), mCapacity(0)
+    {
+        reserve(rhs.mSize);
+        for (int i = 0; i < rhs.mSize; ++i)
+        {
+            new (mData + i) T(rhs.mData[i]);
+        }
+
+        mSize = rhs.mSize;
+    }
+
+    template <typename T>
+    VectorStack<T> &VectorStack<T>::operator =(const VectorStack &rhs)
+    {
+        if (this != &rhs)
+        {
+            clear();
+            reserve(rhs.mSize);
+            for (int i = 0; i < rhs.mSize; ++i)
+            {
+                new (mData + i) T(rhs.mData[i]);
+            }
+
+            mSize = rhs.mSize;
+        }
+
+        return *this;
+    }
+
+    template <typename T>
+    void VectorStack<T>::push(const T &value)
+    {
+        if (mSize == mCapacity)
+        {
+            T copy(value); // value may live in the buffer that is about to move
+            reserve(mCapacity == 0 ? InitialCapacity : mCapacity * 2);
+            new (mData + mSize) T(std::move(copy));
+        }
+        else
+        {
+            new (mData + mSize) T(value);
+        }
+
+        mSize++;
+    }
+
+    template <typename T>
+    void VectorStack<T>::reserve(int capacity)
+    {
+        if (capacity <= mCapacity)
+        {
+            return;
+        }
+
+        T *data = static_cast<T *>(::operator new(sizeof(T) * capacity));
+        for (int i = 0; i < mSize; ++i)
+        {
+            new (data + i) T(std::move(mData[i]));
+            mData[i].~T();
+        }
+
+        ::operator delete(mData);
+        mData = data;
+        mCapacity = capacity;
+    }
+
+    template <typename T>
+    void VectorStack<T>::clear()
+    {
+        while (mSize > 0)
+        {
+            mData[--mSize].~T();
+        }
+    }
 }
 
 #endif // STACK_H
\ No newline at end of file
@@ -0,0 +1,207 @@
+#include "StackTest.h"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "Stack.h"
+
+using namespace std;
+
+namespace Xc
+{
+    namespace
+    {
+        typedef UnrolledList<string, 4> SmallList;
+
+        bool check(bool condition, const char *what)
+        {
+            if (!condition)
+            {
+                printf("Stack: %s\n", what);
+            }
+
+            return condition;
+        }
+
+        // longer than any short string buffer, so every copy and move owns memory
+        string makeValue(int i)
+        {
+            return "value number " + to_string(i) + " of the stack test";
+        }
+
+        template <typename TStack>
+        bool testStack(const char *what)
+        {
+            mt19937 random(2019);
+            TStack stack;
+            vector<string> expected;
+            bool ans = check(stack.isEmpty(), what);
+            for (int i = 0; i < 5000 && ans; ++i)
+            {
+                if (!expected.empty() && random() % 3 == 0)
+                {
+                    stack.pop();
+                    expected.pop_back();
+                }
+                else if (!expected.empty() && random() % 8 == 0)
+                {
+                    stack.push(stack.top()); // the value lives in the stack while it grows
+                    expected.push_back(expected.back());
+                }
+                else
+                {
+                    stack.push(makeValue(i));
+                    expected.push_back(makeValue(i));
+                }
+
+                ans &= check(stack.isEmpty() == expected.empty(), what);
+                ans &= check(expected.empty() || stack.top() == expected.back(), what);
+            }
+
+            while (ans && !expected.empty())
+            {
+                ans &= check(stack.top() == expected.back(), what);
+                stack.pop();
+                expected.pop_back();
+            }
+
+            return ans && check(stack.isEmpty(), what);
+        }
+
+        bool testVectorStackCopies()
+        {
+            VectorStack<string> stack;
+            for (int i = 0; i < 100; ++i)
+            {
+                stack.push(makeValue(i));
+            }
+
+            VectorStack<string> copy(stack);
+            VectorStack<string> assigned;
+            assigned.push(makeValue(-1));
+            assigned = stack;
+            stack.pop();
+            stack.push(makeValue(100));
+            return check(copy.size() == 100 && copy.top() == makeValue(99), "a copied VectorStack holds the values")
+                && check(assigned.size() == 100 && assigned.top() == makeValue(99), "an assigned VectorStack holds the values")
+                && check(stack.top() == makeValue(100), "a VectorStack is independent of its copies");
+        }
+
+        SmallList::Iterator iteratorAt(SmallList &list, int index)
+        {
+            SmallList::Iterator itr = list.begin();
+            for (int i = 0; i < index; ++i)
+            {
+                ++itr;
+            }
+
+            return itr;
+        }
+
+        bool equals(const SmallList &list, const vector<string> &expected)
+        {
+            if (list.size() != (int)expected.size())
+            {
+                return false;
+            }
+
+            int i = 0;
+            for (SmallList::ConstantIterator itr = list.begin(); itr != list.end(); ++itr, ++i)
+            {
+                if (*itr != expected[i] || list.at(i) != expected[i])
+                {
+                    return false;
+                }
+            }
+
+            SmallList::ConstantIterator itr = list.end();
+            for (int j = (int)expected.size() - 1; j >= 0; --j) // backwards through the links of the nodes
+            {
+                if (*--itr != expected[j])
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // With four values a node, inserting in the middle splits nodes and erasing merges them every few steps.
+        bool testUnrolledList()
+        {
+            mt19937 random(2020);
+            SmallList list;
+            vector<string> expected;
+            bool ans = true;
+            for (int i = 0; i < 6000 && ans; ++i)
+            {
+                int operation = int(random() % 10);
+                if (expected.size() > 300)
+                {
+                    operation = 9; // keep it short enough for the quadratic checks, erases merge nodes
+                }
+
+                string value = makeValue(i);
+                if (operation < 4 || expected.empty())
+                {
+                    int index = int(random() % (expected.size() + 1));
+                    SmallList::Iterator inserted = list.insert(iteratorAt(list, index), value);
+                    expected.insert(expected.begin() + index, value);
+                    ans &= check(*inserted == value, "insert returns the inserted value");
+                }
+                else if (operation == 4)
+                {
+                    list.pushFront(value);
+                    expected.insert(expected.begin(), value);
+                }
+                else if (operation == 5)
+                {
+                    list.pushBack(value);
+                    expected.push_back(value);
+                }
+                else if (operation == 6)
+                {
+                    list.popBack();
+                    expected.pop_back();
+                }
+                else if (operation == 7)
+                {
+                    list.popFront();
+                    expected.erase(expected.begin());
+                }
+                else
+                {
+                    int index = int(random() % expected.size());
+                    SmallList::Iterator next = list.erase(iteratorAt(list, index));
+                    expected.erase(expected.begin() + index);
+                    ans &= check(index == (int)expected.size() ? next == list.end() : *next == expected[index],
+                        "erase returns the value after the erased one");
+                }
+
+                ans &= check(equals(list, expected), "UnrolledList holds the values of a vector after inserts and erases");
+            }
+
+            SmallList copy(list);
+            SmallList assigned;
+            assigned.pushBack(makeValue(-1));
+            assigned = list;
+            ans &= check(equals(copy, expected) && equals(assigned, expected), "copies of an UnrolledList hold its values");
+            list.clear();
+            ans &= check(list.isEmpty() && list.begin() == list.end() && equals(copy, expected), "clear empties only the list");
+            return ans;
+        }
+    }
+
+    bool testStacks()
+    {
+        bool ans = true;
+        ans &= testStack<VectorStack<string> >("VectorStack pushes and pops like a vector");
+        ans &= testStack<Stack<string> >("Stack pushes and pops like a vector");
+        ans &= testStack<ListStack<string> >("ListStack over List pushes and pops like a vector");
+        ans &= testStack<ListStack<string, SmallList> >("ListStack over UnrolledList pushes and pops like a vector");
+        ans &= testVectorStackCopies();
+        ans &= testUnrolledList();
+        return ans;
+    }
+}
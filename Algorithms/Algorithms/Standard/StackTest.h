@@ -0,0 +1,12 @@
+#ifndef STACKTEST_H
+#define STACKTEST_H
+
+namespace Xc
+{
+    // Checks VectorStack and ListStack over List and UnrolledList, and inserts and erases anywhere in an
+    // UnrolledList small enough that its nodes split and merge, against a std::vector of strings, and
+    // prints a line for every check that fails. Returns false if any did.
+    bool testStacks();
+}
+
+#endif // STACKTEST_H
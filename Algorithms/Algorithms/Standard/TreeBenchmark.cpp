@@ -0,0 +1,146 @@
+#include "TreeBenchmark.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "BinaryTree.h"
+#include "AVLTree.h"
+#include "RedBlackTree.h"
+
+using namespace std;
+
+namespace Xc
+{
+    namespace
+    {
+        class Stopwatch
+        {
+        public:
+            Stopwatch() : mStart(chrono::steady_clock::now()) {}
+            double milliseconds() const { return chrono::duration<double, milli>(chrono::steady_clock::now() - mStart).count(); }
+
+        private:
+            chrono::steady_clock::time_point mStart;
+        };
+
+        // the checksum keeps the measured work from being optimized away
+        void report(const char *tree, const char *operation, size_t count, double milliseconds, long long checksum)
+        {
+            printf("%-18s %-10s %10zu ops %10.1f ms %10.2f Mops/s  (checksum %lld)\n",
+                tree, operation, count, milliseconds, count / (milliseconds > 0 ? milliseconds : 1) / 1000.0, checksum);
+        }
+
+        // The three trees differ in names and return types, these adapters give them one shape.
+        struct BinarySearchTreeAdapter
+        {
+            typedef BinarySearchTree<int> Tree;
+            static const char *name() { return "BinarySearchTree"; }
+            static bool contains(const Tree &tree, int key) { return tree.count(key) != 0; }
+            template <typename Visitor> static void traverse(Tree &tree, Visitor visit) { tree.traverse([&](const int &value, int) { visit(value); }); }
+        };
+
+        struct AVLTreeAdapter
+        {
+            typedef AVLTree<int> Tree;
+            static const char *name() { return "AVLTree"; }
+            static bool contains(const Tree &tree, int key) { return tree.count(key) != 0; }
+            template <typename Visitor> static void traverse(Tree &tree, Visitor visit)
+            {
+                for (Tree::Iterator itr = tree.begin(); itr != tree.end(); ++itr)
+                {
+                    visit(*itr);
+                }
+            }
+        };
+
+        struct RedBlackTreeAdapter
+        {
+            typedef RedBlackTree<int> Tree;
+            static const char *name() { return "RedBlackTree"; }
+            static bool contains(const Tree &tree, int key) { return tree.isExist(key); }
+            template <typename Visitor> static void traverse(const Tree &tree, Visitor visit)
+            {
+                for (Tree::ConstantIterator itr = tree.begin(); itr != tree.end(); ++itr)
+                {
+                    visit(*itr);
+                }
+            }
+        };
+
+        template <typename Adapter>
+        void run(const char *workload, const vector<int> &keys, const vector<int> &queries)
+        {
+            printf("%s, %s\n", Adapter::name(), workload);
+            typename Adapter::Tree *tree = new typename Adapter::Tree;
+
+            Stopwatch insert;
+            for (int key : keys)
+            {
+                tree->insert(key);
+            }
+            report(Adapter::name(), "insert", keys.size(), insert.milliseconds(), 0);
+
+            Stopwatch find;
+            long long checksum = 0;
+            for (int key : queries)
+            {
+                checksum += Adapter::contains(*tree, key) ? 1 : 0;
+            }
+            report(Adapter::name(), "find", queries.size(), find.milliseconds(), checksum);
+
+            Stopwatch traverse;
+            size_t visited = 0;
+            checksum = 0;
+            Adapter::traverse(*tree, [&](int value) { checksum += value; visited++; });
+            report(Adapter::name(), "traverse", visited, traverse.milliseconds(), checksum);
+
+            Stopwatch copy;
+            typename Adapter::Tree *clone = new typename Adapter::Tree(*tree);
+            report(Adapter::name(), "copy", visited, copy.milliseconds(), 0);
+
+            Stopwatch destroy;
+            delete clone;
+            report(Adapter::name(), "destroy", visited, destroy.milliseconds(), 0);
+
+            Stopwatch erase;
+            for (int key : keys)
+            {
+                tree->erase(key);
+            }
+            report(Adapter::name(), "erase", keys.size(), erase.milliseconds(), 0);
+            delete tree;
+        }
+    }
+
+    void runTreeBenchmark(int count, int sortedLimit)
+    {
+        mt19937 random(20170);
+        uniform_int_distribution<int> distribution(0, count * 2);
+        vector<int> keys(count);
+        vector<int> queries(count);
+        for (int i = 0; i < count; ++i)
+        {
+            keys[i] = distribution(random);
+            queries[i] = distribution(random);
+        }
+
+        run<BinarySearchTreeAdapter>("random keys", keys, queries);
+        run<AVLTreeAdapter>("random keys", keys, queries);
+        run<RedBlackTreeAdapter>("random keys", keys, queries);
+
+        vector<int> sorted(count);
+        for (int i = 0; i < count; ++i)
+        {
+            sorted[i] = i * 2;
+        }
+
+        run<AVLTreeAdapter>("sorted keys", sorted, queries);
+        run<RedBlackTreeAdapter>("sorted keys", sorted, queries);
+
+        int limit = count < sortedLimit ? count : sortedLimit;
+        vector<int> sortedHead(sorted.begin(), sorted.begin() + limit);
+        vector<int> queriesHead(queries.begin(), queries.begin() + limit);
+        run<BinarySearchTreeAdapter>("sorted keys, degenerate", sortedHead, queriesHead);
+    }
+}
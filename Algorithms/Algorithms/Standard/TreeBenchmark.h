@@ -0,0 +1,13 @@
+#ifndef TREEBENCHMARK_H
+#define TREEBENCHMARK_H
+
+namespace Xc
+{
+    // Times insert, find, in order traversal, copy and erase of BinarySearchTree, AVLTree and RedBlackTree
+    // on count random keys and on count sorted keys, and prints one line per measurement.
+    // Sorted keys turn BinarySearchTree into a list, so it gets sortedLimit of them only: every insert walks
+    // the whole list, what matters is that nothing overflows the stack.
+    void runTreeBenchmark(int count, int sortedLimit = 20000);
+}
+
+#endif // TREEBENCHMARK_H
@@ -0,0 +1,5 @@
+#include "UnrolledList.h"
+
+namespace Xc
+{
+}
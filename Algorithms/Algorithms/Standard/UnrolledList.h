@@ -0,0 +1,394 @@
+#ifndef UNROLLEDLIST_H
+#define UNROLLEDLIST_H
+
+#include <new>
+#include <utility>
+
+namespace Xc
+{
+    // A doubly linked list whose nodes hold up to NodeCapacity values side by side.
+    // One allocation serves a whole block and neighbouring values share cache lines,
+    // so walking and pushing at the ends cost about as much as in an array.
+    // Inserting or erasing in the middle shifts at most one node, a full node is split in half
+    // and a node that falls under half full is merged with its successor when they fit together.
+    // Iterators are invalidated by any insert or erase.
+    template <typename T, int NodeCapacity = 16>
+    class UnrolledList
+    {
+        static_assert(NodeCapacity >= 2, "a node must hold at least two values to be split");
+
+    private:
+        struct Node
+        {
+            Node() : count(0), previous(nullptr), next(nullptr) {}
+            inline T *values() { return reinterpret_cast<T *>(storage); }
+
+            int count;
+            Node *previous;
+            Node *next;
+            alignas(T) unsigned char storage[sizeof(T) * NodeCapacity]; // only [0, count) is constructed
+        };
+
+    public:
+        class ConstantIterator
+        {
+        public:
+            inline ConstantIterator() : mList(nullptr), mNode(nullptr), mIndex(0) {}
+            ConstantIterator &operator ++();
+            ConstantIterator &operator --();
+            ConstantIterator operator ++(int);
+            ConstantIterator operator --(int);
+            inline bool operator ==(const ConstantIterator &rhs) const { return mNode == rhs.mNode && mIndex == rhs.mIndex; }
+            inline bool operator !=(const ConstantIterator &rhs) const { return !(*this == rhs); }
+            inline const T &operator *() const { return mNode->values()[mIndex]; }
+            inline const T *operator ->() const { return mNode->values() + mIndex; }
+
+        protected:
+            ConstantIterator(const UnrolledList *list, Node *node, int index) : mList(list), mNode(node), mIndex(index) {}
+
+            const UnrolledList *mList; // end has no node, -- needs the list to find the last one
+            Node *mNode;
+            int mIndex;
+
+            friend class UnrolledList;
+        };
+
+        class Iterator : public ConstantIterator
+        {
+        public:
+            inline Iterator() {}
+            inline Iterator &operator ++() { ConstantIterator::operator ++(); return *this; }
+            inline Iterator &operator --() { ConstantIterator::operator --(); return *this; }
+            inline Iterator operator ++(int) { Iterator itr = *this; ++*this; return itr; }
+            inline Iterator operator --(int) { Iterator itr = *this; --*this; return itr; }
+            inline T &operator *() const { return this->mNode->values()[this->mIndex]; }
+            inline T *operator ->() const { return this->mNode->values() + this->mIndex; }
+
+        private:
+            Iterator(const UnrolledList *list, Node *node, int index) : ConstantIterator(list, node, index) {}
+
+            friend class UnrolledList;
+        };
+
+    public:
+        UnrolledList();
+        ~UnrolledList();
+        UnrolledList(const UnrolledList &rhs);
+        UnrolledList &operator =(const UnrolledList &rhs);
+        inline ConstantIterator begin() const { return ConstantIterator(this, mFirst, 0); }
+        inline ConstantIterator end() const { return ConstantIterator(this, nullptr, 0); }
+        inline bool isEmpty() const { return mSize == 0; }
+        inline int size() const { return mSize; }
+        inline const T &front() const { return mFirst->values()[0]; }
+        inline const T &back() const { return mLast->values()[mLast->count - 1]; }
+        const T &at(int index) const;
+
+        inline Iterator begin() { return Iterator(this, mFirst, 0); }
+        inline Iterator end() { return Iterator(this, nullptr, 0); }
+        void pushBack(const T &value);
+        void pushFront(const T &value);
+        void popBack();
+        inline void popFront() { erase(begin()); }
+        inline T &front() { return mFirst->values()[0]; }
+        inline T &back() { return mLast->values()[mLast->count - 1]; }
+        inline T &at(int index) { return const_cast<T &>(static_cast<const UnrolledList *>(this)->at(index)); }
+        Iterator insert(const ConstantIterator &before, const T &value); // returns the inserted value
+        Iterator erase(const ConstantIterator &location); // returns the value after the erased one
+        void clear();
+
+    private:
+        Node *insertNodeAfter(Node *node); // nullptr inserts at the front
+        void eraseNode(Node *node);
+        Iterator insertAt(Node *node, int index, T &&value);
+        void split(Node *node);
+
+        Node *mFirst;
+        Node *mLast;
+        int mSize;
+    };
+
+    // ConstantIterator functions
+    template <typename T, int NodeCapacity>
+    typename UnrolledList<T, NodeCapacity>::ConstantIterator &UnrolledList<T, NodeCapacity>::ConstantIterator::operator ++()
+    {
+        if (++mIndex == mNode->count)
+        {
+            mNode = mNode->next;
+            mIndex = 0;
+        }
+
+        return *this;
+    }
+
+    template <typename T, int NodeCapacity>
+    typename UnrolledList<T, NodeCapacity>::ConstantIterator &UnrolledList<T, NodeCapacity>::ConstantIterator::operator --()
+    {
+        if (mIndex == 0)
+        {
+            mNode = mNode == nullptr ? mList->mLast : mNode->previous;
+            mIndex = mNode->count;
+        }
+
+        mIndex--;
+        return *this;
+    }
+
+    template <typename T, int NodeCapacity>
+    typename UnrolledList<T, NodeCapacity>::ConstantIterator UnrolledList<T, NodeCapacity>::ConstantIterator::operator ++(int)
+    {
+        ConstantIterator itr = *this;
+        ++*this;
+        return itr;
+    }
+
+    template <typename T, int NodeCapacity>
+    typename UnrolledList<T, NodeCapacity>::ConstantIterator UnrolledList<T, NodeCapacity>::ConstantIterator::operator --(int)
+    {
+        ConstantIterator itr = *this;
+        --*this;
+        return itr;
+    }
+
+    // UnrolledList functions
+    template <typename T, int NodeCapacity>
+    UnrolledList<T, NodeCapacity>::UnrolledList() :
+        mFirst(nullptr), mLast(nullptr), mSize(0)
+    {
+    }
+
+    template <typename T, int NodeCapacity>
+    UnrolledList<T, NodeCapacity>::~UnrolledList()
+    {
+        clear();
+    }
+
+    template <typename T, int NodeCapacity>
+    UnrolledList<T, NodeCapacity>::UnrolledList(const UnrolledList &rhs) :
+        mFirst(nullptr), mLast(nullptr), mSize(0)
+    {
+        for (ConstantIterator itr = rhs.begin(); itr != rhs.end(); ++itr)
+        {
+            pushBack(*itr);
+        }
+    }
+
+    template <typename T, int NodeCapacity>
+    UnrolledList<T, NodeCapacity> &UnrolledList<T, NodeCapacity>::operator =(const UnrolledList &rhs)
+    {
+        if (this != &rhs)
+        {
+            clear();
+            for (ConstantIterator itr = rhs.begin(); itr != rhs.end(); ++itr)
+            {
+                pushBack(*itr);
+            }
+        }
+
+        return *this;
+    }
+
+    template <typename T, int NodeCapacity>
+    const T &UnrolledList<T, NodeCapacity>::at(int index) const
+    {
+        Node *node = mFirst;
+        while (index >= node->count)
+        {
+            index -= node->count;
+            node = node->next;
+        }
+
+        return node->values()[index];
+    }
+
+    template <typename T, int NodeCapacity>
+    void UnrolledList<T, NodeCapacity>::pushBack(const T &value)
+    {
+        if (mLast == nullptr || mLast->count == NodeCapacity)
+        {
+            T copy(value); // value may be in the list, keep it alive until it is placed
+            Node *node = insertNodeAfter(mLast);
+            new (node->values()) T(std::move(copy));
+            node->count = 1;
+        }
+        else
+        {
+            new (mLast->values() + mLast->count) T(value);
+            mLast->count++;
+        }
+
+        mSize++;
+    }
+
+    template <typename T, int NodeCapacity>
+    void UnrolledList<T, NodeCapacity>::pushFront(const T &value)
+    {
+        if (mFirst == nullptr)
+        {
+            pushBack(value);
+            return;
+        }
+
+        insertAt(mFirst, 0, T(value));
+    }
+
+    template <typename T, int NodeCapacity>
+    void UnrolledList<T, NodeCapacity>::popBack()
+    {
+        mLast->values()[--mLast->count].~T();
+        mSize--;
+        if (mLast->count == 0)
+        {
+            eraseNode(mLast);
+        }
+    }
+
+    template <typename T, int NodeCapacity>
+    typename UnrolledList<T, NodeCapacity>::Iterator UnrolledList<T, NodeCapacity>::insert(const ConstantIterator &before, const T &value)
+    {
+        if (before.mNode == nullptr)
+        {
+            pushBack(value);
+            return Iterator(this, mLast, mLast->count - 1);
+        }
+
+        return insertAt(before.mNode, before.mIndex, T(value));
+    }
+
+    template <typename T, int NodeCapacity>
+    typename UnrolledList<T, NodeCapacity>::Iterator UnrolledList<T, NodeCapacity>::erase(const ConstantIterator &location)
+    {
+        Node *node = location.mNode;
+        int index = location.mIndex;
+        T *values = node->values();
+        for (int i = index + 1; i < node->count; ++i)
+        {
+            values[i - 1] = std::move(values[i]);
+        }
+
+        values[--node->count].~T();
+        mSize--;
+        if (node->count == 0)
+        {
+            Node *next = node->next;
+            eraseNode(node);
+            return Iterator(this, next, 0);
+        }
+
+        // Keep nodes at least half full where possible, otherwise a mix of inserts and erases
+        // could leave a list of one value nodes.
+        Node *next = node->next;
+        if (node->count < NodeCapacity / 2 && next != nullptr && node->count + next->count <= NodeCapacity)
+        {
+            T *nextValues = next->values();
+            for (int i = 0; i < next->count; ++i)
+            {
+                new (values + node->count + i) T(std::move(nextValues[i]));
+                nextValues[i].~T();
+            }
+
+            node->count += next->count;
+            next->count = 0;
+            eraseNode(next);
+        }
+
+        if (index == node->count)
+        {
+            return Iterator(this, node->next, 0);
+        }
+
+        return Iterator(this, node, index);
+    }
+
+    template <typename T, int NodeCapacity>
+    void UnrolledList<T, NodeCapacity>::clear()
+    {
+        while (mFirst != nullptr)
+        {
+            Node *node = mFirst;
+            mFirst = node->next;
+            for (int i = 0; i < node->count; ++i)
+            {
+                node->values()[i].~T();
+            }
+
+            delete node;
+        }
+
+        mLast = nullptr;
+        mSize = 0;
+    }
+
+    template <typename T, int NodeCapacity>
+    typename UnrolledList<T, NodeCapacity>::Node *UnrolledList<T, NodeCapacity>::insertNodeAfter(Node *node)
+    {
+        Node *inserted = new Node;
+        Node *next = node == nullptr ? mFirst : node->next;
+        inserted->previous = node;
+        inserted->next = next;
+        (node == nullptr ? mFirst : node->next) = inserted;
+        (next == nullptr ? mLast : next->previous) = inserted;
+        return inserted;
+    }
+
+    template <typename T, int NodeCapacity>
+    void UnrolledList<T, NodeCapacity>::eraseNode(Node *node)
+    {
+        (node->previous == nullptr ? mFirst : node->previous->next) = node->next;
+        (node->next == nullptr ? mLast : node->next->previous) = node->previous;
+        delete node;
+    }
+
+    // Moves the upper half of a full node into a new node after it.
+    template <typename T, int NodeCapacity>
+    void UnrolledList<T, NodeCapacity>::split(Node *node)
+    {
+        Node *next = insertNodeAfter(node);
+        int keep = NodeCapacity / 2;
+        T *values = node->values();
+        T *nextValues = next->values();
+        for (int i = keep; i < node->count; ++i)
+        {
+            new (nextValues + i - keep) T(std::move(values[i]));
+            values[i].~T();
+        }
+
+        next->count = node->count - keep;
+        node->count = keep;
+    }
+
+    template <typename T, int NodeCapacity>
+    typename UnrolledList<T, NodeCapacity>::Iterator UnrolledList<T, NodeCapacity>::insertAt(Node *node, int index, T &&value)
+    {
+        if (node->count == NodeCapacity)
+        {
+            split(node);
+            if (index > node->count)
+            {
+                index -= node->count;
+                node = node->next;
+            }
+        }
+
+        T *values = node->values();
+        if (index == node->count)
+        {
+            new (values + index) T(std::move(value));
+        }
+        else
+        {
+            new (values + node->count) T(std::move(values[node->count - 1]));
+            for (int i = node->count - 1; i > index; --i)
+            {
+                values[i] = std::move(values[i - 1]);
+            }
+
+            values[index] = std::move(value);
+        }
+
+        node->count++;
+        mSize++;
+        return Iterator(this, node, index);
+    }
+}
+
+#endif // UNROLLEDLIST_H
@@ -63,6 +63,7 @@ XC_BEGIN_NAMESPACE_1(XC)
         void PushFront(const T & value) { Insert(GetBegin(), value); }
         void PopFront() { Erase(GetBegin()); }
         void Remove(T value);
+        Memories::MemoryStatistics GetMemoryStatistics() const;
 
         // these functions are provided for c++ for statement
         ConstantIterator begin() const { return GetBegin(); }
@@ -179,6 +180,7 @@ XC_BEGIN_NAMESPACE_1(XC)
             ++newFinish;
 
             Memories::Destroy(GetBegin(), GetEnd());
+            Deallocate();
             mStart = newStart;
             mFinish = newFinish;
             mEndOfStorage = newStart + newCap;
@@ -292,6 +294,18 @@ XC_BEGIN_NAMESPACE_1(XC)
         }
     }
 
+    template <typename T, typename TAllocator>
+    Memories::MemoryStatistics Array<T, TAllocator>::GetMemoryStatistics() const
+    {
+        Memories::MemoryStatistics ans;
+        ans.mCountElements = GetSize();
+        ans.mCapacity = GetCapacity();
+        ans.mCountNodes = mStart != nullptr ? 1 : 0;
+        ans.mElementSize = sizeof(T);
+        ans.mOverheadBytes = 0; // one contiguous block, only unused slots are wasted
+        return ans;
+    }
+
     template <typename T, typename TAllocator>
     inline void Array<T, TAllocator>::Deallocate()
     {
@@ -332,3 +346,45 @@ XC_BEGIN_NAMESPACE_1(XC)
     }
 
 } XC_END_NAMESPACE_1
+
+XC_BEGIN_NAMESPACE_1(XC_ARRAY_TEST)
+{
+    class ArrayTestTag {};
+
+    XC_TEST_CASE(ARRAY_MEMORY_STATISTICS_TEST)
+    {
+        using Allocator = XC::TrackingAllocator<int, XC::DefaultAllocator<int>, ArrayTestTag>;
+        XC::Memories::AllocationStatistics & statistics = Allocator::GetStatistics();
+        statistics.Reset(); // the test runs once for every translation unit including this header
+
+        {
+            XC::Array<int, Allocator> arr;
+            for (int i = 0; i < 100; ++i)
+            {
+                arr.PushBack(i);
+            }
+
+            XC::Memories::MemoryStatistics memory = arr.GetMemoryStatistics();
+            XC_TEST_ASSERT(memory.mCountElements == 100);
+            XC_TEST_ASSERT(memory.mCapacity == 128);
+            XC_TEST_ASSERT(memory.GetUnusedBytes() == 28 * sizeof(int));
+            XC_TEST_ASSERT(statistics.GetCountAllocations() == 8); // 1, 2, 4 ... 128
+            XC_TEST_ASSERT(statistics.GetLiveBytes() == 128 * sizeof(int));
+            XC_TEST_ASSERT(statistics.GetPeakBytes() == (128 + 64) * sizeof(int));
+            XC_TEST_ASSERT(statistics.GetHistogram(XC::Memories::AllocationStatistics::GetBucketIndex(128 * sizeof(int))) == 1);
+        }
+
+        XC_TEST_ASSERT(statistics.GetLiveBytes() == 0);
+        XC_TEST_ASSERT(statistics.GetCountLiveAllocations() == 0);
+
+        {
+            XC::Array<int, Allocator> arr;
+            arr.PushBack(1);
+            statistics.Reset(); // a block allocated before the reset is freed after it
+        }
+
+        XC_TEST_ASSERT(statistics.GetCountDeallocations() == 1);
+        XC_TEST_ASSERT(statistics.GetCountLiveAllocations() == 0);
+    }
+
+} XC_END_NAMESPACE_1
@@ -0,0 +1,1033 @@
+// BTree is the base class of BTreeSet and BTreeMap, a B+ tree with the same interface as RBTree
+
+#pragma once
+
+#include <new>
+#include <utility>
+#include <type_traits>
+
+#include "../SyntaxSugars/SyntaxSugars.h"
+#include "../Functors/Functors.h"
+#include "../Iterators/Iterators.h"
+#include "../Memories/Allocators.h"
+#include "../Memories/MemoryStatistics.h"
+#include "Pair.h"
+#include "Array.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define XC_BTREE_SSE2
+#include <emmintrin.h>
+#endif
+
+XC_BEGIN_NAMESPACE_3(XC, Containers, Details)
+{
+    // Searches the sorted keys of a node with a branch free binary search.
+    template <typename TKey, typename TCompare>
+    class BinaryKeySearch
+    {
+    public:
+        // first index whose key is not less than key
+        static xsize LowerBound(const TKey * keys, xsize count, const TKey & key, const TCompare & compare)
+        {
+            xsize base = 0;
+            if (count == 0)
+            {
+                return 0;
+            }
+
+            while (count > 1)
+            {
+                xsize half = count / 2;
+                base = compare(keys[base + half], key) ? base + half : base;
+                count -= half;
+            }
+
+            return base + (compare(keys[base], key) ? 1 : 0);
+        }
+
+        // first index whose key is greater than key
+        static xsize UpperBound(const TKey * keys, xsize count, const TKey & key, const TCompare & compare)
+        {
+            xsize base = 0;
+            if (count == 0)
+            {
+                return 0;
+            }
+
+            while (count > 1)
+            {
+                xsize half = count / 2;
+                base = compare(key, keys[base + half]) ? base : base + half;
+                count -= half;
+            }
+
+            return base + (compare(key, keys[base]) ? 0 : 1);
+        }
+    };
+
+    template <typename TKey, typename TCompare>
+    class KeySearch : public BinaryKeySearch<TKey, TCompare>
+    {
+    };
+
+#ifdef XC_BTREE_SSE2
+    // Of the eight keys from keys, how many are below key, and how many above it.
+    inline xsize CountLess(const int * keys, int key)
+    {
+        __m128i pivot = _mm_set1_epi32(key);
+        __m128i below = _mm_add_epi32(
+            _mm_cmplt_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(keys)), pivot),
+            _mm_cmplt_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + 4)), pivot));
+        below = _mm_add_epi32(below, _mm_shuffle_epi32(below, _MM_SHUFFLE(1, 0, 3, 2)));
+        below = _mm_add_epi32(below, _mm_shuffle_epi32(below, _MM_SHUFFLE(2, 3, 0, 1)));
+        return xsize(-_mm_cvtsi128_si32(below));
+    }
+
+    inline xsize CountGreater(const int * keys, int key)
+    {
+        __m128i pivot = _mm_set1_epi32(key);
+        __m128i above = _mm_add_epi32(
+            _mm_cmpgt_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(keys)), pivot),
+            _mm_cmpgt_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + 4)), pivot));
+        above = _mm_add_epi32(above, _mm_shuffle_epi32(above, _MM_SHUFFLE(1, 0, 3, 2)));
+        above = _mm_add_epi32(above, _mm_shuffle_epi32(above, _MM_SHUFFLE(2, 3, 0, 1)));
+        return xsize(-_mm_cvtsi128_si32(above));
+    }
+
+    // Of the four keys from keys, how many are below key, and how many above it.
+    inline xsize CountLess(const double * keys, double key)
+    {
+        __m128d pivot = _mm_set1_pd(key);
+        __m128i below = _mm_add_epi64(
+            _mm_castpd_si128(_mm_cmplt_pd(_mm_loadu_pd(keys), pivot)),
+            _mm_castpd_si128(_mm_cmplt_pd(_mm_loadu_pd(keys + 2), pivot)));
+        below = _mm_add_epi64(below, _mm_unpackhi_epi64(below, below));
+        return xsize(-_mm_cvtsi128_si32(below));
+    }
+
+    inline xsize CountGreater(const double * keys, double key)
+    {
+        __m128d pivot = _mm_set1_pd(key);
+        __m128i above = _mm_add_epi64(
+            _mm_castpd_si128(_mm_cmpgt_pd(_mm_loadu_pd(keys), pivot)),
+            _mm_castpd_si128(_mm_cmpgt_pd(_mm_loadu_pd(keys + 2), pivot)));
+        above = _mm_add_epi64(above, _mm_unpackhi_epi64(above, above));
+        return xsize(-_mm_cvtsi128_si32(above));
+    }
+
+    // Keys that SSE2 compares itself, ordered by Less: the binary search only narrows the keys down to a
+    // window of two registers, whose keys are counted with SIMD compares instead of taking the last few
+    // dependent steps. The window is moved back to fit in the keys, the keys before the narrowed range
+    // are all below key, or not above it, so counting them too still gives the bound. Fewer keys than a
+    // window are searched as any other.
+    template <typename TKey>
+    class CountingKeySearch
+    {
+    public:
+        static xsize LowerBound(const TKey * keys, xsize count, TKey key, const Functors::Less<TKey> & compare)
+        {
+            if (count < Window)
+            {
+                return BinaryKeySearch<TKey, Functors::Less<TKey> >::LowerBound(keys, count, key, compare);
+            }
+
+            xsize base = 0;
+            xsize rest = count;
+            while (rest > Window)
+            {
+                xsize half = rest / 2;
+                base = keys[base + half] < key ? base + half : base;
+                rest -= half;
+            }
+
+            base = base + Window <= count ? base : count - Window;
+            return base + CountLess(keys + base, key);
+        }
+
+        static xsize UpperBound(const TKey * keys, xsize count, TKey key, const Functors::Less<TKey> & compare)
+        {
+            if (count < Window)
+            {
+                return BinaryKeySearch<TKey, Functors::Less<TKey> >::UpperBound(keys, count, key, compare);
+            }
+
+            xsize base = 0;
+            xsize rest = count;
+            while (rest > Window)
+            {
+                xsize half = rest / 2;
+                base = key < keys[base + half] ? base : base + half;
+                rest -= half;
+            }
+
+            base = base + Window <= count ? base : count - Window;
+            return base + Window - CountGreater(keys + base, key);
+        }
+
+    private:
+        static const xsize Window = 32 / sizeof(TKey);
+    };
+
+    template <>
+    class KeySearch<int, Functors::Less<int> > : public CountingKeySearch<int>
+    {
+    };
+
+    template <>
+    class KeySearch<double, Functors::Less<double> > : public CountingKeySearch<double>
+    {
+    };
+#endif
+
+    // Values live only in the leaves, which are linked in order, so iteration and range scans walk arrays.
+    // Inner nodes keep separator keys, child i holds the keys in [key i - 1, key i).
+    // A node is about TNodeBytes large, it is searched with KeySearch: SSE2 for int and double keys with
+    // the default order, a branch free binary search otherwise. Leaves are only searched that way when the
+    // values are the keys, as in a set, elsewhere the keys of a leaf are not side by side.
+    // Inner nodes keep their keys in an array, so TKey must be default constructible.
+    // Inserting or erasing may move values inside their leaf, so iterators are invalidated by any change.
+    template <typename TKey, typename TValue, typename TKeyOfValue, typename TCompare, typename TAllocator = XC::DefaultAllocator<TValue>, xsize TNodeBytes = 256>
+    class BTree
+    {
+        static_assert(std::is_default_constructible<TKey>::value, "the keys of inner nodes are an array of TKey");
+
+    public:
+        using KeyType = TKey;
+        using ValueType = TValue;
+        using Pointer = TValue *;
+        using ConstantPointer = const ValueType *;
+        using Reference = ValueType &;
+        using ConstantReference = const ValueType &;
+        using SizeType = xsize;
+        using DifferenceType = xptrdiff;
+        using Self = BTree<TKey, TValue, TKeyOfValue, TCompare, TAllocator, TNodeBytes>;
+
+    public:
+        class NodeBase
+        {
+        public:
+            bool mIsLeaf;
+            xsize mCount; // values of a leaf, keys of an inner node
+        };
+
+        static const xsize LeafHeaderBytes = sizeof(NodeBase) + 2 * sizeof(void *);
+        static const xsize InnerHeaderBytes = sizeof(NodeBase) + sizeof(void *);
+        static const xsize LeafCapacity = TNodeBytes >= LeafHeaderBytes + 4 * sizeof(TValue) ? (TNodeBytes - LeafHeaderBytes) / sizeof(TValue) : 4;
+        static const xsize InnerCapacity = TNodeBytes >= InnerHeaderBytes + 4 * (sizeof(TKey) + sizeof(void *)) ? (TNodeBytes - InnerHeaderBytes) / (sizeof(TKey) + sizeof(void *)) : 4;
+        static const xsize MinLeafCount = LeafCapacity / 2; // every leaf but the root holds at least this
+        static const xsize MinInnerCount = InnerCapacity / 2;
+        static const xsize MaxHeight = 64;
+
+        class LeafNode : public NodeBase
+        {
+        public:
+            TValue & Get(xsize index) { return *reinterpret_cast<TValue *>(&mSlots[index]); }
+            const TValue & Get(xsize index) const { return *reinterpret_cast<const TValue *>(&mSlots[index]); }
+
+        public:
+            LeafNode * mPrevious;
+            LeafNode * mNext;
+            typename std::aligned_storage<sizeof(TValue), alignof(TValue)>::type mSlots[LeafCapacity];
+        };
+
+        class InnerNode : public NodeBase
+        {
+        public:
+            TKey mKeys[InnerCapacity];
+            NodeBase * mChildren[InnerCapacity + 1];
+        };
+
+        template <typename TReference, typename TPointer>
+        class BaseIterator
+        {
+        public:
+            using IteratorCategory = Iterators::BidirectionalIteratorTag;
+            using ValueType = TValue;
+            using Reference = TReference;
+            using Pointer = TPointer;
+            using DifferenceType = xptrdiff;
+            using Self = BaseIterator<TReference, TPointer>;
+
+        public:
+            BaseIterator() : mLeaf(nullptr), mIndex(0) {}
+            BaseIterator(LeafNode * leaf, xsize index) : mLeaf(leaf), mIndex(index) {}
+            BaseIterator(const Self &) = default;
+            Self & operator = (const Self &) = default;
+
+            // an Iterator converts to a ConstantIterator; as a template this is never the copy constructor
+            template <typename TIterator,
+                      typename = typename std::enable_if<std::is_same<TIterator, BaseIterator<TValue &, TValue *>>::value &&
+                                                         !std::is_same<TIterator, Self>::value>::type>
+            BaseIterator(const TIterator & rhs) : mLeaf(rhs.mLeaf), mIndex(rhs.mIndex) {}
+
+        public:
+            Reference operator * () const { return mLeaf->Get(mIndex); }
+            Pointer operator -> () const { return &(operator * ()); }
+            bool operator == (const Self & rhs) const { return mLeaf == rhs.mLeaf && mIndex == rhs.mIndex; }
+            bool operator != (const Self & rhs) const { return !(*this == rhs); }
+
+            Self & operator ++ ()
+            {
+                ++mIndex;
+                if (mIndex == mLeaf->mCount && mLeaf->mNext != nullptr)
+                {
+                    mLeaf = mLeaf->mNext;
+                    mIndex = 0;
+                }
+
+                return *this;
+            }
+
+            Self & operator -- ()
+            {
+                if (mIndex == 0)
+                {
+                    mLeaf = mLeaf->mPrevious;
+                    mIndex = mLeaf->mCount;
+                }
+
+                --mIndex;
+                return *this;
+            }
+
+            Self operator ++ (int) { Self ans = *this; ++(*this); return ans; }
+            Self operator -- (int) { Self ans = *this; --(*this); return ans; }
+
+        public:
+            LeafNode * mLeaf;
+            xsize mIndex; // the end iterator is the one past the last value of the last leaf
+        };
+
+        using ConstantIterator = BaseIterator<ConstantReference, ConstantPointer>;
+        using Iterator = BaseIterator<Reference, Pointer>;
+
+        // allocators :
+        using LeafNodeAllocator = typename AllocatorRebind<TAllocator, LeafNode>::Type;
+        using InnerNodeAllocator = typename AllocatorRebind<TAllocator, InnerNode>::Type;
+
+    public:
+        BTree(const TCompare & compare = TCompare()) :
+            mRoot(nullptr), mFirst(nullptr), mLast(nullptr), mSize(0), mCountLeaves(0), mCountInners(0), mKeyCompare(compare)
+        {
+        }
+
+        BTree(const Self &) = delete;
+        Self & operator = (const Self &) = delete;
+
+        ~BTree()
+        {
+            Clear();
+        }
+
+    public:
+        ConstantIterator begin() const { return GetBegin(); }
+        Iterator begin() { return GetBegin(); }
+        ConstantIterator end() const { return GetEnd(); }
+        Iterator end() { return GetEnd(); }
+
+    public:
+        ConstantIterator GetBegin() const { return ConstantIterator(mFirst, 0); }
+        Iterator GetBegin() { return Iterator(mFirst, 0); }
+        ConstantIterator GetEnd() const { return ConstantIterator(mLast, mLast == nullptr ? 0 : mLast->mCount); }
+        Iterator GetEnd() { return Iterator(mLast, mLast == nullptr ? 0 : mLast->mCount); }
+        xsize GetSize() const { return mSize; }
+        bool IsEmpty() const { return mSize == 0; }
+
+        void Clear()
+        {
+            if (mRoot != nullptr)
+            {
+                DestroySubtree(mRoot);
+            }
+
+            mRoot = nullptr;
+            mFirst = nullptr;
+            mLast = nullptr;
+            mSize = 0;
+        }
+
+        // bool claims if it is inserted success
+        Pair<Iterator, bool> InsertUnique(const TValue & value)
+        {
+            const TKey & key = TKeyOfValue()(value);
+            if (mRoot == nullptr)
+            {
+                LeafNode * leaf = CreateLeaf();
+                InsertIntoLeaf(leaf, 0, value);
+                mRoot = mFirst = mLast = leaf;
+                mSize = 1;
+                return Pair<Iterator, bool>(Iterator(leaf, 0), true);
+            }
+
+            InnerNode * path[MaxHeight];
+            xsize indices[MaxHeight];
+            xsize depth = 0;
+            LeafNode * leaf = Descend(key, path, indices, depth);
+            xsize position = LeafLowerBound(leaf, key);
+            if (position < leaf->mCount && !mKeyCompare(key, GetKey(leaf, position)))
+            {
+                return Pair<Iterator, bool>(Iterator(leaf, position), false);
+            }
+
+            ++mSize;
+            if (leaf->mCount < LeafCapacity)
+            {
+                InsertIntoLeaf(leaf, position, value);
+                return Pair<Iterator, bool>(Iterator(leaf, position), true);
+            }
+
+            // the leaf is full, the upper half moves to a new leaf on its right
+            LeafNode * right = CreateLeaf();
+            xsize middle = LeafCapacity / 2;
+            MoveValues(leaf, middle, right);
+            right->mPrevious = leaf;
+            right->mNext = leaf->mNext;
+            (leaf->mNext == nullptr ? mLast : leaf->mNext->mPrevious) = right;
+            leaf->mNext = right;
+
+            Iterator ans;
+            if (position <= middle)
+            {
+                InsertIntoLeaf(leaf, position, value);
+                ans = Iterator(leaf, position);
+            }
+            else
+            {
+                InsertIntoLeaf(right, position - middle, value);
+                ans = Iterator(right, position - middle);
+            }
+
+            InsertIntoParent(path, indices, depth, GetKey(right, 0), right);
+            return Pair<Iterator, bool>(ans, true);
+        }
+
+        SizeType Erase(const TKey & key)
+        {
+            if (mRoot == nullptr)
+            {
+                return 0;
+            }
+
+            InnerNode * path[MaxHeight];
+            xsize indices[MaxHeight];
+            xsize depth = 0;
+            LeafNode * leaf = Descend(key, path, indices, depth);
+            xsize position = LeafLowerBound(leaf, key);
+            if (position == leaf->mCount || mKeyCompare(key, GetKey(leaf, position)))
+            {
+                return 0;
+            }
+
+            EraseFromLeaf(leaf, position);
+            --mSize;
+            RebalanceLeaf(leaf, path, indices, depth);
+            return 1;
+        }
+
+        void Erase(Iterator position)
+        {
+            TKey key = TKeyOfValue()(*position); // the value moves while it is erased
+            Erase(key);
+        }
+
+        ConstantIterator Find(const TKey & key) const
+        {
+            ConstantIterator ans = GetLowerBound(key);
+            return ans == GetEnd() || mKeyCompare(key, TKeyOfValue()(*ans)) ? GetEnd() : ans;
+        }
+
+        Iterator Find(const TKey & key)
+        {
+            Iterator ans = GetLowerBound(key);
+            return ans == GetEnd() || mKeyCompare(key, TKeyOfValue()(*ans)) ? GetEnd() : ans;
+        }
+
+        ConstantIterator GetLowerBound(const TKey & key) const { return ConstantIterator(const_cast<Self *>(this)->GetLowerBound(key)); }
+        ConstantIterator GetUpperBound(const TKey & key) const { return ConstantIterator(const_cast<Self *>(this)->GetUpperBound(key)); }
+
+        Iterator GetLowerBound(const TKey & key)
+        {
+            if (mRoot == nullptr)
+            {
+                return GetEnd();
+            }
+
+            LeafNode * leaf = FindLeaf(key);
+            return Normalize(leaf, LeafLowerBound(leaf, key));
+        }
+
+        Iterator GetUpperBound(const TKey & key)
+        {
+            if (mRoot == nullptr)
+            {
+                return GetEnd();
+            }
+
+            LeafNode * leaf = FindLeaf(key);
+            return Normalize(leaf, LeafUpperBound(leaf, key));
+        }
+
+        bool Contains(const TKey & key) const
+        {
+            return Find(key) != GetEnd();
+        }
+
+        xsize GetCount(const TKey & key) const
+        {
+            return Contains(key) ? 1 : 0;
+        }
+
+        // Replaces the content. A strictly increasing range is packed into leaves directly,
+        // about twice as dense as inserting one by one, any other range falls back to InsertUnique.
+        template <typename TIterator>
+        void Assign(TIterator first, TIterator last)
+        {
+            Clear();
+            Array<TValue> values;
+            bool isSorted = true;
+            for (; first != last; ++first)
+            {
+                if (!values.IsEmpty() && !mKeyCompare(TKeyOfValue()(values.GetBack()), TKeyOfValue()(*first)))
+                {
+                    isSorted = false;
+                }
+
+                values.PushBack(*first);
+            }
+
+            if (isSorted)
+            {
+                BuildFromSorted(values);
+                return;
+            }
+
+            for (const TValue & value : values)
+            {
+                InsertUnique(value);
+            }
+        }
+
+        Memories::MemoryStatistics GetMemoryStatistics() const
+        {
+            Memories::MemoryStatistics ans;
+            ans.mCountElements = mSize;
+            ans.mCapacity = mCountLeaves * LeafCapacity;
+            ans.mCountNodes = mCountLeaves + mCountInners;
+            ans.mElementSize = sizeof(ValueType);
+            ans.mOverheadBytes = (sizeof(LeafNode) - LeafCapacity * sizeof(ValueType)) * mCountLeaves + sizeof(InnerNode) * mCountInners;
+            return ans;
+        }
+
+    protected:
+        const TKey & GetKey(const LeafNode * leaf, xsize index) const
+        {
+            return TKeyOfValue()(leaf->Get(index));
+        }
+
+        xsize LeafLowerBound(const LeafNode * leaf, const TKey & key) const { return LeafLowerBound(leaf, key, std::is_same<TKey, TValue>()); }
+        xsize LeafUpperBound(const LeafNode * leaf, const TKey & key) const { return LeafUpperBound(leaf, key, std::is_same<TKey, TValue>()); }
+
+        // the values are the keys
+        xsize LeafLowerBound(const LeafNode * leaf, const TKey & key, std::true_type) const
+        {
+            return KeySearch<TKey, TCompare>::LowerBound(&leaf->Get(0), leaf->mCount, key, mKeyCompare);
+        }
+
+        xsize LeafUpperBound(const LeafNode * leaf, const TKey & key, std::true_type) const
+        {
+            return KeySearch<TKey, TCompare>::UpperBound(&leaf->Get(0), leaf->mCount, key, mKeyCompare);
+        }
+
+        // first index whose key is not less than key
+        xsize LeafLowerBound(const LeafNode * leaf, const TKey & key, std::false_type) const
+        {
+            xsize base = 0;
+            xsize n = leaf->mCount;
+            if (n == 0)
+            {
+                return 0;
+            }
+
+            while (n > 1)
+            {
+                xsize half = n / 2;
+                base = mKeyCompare(GetKey(leaf, base + half), key) ? base + half : base;
+                n -= half;
+            }
+
+            return base + (mKeyCompare(GetKey(leaf, base), key) ? 1 : 0);
+        }
+
+        // first index whose key is greater than key
+        xsize LeafUpperBound(const LeafNode * leaf, const TKey & key, std::false_type) const
+        {
+            xsize base = 0;
+            xsize n = leaf->mCount;
+            if (n == 0)
+            {
+                return 0;
+            }
+
+            while (n > 1)
+            {
+                xsize half = n / 2;
+                base = mKeyCompare(key, GetKey(leaf, base + half)) ? base : base + half;
+                n -= half;
+            }
+
+            return base + (mKeyCompare(key, GetKey(leaf, base)) ? 0 : 1);
+        }
+
+        // the child that may hold key
+        xsize ChildIndex(const InnerNode * node, const TKey & key) const
+        {
+            return KeySearch<TKey, TCompare>::UpperBound(node->mKeys, node->mCount, key, mKeyCompare);
+        }
+
+        LeafNode * FindLeaf(const TKey & key) const
+        {
+            NodeBase * node = mRoot;
+            while (!node->mIsLeaf)
+            {
+                InnerNode * inner = static_cast<InnerNode *>(node);
+                node = inner->mChildren[ChildIndex(inner, key)];
+            }
+
+            return static_cast<LeafNode *>(node);
+        }
+
+        // like FindLeaf, also records the inner nodes passed and the child taken in each
+        LeafNode * Descend(const TKey & key, InnerNode ** path, xsize * indices, xsize & depth) const
+        {
+            NodeBase * node = mRoot;
+            while (!node->mIsLeaf)
+            {
+                InnerNode * inner = static_cast<InnerNode *>(node);
+                xsize index = ChildIndex(inner, key);
+                path[depth] = inner;
+                indices[depth] = index;
+                ++depth;
+                node = inner->mChildren[index];
+            }
+
+            return static_cast<LeafNode *>(node);
+        }
+
+        Iterator Normalize(LeafNode * leaf, xsize index)
+        {
+            if (index == leaf->mCount && leaf->mNext != nullptr)
+            {
+                return Iterator(leaf->mNext, 0);
+            }
+
+            return Iterator(leaf, index);
+        }
+
+        template <typename TArgument>
+        void InsertIntoLeaf(LeafNode * leaf, xsize position, TArgument && value)
+        {
+            xsize count = leaf->mCount;
+            if (position == count)
+            {
+                new (&leaf->Get(count)) TValue(std::forward<TArgument>(value));
+            }
+            else
+            {
+                new (&leaf->Get(count)) TValue(std::move(leaf->Get(count - 1)));
+                for (xsize i = count - 1; i > position; --i)
+                {
+                    leaf->Get(i) = std::move(leaf->Get(i - 1));
+                }
+
+                leaf->Get(position) = std::forward<TArgument>(value);
+            }
+
+            ++leaf->mCount;
+        }
+
+        void EraseFromLeaf(LeafNode * leaf, xsize position)
+        {
+            for (xsize i = position; i + 1 < leaf->mCount; ++i)
+            {
+                leaf->Get(i) = std::move(leaf->Get(i + 1));
+            }
+
+            --leaf->mCount;
+            leaf->Get(leaf->mCount).~TValue();
+        }
+
+        // moves the values of source from first on to the end of target
+        void MoveValues(LeafNode * source, xsize first, LeafNode * target)
+        {
+            for (xsize i = first; i < source->mCount; ++i)
+            {
+                new (&target->Get(target->mCount++)) TValue(std::move(source->Get(i)));
+                source->Get(i).~TValue();
+            }
+
+            source->mCount = first;
+        }
+
+        void InsertIntoInner(InnerNode * node, xsize index, const TKey & key, NodeBase * child)
+        {
+            for (xsize i = node->mCount; i > index; --i)
+            {
+                node->mKeys[i] = node->mKeys[i - 1];
+                node->mChildren[i + 1] = node->mChildren[i];
+            }
+
+            node->mKeys[index] = key;
+            node->mChildren[index + 1] = child;
+            ++node->mCount;
+        }
+
+        // removes key index and the child on its right
+        void EraseFromInner(InnerNode * node, xsize index)
+        {
+            for (xsize i = index; i + 1 < node->mCount; ++i)
+            {
+                node->mKeys[i] = node->mKeys[i + 1];
+                node->mChildren[i + 1] = node->mChildren[i + 2];
+            }
+
+            --node->mCount;
+        }
+
+        // adds child after the one taken at each level of path, splitting full nodes on the way up
+        void InsertIntoParent(InnerNode ** path, xsize * indices, xsize depth, TKey key, NodeBase * child)
+        {
+            while (depth != 0)
+            {
+                --depth;
+                InnerNode * node = path[depth];
+                xsize index = indices[depth];
+                if (node->mCount < InnerCapacity)
+                {
+                    InsertIntoInner(node, index, key, child);
+                    return;
+                }
+
+                TKey keys[InnerCapacity + 1];
+                NodeBase * children[InnerCapacity + 2];
+                for (xsize i = 0, j = 0; i <= InnerCapacity; ++i)
+                {
+                    keys[i] = i == index ? key : node->mKeys[j++];
+                }
+
+                for (xsize i = 0, j = 0; i <= InnerCapacity + 1; ++i)
+                {
+                    children[i] = i == index + 1 ? child : node->mChildren[j++];
+                }
+
+                xsize middle = (InnerCapacity + 1) / 2;
+                InnerNode * right = CreateInner();
+                node->mCount = middle;
+                right->mCount = InnerCapacity - middle;
+                for (xsize i = 0; i < middle; ++i)
+                {
+                    node->mKeys[i] = keys[i];
+                    node->mChildren[i] = children[i];
+                }
+
+                node->mChildren[middle] = children[middle];
+                for (xsize i = 0; i < right->mCount; ++i)
+                {
+                    right->mKeys[i] = keys[middle + 1 + i];
+                    right->mChildren[i] = children[middle + 1 + i];
+                }
+
+                right->mChildren[right->mCount] = children[InnerCapacity + 1];
+                key = keys[middle]; // moves up instead of staying in either half
+                child = right;
+            }
+
+            InnerNode * root = CreateInner();
+            root->mCount = 1;
+            root->mKeys[0] = key;
+            root->mChildren[0] = mRoot;
+            root->mChildren[1] = child;
+            mRoot = root;
+        }
+
+        void RebalanceLeaf(LeafNode * leaf, InnerNode ** path, xsize * indices, xsize depth)
+        {
+            if (depth == 0)
+            {
+                if (leaf->mCount == 0)
+                {
+                    DestroyLeaf(leaf);
+                    mRoot = mFirst = mLast = nullptr;
+                }
+
+                return;
+            }
+
+            if (leaf->mCount >= MinLeafCount)
+            {
+                return;
+            }
+
+            InnerNode * parent = path[depth - 1];
+            xsize index = indices[depth - 1];
+            LeafNode * left = index > 0 ? static_cast<LeafNode *>(parent->mChildren[index - 1]) : nullptr;
+            LeafNode * right = index < parent->mCount ? static_cast<LeafNode *>(parent->mChildren[index + 1]) : nullptr;
+            if (left != nullptr && left->mCount > MinLeafCount)
+            {
+                InsertIntoLeaf(leaf, 0, std::move(left->Get(left->mCount - 1)));
+                EraseFromLeaf(left, left->mCount - 1);
+                parent->mKeys[index - 1] = GetKey(leaf, 0);
+                return;
+            }
+
+            if (right != nullptr && right->mCount > MinLeafCount)
+            {
+                InsertIntoLeaf(leaf, leaf->mCount, std::move(right->Get(0)));
+                EraseFromLeaf(right, 0);
+                parent->mKeys[index] = GetKey(right, 0);
+                return;
+            }
+
+            if (left != nullptr)
+            {
+                MergeLeaves(left, leaf, parent, index - 1);
+            }
+            else
+            {
+                MergeLeaves(leaf, right, parent, index);
+            }
+
+            RebalanceInner(path, indices, depth - 1);
+        }
+
+        void MergeLeaves(LeafNode * left, LeafNode * right, InnerNode * parent, xsize keyIndex)
+        {
+            MoveValues(right, 0, left);
+            left->mNext = right->mNext;
+            (right->mNext == nullptr ? mLast : right->mNext->mPrevious) = left;
+            DestroyLeaf(right);
+            EraseFromInner(parent, keyIndex);
+        }
+
+        void RebalanceInner(InnerNode ** path, xsize * indices, xsize depth)
+        {
+            while (true)
+            {
+                InnerNode * node = path[depth];
+                if (depth == 0)
+                {
+                    if (node->mCount == 0)
+                    {
+                        mRoot = node->mChildren[0];
+                        DestroyInner(node);
+                    }
+
+                    return;
+                }
+
+                if (node->mCount >= MinInnerCount)
+                {
+                    return;
+                }
+
+                InnerNode * parent = path[depth - 1];
+                xsize index = indices[depth - 1];
+                InnerNode * left = index > 0 ? static_cast<InnerNode *>(parent->mChildren[index - 1]) : nullptr;
+                InnerNode * right = index < parent->mCount ? static_cast<InnerNode *>(parent->mChildren[index + 1]) : nullptr;
+                if (left != nullptr && left->mCount > MinInnerCount)
+                {
+                    node->mChildren[node->mCount + 1] = node->mChildren[node->mCount];
+                    for (xsize i = node->mCount; i > 0; --i)
+                    {
+                        node->mKeys[i] = node->mKeys[i - 1];
+                        node->mChildren[i] = node->mChildren[i - 1];
+                    }
+
+                    node->mKeys[0] = parent->mKeys[index - 1];
+                    node->mChildren[0] = left->mChildren[left->mCount];
+                    ++node->mCount;
+                    parent->mKeys[index - 1] = left->mKeys[left->mCount - 1];
+                    --left->mCount;
+                    return;
+                }
+
+                if (right != nullptr && right->mCount > MinInnerCount)
+                {
+                    node->mKeys[node->mCount] = parent->mKeys[index];
+                    node->mChildren[node->mCount + 1] = right->mChildren[0];
+                    ++node->mCount;
+                    parent->mKeys[index] = right->mKeys[0];
+                    for (xsize i = 0; i + 1 < right->mCount; ++i)
+                    {
+                        right->mKeys[i] = right->mKeys[i + 1];
+                        right->mChildren[i] = right->mChildren[i + 1];
+                    }
+
+                    right->mChildren[right->mCount - 1] = right->mChildren[right->mCount];
+                    --right->mCount;
+                    return;
+                }
+
+                if (left != nullptr)
+                {
+                    MergeInners(left, node, parent, index - 1);
+                }
+                else
+                {
+                    MergeInners(node, right, parent, index);
+                }
+
+                --depth;
+            }
+        }
+
+        void MergeInners(InnerNode * left, InnerNode * right, InnerNode * parent, xsize keyIndex)
+        {
+            left->mKeys[left->mCount] = parent->mKeys[keyIndex];
+            for (xsize i = 0; i < right->mCount; ++i)
+            {
+                left->mKeys[left->mCount + 1 + i] = right->mKeys[i];
+            }
+
+            for (xsize i = 0; i <= right->mCount; ++i)
+            {
+                left->mChildren[left->mCount + 1 + i] = right->mChildren[i];
+            }
+
+            left->mCount += 1 + right->mCount;
+            DestroyInner(right);
+            EraseFromInner(parent, keyIndex);
+        }
+
+        // packs the values into evenly filled leaves, then builds each inner level the same way
+        void BuildFromSorted(const Array<TValue> & values)
+        {
+            xsize n = values.GetSize();
+            if (n == 0)
+            {
+                return;
+            }
+
+            Array<NodeBase *> level;
+            Array<TKey> minimums;
+            xsize countLeaves = (n + LeafCapacity - 1) / LeafCapacity;
+            xsize next = 0;
+            LeafNode * previous = nullptr;
+            for (xsize i = 0; i < countLeaves; ++i)
+            {
+                xsize count = n / countLeaves + (i < n % countLeaves ? 1 : 0);
+                LeafNode * leaf = CreateLeaf();
+                for (xsize j = 0; j < count; ++j)
+                {
+                    new (&leaf->Get(j)) TValue(values[next++]);
+                }
+
+                leaf->mCount = count;
+                leaf->mPrevious = previous;
+                (previous == nullptr ? mFirst : previous->mNext) = leaf;
+                previous = leaf;
+                level.PushBack(leaf);
+                minimums.PushBack(GetKey(leaf, 0));
+            }
+
+            mLast = previous;
+            while (level.GetSize() > 1)
+            {
+                Array<NodeBase *> upperLevel;
+                Array<TKey> upperMinimums;
+                xsize countChildren = level.GetSize();
+                xsize countNodes = (countChildren + InnerCapacity) / (InnerCapacity + 1);
+                next = 0;
+                for (xsize i = 0; i < countNodes; ++i)
+                {
+                    xsize count = countChildren / countNodes + (i < countChildren % countNodes ? 1 : 0);
+                    InnerNode * node = CreateInner();
+                    node->mCount = count - 1;
+                    for (xsize j = 0; j < count; ++j)
+                    {
+                        node->mChildren[j] = level[next + j];
+                        if (j != 0)
+                        {
+                            node->mKeys[j - 1] = minimums[next + j];
+                        }
+                    }
+
+                    upperLevel.PushBack(node);
+                    upperMinimums.PushBack(minimums[next]);
+                    next += count;
+                }
+
+                level = upperLevel;
+                minimums = upperMinimums;
+            }
+
+            mRoot = level[0];
+            mSize = n;
+        }
+
+        LeafNode * CreateLeaf()
+        {
+            LeafNode * ans = LeafNodeAllocator::Allocate();
+            ans->mIsLeaf = true;
+            ans->mCount = 0;
+            ans->mPrevious = nullptr;
+            ans->mNext = nullptr;
+            ++mCountLeaves;
+            return ans;
+        }
+
+        InnerNode * CreateInner()
+        {
+            InnerNode * ans = new (InnerNodeAllocator::Allocate()) InnerNode();
+            ans->mIsLeaf = false;
+            ans->mCount = 0;
+            ++mCountInners;
+            return ans;
+        }
+
+        void DestroyLeaf(LeafNode * leaf)
+        {
+            for (xsize i = 0; i < leaf->mCount; ++i)
+            {
+                leaf->Get(i).~TValue();
+            }
+
+            LeafNodeAllocator::Deallocate(leaf);
+            --mCountLeaves;
+        }
+
+        void DestroyInner(InnerNode * node)
+        {
+            node->~InnerNode();
+            InnerNodeAllocator::Deallocate(node);
+            --mCountInners;
+        }
+
+        // recursion only goes as deep as the tree is high
+        void DestroySubtree(NodeBase * node)
+        {
+            if (node->mIsLeaf)
+            {
+                DestroyLeaf(static_cast<LeafNode *>(node));
+                return;
+            }
+
+            InnerNode * inner = static_cast<InnerNode *>(node);
+            for (xsize i = 0; i <= inner->mCount; ++i)
+            {
+                DestroySubtree(inner->mChildren[i]);
+            }
+
+            DestroyInner(inner);
+        }
+
+    protected:
+        NodeBase * mRoot;
+        LeafNode * mFirst;
+        LeafNode * mLast;
+        xsize mSize;
+        xsize mCountLeaves;
+        xsize mCountInners;
+        TCompare mKeyCompare;
+    };
+
+} XC_END_NAMESPACE_3
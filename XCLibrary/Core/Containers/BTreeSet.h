@@ -0,0 +1,387 @@
+#pragma once
+
+#include "BTree.h"
+#include "../Functors/Functors.h"
+
+XC_BEGIN_NAMESPACE_2(XC, Containers)
+{
+	// Same interface as Set, backed by a B+ tree instead of RBTree.
+	// Prefer it for large sets that are mostly searched and scanned in order.
+	template <typename TKey, typename TCompare = Functors::Less<TKey>, class TAllocator = DefaultAllocator<TKey>, xsize TNodeBytes = 256>
+	class BTreeSet
+	{
+	public:
+		using KeyType = TKey;
+		using ValueType = TKey;
+		using KeyCompare = TCompare;
+		using ValueCompare = TCompare;
+		using TreeType = Details::BTree<KeyType, ValueType, Functors::Identity<ValueType>, KeyCompare, TAllocator, TNodeBytes>;
+		using ConstantPointer = typename TreeType::ConstantPointer;
+		using Pointer = typename TreeType::ConstantPointer;
+		using ConstantReference = typename TreeType::ConstantReference;
+		using Reference = typename TreeType::Reference;
+		using SizeType = typename TreeType::SizeType;
+		using DifferenceType = typename TreeType::DifferenceType;
+		using Iterator = typename TreeType::Iterator;
+		using ConstantIterator = typename TreeType::ConstantIterator;
+
+	public:
+		BTreeSet() : mTree(TCompare())
+		{
+
+		}
+
+	public:
+		ConstantIterator begin() const { return GetBegin(); }
+		Iterator begin() { return GetBegin(); }
+		ConstantIterator end() const { return GetEnd(); }
+		Iterator end() { return GetEnd(); }
+
+	public:
+		ConstantIterator GetBegin() const
+		{
+			return mTree.GetBegin();
+		}
+
+		Iterator GetBegin()
+		{
+			return mTree.GetBegin();
+		}
+
+		ConstantIterator GetEnd() const
+		{
+			return mTree.GetEnd();
+		}
+
+		Iterator GetEnd()
+		{
+			return mTree.GetEnd();
+		}
+
+		SizeType GetSize() const
+		{
+			return mTree.GetSize();
+		}
+
+		bool IsEmpty() const
+		{
+			return mTree.IsEmpty();
+		}
+
+		void Clear()
+		{
+			mTree.Clear();
+		}
+
+		Iterator Insert(const TKey& value)
+		{
+			Pair<Iterator, bool> ans = mTree.InsertUnique(value);
+			return ans.mFirst;
+		}
+
+		bool Contains(const TKey& key) const
+		{
+			return mTree.Contains(key);
+		}
+
+		Iterator Find(const TKey& key)
+		{
+			return mTree.Find(key);
+		}
+
+		SizeType Erase(const TKey& key)
+		{
+			return mTree.Erase(key);
+		}
+
+		Iterator GetLowerBound(const TKey& key)
+		{
+			return mTree.GetLowerBound(key);
+		}
+
+		Iterator GetUpperBound(const TKey& key)
+		{
+			return mTree.GetUpperBound(key);
+		}
+
+		// a sorted range is bulk loaded
+		template <typename TIterator>
+		void Assign(TIterator first, TIterator last)
+		{
+			mTree.Assign(first, last);
+		}
+
+		Memories::MemoryStatistics GetMemoryStatistics() const
+		{
+			return mTree.GetMemoryStatistics();
+		}
+
+	public:
+		TreeType mTree;
+	};
+
+	XC_BEGIN_NAMESPACE_1(Details)
+	{
+		template <typename TKey, typename TMapped>
+		class SelectKey
+		{
+		public:
+			const TKey& operator () (const Pair<TKey, TMapped>& pair) const
+			{
+				return pair.mFirst;
+			}
+		};
+
+	} XC_END_NAMESPACE_1
+
+	// Elements are Pair<key, mapped>, the key of an element must not be changed through an iterator.
+	template <typename TKey, typename TMapped, typename TCompare = Functors::Less<TKey>, class TAllocator = DefaultAllocator<TKey>, xsize TNodeBytes = 256>
+	class BTreeMap
+	{
+	public:
+		using KeyType = TKey;
+		using MappedType = TMapped;
+		using ValueType = Pair<TKey, TMapped>;
+		using KeyCompare = TCompare;
+		using TreeType = Details::BTree<KeyType, ValueType, Details::SelectKey<TKey, TMapped>, KeyCompare, TAllocator, TNodeBytes>;
+		using ConstantPointer = typename TreeType::ConstantPointer;
+		using Pointer = typename TreeType::Pointer;
+		using ConstantReference = typename TreeType::ConstantReference;
+		using Reference = typename TreeType::Reference;
+		using SizeType = typename TreeType::SizeType;
+		using DifferenceType = typename TreeType::DifferenceType;
+		using Iterator = typename TreeType::Iterator;
+		using ConstantIterator = typename TreeType::ConstantIterator;
+
+	public:
+		BTreeMap() : mTree(TCompare())
+		{
+
+		}
+
+	public:
+		ConstantIterator begin() const { return GetBegin(); }
+		Iterator begin() { return GetBegin(); }
+		ConstantIterator end() const { return GetEnd(); }
+		Iterator end() { return GetEnd(); }
+
+	public:
+		ConstantIterator GetBegin() const
+		{
+			return mTree.GetBegin();
+		}
+
+		Iterator GetBegin()
+		{
+			return mTree.GetBegin();
+		}
+
+		ConstantIterator GetEnd() const
+		{
+			return mTree.GetEnd();
+		}
+
+		Iterator GetEnd()
+		{
+			return mTree.GetEnd();
+		}
+
+		SizeType GetSize() const
+		{
+			return mTree.GetSize();
+		}
+
+		bool IsEmpty() const
+		{
+			return mTree.IsEmpty();
+		}
+
+		void Clear()
+		{
+			mTree.Clear();
+		}
+
+		Iterator Insert(const ValueType& value)
+		{
+			Pair<Iterator, bool> ans = mTree.InsertUnique(value);
+			return ans.mFirst;
+		}
+
+		Iterator Insert(const TKey& key, const TMapped& mapped)
+		{
+			return Insert(ValueType(key, mapped));
+		}
+
+		// inserts a default mapped value when key is missing
+		TMapped& operator [] (const TKey& key)
+		{
+			Iterator ans = mTree.Find(key);
+			if (ans == mTree.GetEnd())
+			{
+				ans = Insert(key, TMapped());
+			}
+
+			return ans->mSecond;
+		}
+
+		bool Contains(const TKey& key) const
+		{
+			return mTree.Contains(key);
+		}
+
+		ConstantIterator Find(const TKey& key) const
+		{
+			return mTree.Find(key);
+		}
+
+		Iterator Find(const TKey& key)
+		{
+			return mTree.Find(key);
+		}
+
+		SizeType Erase(const TKey& key)
+		{
+			return mTree.Erase(key);
+		}
+
+		Iterator GetLowerBound(const TKey& key)
+		{
+			return mTree.GetLowerBound(key);
+		}
+
+		Iterator GetUpperBound(const TKey& key)
+		{
+			return mTree.GetUpperBound(key);
+		}
+
+		// a range sorted by key is bulk loaded
+		template <typename TIterator>
+		void Assign(TIterator first, TIterator last)
+		{
+			mTree.Assign(first, last);
+		}
+
+		Memories::MemoryStatistics GetMemoryStatistics() const
+		{
+			return mTree.GetMemoryStatistics();
+		}
+
+	public:
+		TreeType mTree;
+	};
+
+} XC_END_NAMESPACE_2;
+
+#include <cstdlib>
+#include "Set.h"
+
+XC_BEGIN_NAMESPACE_1(XC_BTREE_TEST)
+{
+	XC_TEST_CASE(BTREE_SET_TEST)
+	{
+		using namespace XC::Containers;
+
+		// small nodes, so a few thousand keys already split and merge several levels
+		BTreeSet<int, XC::Functors::Less<int>, XC::DefaultAllocator<int>, 64> btree;
+		Set<int> rbtree;
+		srand(7);
+		for (int i = 0; i < 20000; ++i)
+		{
+			int key = rand() % 3000;
+			if (rand() % 3 == 0)
+			{
+				XC_TEST_ASSERT(btree.Erase(key) == (rbtree.Contains(key) ? 1u : 0u));
+				rbtree.Erase(key);
+			}
+			else
+			{
+				btree.Insert(key);
+				rbtree.Insert(key);
+			}
+		}
+
+		XC_TEST_ASSERT(btree.GetSize() == rbtree.GetSize());
+		auto itr = rbtree.GetBegin();
+		for (int key : btree)
+		{
+			XC_TEST_ASSERT(key == *itr);
+			++itr;
+		}
+		XC_TEST_ASSERT(itr == rbtree.GetEnd());
+
+		for (int key = -1; key <= 3000; ++key)
+		{
+			XC_TEST_ASSERT(btree.Contains(key) == rbtree.Contains(key));
+			auto lower = btree.GetLowerBound(key);
+			XC_TEST_ASSERT(lower == btree.GetEnd() ? *--btree.GetEnd() < key : *lower >= key);
+		}
+
+		for (int key = 0; key < 3000; ++key)
+		{
+			btree.Erase(key);
+		}
+		XC_TEST_ASSERT(btree.IsEmpty() && btree.GetBegin() == btree.GetEnd());
+
+		XC::Array<int> sorted;
+		for (int i = 0; i < 10000; ++i)
+		{
+			sorted.PushBack(i * 2);
+		}
+		btree.Assign(sorted.GetBegin(), sorted.GetEnd());
+		XC_TEST_ASSERT(btree.GetSize() == 10000 && btree.Contains(19998) && !btree.Contains(19997));
+		XC_TEST_ASSERT(*btree.GetUpperBound(100) == 102);
+		for (int i = 0; i < 10000; i += 2)
+		{
+			btree.Erase(i * 2);
+		}
+		XC_TEST_ASSERT(btree.GetSize() == 5000 && *btree.GetBegin() == 2);
+
+		BTreeMap<int, int> map;
+		for (int i = 0; i < 1000; ++i)
+		{
+			map[i % 100] += 1;
+		}
+		XC_TEST_ASSERT(map.GetSize() == 100 && map[42] == 10 && map.Find(100) == map.GetEnd());
+	}
+
+	// the same order as Less, but the binary search, as KeySearch only counts with SIMD for Less
+	template <typename T>
+	class BinarySearchLess
+	{
+	public:
+		bool operator () (const T& x, const T& y) const { return x < y; }
+	};
+
+	template <typename T>
+	bool KeySearchAgrees(const T * keys, XC::xsize count, T key)
+	{
+		using namespace XC::Containers::Details;
+		using Counted = KeySearch<T, XC::Functors::Less<T>>;
+		using Searched = KeySearch<T, BinarySearchLess<T>>;
+		return Counted::LowerBound(keys, count, key, XC::Functors::Less<T>()) == Searched::LowerBound(keys, count, key, BinarySearchLess<T>()) &&
+			Counted::UpperBound(keys, count, key, XC::Functors::Less<T>()) == Searched::UpperBound(keys, count, key, BinarySearchLess<T>());
+	}
+
+	XC_TEST_CASE(BTREE_KEY_SEARCH_TEST)
+	{
+		// every length around the widths of the vectors, with runs of equal keys
+		int ints[40];
+		double doubles[40];
+		for (int i = 0; i < 40; ++i)
+		{
+			ints[i] = i / 3 * 2 - 20;
+			doubles[i] = ints[i] * 0.5;
+		}
+
+		for (XC::xsize count = 0; count <= 40; ++count)
+		{
+			for (int key = -23; key <= 23; ++key)
+			{
+				XC_TEST_ASSERT(KeySearchAgrees(ints, count, key));
+				XC_TEST_ASSERT(KeySearchAgrees(doubles, count, key * 0.5));
+				XC_TEST_ASSERT(KeySearchAgrees(doubles, count, key * 0.5 + 0.25));
+			}
+		}
+	}
+
+} XC_END_NAMESPACE_1
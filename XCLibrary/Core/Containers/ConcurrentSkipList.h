@@ -0,0 +1,479 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+#include "../Types/Types.h"
+#include "../Functors/Functors.h"
+#include "../Memories/EpochReclamation.h"
+#include "Pair.h"
+#include "Array.h"
+
+XC_BEGIN_NAMESPACE_3(XC, Containers, Details)
+{
+    // A lock free skip list (Herlihy and Shavit), shared by ConcurrentSet and ConcurrentMap.
+    // A node is removed by marking its next pointers, the lowest level last, whoever marks the lowest
+    // level owns the removal. Marked nodes are unlinked by any thread that walks past them.
+    // A node is retired when both its inserter and its remover are done with it, since the inserter
+    // may still be linking upper levels after the node has been removed.
+    template <typename TKey, typename TValue, typename TKeyOfValue, typename TCompare>
+    class ConcurrentSkipList
+    {
+    public:
+        using KeyType = TKey;
+        using ValueType = TValue;
+        using SizeType = xsize;
+        using Self = ConcurrentSkipList<TKey, TValue, TKeyOfValue, TCompare>;
+
+        static const xsize MaxHeight = 24; // with one level in four, enough for about 4^24 elements
+
+    private:
+        using Word = std::uintptr_t; // a next pointer, the lowest bit marks the owner as removed
+
+        class Node : public Memories::Reclaimable
+        {
+        public:
+            TValue & GetValue() { return *reinterpret_cast<TValue *>(&mValue); }
+
+        public:
+            typename std::aligned_storage<sizeof(TValue), alignof(TValue)>::type mValue; // empty in the head
+            std::atomic<int> mReferences; // the inserter and the list, see ReleaseNode
+            xsize mHeight;
+            std::atomic<Word> mNext[1]; // mHeight of them are allocated
+        };
+
+    public:
+        ConcurrentSkipList(const TCompare & compare = TCompare()) :
+            mSize(0), mKeyCompare(compare)
+        {
+            mHead = AllocateNode(MaxHeight);
+        }
+
+        ConcurrentSkipList(const Self &) = delete;
+        Self & operator = (const Self &) = delete;
+
+        // no other thread may use the list any more
+        ~ConcurrentSkipList()
+        {
+            Node * node = GetPointer(mHead->mNext[0].load());
+            while (node != nullptr)
+            {
+                Node * next = GetPointer(node->mNext[0].load());
+                DestroyNode(node);
+                node = next;
+            }
+
+            FreeNode(mHead);
+        }
+
+    public:
+        // counted when an insert or erase takes effect, exact once the writers are done
+        xsize GetSize() const { return mSize.load(std::memory_order_relaxed); }
+        bool IsEmpty() const { return GetSize() == 0; }
+
+        // false if the key is already there
+        bool InsertUnique(const TValue & value)
+        {
+            Memories::EpochGuard guard(mDomain);
+            const TKey & key = TKeyOfValue()(value);
+            Node * preds[MaxHeight];
+            Node * succs[MaxHeight];
+            Node * node = nullptr;
+            while (true)
+            {
+                if (Find(key, preds, succs))
+                {
+                    if (node != nullptr)
+                    {
+                        DestroyNode(node); // never published
+                    }
+
+                    return false;
+                }
+
+                if (node == nullptr)
+                {
+                    node = CreateNode(value, GetRandomHeight());
+                }
+
+                for (xsize level = 0; level < node->mHeight; ++level)
+                {
+                    node->mNext[level].store(MakeWord(succs[level]), std::memory_order_relaxed);
+                }
+
+                Word expected = MakeWord(succs[0]);
+                if (preds[0]->mNext[0].compare_exchange_strong(expected, MakeWord(node)))
+                {
+                    break;
+                }
+            }
+
+            mSize.fetch_add(1, std::memory_order_relaxed);
+            for (xsize level = 1; level < node->mHeight; ++level)
+            {
+                if (!LinkLevel(node, level, key, preds, succs))
+                {
+                    break;
+                }
+            }
+
+            if (IsMarked(node->mNext[0].load()))
+            {
+                Find(key, preds, succs); // removed meanwhile, unlinks what was linked after the remover looked
+            }
+
+            ReleaseNode(node);
+            return true;
+        }
+
+        bool Erase(const TKey & key)
+        {
+            Memories::EpochGuard guard(mDomain);
+            Node * preds[MaxHeight];
+            Node * succs[MaxHeight];
+            if (!Find(key, preds, succs))
+            {
+                return false;
+            }
+
+            Node * node = succs[0];
+            for (xsize level = node->mHeight - 1; level > 0; --level)
+            {
+                Word word = node->mNext[level].load();
+                while (!IsMarked(word) && !node->mNext[level].compare_exchange_weak(word, word | 1))
+                {
+                }
+            }
+
+            Word word = node->mNext[0].load();
+            while (true)
+            {
+                if (IsMarked(word))
+                {
+                    return false; // another thread removed it first
+                }
+
+                if (node->mNext[0].compare_exchange_weak(word, word | 1))
+                {
+                    break;
+                }
+            }
+
+            mSize.fetch_sub(1, std::memory_order_relaxed);
+            Find(key, preds, succs);
+            ReleaseNode(node);
+            return true;
+        }
+
+        // wait free, never helps other threads
+        bool Contains(const TKey & key)
+        {
+            Memories::EpochGuard guard(mDomain);
+            return FindNode(key) != nullptr;
+        }
+
+        // copies the element out, the node itself may be freed as soon as the guard is left
+        bool Find(const TKey & key, TValue & value)
+        {
+            Memories::EpochGuard guard(mDomain);
+            Node * node = FindNode(key);
+            if (node == nullptr)
+            {
+                return false;
+            }
+
+            value = node->GetValue();
+            return true;
+        }
+
+        // Calls function with every element in order. Each element was in the list at some moment of the walk,
+        // changes made meanwhile may or may not be seen. The walk only reads and never waits for writers.
+        template <typename TFunction>
+        void ForEach(TFunction function)
+        {
+            Memories::EpochGuard guard(mDomain);
+            Node * node = GetPointer(mHead->mNext[0].load());
+            while (node != nullptr)
+            {
+                Word next = node->mNext[0].load();
+                if (!IsMarked(next))
+                {
+                    function(static_cast<const TValue &>(node->GetValue()));
+                }
+
+                node = GetPointer(next);
+            }
+        }
+
+        // the elements of one ForEach walk, sorted
+        Array<TValue> GetSnapshot()
+        {
+            Array<TValue> ans;
+            ForEach([&ans](const TValue & value) { ans.PushBack(value); });
+            return ans;
+        }
+
+    private:
+        static Node * GetPointer(Word word) { return reinterpret_cast<Node *>(word & ~Word(1)); }
+        static bool IsMarked(Word word) { return (word & 1) != 0; }
+        static Word MakeWord(Node * node) { return reinterpret_cast<Word>(node); }
+
+        const TKey & GetKey(Node * node) { return TKeyOfValue()(node->GetValue()); }
+
+        // Fills the last node before key and the first node not before it on every level,
+        // unlinking marked nodes on the way. Returns if the node at level 0 holds key.
+        bool Find(const TKey & key, Node ** preds, Node ** succs)
+        {
+        retry:
+            Node * pred = mHead;
+            Node * current = nullptr;
+            for (xsize level = MaxHeight; level-- > 0;)
+            {
+                current = GetPointer(pred->mNext[level].load());
+                while (current != nullptr)
+                {
+                    Word next = current->mNext[level].load();
+                    while (IsMarked(next))
+                    {
+                        Word expected = MakeWord(current);
+                        if (!pred->mNext[level].compare_exchange_strong(expected, MakeWord(GetPointer(next))))
+                        {
+                            goto retry;
+                        }
+
+                        current = GetPointer(next);
+                        if (current == nullptr)
+                        {
+                            break;
+                        }
+
+                        next = current->mNext[level].load();
+                    }
+
+                    if (current == nullptr || !mKeyCompare(GetKey(current), key))
+                    {
+                        break;
+                    }
+
+                    pred = current;
+                    current = GetPointer(next);
+                }
+
+                preds[level] = pred;
+                succs[level] = current;
+            }
+
+            return current != nullptr && !mKeyCompare(key, GetKey(current));
+        }
+
+        // like Find, but passes marked nodes instead of unlinking them
+        Node * FindNode(const TKey & key)
+        {
+            Node * pred = mHead;
+            Node * current = nullptr;
+            for (xsize level = MaxHeight; level-- > 0;)
+            {
+                current = GetPointer(pred->mNext[level].load());
+                while (current != nullptr && mKeyCompare(GetKey(current), key))
+                {
+                    pred = current;
+                    current = GetPointer(current->mNext[level].load());
+                }
+            }
+
+            if (current == nullptr || mKeyCompare(key, GetKey(current)) || IsMarked(current->mNext[0].load()))
+            {
+                return nullptr;
+            }
+
+            return current;
+        }
+
+        // links node into level, returns false when the node was removed meanwhile
+        bool LinkLevel(Node * node, xsize level, const TKey & key, Node ** preds, Node ** succs)
+        {
+            while (true)
+            {
+                Word word = node->mNext[level].load();
+                if (IsMarked(word))
+                {
+                    return false;
+                }
+
+                if (GetPointer(word) != succs[level] && !node->mNext[level].compare_exchange_strong(word, MakeWord(succs[level])))
+                {
+                    continue;
+                }
+
+                Word expected = MakeWord(succs[level]);
+                if (preds[level]->mNext[level].compare_exchange_strong(expected, MakeWord(node)))
+                {
+                    return true;
+                }
+
+                Find(key, preds, succs);
+                if (succs[0] != node)
+                {
+                    return false;
+                }
+            }
+        }
+
+        // one level more with a probability of 1/4
+        static xsize GetRandomHeight()
+        {
+            static thread_local std::uint32_t state = std::uint32_t(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1u;
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            xsize height = 1;
+            std::uint32_t bits = state;
+            while (height < MaxHeight && (bits & 3) == 0)
+            {
+                ++height;
+                bits >>= 2;
+            }
+
+            return height;
+        }
+
+        static Node * AllocateNode(xsize height)
+        {
+            void * memory = ::operator new(sizeof(Node) + (height - 1) * sizeof(std::atomic<Word>));
+            Node * node = new (memory) Node();
+            node->mHeight = height;
+            node->mReferences.store(2, std::memory_order_relaxed);
+            for (xsize level = 0; level < height; ++level)
+            {
+                new (&node->mNext[level]) std::atomic<Word>(0);
+            }
+
+            return node;
+        }
+
+        static void FreeNode(Node * node)
+        {
+            node->~Node();
+            ::operator delete(node);
+        }
+
+        static Node * CreateNode(const TValue & value, xsize height)
+        {
+            Node * node = AllocateNode(height);
+            new (&node->mValue) TValue(value);
+            return node;
+        }
+
+        static void DestroyNode(Node * node)
+        {
+            node->GetValue().~TValue();
+            FreeNode(node);
+        }
+
+        static void ReclaimNode(Memories::Reclaimable * object)
+        {
+            DestroyNode(static_cast<Node *>(object));
+        }
+
+        // the last of the inserter and the remover retires the node, by then neither links it any more
+        void ReleaseNode(Node * node)
+        {
+            if (node->mReferences.fetch_sub(1) == 1)
+            {
+                mDomain.Retire(node, &ReclaimNode);
+            }
+        }
+
+    private:
+        Memories::EpochDomain mDomain;
+        Node * mHead;
+        std::atomic<xsize> mSize;
+        TCompare mKeyCompare;
+    };
+
+} XC_END_NAMESPACE_3
+
+XC_BEGIN_NAMESPACE_2(XC, Containers)
+{
+    // An ordered set that many threads may change at the same time without locks.
+    // There are no iterators, elements are read by Contains, ForEach and GetSnapshot.
+    template <typename TKey, typename TCompare = Functors::Less<TKey> >
+    class ConcurrentSet
+    {
+    public:
+        using KeyType = TKey;
+        using ValueType = TKey;
+        using SizeType = xsize;
+        using ListType = Details::ConcurrentSkipList<TKey, TKey, Functors::Identity<TKey>, TCompare>;
+
+    public:
+        SizeType GetSize() const { return mList.GetSize(); }
+        bool IsEmpty() const { return mList.IsEmpty(); }
+        bool Insert(const TKey & key) { return mList.InsertUnique(key); }
+        bool Erase(const TKey & key) { return mList.Erase(key); }
+        bool Contains(const TKey & key) { return mList.Contains(key); }
+        Array<TKey> GetSnapshot() { return mList.GetSnapshot(); }
+
+        template <typename TFunction>
+        void ForEach(TFunction function) { mList.ForEach(function); }
+
+    private:
+        ListType mList;
+    };
+
+    XC_BEGIN_NAMESPACE_1(Details)
+    {
+        template <typename TKey, typename TMapped>
+        class SelectConcurrentKey
+        {
+        public:
+            const TKey & operator () (const Pair<TKey, TMapped> & pair) const
+            {
+                return pair.mFirst;
+            }
+        };
+
+    } XC_END_NAMESPACE_1
+
+    // Elements are Pair<key, mapped>. A mapped value is fixed once inserted, erase and insert again to change it.
+    template <typename TKey, typename TMapped, typename TCompare = Functors::Less<TKey> >
+    class ConcurrentMap
+    {
+    public:
+        using KeyType = TKey;
+        using MappedType = TMapped;
+        using ValueType = Pair<TKey, TMapped>;
+        using SizeType = xsize;
+        using ListType = Details::ConcurrentSkipList<TKey, ValueType, Details::SelectConcurrentKey<TKey, TMapped>, TCompare>;
+
+    public:
+        SizeType GetSize() const { return mList.GetSize(); }
+        bool IsEmpty() const { return mList.IsEmpty(); }
+        bool Insert(const TKey & key, const TMapped & mapped) { return mList.InsertUnique(ValueType(key, mapped)); }
+        bool Erase(const TKey & key) { return mList.Erase(key); }
+        bool Contains(const TKey & key) { return mList.Contains(key); }
+        Array<ValueType> GetSnapshot() { return mList.GetSnapshot(); }
+
+        bool Find(const TKey & key, TMapped & mapped)
+        {
+            ValueType value(key, mapped);
+            if (!mList.Find(key, value))
+            {
+                return false;
+            }
+
+            mapped = value.mSecond;
+            return true;
+        }
+
+        template <typename TFunction>
+        void ForEach(TFunction function) { mList.ForEach(function); }
+
+    private:
+        ListType mList;
+    };
+
+} XC_END_NAMESPACE_2
@@ -8,4 +8,5 @@
 #include "Stack.h"
 #include "PriorityQueue.h"
 #include "RBTree.h"
-#include "Set.h"
\ No newline at end of file
+#include "Set.h"
+#include "BTreeSet.h"
\ No newline at end of file
@@ -117,6 +117,7 @@ XC_BEGIN_NAMESPACE_1(XC)
         Iterator Erase(Iterator position);
         Iterator Erase(Iterator first, Iterator last);
         Iterator Insert(Iterator position, const T & value);
+        Memories::MemoryStatistics GetMemoryStatistics() const;
 
         // These functions are for C++ 11 :
         ConstantIterator begin() const { return GetBegin(); }
@@ -126,8 +127,8 @@ XC_BEGIN_NAMESPACE_1(XC)
         Iterator end() { return GetEnd(); }
 
     protected:
-        typedef InsideAllocator<T *, DefaultAllocator<T *> > MapAllocator; // Allocate the whole map
-        typedef InsideAllocator<T, DefaultAllocator<T> > DataAllocator; // Allocate element of each node
+        typedef InsideAllocator<T *, typename AllocatorRebind<TAllocator, T *>::Type> MapAllocator; // Allocate the whole map
+        typedef InsideAllocator<T, typename AllocatorRebind<TAllocator, T>::Type> DataAllocator; // Allocate element of each node
 
     protected:
         xsize GetBufferSize() const { return TBufferSize == 0 ? 512 : TBufferSize; }
@@ -469,6 +470,18 @@ XC_BEGIN_NAMESPACE_1(XC)
         }
     }
 
+    template <typename T, xsize TBufferSize, typename TAllocator>
+    Memories::MemoryStatistics DEQueue<T, TBufferSize, TAllocator>::GetMemoryStatistics() const
+    {
+        Memories::MemoryStatistics ans;
+        ans.mCountElements = GetSize();
+        ans.mCountNodes = xsize(mFinish.mNode - mStart.mNode) + 1; // The finish node is always allocated.
+        ans.mCapacity = ans.mCountNodes * GetBufferSize();
+        ans.mElementSize = sizeof(T);
+        ans.mOverheadBytes = mMapSize * sizeof(T *);
+        return ans;
+    }
+
     template <typename T, xsize TBufferSize, typename TAllocator>
     void DEQueue<T, TBufferSize, TAllocator>::EmptyCreateMapAndNodes()
     {
@@ -622,3 +635,32 @@ XC_BEGIN_NAMESPACE_1(XC)
     }
 
 } XC_END_NAMESPACE_1
+
+XC_BEGIN_NAMESPACE_1(XC_DEQUEUE_TEST)
+{
+    class DEQueueTestTag {};
+
+    XC_TEST_CASE(DEQUEUE_MEMORY_STATISTICS_TEST)
+    {
+        using Allocator = XC::TrackingAllocator<int, XC::DefaultAllocator<int>, DEQueueTestTag>;
+        XC::Memories::AllocationStatistics & statistics = Allocator::GetStatistics();
+
+        {
+            XC::DEQueue<int, 8, Allocator> queue;
+            for (int i = 0; i < 20; ++i)
+            {
+                queue.PushBack(i);
+            }
+
+            XC::Memories::MemoryStatistics memory = queue.GetMemoryStatistics();
+            XC_TEST_ASSERT(memory.mCountElements == 20);
+            XC_TEST_ASSERT(memory.mCountNodes == 3);
+            XC_TEST_ASSERT(memory.mCapacity == 24);
+            XC_TEST_ASSERT(memory.mOverheadBytes >= 4 * sizeof(int *));
+            XC_TEST_ASSERT(statistics.GetCountLiveAllocations() == 4); // the map and three buffers
+        }
+
+        XC_TEST_ASSERT(statistics.GetLiveBytes() == 0);
+    }
+
+} XC_END_NAMESPACE_1
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <type_traits>
+
+#include "../Types/Types.h"
+#include "../Memories/MappedFile.h"
+#include "Serialization.h"
+
+XC_BEGIN_NAMESPACE_1(XC)
+{
+    // An array of trivially copyable elements that lives in a mapped file.
+    // The file is a snapshot (see Serialization::SnapshotHeader), so Serialization::SaveFile of an Array
+    // can be opened here read only without copying, and a closed MappedArray can be loaded into an Array.
+    // While open for writing the file keeps spare capacity at its end, Close cuts it off.
+    template <typename T>
+    class MappedArray
+    {
+    public:
+        static_assert(std::is_trivially_copyable<T>::value, "MappedArray needs trivially copyable elements");
+        static_assert(alignof(T) <= sizeof(Serialization::SnapshotHeader), "the payload is only aligned to the header size");
+
+        typedef T ValueType;
+        typedef xptrdiff DifferenceType;
+        typedef T * Pointer;
+        typedef T & Reference;
+        typedef xsize SizeType;
+        typedef const T * ConstantIterator;
+        typedef T * Iterator;
+
+    public:
+        MappedArray() {}
+        ~MappedArray() { Close(); }
+        MappedArray(const MappedArray<T> &) = delete;
+        MappedArray<T> & operator = (const MappedArray<T> &) = delete;
+
+    public:
+        bool Create(const char * path);
+        bool Open(const char * path, bool readOnly = true);
+        bool Flush() { return mFile.Flush(); }
+        void Close();
+
+        bool IsOpen() const { return mFile.IsOpen(); }
+        bool IsReadOnly() const { return mFile.IsReadOnly(); }
+        ConstantIterator GetBegin() const { return (ConstantIterator)GetPayload(); }
+        Iterator GetBegin() { return (Iterator)GetPayload(); }
+        ConstantIterator GetEnd() const { return GetBegin() + GetSize(); }
+        Iterator GetEnd() { return GetBegin() + GetSize(); }
+        xsize GetSize() const { return IsMapped() ? xsize(GetHeader()->mCount) : 0; }
+        xsize GetCapacity() const { return IsMapped() ? (mFile.GetSize() - HeaderSize) / sizeof(T) : 0; }
+        bool IsEmpty() const { return GetSize() == 0; }
+        const T & At(xsize index) const { return *(GetBegin() + index); }
+        T & At(xsize index) { return *(GetBegin() + index); }
+        const T & operator [] (xsize index) const { return At(index); }
+        T & operator [] (xsize index) { return At(index); }
+        const T & GetBack() const { return *(GetEnd() - 1); }
+        T & GetBack() { return *(GetEnd() - 1); }
+
+        // These return false when the file is read only, cannot grow or, for PopBack, the array is empty;
+        // the array is unchanged then.
+        bool Reserve(xsize capacity);
+        bool PushBack(const T & value);
+        bool PopBack();
+        void Clear() { if (IsMapped() && !IsReadOnly()) GetHeader()->mCount = 0; }
+
+        // these functions are provided for c++ for statement
+        ConstantIterator begin() const { return GetBegin(); }
+        Iterator begin() { return GetBegin(); }
+        ConstantIterator end() const { return GetEnd(); }
+        Iterator end() { return GetEnd(); }
+
+    private:
+        static const xsize HeaderSize = sizeof(Serialization::SnapshotHeader);
+
+        bool IsMapped() const { return mFile.GetData() != nullptr; }
+        const Serialization::SnapshotHeader * GetHeader() const { return (const Serialization::SnapshotHeader *)mFile.GetData(); }
+        Serialization::SnapshotHeader * GetHeader() { return (Serialization::SnapshotHeader *)mFile.GetData(); }
+        const char * GetPayload() const { return IsMapped() ? (const char *)mFile.GetData() + HeaderSize : nullptr; }
+        char * GetPayload() { return IsMapped() ? (char *)mFile.GetData() + HeaderSize : nullptr; }
+
+        Memories::MappedFile mFile;
+    };
+
+    template <typename T>
+    bool MappedArray<T>::Create(const char * path)
+    {
+        if (!mFile.Open(path, Memories::MappedFile::Mode::Create) || !mFile.Resize(HeaderSize))
+        {
+            mFile.Close();
+            return false;
+        }
+
+        *GetHeader() = Serialization::SnapshotHeader(sizeof(T), 0);
+        return true;
+    }
+
+    template <typename T>
+    bool MappedArray<T>::Open(const char * path, bool readOnly)
+    {
+        Memories::MappedFile::Mode mode = readOnly ? Memories::MappedFile::Mode::ReadOnly : Memories::MappedFile::Mode::ReadWrite;
+        if (!mFile.Open(path, mode))
+        {
+            return false;
+        }
+
+        if (mFile.GetSize() < HeaderSize || !GetHeader()->IsValid(sizeof(T)) ||
+            (mFile.GetSize() - HeaderSize) / sizeof(T) < GetHeader()->mCount)
+        {
+            mFile.Close();
+            return false;
+        }
+
+        return true;
+    }
+
+    template <typename T>
+    void MappedArray<T>::Close()
+    {
+        if (IsOpen() && !IsReadOnly() && IsMapped())
+        {
+            mFile.Resize(HeaderSize + GetSize() * sizeof(T));
+            mFile.Flush();
+        }
+
+        mFile.Close();
+    }
+
+    template <typename T>
+    bool MappedArray<T>::Reserve(xsize capacity)
+    {
+        if (!IsOpen() || IsReadOnly())
+        {
+            return false;
+        }
+
+        if (capacity <= GetCapacity())
+        {
+            return true;
+        }
+
+        return mFile.Resize(HeaderSize + capacity * sizeof(T));
+    }
+
+    template <typename T>
+    bool MappedArray<T>::PushBack(const T & value)
+    {
+        xsize size = GetSize();
+        if (size == GetCapacity() && !Reserve(size == 0 ? 16 : size * 2))
+        {
+            return false;
+        }
+
+        new (GetBegin() + size) T(value);
+        ++GetHeader()->mCount;
+        return true;
+    }
+
+    template <typename T>
+    bool MappedArray<T>::PopBack()
+    {
+        if (IsEmpty() || IsReadOnly())
+        {
+            return false;
+        }
+
+        --GetHeader()->mCount;
+        return true;
+    }
+
+} XC_END_NAMESPACE_1
+
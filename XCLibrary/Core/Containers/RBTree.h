@@ -5,6 +5,7 @@
 #include "../SyntaxSugars/SyntaxSugars.h"
 #include "../Iterators/Iterators.h"
 #include "../Memories/Allocators.h"
+#include "../Memories/MemoryStatistics.h"
 #include "Pair.h"
 #include "../Iterators/Iterators.h"
 #include "../Delegates/Delegates.h"
@@ -214,7 +215,7 @@ XC_BEGIN_NAMESPACE_3(XC, Containers, Details)
         using Self = RBTree<TKey, TValue, TKeyOfValue, TCompare, TAllocator>;
 
         // allocators :
-        using RBTreeNodeAllocator = DefaultAllocator<Node>;
+        using RBTreeNodeAllocator = typename AllocatorRebind<TAllocator, Node>::Type;
 
     public:
         RBTree(const TCompare & compare = TCompare()) :
@@ -290,7 +291,16 @@ XC_BEGIN_NAMESPACE_3(XC, Containers, Details)
 
         void Clear()
         {
+            if (mCountNodes == 0)
+            {
+                return;
+            }
 
+            EraseSubtree(GetRoot());
+            GetRoot() = nullptr;
+            GetMostLeft() = mHeader;
+            GetMostRight() = mHeader;
+            mCountNodes = 0;
         }
 
         // insert functions
@@ -487,6 +497,17 @@ XC_BEGIN_NAMESPACE_3(XC, Containers, Details)
             return Find(key) != GetEnd();
         }
 
+        Memories::MemoryStatistics GetMemoryStatistics() const
+        {
+            Memories::MemoryStatistics ans;
+            ans.mCountElements = mCountNodes;
+            ans.mCapacity = mCountNodes;
+            ans.mCountNodes = mCountNodes + 1; // with the header
+            ans.mElementSize = sizeof(ValueType);
+            ans.mOverheadBytes = (sizeof(Node) - sizeof(ValueType)) * mCountNodes + sizeof(Node);
+            return ans;
+        }
+
         void Erase(Iterator position)
         {
             Node* y = EraseRebalance(position.mNode, mHeader->mParent, mHeader->mLeft, mHeader->mRight);
@@ -544,6 +565,18 @@ XC_BEGIN_NAMESPACE_3(XC, Containers, Details)
             PutNode(node);
         }
 
+        // destroys the nodes without rebalancing, loops on left children so recursion stays within the tree height
+        void EraseSubtree(Node* node)
+        {
+            while (node != nullptr)
+            {
+                EraseSubtree(node->mRight);
+                Node* left = node->mLeft;
+                DestroyNode(node);
+                node = left;
+            }
+        }
+
         // node functions, static like
         TValue& GetValue(Node* node) const
         {
@@ -940,7 +973,7 @@ XC_BEGIN_NAMESPACE_3(XC, Containers, Details)
         {
             Node* y = x->mLeft;
             x->mLeft = y->mRight;
-            if (x->mRight != nullptr)
+            if (y->mRight != nullptr)
             {
                 y->mRight->mParent = x;
             }
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+
+#include "../Types/Types.h"
+#include "Array.h"
+#include "DEQueue.h"
+#include "Set.h"
+
+// Binary snapshots of containers whose elements are trivially copyable.
+// A snapshot is a SnapshotHeader followed by the elements in order, written and read with one call each,
+// the same layout MappedArray uses, so a saved Array can be opened by mapping instead of loading.
+XC_BEGIN_NAMESPACE_2(XC, Serialization)
+{
+    class SnapshotHeader
+    {
+    public:
+        static const std::uint32_t Magic = 0x4e534358; // "XCSN"
+        static const std::uint32_t CurrentVersion = 1;
+
+    public:
+        SnapshotHeader() :
+            mMagic(Magic), mVersion(CurrentVersion), mElementSize(0), mReserved(0), mCount(0)
+        {
+            std::memset(mPadding, 0, sizeof(mPadding));
+        }
+
+        SnapshotHeader(xsize elementSize, xsize count) : SnapshotHeader()
+        {
+            mElementSize = std::uint32_t(elementSize);
+            mCount = std::uint64_t(count);
+        }
+
+    public:
+        bool IsValid(xsize elementSize) const
+        {
+            return mMagic == Magic && mVersion == CurrentVersion && mElementSize == elementSize;
+        }
+
+    public:
+        std::uint32_t mMagic;
+        std::uint32_t mVersion;
+        std::uint32_t mElementSize;
+        std::uint32_t mReserved;
+        std::uint64_t mCount;
+        std::uint8_t mPadding[8]; // keeps the payload 32 bytes aligned
+    };
+
+    static_assert(sizeof(SnapshotHeader) == 32, "the snapshot header is part of the file format");
+
+    XC_BEGIN_NAMESPACE_1(Details)
+    {
+        template <typename T>
+        bool WritePayload(std::ostream & stream, const T * data, xsize count)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable elements can be saved");
+            SnapshotHeader header(sizeof(T), count);
+            stream.write((const char *)&header, sizeof(header));
+            if (count != 0)
+            {
+                stream.write((const char *)data, std::streamsize(count * sizeof(T)));
+            }
+
+            return bool(stream);
+        }
+
+        // The bytes from the read position to the end, false for a stream that cannot seek, as a pipe.
+        inline bool GetRemaining(std::istream & stream, std::uint64_t & remaining)
+        {
+            const std::istream::pos_type none(-1);
+            std::istream::pos_type position = stream.tellg();
+            if (position == none)
+            {
+                return false;
+            }
+
+            stream.seekg(0, std::ios::end);
+            std::istream::pos_type end = stream.tellg();
+            stream.clear();
+            stream.seekg(position);
+            if (!stream || end == none || end < position)
+            {
+                stream.clear();
+                return false;
+            }
+
+            remaining = std::uint64_t(end - position);
+            return true;
+        }
+
+        // The count comes from the file, so it is checked against what the payload can hold before
+        // anything is allocated for it.
+        template <typename T>
+        bool ReadHeader(std::istream & stream, xsize & count)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable elements can be loaded");
+            SnapshotHeader header;
+            stream.read((char *)&header, sizeof(header));
+            if (!stream || !header.IsValid(sizeof(T)) || header.mCount > std::uint64_t(xsize(-1) / sizeof(T)))
+            {
+                return false;
+            }
+
+            std::uint64_t remaining = 0;
+            if (GetRemaining(stream, remaining) && header.mCount > remaining / sizeof(T))
+            {
+                return false;
+            }
+
+            count = xsize(header.mCount);
+            return true;
+        }
+
+        // A stream whose length is unknown is read a step at a time, so a count it does not hold
+        // fails having allocated about as much as it does.
+        template <typename T, typename TAllocator>
+        bool ReadElements(std::istream & stream, Array<T, TAllocator> & array, xsize count)
+        {
+            std::uint64_t remaining = 0;
+            const xsize step = GetRemaining(stream, remaining) ? count : (1 << 20) / sizeof(T) + 1;
+            array.Clear();
+            while (array.GetSize() < count)
+            {
+                xsize size = array.GetSize();
+                xsize next = count - size < step ? count - size : step;
+                if (size == 0)
+                {
+                    array.Resize(next);
+                }
+                else
+                {
+                    array.Insert(array.GetEnd(), next, T());
+                }
+
+                stream.read((char *)(array.GetBegin() + size), std::streamsize(next * sizeof(T)));
+                if (!stream)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // Containers that are not contiguous are staged into one buffer, so the payload is still a single write.
+        template <typename TIterator, typename T>
+        bool WriteRange(std::ostream & stream, TIterator first, TIterator last, xsize count)
+        {
+            Array<T> buffer;
+            buffer.SetCapacity(count);
+            for (; first != last; ++first)
+            {
+                buffer.PushBack(*first);
+            }
+
+            return WritePayload(stream, buffer.GetBegin(), buffer.GetSize());
+        }
+
+        template <typename T>
+        bool ReadBuffer(std::istream & stream, Array<T> & buffer)
+        {
+            xsize count = 0;
+            if (!ReadHeader<T>(stream, count))
+            {
+                return false;
+            }
+
+            return ReadElements(stream, buffer, count);
+        }
+
+    } XC_END_NAMESPACE_1
+
+    template <typename T, typename TAllocator>
+    bool Save(std::ostream & stream, const Array<T, TAllocator> & array)
+    {
+        return Details::WritePayload(stream, array.GetBegin(), array.GetSize());
+    }
+
+    // On failure the array is left empty.
+    template <typename T, typename TAllocator>
+    bool Load(std::istream & stream, Array<T, TAllocator> & array)
+    {
+        xsize count = 0;
+        array.Clear();
+        if (!Details::ReadHeader<T>(stream, count))
+        {
+            return false;
+        }
+
+        if (!Details::ReadElements(stream, array, count))
+        {
+            array.Clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    template <typename T, xsize TBufferSize, typename TAllocator>
+    bool Save(std::ostream & stream, const DEQueue<T, TBufferSize, TAllocator> & queue)
+    {
+        return Details::WriteRange<decltype(queue.GetBegin()), T>(stream, queue.GetBegin(), queue.GetEnd(), queue.GetSize());
+    }
+
+    template <typename T, xsize TBufferSize, typename TAllocator>
+    bool Load(std::istream & stream, DEQueue<T, TBufferSize, TAllocator> & queue)
+    {
+        Array<T> buffer;
+        queue.Clear();
+        if (!Details::ReadBuffer(stream, buffer))
+        {
+            return false;
+        }
+
+        for (const T & value : buffer)
+        {
+            queue.PushBack(value);
+        }
+
+        return true;
+    }
+
+    // Keys are written in order, so loading inserts a sorted run.
+    template <typename TKey, typename TCompare, typename TAllocator>
+    bool Save(std::ostream & stream, const Containers::Set<TKey, TCompare, TAllocator> & set)
+    {
+        return Details::WriteRange<decltype(set.GetBegin()), TKey>(stream, set.GetBegin(), set.GetEnd(), set.GetSize());
+    }
+
+    template <typename TKey, typename TCompare, typename TAllocator>
+    bool Load(std::istream & stream, Containers::Set<TKey, TCompare, TAllocator> & set)
+    {
+        Array<TKey> buffer;
+        set.Clear();
+        if (!Details::ReadBuffer(stream, buffer))
+        {
+            return false;
+        }
+
+        for (const TKey & key : buffer)
+        {
+            set.Insert(key);
+        }
+
+        return true;
+    }
+
+    template <typename TContainer>
+    bool SaveFile(const char * path, const TContainer & container)
+    {
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        return stream && Save(stream, container);
+    }
+
+    template <typename TContainer>
+    bool LoadFile(const char * path, TContainer & container)
+    {
+        std::ifstream stream(path, std::ios::binary);
+        return stream && Load(stream, container);
+    }
+
+} XC_END_NAMESPACE_2
@@ -21,6 +21,7 @@ XC_BEGIN_NAMESPACE_2(XC, Containers)
 		using SizeType = typename TreeType::SizeType;
 		using DifferenceType = typename TreeType::DifferenceType;
 		using Iterator = typename TreeType::Iterator;
+		using ConstantIterator = typename TreeType::ConstantIterator;
 
 	public:
 		Set() : mTree(TCompare())
@@ -29,15 +30,27 @@ XC_BEGIN_NAMESPACE_2(XC, Containers)
 		}
 
 	public:
+		ConstantIterator begin() const { return GetBegin(); }
 		Iterator begin() { return GetBegin(); }
+		ConstantIterator end() const { return GetEnd(); }
 		Iterator end() { return GetEnd(); }
 
 	public:
+		ConstantIterator GetBegin() const
+		{
+			return mTree.GetBegin();
+		}
+
 		Iterator GetBegin()
 		{
 			return mTree.GetBegin();
 		}
 
+		ConstantIterator GetEnd() const
+		{
+			return mTree.GetEnd();
+		}
+
 		Iterator GetEnd()
 		{
 			return mTree.GetEnd();
@@ -69,6 +82,31 @@ XC_BEGIN_NAMESPACE_2(XC, Containers)
 			return mTree.Contains(key);
 		}
 
+		Iterator Find(const TKey& key)
+		{
+			return mTree.Find(key);
+		}
+
+		SizeType Erase(const TKey& key)
+		{
+			return mTree.Erase(key);
+		}
+
+		Iterator GetLowerBound(const TKey& key)
+		{
+			return mTree.GetLowerBound(key);
+		}
+
+		Iterator GetUpperBound(const TKey& key)
+		{
+			return mTree.GetUpperBound(key);
+		}
+
+		Memories::MemoryStatistics GetMemoryStatistics() const
+		{
+			return mTree.GetMemoryStatistics();
+		}
+
 
 
 	public:
@@ -4,6 +4,7 @@
 #include "Delegates/Delegates.h"
 #include "Containers/Containers.h"
 #include "Algorithms/Algorithms.h"
+#include "Iterators/Views.h"
 
 #include <string>
 #include <map>
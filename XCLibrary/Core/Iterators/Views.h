@@ -0,0 +1,584 @@
+#pragma once
+
+#include <utility>
+#include <type_traits>
+#include "../Types/Types.h"
+#include "Iterators.h"
+#include "../Containers/Pair.h"
+
+// Lazy views over anything that has begin() and end().
+// A view only keeps iterators (or the view it is built on), so
+//     arr | Views::Filter(isValid) | Views::Transform(getDistance)
+// is walked in one loop without any temporary container, and nothing is copied until To<Array>() or Collect().
+// Containers are referenced, not copied, they must outlive the views built on them.
+XC_BEGIN_NAMESPACE_2(XC, Views)
+{
+    class ViewBase {};
+    class AdaptorBase {};
+
+    template <typename TIterator>
+    class Range : public ViewBase
+    {
+    public:
+        Range(TIterator first, TIterator last) : mFirst(first), mLast(last) {}
+
+    public:
+        TIterator begin() const { return mFirst; }
+        TIterator end() const { return mLast; }
+
+    private:
+        TIterator mFirst;
+        TIterator mLast;
+    };
+
+    XC_BEGIN_NAMESPACE_1(Details)
+    {
+        template <typename TRange, bool TIsView = std::is_base_of<ViewBase, typename std::decay<TRange>::type>::value>
+        class AllOf
+        {
+        public:
+            using Type = typename std::decay<TRange>::type;
+
+            static Type Get(TRange && range) { return Type(std::forward<TRange>(range)); }
+        };
+
+        template <typename TRange>
+        class AllOf<TRange, false>
+        {
+        public:
+            static_assert(std::is_lvalue_reference<TRange>::value, "a view cannot be built on a temporary container");
+            using Type = Range<decltype(std::declval<TRange>().begin())>;
+
+            static Type Get(TRange && range) { return Type(range.begin(), range.end()); }
+        };
+
+        template <typename TView>
+        class ViewTraits
+        {
+        public:
+            using Iterator = decltype(std::declval<const TView &>().begin());
+            using Reference = decltype(*std::declval<const Iterator &>());
+            using ValueType = typename std::decay<Reference>::type;
+        };
+
+        template <typename TIterator>
+        void AdvanceUntil(TIterator & iterator, const TIterator & last, xsize n)
+        {
+            while (n != 0 && iterator != last)
+            {
+                ++iterator;
+                --n;
+            }
+        }
+
+    } XC_END_NAMESPACE_1
+
+    template <typename TRange>
+    using ViewOf = typename Details::AllOf<TRange>::Type;
+
+    // Wraps a container into a Range, views are passed through.
+    template <typename TRange>
+    ViewOf<TRange> All(TRange && range)
+    {
+        return Details::AllOf<TRange>::Get(std::forward<TRange>(range));
+    }
+
+    template <typename TBase, typename TPredicate>
+    class FilterView : public ViewBase
+    {
+    public:
+        using BaseIterator = typename Details::ViewTraits<TBase>::Iterator;
+
+        class Iterator
+        {
+        public:
+            using IteratorCategory = Iterators::ForwardIteratorTag;
+            using Reference = typename Details::ViewTraits<TBase>::Reference;
+            using ValueType = typename std::decay<Reference>::type;
+            using Pointer = ValueType *;
+            using DifferenceType = xptrdiff;
+
+        public:
+            Iterator(BaseIterator current, BaseIterator last, const TPredicate * predicate) :
+                mCurrent(current), mLast(last), mPredicate(predicate)
+            {
+                Satisfy();
+            }
+
+        public:
+            Reference operator * () const { return *mCurrent; }
+            Iterator & operator ++ () { ++mCurrent; Satisfy(); return *this; }
+            bool operator == (const Iterator & rhs) const { return mCurrent == rhs.mCurrent; }
+            bool operator != (const Iterator & rhs) const { return !(*this == rhs); }
+
+        private:
+            void Satisfy()
+            {
+                while (mCurrent != mLast && !(*mPredicate)(*mCurrent))
+                {
+                    ++mCurrent;
+                }
+            }
+
+            BaseIterator mCurrent;
+            BaseIterator mLast;
+            const TPredicate * mPredicate;
+        };
+
+    public:
+        FilterView(const TBase & base, const TPredicate & predicate) : mBase(base), mPredicate(predicate) {}
+
+    public:
+        Iterator begin() const { return Iterator(mBase.begin(), mBase.end(), &mPredicate); }
+        Iterator end() const { return Iterator(mBase.end(), mBase.end(), &mPredicate); }
+
+    private:
+        TBase mBase;
+        TPredicate mPredicate;
+    };
+
+    template <typename TBase, typename TFunction>
+    class TransformView : public ViewBase
+    {
+    public:
+        using BaseIterator = typename Details::ViewTraits<TBase>::Iterator;
+
+        class Iterator
+        {
+        public:
+            using IteratorCategory = Iterators::ForwardIteratorTag;
+            using Reference = decltype(std::declval<const TFunction &>()(*std::declval<const BaseIterator &>()));
+            using ValueType = typename std::decay<Reference>::type;
+            using Pointer = ValueType *;
+            using DifferenceType = xptrdiff;
+
+        public:
+            Iterator(BaseIterator current, const TFunction * function) : mCurrent(current), mFunction(function) {}
+
+        public:
+            Reference operator * () const { return (*mFunction)(*mCurrent); }
+            Iterator & operator ++ () { ++mCurrent; return *this; }
+            bool operator == (const Iterator & rhs) const { return mCurrent == rhs.mCurrent; }
+            bool operator != (const Iterator & rhs) const { return !(*this == rhs); }
+
+        private:
+            BaseIterator mCurrent;
+            const TFunction * mFunction;
+        };
+
+    public:
+        TransformView(const TBase & base, const TFunction & function) : mBase(base), mFunction(function) {}
+
+    public:
+        Iterator begin() const { return Iterator(mBase.begin(), &mFunction); }
+        Iterator end() const { return Iterator(mBase.end(), &mFunction); }
+
+    private:
+        TBase mBase;
+        TFunction mFunction;
+    };
+
+    template <typename TBase>
+    class TakeView : public ViewBase
+    {
+    public:
+        using BaseIterator = typename Details::ViewTraits<TBase>::Iterator;
+
+        class Iterator
+        {
+        public:
+            using IteratorCategory = Iterators::ForwardIteratorTag;
+            using Reference = typename Details::ViewTraits<TBase>::Reference;
+            using ValueType = typename std::decay<Reference>::type;
+            using Pointer = ValueType *;
+            using DifferenceType = xptrdiff;
+
+        public:
+            Iterator(BaseIterator current, BaseIterator last, xsize remaining) :
+                mCurrent(current), mLast(last), mRemaining(remaining)
+            {
+            }
+
+        public:
+            Reference operator * () const { return *mCurrent; }
+            Iterator & operator ++ () { ++mCurrent; --mRemaining; return *this; }
+            bool operator != (const Iterator & rhs) const { return !(*this == rhs); }
+            bool operator == (const Iterator & rhs) const
+            {
+                if (IsEnd() || rhs.IsEnd())
+                {
+                    return IsEnd() && rhs.IsEnd();
+                }
+
+                return mCurrent == rhs.mCurrent;
+            }
+
+        private:
+            bool IsEnd() const { return mRemaining == 0 || mCurrent == mLast; }
+
+            BaseIterator mCurrent;
+            BaseIterator mLast;
+            xsize mRemaining;
+        };
+
+    public:
+        TakeView(const TBase & base, xsize count) : mBase(base), mCount(count) {}
+
+    public:
+        Iterator begin() const { return Iterator(mBase.begin(), mBase.end(), mCount); }
+        Iterator end() const { return Iterator(mBase.end(), mBase.end(), 0); }
+
+    private:
+        TBase mBase;
+        xsize mCount;
+    };
+
+    template <typename TBase>
+    class DropView : public ViewBase
+    {
+    public:
+        using Iterator = typename Details::ViewTraits<TBase>::Iterator;
+
+    public:
+        DropView(const TBase & base, xsize count) : mBase(base), mCount(count) {}
+
+    public:
+        Iterator begin() const
+        {
+            Iterator ans = mBase.begin();
+            Details::AdvanceUntil(ans, mBase.end(), mCount);
+            return ans;
+        }
+
+        Iterator end() const { return mBase.end(); }
+
+    private:
+        TBase mBase;
+        xsize mCount;
+    };
+
+    template <typename TBase>
+    class StrideView : public ViewBase
+    {
+    public:
+        using BaseIterator = typename Details::ViewTraits<TBase>::Iterator;
+
+        class Iterator
+        {
+        public:
+            using IteratorCategory = Iterators::ForwardIteratorTag;
+            using Reference = typename Details::ViewTraits<TBase>::Reference;
+            using ValueType = typename std::decay<Reference>::type;
+            using Pointer = ValueType *;
+            using DifferenceType = xptrdiff;
+
+        public:
+            Iterator(BaseIterator current, BaseIterator last, xsize step) : mCurrent(current), mLast(last), mStep(step) {}
+
+        public:
+            Reference operator * () const { return *mCurrent; }
+            Iterator & operator ++ () { Details::AdvanceUntil(mCurrent, mLast, mStep); return *this; }
+            bool operator == (const Iterator & rhs) const { return mCurrent == rhs.mCurrent; }
+            bool operator != (const Iterator & rhs) const { return !(*this == rhs); }
+
+        private:
+            BaseIterator mCurrent;
+            BaseIterator mLast;
+            xsize mStep;
+        };
+
+    public:
+        StrideView(const TBase & base, xsize step) : mBase(base), mStep(step == 0 ? 1 : step) {}
+
+    public:
+        Iterator begin() const { return Iterator(mBase.begin(), mBase.end(), mStep); }
+        Iterator end() const { return Iterator(mBase.end(), mBase.end(), mStep); }
+
+    private:
+        TBase mBase;
+        xsize mStep;
+    };
+
+    // Every element is a TakeView of at most count elements, the last chunk may be shorter.
+    template <typename TBase>
+    class ChunkView : public ViewBase
+    {
+    public:
+        using BaseIterator = typename Details::ViewTraits<TBase>::Iterator;
+        using Chunk = TakeView<Range<BaseIterator> >;
+
+        class Iterator
+        {
+        public:
+            using IteratorCategory = Iterators::ForwardIteratorTag;
+            using Reference = Chunk;
+            using ValueType = Chunk;
+            using Pointer = Chunk *;
+            using DifferenceType = xptrdiff;
+
+        public:
+            Iterator(BaseIterator current, BaseIterator last, xsize count) : mCurrent(current), mLast(last), mCount(count) {}
+
+        public:
+            Chunk operator * () const { return Chunk(Range<BaseIterator>(mCurrent, mLast), mCount); }
+            Iterator & operator ++ () { Details::AdvanceUntil(mCurrent, mLast, mCount); return *this; }
+            bool operator == (const Iterator & rhs) const { return mCurrent == rhs.mCurrent; }
+            bool operator != (const Iterator & rhs) const { return !(*this == rhs); }
+
+        private:
+            BaseIterator mCurrent;
+            BaseIterator mLast;
+            xsize mCount;
+        };
+
+    public:
+        ChunkView(const TBase & base, xsize count) : mBase(base), mCount(count == 0 ? 1 : count) {}
+
+    public:
+        Iterator begin() const { return Iterator(mBase.begin(), mBase.end(), mCount); }
+        Iterator end() const { return Iterator(mBase.end(), mBase.end(), mCount); }
+
+    private:
+        TBase mBase;
+        xsize mCount;
+    };
+
+    // Elements are Pair<index, element>, the element is still a reference.
+    template <typename TBase>
+    class EnumerateView : public ViewBase
+    {
+    public:
+        using BaseIterator = typename Details::ViewTraits<TBase>::Iterator;
+
+        class Iterator
+        {
+        public:
+            using IteratorCategory = Iterators::ForwardIteratorTag;
+            using Reference = Containers::Pair<xsize, typename Details::ViewTraits<TBase>::Reference>;
+            using ValueType = Reference;
+            using Pointer = ValueType *;
+            using DifferenceType = xptrdiff;
+
+        public:
+            Iterator(BaseIterator current, xsize index) : mCurrent(current), mIndex(index) {}
+
+        public:
+            Reference operator * () const { return Reference(mIndex, *mCurrent); }
+            Iterator & operator ++ () { ++mCurrent; ++mIndex; return *this; }
+            bool operator == (const Iterator & rhs) const { return mCurrent == rhs.mCurrent; }
+            bool operator != (const Iterator & rhs) const { return !(*this == rhs); }
+
+        private:
+            BaseIterator mCurrent;
+            xsize mIndex;
+        };
+
+    public:
+        explicit EnumerateView(const TBase & base) : mBase(base) {}
+
+    public:
+        Iterator begin() const { return Iterator(mBase.begin(), 0); }
+        Iterator end() const { return Iterator(mBase.end(), 0); }
+
+    private:
+        TBase mBase;
+    };
+
+    // Walks two ranges together and stops at the shorter one.
+    template <typename TBase1, typename TBase2>
+    class ZipView : public ViewBase
+    {
+    public:
+        using BaseIterator1 = typename Details::ViewTraits<TBase1>::Iterator;
+        using BaseIterator2 = typename Details::ViewTraits<TBase2>::Iterator;
+
+        class Iterator
+        {
+        public:
+            using IteratorCategory = Iterators::ForwardIteratorTag;
+            using Reference = Containers::Pair<typename Details::ViewTraits<TBase1>::Reference, typename Details::ViewTraits<TBase2>::Reference>;
+            using ValueType = Reference;
+            using Pointer = ValueType *;
+            using DifferenceType = xptrdiff;
+
+        public:
+            Iterator(BaseIterator1 current1, BaseIterator1 last1, BaseIterator2 current2, BaseIterator2 last2) :
+                mCurrent1(current1), mLast1(last1), mCurrent2(current2), mLast2(last2)
+            {
+            }
+
+        public:
+            Reference operator * () const { return Reference(*mCurrent1, *mCurrent2); }
+            Iterator & operator ++ () { ++mCurrent1; ++mCurrent2; return *this; }
+            bool operator != (const Iterator & rhs) const { return !(*this == rhs); }
+            bool operator == (const Iterator & rhs) const
+            {
+                if (IsEnd() || rhs.IsEnd())
+                {
+                    return IsEnd() && rhs.IsEnd();
+                }
+
+                return mCurrent1 == rhs.mCurrent1 && mCurrent2 == rhs.mCurrent2;
+            }
+
+        private:
+            bool IsEnd() const { return mCurrent1 == mLast1 || mCurrent2 == mLast2; }
+
+            BaseIterator1 mCurrent1;
+            BaseIterator1 mLast1;
+            BaseIterator2 mCurrent2;
+            BaseIterator2 mLast2;
+        };
+
+    public:
+        ZipView(const TBase1 & base1, const TBase2 & base2) : mBase1(base1), mBase2(base2) {}
+
+    public:
+        Iterator begin() const { return Iterator(mBase1.begin(), mBase1.end(), mBase2.begin(), mBase2.end()); }
+        Iterator end() const { return Iterator(mBase1.end(), mBase1.end(), mBase2.end(), mBase2.end()); }
+
+    private:
+        TBase1 mBase1;
+        TBase2 mBase2;
+    };
+
+    // Adaptors are the right hand side of operator |.
+    XC_BEGIN_NAMESPACE_1(Details)
+    {
+        template <typename TPredicate>
+        class FilterAdaptor : public AdaptorBase
+        {
+        public:
+            explicit FilterAdaptor(const TPredicate & predicate) : mPredicate(predicate) {}
+
+            template <typename TRange>
+            FilterView<ViewOf<TRange>, TPredicate> Apply(TRange && range) const
+            {
+                return FilterView<ViewOf<TRange>, TPredicate>(All(std::forward<TRange>(range)), mPredicate);
+            }
+
+        private:
+            TPredicate mPredicate;
+        };
+
+        template <typename TFunction>
+        class TransformAdaptor : public AdaptorBase
+        {
+        public:
+            explicit TransformAdaptor(const TFunction & function) : mFunction(function) {}
+
+            template <typename TRange>
+            TransformView<ViewOf<TRange>, TFunction> Apply(TRange && range) const
+            {
+                return TransformView<ViewOf<TRange>, TFunction>(All(std::forward<TRange>(range)), mFunction);
+            }
+
+        private:
+            TFunction mFunction;
+        };
+
+        // TakeView, DropView, StrideView and ChunkView only need a count.
+        template <template <typename> class TView>
+        class CountAdaptor : public AdaptorBase
+        {
+        public:
+            explicit CountAdaptor(xsize count) : mCount(count) {}
+
+            template <typename TRange>
+            TView<ViewOf<TRange> > Apply(TRange && range) const
+            {
+                return TView<ViewOf<TRange> >(All(std::forward<TRange>(range)), mCount);
+            }
+
+        private:
+            xsize mCount;
+        };
+
+        class EnumerateAdaptor : public AdaptorBase
+        {
+        public:
+            template <typename TRange>
+            EnumerateView<ViewOf<TRange> > Apply(TRange && range) const
+            {
+                return EnumerateView<ViewOf<TRange> >(All(std::forward<TRange>(range)));
+            }
+        };
+
+        template <typename TOther>
+        class ZipAdaptor : public AdaptorBase
+        {
+        public:
+            explicit ZipAdaptor(const TOther & other) : mOther(other) {}
+
+            template <typename TRange>
+            ZipView<ViewOf<TRange>, TOther> Apply(TRange && range) const
+            {
+                return ZipView<ViewOf<TRange>, TOther>(All(std::forward<TRange>(range)), mOther);
+            }
+
+        private:
+            TOther mOther;
+        };
+
+        template <typename TContainer>
+        class CollectAdaptor : public AdaptorBase
+        {
+        public:
+            template <typename TRange>
+            TContainer Apply(TRange && range) const
+            {
+                TContainer ans;
+                for (auto && value : range)
+                {
+                    ans.PushBack(value);
+                }
+
+                return ans;
+            }
+        };
+
+        template <template <typename...> class TContainer>
+        class ToAdaptor : public AdaptorBase
+        {
+        public:
+            template <typename TRange>
+            TContainer<typename ViewTraits<ViewOf<TRange> >::ValueType> Apply(TRange && range) const
+            {
+                return CollectAdaptor<TContainer<typename ViewTraits<ViewOf<TRange> >::ValueType> >().Apply(range);
+            }
+        };
+
+    } XC_END_NAMESPACE_1
+
+    template <typename TPredicate>
+    Details::FilterAdaptor<TPredicate> Filter(const TPredicate & predicate) { return Details::FilterAdaptor<TPredicate>(predicate); }
+
+    template <typename TFunction>
+    Details::TransformAdaptor<TFunction> Transform(const TFunction & function) { return Details::TransformAdaptor<TFunction>(function); }
+
+    inline Details::CountAdaptor<TakeView> Take(xsize count) { return Details::CountAdaptor<TakeView>(count); }
+    inline Details::CountAdaptor<DropView> Drop(xsize count) { return Details::CountAdaptor<DropView>(count); }
+    inline Details::CountAdaptor<StrideView> Stride(xsize step) { return Details::CountAdaptor<StrideView>(step); }
+    inline Details::CountAdaptor<ChunkView> Chunk(xsize count) { return Details::CountAdaptor<ChunkView>(count); }
+    inline Details::EnumerateAdaptor Enumerate() { return Details::EnumerateAdaptor(); }
+
+    template <typename TRange>
+    Details::ZipAdaptor<ViewOf<TRange> > Zip(TRange && other) { return Details::ZipAdaptor<ViewOf<TRange> >(All(std::forward<TRange>(other))); }
+
+    // Collecting is the only place where elements are copied.
+    template <typename TContainer>
+    Details::CollectAdaptor<TContainer> Collect() { return Details::CollectAdaptor<TContainer>(); }
+
+    // To<Array>() collects into an Array of the element type; any container template with PushBack
+    // whose other parameters have defaults will do, so views need not know the containers.
+    template <template <typename...> class TContainer>
+    Details::ToAdaptor<TContainer> To() { return Details::ToAdaptor<TContainer>(); }
+
+    template <typename TRange, typename TAdaptor,
+              typename = typename std::enable_if<std::is_base_of<AdaptorBase, TAdaptor>::value>::type>
+    auto operator | (TRange && range, const TAdaptor & adaptor) -> decltype(adaptor.Apply(std::forward<TRange>(range)))
+    {
+        return adaptor.Apply(std::forward<TRange>(range));
+    }
+
+} XC_END_NAMESPACE_2
@@ -9,12 +9,18 @@ namespace XC
 {
     template <typename T> class StandardAllocator;
     template <typename T, typename Allocator> class InsideAllocator;
-    template <typename T> class DefaultAllocator : public StandardAllocator<T> {};
+    template <typename T> class DefaultAllocator : public StandardAllocator<T>
+    {
+    public:
+        template <typename U> using Rebind = DefaultAllocator<U>;
+    };
 
     template <typename T>
     class StandardAllocator
     {
     public:
+        template <typename U> using Rebind = StandardAllocator<U>;
+
         static T * Allocate(xsize count) { return (T *)::operator new(count * sizeof(T)); }
         static T * Allocate() { return Allocate(1); }
         static void Deallocate(T * location) { ::operator delete(location); }
@@ -32,6 +38,22 @@ namespace XC
         static void Deallocate(T * location) { TAllocator::Deallocate(location); }
         static void Deallocate(T * location, xsize n) { if (n != 0) TAllocator::Deallocate(location, n); }
     };
+
+    // Gets the allocator of U that matches TAllocator, containers use it to allocate their nodes and maps.
+    // void stands for the default allocator.
+    template <typename TAllocator, typename U>
+    class AllocatorRebind
+    {
+    public:
+        using Type = typename TAllocator::template Rebind<U>;
+    };
+
+    template <typename U>
+    class AllocatorRebind<void, U>
+    {
+    public:
+        using Type = DefaultAllocator<U>;
+    };
 }
 
 #endif // XCALLOCATORS_H
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include "../Types/Types.h"
+#include "../SyntaxSugars/SyntaxSugars.h"
+
+XC_BEGIN_NAMESPACE_2(XC, Memories)
+{
+    // Base of objects that are freed through an EpochDomain.
+    class Reclaimable
+    {
+    public:
+        Reclaimable() : mRetiredNext(nullptr), mReclaim(nullptr) {}
+
+    public:
+        Reclaimable * mRetiredNext;
+        void (*mReclaim)(Reclaimable *);
+    };
+
+    // Epoch based reclamation for lock free containers.
+    // Every access to shared nodes happens inside an EpochGuard. A node that is no longer reachable is retired
+    // with the current epoch and freed once the global epoch is two ahead, at that point every guard that
+    // could have seen the node has been left. Nothing here takes a lock, a guard only claims a slot.
+    class EpochDomain
+    {
+    public:
+        static const xsize CountSlots = 256; // guards alive at the same time, across all threads
+        static const xsize Inactive = ~xsize(0);
+        static const xsize AdvanceInterval = 32; // retirements between two attempts, an attempt reads every slot
+
+    public:
+        EpochDomain() : mGlobalEpoch(0), mCountRetired(0)
+        {
+            for (xsize i = 0; i < CountSlots; ++i)
+            {
+                mSlots[i].mEpoch.store(Inactive, std::memory_order_relaxed);
+                mSlots[i].mInUse.store(false, std::memory_order_relaxed);
+            }
+
+            for (xsize i = 0; i < 3; ++i)
+            {
+                mRetired[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        // no guard may be alive any more
+        ~EpochDomain()
+        {
+            for (xsize i = 0; i < 3; ++i)
+            {
+                Reclaim(mRetired[i].exchange(nullptr));
+            }
+        }
+
+        EpochDomain(const EpochDomain &) = delete;
+        EpochDomain & operator = (const EpochDomain &) = delete;
+
+    public:
+        // throws when all CountSlots slots are taken, rather than waiting for a guard that may be this thread's own
+        xsize Enter()
+        {
+            xsize slot = std::hash<std::thread::id>()(std::this_thread::get_id()) % CountSlots;
+            for (xsize tried = 0; ; ++tried)
+            {
+                if (tried == CountSlots)
+                {
+                    throw "Too many epoch guards alive";
+                }
+
+                bool expected = false;
+                if (!mSlots[slot].mInUse.load(std::memory_order_relaxed) && mSlots[slot].mInUse.compare_exchange_strong(expected, true))
+                {
+                    break;
+                }
+
+                slot = (slot + 1) % CountSlots;
+            }
+
+            // publish the epoch, then check it did not move meanwhile
+            xsize epoch = mGlobalEpoch.load();
+            mSlots[slot].mEpoch.store(epoch);
+            while (mGlobalEpoch.load() != epoch)
+            {
+                epoch = mGlobalEpoch.load();
+                mSlots[slot].mEpoch.store(epoch);
+            }
+
+            return slot;
+        }
+
+        void Leave(xsize slot)
+        {
+            mSlots[slot].mEpoch.store(Inactive);
+            mSlots[slot].mInUse.store(false);
+        }
+
+        // object must be unreachable for new readers already, the caller holds a guard
+        void Retire(Reclaimable * object, void (*reclaim)(Reclaimable *))
+        {
+            object->mReclaim = reclaim;
+            xsize epoch = mGlobalEpoch.load();
+            std::atomic<Reclaimable *> & list = mRetired[epoch % 3];
+            object->mRetiredNext = list.load(std::memory_order_relaxed);
+            while (!list.compare_exchange_weak(object->mRetiredNext, object))
+            {
+            }
+
+            if (mCountRetired.fetch_add(1, std::memory_order_relaxed) % AdvanceInterval == 0)
+            {
+                TryAdvance();
+            }
+        }
+
+    private:
+        // Moves to the next epoch when every guard has seen the current one, then frees what was retired two epochs ago.
+        // Only Retire calls it, from inside the caller's guard, which keeps the epoch from moving twice during the scan.
+        bool TryAdvance()
+        {
+            xsize epoch = mGlobalEpoch.load();
+            for (xsize i = 0; i < CountSlots; ++i)
+            {
+                xsize observed = mSlots[i].mEpoch.load();
+                if (observed != Inactive && observed != epoch)
+                {
+                    return false;
+                }
+            }
+
+            if (!mGlobalEpoch.compare_exchange_strong(epoch, epoch + 1))
+            {
+                return false;
+            }
+
+            Reclaim(mRetired[(epoch + 2) % 3].exchange(nullptr));
+            return true;
+        }
+
+        static void Reclaim(Reclaimable * object)
+        {
+            while (object != nullptr)
+            {
+                Reclaimable * next = object->mRetiredNext;
+                object->mReclaim(object);
+                object = next;
+            }
+        }
+
+        class Slot
+        {
+        public:
+            std::atomic<xsize> mEpoch;
+            std::atomic<bool> mInUse;
+            char mPadding[64 - sizeof(std::atomic<xsize>) - sizeof(std::atomic<bool>)]; // one slot per cache line
+        };
+
+        std::atomic<xsize> mGlobalEpoch;
+        std::atomic<xsize> mCountRetired;
+        Slot mSlots[CountSlots];
+        std::atomic<Reclaimable *> mRetired[3];
+    };
+
+    class EpochGuard
+    {
+    public:
+        explicit EpochGuard(EpochDomain & domain) : mDomain(domain), mSlot(domain.Enter()) {}
+        ~EpochGuard() { mDomain.Leave(mSlot); }
+        EpochGuard(const EpochGuard &) = delete;
+        EpochGuard & operator = (const EpochGuard &) = delete;
+
+    private:
+        EpochDomain & mDomain;
+        xsize mSlot;
+    };
+
+} XC_END_NAMESPACE_2
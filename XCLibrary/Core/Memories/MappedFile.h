@@ -0,0 +1,287 @@
+#pragma once
+
+#include "../Types/Types.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+XC_BEGIN_NAMESPACE_2(XC, Memories)
+{
+    // A whole file mapped into memory. Writes through a ReadWrite mapping go to the file,
+    // Resize changes the length of the file and maps it again, so pointers into the old view become invalid.
+    class MappedFile
+    {
+    public:
+        enum class Mode
+        {
+            ReadOnly, // the file must exist
+            ReadWrite, // the file must exist
+            Create, // the file is created or truncated, then opened for ReadWrite
+        };
+
+    public:
+        MappedFile() :
+            mData(nullptr), mSize(0), mReadOnly(true)
+        {
+            ResetHandles();
+        }
+
+        ~MappedFile() { Close(); }
+        MappedFile(const MappedFile &) = delete;
+        MappedFile & operator = (const MappedFile &) = delete;
+
+    public:
+        bool IsOpen() const { return HasFile(); }
+        bool IsReadOnly() const { return mReadOnly; }
+        void * GetData() { return mData; }
+        const void * GetData() const { return mData; }
+        xsize GetSize() const { return mSize; }
+
+        bool Open(const char * path, Mode mode);
+        bool Resize(xsize size);
+        bool Flush();
+        void Close();
+
+    private:
+        bool HasFile() const;
+        void ResetHandles();
+        bool Map();
+        void Unmap();
+
+    private:
+#ifdef _WIN32
+        HANDLE mFile;
+        HANDLE mMapping;
+#else
+        int mFile;
+#endif
+        void * mData;
+        xsize mSize;
+        bool mReadOnly;
+    };
+
+#ifdef _WIN32
+
+    inline bool MappedFile::HasFile() const { return mFile != INVALID_HANDLE_VALUE; }
+    inline void MappedFile::ResetHandles() { mFile = INVALID_HANDLE_VALUE; mMapping = nullptr; }
+
+    inline bool MappedFile::Open(const char * path, Mode mode)
+    {
+        Close();
+        mReadOnly = mode == Mode::ReadOnly;
+        DWORD access = mReadOnly ? GENERIC_READ : GENERIC_READ | GENERIC_WRITE;
+        DWORD creation = mode == Mode::Create ? CREATE_ALWAYS : OPEN_EXISTING;
+        mFile = CreateFileA(path, access, FILE_SHARE_READ, nullptr, creation, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (mFile == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        if (!Map())
+        {
+            Close();
+            return false;
+        }
+
+        return true;
+    }
+
+    inline bool MappedFile::Map()
+    {
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(mFile, &size))
+        {
+            return false;
+        }
+
+        mSize = xsize(size.QuadPart);
+        if (mSize == 0)
+        {
+            return true; // an empty file cannot be mapped, mData stays nullptr
+        }
+
+        mMapping = CreateFileMappingA(mFile, nullptr, mReadOnly ? PAGE_READONLY : PAGE_READWRITE, 0, 0, nullptr);
+        if (mMapping == nullptr)
+        {
+            return false;
+        }
+
+        mData = MapViewOfFile(mMapping, mReadOnly ? FILE_MAP_READ : FILE_MAP_WRITE, 0, 0, 0);
+        return mData != nullptr;
+    }
+
+    inline void MappedFile::Unmap()
+    {
+        if (mData != nullptr)
+        {
+            UnmapViewOfFile(mData);
+            mData = nullptr;
+        }
+
+        if (mMapping != nullptr)
+        {
+            CloseHandle(mMapping);
+            mMapping = nullptr;
+        }
+
+        mSize = 0;
+    }
+
+    inline bool MappedFile::Resize(xsize size)
+    {
+        if (!HasFile() || mReadOnly)
+        {
+            return false;
+        }
+
+        Unmap();
+        LARGE_INTEGER position;
+        position.QuadPart = LONGLONG(size);
+        if (!SetFilePointerEx(mFile, position, nullptr, FILE_BEGIN) || !SetEndOfFile(mFile))
+        {
+            Map();
+            return false;
+        }
+
+        return Map();
+    }
+
+    inline bool MappedFile::Flush()
+    {
+        if (mData == nullptr || mReadOnly)
+        {
+            return true;
+        }
+
+        return FlushViewOfFile(mData, 0) && FlushFileBuffers(mFile);
+    }
+
+    inline void MappedFile::Close()
+    {
+        Unmap();
+        if (mFile != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(mFile);
+            mFile = INVALID_HANDLE_VALUE;
+        }
+    }
+
+#else
+
+    inline bool MappedFile::HasFile() const { return mFile >= 0; }
+    inline void MappedFile::ResetHandles() { mFile = -1; }
+
+    inline bool MappedFile::Open(const char * path, Mode mode)
+    {
+        Close();
+        mReadOnly = mode == Mode::ReadOnly;
+        int flags = mReadOnly ? O_RDONLY : O_RDWR;
+        if (mode == Mode::Create)
+        {
+            flags |= O_CREAT | O_TRUNC;
+        }
+
+        mFile = ::open(path, flags, 0644);
+        if (mFile < 0)
+        {
+            return false;
+        }
+
+        if (!Map())
+        {
+            Close();
+            return false;
+        }
+
+        return true;
+    }
+
+    inline bool MappedFile::Map()
+    {
+        struct stat status;
+        if (::fstat(mFile, &status) != 0)
+        {
+            return false;
+        }
+
+        mSize = xsize(status.st_size);
+        if (mSize == 0)
+        {
+            return true; // an empty file cannot be mapped, mData stays nullptr
+        }
+
+        int protection = mReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+        void * data = ::mmap(nullptr, mSize, protection, MAP_SHARED, mFile, 0);
+        if (data == MAP_FAILED)
+        {
+            mSize = 0;
+            return false;
+        }
+
+        mData = data;
+        return true;
+    }
+
+    inline void MappedFile::Unmap()
+    {
+        if (mData != nullptr)
+        {
+            ::munmap(mData, mSize);
+            mData = nullptr;
+        }
+
+        mSize = 0;
+    }
+
+    inline bool MappedFile::Resize(xsize size)
+    {
+        if (!HasFile() || mReadOnly)
+        {
+            return false;
+        }
+
+        Unmap();
+        if (::ftruncate(mFile, off_t(size)) != 0)
+        {
+            Map();
+            return false;
+        }
+
+        return Map();
+    }
+
+    inline bool MappedFile::Flush()
+    {
+        if (mData == nullptr || mReadOnly)
+        {
+            return true;
+        }
+
+        return ::msync(mData, mSize, MS_SYNC) == 0;
+    }
+
+    inline void MappedFile::Close()
+    {
+        Unmap();
+        if (mFile >= 0)
+        {
+            ::close(mFile);
+            mFile = -1;
+        }
+    }
+
+#endif
+
+} XC_END_NAMESPACE_2
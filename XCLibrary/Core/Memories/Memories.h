@@ -5,6 +5,8 @@
 #include "Construts.h"
 #include "Uninitializeds.h"
 #include "Initialized.h"
+#include "MemoryStatistics.h"
+#include "TrackingAllocator.h"
 
 XC_BEGIN_NAMESPACE_1(XC)
 {
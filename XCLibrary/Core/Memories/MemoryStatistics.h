@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include "../Types/Types.h"
+
+XC_BEGIN_NAMESPACE_2(XC, Memories)
+{
+    // A snapshot of how a container uses its memory, returned by GetMemoryStatistics().
+    // Capacity is counted in element slots, overhead is everything that is not a slot (maps, links, headers).
+    class MemoryStatistics
+    {
+    public:
+        MemoryStatistics() :
+            mCountElements(0), mCapacity(0), mCountNodes(0), mElementSize(0), mOverheadBytes(0)
+        {
+        }
+
+    public:
+        xsize GetPayloadBytes() const { return mCountElements * mElementSize; }
+        xsize GetReservedBytes() const { return mCapacity * mElementSize; }
+        xsize GetUnusedBytes() const { return GetReservedBytes() - GetPayloadBytes(); }
+        xsize GetTotalBytes() const { return GetReservedBytes() + mOverheadBytes; }
+
+    public:
+        xsize mCountElements; // elements stored
+        xsize mCapacity; // element slots allocated
+        xsize mCountNodes; // heap blocks owned: buffers for DEQueue, nodes for RBTree
+        xsize mElementSize; // sizeof one element
+        xsize mOverheadBytes; // bookkeeping bytes, not counting unused slots
+    };
+
+    // Counters of one allocation tag, shared by every TrackingAllocator with that tag.
+    class AllocationStatistics
+    {
+    public:
+        static const xsize CountBuckets = 32; // bucket i holds sizes in [2^i, 2^(i+1)), the last one holds the rest
+
+    public:
+        AllocationStatistics() { Reset(); }
+        AllocationStatistics(const AllocationStatistics &) = delete;
+        AllocationStatistics & operator = (const AllocationStatistics &) = delete;
+
+    public:
+        xsize GetLiveBytes() const { return mLiveBytes.load(std::memory_order_relaxed); }
+        xsize GetPeakBytes() const { return mPeakBytes.load(std::memory_order_relaxed); }
+        xsize GetCountAllocations() const { return mCountAllocations.load(std::memory_order_relaxed); }
+        xsize GetCountDeallocations() const { return mCountDeallocations.load(std::memory_order_relaxed); }
+        xsize GetCountLiveAllocations() const { return mCountLiveAllocations.load(std::memory_order_relaxed); }
+        xsize GetHistogram(xsize bucket) const { return mHistogram[bucket].load(std::memory_order_relaxed); }
+
+        static xsize GetBucketIndex(xsize bytes)
+        {
+            xsize bucket = 0;
+            while (bytes > 1 && bucket + 1 < CountBuckets)
+            {
+                bytes >>= 1;
+                ++bucket;
+            }
+
+            return bucket;
+        }
+
+        static xsize GetBucketLowerBound(xsize bucket)
+        {
+            return xsize(1) << bucket;
+        }
+
+        void RecordAllocation(xsize bytes)
+        {
+            mCountAllocations.fetch_add(1, std::memory_order_relaxed);
+            mCountLiveAllocations.fetch_add(1, std::memory_order_relaxed);
+            mHistogram[GetBucketIndex(bytes)].fetch_add(1, std::memory_order_relaxed);
+            xsize live = mLiveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+            xsize peak = mPeakBytes.load(std::memory_order_relaxed);
+            while (live > peak && !mPeakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        void RecordDeallocation(xsize bytes)
+        {
+            mCountDeallocations.fetch_add(1, std::memory_order_relaxed);
+            mCountLiveAllocations.fetch_sub(1, std::memory_order_relaxed);
+            mLiveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+        }
+
+        // Peak restarts from the bytes still alive, so a benchmark phase can be measured on its own.
+        // The live bytes and blocks are kept, as blocks allocated before a reset may be freed after it.
+        void Reset()
+        {
+            mPeakBytes.store(mLiveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            mCountAllocations.store(0, std::memory_order_relaxed);
+            mCountDeallocations.store(0, std::memory_order_relaxed);
+            for (xsize i = 0; i < CountBuckets; ++i)
+            {
+                mHistogram[i].store(0, std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        std::atomic<xsize> mLiveBytes { 0 };
+        std::atomic<xsize> mPeakBytes { 0 };
+        std::atomic<xsize> mCountAllocations { 0 };
+        std::atomic<xsize> mCountDeallocations { 0 };
+        std::atomic<xsize> mCountLiveAllocations { 0 };
+        std::atomic<xsize> mHistogram[CountBuckets];
+    };
+
+    // One AllocationStatistics per tag type.
+    template <typename TTag>
+    class AllocationTracker
+    {
+    public:
+        static AllocationStatistics & GetStatistics()
+        {
+            static AllocationStatistics statistics;
+            return statistics;
+        }
+    };
+
+} XC_END_NAMESPACE_2
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstring>
+#include "../Types/Types.h"
+#include "Allocators.h"
+#include "MemoryStatistics.h"
+
+XC_BEGIN_NAMESPACE_1(XC)
+{
+    // Wraps TAllocator and records every allocation in the statistics of TTag.
+    // The element count is stored in front of each block, so Deallocate(location) knows the size too.
+    // Rebind keeps the tag, so the nodes and maps of a container are counted together with it.
+    template <typename T, typename TAllocator = DefaultAllocator<T>, typename TTag = void>
+    class TrackingAllocator
+    {
+    public:
+        template <typename U> using Rebind = TrackingAllocator<U, typename AllocatorRebind<TAllocator, U>::Type, TTag>;
+
+    public:
+        static T * Allocate(xsize count)
+        {
+            T * base = (T *)TAllocator::Allocate(count + HeaderCount);
+            std::memcpy((void *)base, &count, sizeof(count));
+            GetStatistics().RecordAllocation(count * sizeof(T));
+            return base + HeaderCount;
+        }
+
+        static T * Allocate() { return Allocate(1); }
+
+        static void Deallocate(T * location)
+        {
+            if (location == nullptr)
+            {
+                return;
+            }
+
+            T * base = location - HeaderCount;
+            xsize count = 0;
+            std::memcpy(&count, (const void *)base, sizeof(count));
+            GetStatistics().RecordDeallocation(count * sizeof(T));
+            TAllocator::Deallocate(base, count + HeaderCount);
+        }
+
+        static void Deallocate(T * location, xsize n) { if (n != 0) Deallocate(location); }
+        static void Construct(T * location, const T & value) { Memories::Construct(location, value); }
+        static void Destroy(T * location) { Memories::Destroy(location); }
+
+        static Memories::AllocationStatistics & GetStatistics()
+        {
+            return Memories::AllocationTracker<TTag>::GetStatistics();
+        }
+
+    private:
+        static const xsize HeaderCount = (sizeof(xsize) + sizeof(T) - 1) / sizeof(T); // in elements, keeps T aligned
+    };
+
+} XC_END_NAMESPACE_1
@@ -0,0 +1,95 @@
+#include <cstdlib>
+#include <random>
+#include <Containers/Set.h>
+#include <Containers/BTreeSet.h>
+#include "Benchmark.h"
+
+using namespace XC;
+using namespace XC::Containers;
+
+XC_BEGIN_NAMESPACE_1(XC_BENCHMARK)
+{
+    static const xsize RangeLength = 64;
+
+    template <typename TSet>
+    void RunOrderedSet(const char * name, const Array<int> & keys, const Array<int> & queries)
+    {
+        TSet set;
+        long long checksum = 0;
+
+        Stopwatch insert;
+        for (int key : keys)
+        {
+            set.Insert(key);
+        }
+        Report(name, "insert", keys.GetSize(), insert.GetMilliseconds(), (long long)set.GetSize());
+
+        Stopwatch find;
+        checksum = 0;
+        for (int key : queries)
+        {
+            checksum += set.Contains(key) ? 1 : 0;
+        }
+        Report(name, "point lookup", queries.GetSize(), find.GetMilliseconds(), checksum);
+
+        Stopwatch iterate;
+        checksum = 0;
+        for (int key : set)
+        {
+            checksum += key;
+        }
+        Report(name, "ordered scan", set.GetSize(), iterate.GetMilliseconds(), checksum);
+
+        Stopwatch range;
+        checksum = 0;
+        for (int key : queries)
+        {
+            auto itr = set.GetLowerBound(key);
+            for (xsize i = 0; i < RangeLength && itr != set.GetEnd(); ++i, ++itr)
+            {
+                checksum += *itr;
+            }
+        }
+        Report(name, "range query 64", queries.GetSize(), range.GetMilliseconds(), checksum);
+
+        Memories::MemoryStatistics statistics = set.GetMemoryStatistics();
+        std::printf("%-12s %-16s %10zu bytes\n", name, "memory", (size_t)statistics.GetTotalBytes());
+
+        Stopwatch erase;
+        checksum = 0;
+        for (int key : queries)
+        {
+            checksum += (long long)set.Erase(key);
+        }
+        Report(name, "erase", queries.GetSize(), erase.GetMilliseconds(), checksum);
+    }
+
+    void RunBTreeBenchmark(xsize count)
+    {
+        std::mt19937 random(20161);
+        std::uniform_int_distribution<int> distribution(0, int(count * 4));
+        Array<int> keys;
+        Array<int> queries;
+        for (xsize i = 0; i < count; ++i)
+        {
+            keys.PushBack(distribution(random));
+            queries.PushBack(distribution(random));
+        }
+
+        std::printf("ordered set benchmark, %zu random keys\n", (size_t)count);
+        RunOrderedSet<Set<int> >("RBTree", keys, queries);
+        RunOrderedSet<BTreeSet<int> >("BTree", keys, queries);
+
+        Array<int> sorted;
+        for (xsize i = 0; i < count; ++i)
+        {
+            sorted.PushBack(int(i * 2));
+        }
+
+        BTreeSet<int> bulk;
+        Stopwatch load;
+        bulk.Assign(sorted.GetBegin(), sorted.GetEnd());
+        Report("BTree", "bulk load", count, load.GetMilliseconds(), (long long)bulk.GetSize());
+    }
+
+} XC_END_NAMESPACE_1
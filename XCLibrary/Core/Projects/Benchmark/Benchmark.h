@@ -0,0 +1,40 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <Types/Types.h>
+#include <SyntaxSugars/SyntaxSugars.h>
+
+XC_BEGIN_NAMESPACE_1(XC_BENCHMARK)
+{
+    class Stopwatch
+    {
+    public:
+        Stopwatch() : mStart(std::chrono::steady_clock::now()) {}
+
+    public:
+        double GetMilliseconds() const
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - mStart).count();
+        }
+
+    private:
+        std::chrono::steady_clock::time_point mStart;
+    };
+
+    // One line per measurement, the checksum keeps the measured work from being optimized away.
+    inline void Report(const char * container, const char * operation, XC::xsize count, double milliseconds, long long checksum)
+    {
+        std::printf("%-12s %-16s %10zu ops %10.2f ms %8.1f ns/op  (checksum %lld)\n",
+            container, operation, (size_t)count, milliseconds, milliseconds * 1e6 / double(count == 0 ? 1 : count), checksum);
+    }
+
+    void RunBTreeBenchmark(XC::xsize count);
+
+    // Runs the same insert, find, iterate, range and erase phases on XC RBTree, Xc::RedBlackTree, Xc::AVLTree
+    // and std::set, for four key orders and sizes from 1000 up to count, and prints Mops/s and heap bytes per element.
+    // After every phase each tree is checked: red black rules or AVL balance, parent links, order and size.
+    // Returns false when a check failed.
+    bool RunTreeComparison(XC::xsize count);
+
+} XC_END_NAMESPACE_1
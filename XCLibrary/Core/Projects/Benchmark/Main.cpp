@@ -0,0 +1,22 @@
+#include <cstdlib>
+#include <cstring>
+#include "Benchmark.h"
+
+// Benchmark [count] [btree | trees], runs both when no benchmark is named.
+int main(int argc, char * argv[])
+{
+    XC::xsize count = argc > 1 ? XC::xsize(std::atoll(argv[1])) : 1000000;
+    const char * benchmark = argc > 2 ? argv[2] : "";
+    bool valid = true;
+    if (std::strcmp(benchmark, "trees") != 0)
+    {
+        XC_BENCHMARK::RunBTreeBenchmark(count);
+    }
+
+    if (std::strcmp(benchmark, "btree") != 0)
+    {
+        valid = XC_BENCHMARK::RunTreeComparison(count);
+    }
+
+    return valid ? 0 : 1;
+}
@@ -0,0 +1,588 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <initializer_list>
+#include <new>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include <Containers/RBTree.h>
+#include <Functors/Functors.h>
+#include <AVLTree.h>
+#include <RedBlackTree.h>
+#include "Benchmark.h"
+
+using namespace XC;
+using namespace XC::Containers;
+
+// Every allocation of the benchmark goes through here, so the memory of the trees that allocate with plain new,
+// the Algorithms trees and std::set, is measured the same way as the memory of XC RBTree.
+// Only requested bytes are counted, not what the heap adds per block.
+namespace
+{
+    const std::size_t HeapHeader = alignof(std::max_align_t) > sizeof(std::size_t) ? alignof(std::max_align_t) : sizeof(std::size_t);
+    long long gLiveHeapBytes = 0;
+}
+
+void * operator new(std::size_t bytes)
+{
+    char * block = (char *)std::malloc(bytes + HeapHeader);
+    if (block == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    *(std::size_t *)block = bytes;
+    gLiveHeapBytes += (long long)bytes;
+    return block + HeapHeader;
+}
+
+void operator delete(void * location) noexcept
+{
+    if (location == nullptr)
+    {
+        return;
+    }
+
+    char * block = (char *)location - HeapHeader;
+    gLiveHeapBytes -= (long long)*(std::size_t *)block;
+    std::free(block);
+}
+
+// The array and sized forms would otherwise go to the default heap, which does not know the header.
+void * operator new[](std::size_t bytes)
+{
+    return operator new(bytes);
+}
+
+void operator delete[](void * location) noexcept
+{
+    operator delete(location);
+}
+
+void operator delete(void * location, std::size_t) noexcept
+{
+    operator delete(location);
+}
+
+void operator delete[](void * location, std::size_t) noexcept
+{
+    operator delete(location);
+}
+
+XC_BEGIN_NAMESPACE_1(XC_BENCHMARK)
+{
+    static const xsize RangeLength = 64;
+
+    enum Phase
+    {
+        PhaseInsert, PhaseFind, PhaseIterate, PhaseRange, PhaseEraseHalf, PhaseEraseRest, CountPhases,
+    };
+
+    static const char * const PhaseNames[CountPhases] = { "insert", "find", "iterate", "range 64", "erase half", "erase rest" };
+
+    // The four trees differ in names, return types and in how their nodes can be reached,
+    // these adapters give them one shape. Each owns its tree.
+    // CheckShape walks the nodes and checks what the tree promises about its shape,
+    // the order and the size are checked for all of them by the caller through an ordered scan.
+
+    class XCRBTreeAdapter
+    {
+    public:
+        using Tree = Containers::Details::RBTree<int, int, Functors::Identity<int>, Functors::Less<int> >;
+        using Node = Tree::Node;
+
+    public:
+        static const char * GetName() { return "XC RBTree"; }
+        void Insert(int key) { mTree.InsertUnique(key); }
+        bool Contains(int key) const { return mTree.Contains(key); }
+        void Erase(int key) { mTree.Erase(key); }
+        xsize GetSize() const { return mTree.GetSize(); }
+
+        template <typename TVisitor>
+        void Iterate(TVisitor visit)
+        {
+            for (Tree::Iterator itr = mTree.GetBegin(); itr != mTree.GetEnd(); ++itr)
+            {
+                visit(*itr);
+            }
+        }
+
+        template <typename TVisitor>
+        void Range(int key, TVisitor visit)
+        {
+            Tree::Iterator itr = mTree.GetLowerBound(key);
+            for (xsize i = 0; i < RangeLength && itr != mTree.GetEnd(); ++i, ++itr)
+            {
+                visit(*itr);
+            }
+        }
+
+        const char * CheckShape() const
+        {
+            Node * root = mTree.GetRoot();
+            if (root == nullptr)
+            {
+                return mTree.GetMostLeft() == mTree.mHeader && mTree.GetMostRight() == mTree.mHeader ? nullptr : "empty tree with stale extremes";
+            }
+
+            if (root->mParent != mTree.mHeader || root->mColor != Containers::Details::RBTreeColorType::Black)
+            {
+                return "root is red or not linked to the header";
+            }
+
+            if (mTree.GetMostLeft() != root->GetMinimum() || mTree.GetMostRight() != root->GetMaximum())
+            {
+                return "header does not point at the extremes";
+            }
+
+            return GetBlackHeight(root) < 0 ? "red node with a red child, black heights differ or broken parent" : nullptr;
+        }
+
+    private:
+        // -1 when the subtree breaks a rule
+        static int GetBlackHeight(const Node * node)
+        {
+            if (node == nullptr)
+            {
+                return 1;
+            }
+
+            for (const Node * child : { node->mLeft, node->mRight })
+            {
+                if (child != nullptr && (child->mParent != node || (node->mColor == Containers::Details::RBTreeColorType::Red && child->mColor == Containers::Details::RBTreeColorType::Red)))
+                {
+                    return -1;
+                }
+            }
+
+            int left = GetBlackHeight(node->mLeft);
+            int right = GetBlackHeight(node->mRight);
+            if (left < 0 || left != right)
+            {
+                return -1;
+            }
+
+            return left + (node->mColor == Containers::Details::RBTreeColorType::Black ? 1 : 0);
+        }
+
+    private:
+        Tree mTree;
+    };
+
+    class RedBlackTreeAdapter
+    {
+    public:
+        using Tree = Xc::RedBlackTree<int>;
+        using Node = Tree::Node;
+
+    public:
+        static const char * GetName() { return "Xc::RedBlackTree"; }
+        void Insert(int key) { mTree.insert(key); }
+        bool Contains(int key) const { return mTree.isExist(key); }
+        void Erase(int key) { mTree.erase(key); }
+        xsize GetSize() const { return xsize(mTree.size()); }
+
+        template <typename TVisitor>
+        void Iterate(TVisitor visit)
+        {
+            for (Tree::Iterator itr = mTree.begin(); itr != mTree.end(); ++itr)
+            {
+                visit(*itr);
+            }
+        }
+
+        template <typename TVisitor>
+        void Range(int key, TVisitor visit)
+        {
+            Tree::Iterator itr = mTree.lowerBound(key);
+            for (xsize i = 0; i < RangeLength && itr != mTree.end(); ++i, ++itr)
+            {
+                visit(*itr);
+            }
+        }
+
+        const char * CheckShape()
+        {
+            Node * root = mTree.UNSAFERoot();
+            if (root == nullptr)
+            {
+                return nullptr;
+            }
+
+            if (root->mParent != nullptr || root->mColor != Node::BLACK)
+            {
+                return "root is red or has a parent";
+            }
+
+            return GetBlackHeight(root) < 0 ? "red node with a red child, black heights differ, broken parent or duplicate count" : nullptr;
+        }
+
+    private:
+        static int GetBlackHeight(const Node * node)
+        {
+            if (node == nullptr)
+            {
+                return 1;
+            }
+
+            if (node->mTimes != 1)
+            {
+                return -1;
+            }
+
+            for (const Node * child : { node->mLeft, node->mRight })
+            {
+                if (child != nullptr && (child->mParent != node || (node->mColor == Node::RED && child->mColor == Node::RED)))
+                {
+                    return -1;
+                }
+            }
+
+            int left = GetBlackHeight(node->mLeft);
+            int right = GetBlackHeight(node->mRight);
+            if (left < 0 || left != right)
+            {
+                return -1;
+            }
+
+            return left + (node->mColor == Node::BLACK ? 1 : 0);
+        }
+
+    private:
+        Tree mTree;
+    };
+
+    class AVLTreeAdapter
+    {
+    public:
+        using Tree = Xc::AVLTree<int>;
+        using Node = Tree::Node;
+
+    public:
+        static const char * GetName() { return "Xc::AVLTree"; }
+        void Insert(int key) { mTree.insert(key); }
+        bool Contains(int key) const { return mTree.count(key) != 0; }
+        void Erase(int key) { mTree.erase(key); }
+        xsize GetSize() const { return xsize(mTree.size()); }
+
+        template <typename TVisitor>
+        void Iterate(TVisitor visit)
+        {
+            for (Tree::Iterator itr = mTree.begin(); itr != mTree.end(); ++itr)
+            {
+                visit(*itr);
+            }
+        }
+
+        template <typename TVisitor>
+        void Range(int key, TVisitor visit)
+        {
+            Tree::Iterator itr = mTree.lowerBound(key);
+            for (xsize i = 0; i < RangeLength && itr != mTree.end(); ++i, ++itr)
+            {
+                visit(*itr);
+            }
+        }
+
+        const char * CheckShape() const
+        {
+            Node * root = mTree.root();
+            if (root != nullptr && root->father != nullptr)
+            {
+                return "root has a father";
+            }
+
+            return GetHeight(root) < -1 ? "unbalanced node, stale height, broken father or duplicate count" : nullptr;
+        }
+
+    private:
+        // -2 when the subtree breaks a rule, the height of an empty subtree is -1 as in AVLTree
+        static int GetHeight(const Node * node)
+        {
+            if (node == nullptr)
+            {
+                return -1;
+            }
+
+            if (node->count != 1)
+            {
+                return -2;
+            }
+
+            for (const Node * child : { node->left, node->right })
+            {
+                if (child != nullptr && child->father != node)
+                {
+                    return -2;
+                }
+            }
+
+            int left = GetHeight(node->left);
+            int right = GetHeight(node->right);
+            if (left < -1 || right < -1 || left - right > 1 || right - left > 1)
+            {
+                return -2;
+            }
+
+            int height = 1 + (left > right ? left : right);
+            return node->height == height ? height : -2;
+        }
+
+    private:
+        Tree mTree;
+    };
+
+    class StdSetAdapter
+    {
+    public:
+        using Tree = std::set<int>;
+
+    public:
+        static const char * GetName() { return "std::set"; }
+        void Insert(int key) { mTree.insert(key); }
+        bool Contains(int key) const { return mTree.find(key) != mTree.end(); }
+        void Erase(int key) { mTree.erase(key); }
+        xsize GetSize() const { return xsize(mTree.size()); }
+
+        template <typename TVisitor>
+        void Iterate(TVisitor visit)
+        {
+            for (int key : mTree)
+            {
+                visit(key);
+            }
+        }
+
+        template <typename TVisitor>
+        void Range(int key, TVisitor visit)
+        {
+            Tree::const_iterator itr = mTree.lower_bound(key);
+            for (xsize i = 0; i < RangeLength && itr != mTree.end(); ++i, ++itr)
+            {
+                visit(*itr);
+            }
+        }
+
+        const char * CheckShape() const { return nullptr; } // the shape is the standard library's business
+
+    private:
+        Tree mTree;
+    };
+
+    struct Workload
+    {
+        const char * mName;
+        std::vector<int> mKeys; // distinct and even, in insertion order
+        std::vector<int> mQueries; // uniform over the key range, about half of them miss
+        std::vector<int> mErasures; // the keys in a random order
+    };
+
+    struct Result
+    {
+        double mOpsPerSecond[CountPhases];
+        double mBytesPerElement;
+        bool mValid;
+    };
+
+    template <typename TAdapter>
+    static bool Validate(TAdapter & adapter, xsize expectedSize, Phase phase)
+    {
+        const char * failure = adapter.CheckShape();
+        if (failure == nullptr)
+        {
+            xsize count = 0;
+            long long previous = -1;
+            adapter.Iterate([&](int key)
+            {
+                if (key <= previous)
+                {
+                    failure = "ordered scan is not strictly increasing";
+                }
+
+                previous = key;
+                ++count;
+            });
+
+            if (failure == nullptr && (count != expectedSize || adapter.GetSize() != expectedSize))
+            {
+                failure = "wrong number of elements";
+            }
+        }
+
+        if (failure != nullptr)
+        {
+            std::printf("INVALID %s after %s: %s\n", TAdapter::GetName(), PhaseNames[phase], failure);
+        }
+
+        return failure == nullptr;
+    }
+
+    static double GetOpsPerSecond(xsize count, double milliseconds)
+    {
+        return double(count) * 1000.0 / (milliseconds > 0 ? milliseconds : 1e-3);
+    }
+
+    // Every phase is timed on its own and followed by a validation, which is not timed.
+    template <typename TAdapter>
+    static Result RunTree(const Workload & workload, long long & checksum)
+    {
+        Result result;
+        result.mValid = true;
+        xsize size = workload.mKeys.size();
+        xsize half = size / 2;
+        long long heapBefore = gLiveHeapBytes;
+        TAdapter * adapter = new TAdapter;
+
+        Stopwatch insert;
+        for (int key : workload.mKeys)
+        {
+            adapter->Insert(key);
+        }
+        result.mOpsPerSecond[PhaseInsert] = GetOpsPerSecond(size, insert.GetMilliseconds());
+        result.mBytesPerElement = double(gLiveHeapBytes - heapBefore) / double(size == 0 ? 1 : size);
+        result.mValid &= Validate(*adapter, size, PhaseInsert);
+
+        Stopwatch find;
+        for (int key : workload.mQueries)
+        {
+            checksum += adapter->Contains(key) ? 1 : 0;
+        }
+        result.mOpsPerSecond[PhaseFind] = GetOpsPerSecond(workload.mQueries.size(), find.GetMilliseconds());
+        result.mValid &= Validate(*adapter, size, PhaseFind);
+
+        Stopwatch iterate;
+        adapter->Iterate([&](int key) { checksum += key; });
+        result.mOpsPerSecond[PhaseIterate] = GetOpsPerSecond(size, iterate.GetMilliseconds());
+        result.mValid &= Validate(*adapter, size, PhaseIterate);
+
+        Stopwatch range;
+        for (int key : workload.mQueries)
+        {
+            adapter->Range(key, [&](int value) { checksum += value; });
+        }
+        result.mOpsPerSecond[PhaseRange] = GetOpsPerSecond(workload.mQueries.size(), range.GetMilliseconds());
+        result.mValid &= Validate(*adapter, size, PhaseRange);
+
+        Stopwatch eraseHalf;
+        for (xsize i = 0; i < half; ++i)
+        {
+            adapter->Erase(workload.mErasures[i]);
+        }
+        result.mOpsPerSecond[PhaseEraseHalf] = GetOpsPerSecond(half, eraseHalf.GetMilliseconds());
+        result.mValid &= Validate(*adapter, size - half, PhaseEraseHalf);
+
+        Stopwatch eraseRest;
+        for (xsize i = half; i < size; ++i)
+        {
+            adapter->Erase(workload.mErasures[i]);
+        }
+        result.mOpsPerSecond[PhaseEraseRest] = GetOpsPerSecond(size - half, eraseRest.GetMilliseconds());
+        result.mValid &= Validate(*adapter, 0, PhaseEraseRest);
+
+        delete adapter;
+        return result;
+    }
+
+    template <typename TAdapter>
+    static bool RunAndPrint(const Workload & workload)
+    {
+        long long checksum = 0;
+        Result result = RunTree<TAdapter>(workload, checksum);
+        std::printf("%-18s", TAdapter::GetName());
+        for (double opsPerSecond : result.mOpsPerSecond)
+        {
+            std::printf(" %10.2f", opsPerSecond / 1e6);
+        }
+        std::printf(" %10.1f  %s (checksum %lld)\n", result.mBytesPerElement, result.mValid ? "valid" : "INVALID", checksum);
+        return result.mValid;
+    }
+
+    // Distinct even keys 0, 2, ..., 2 (size - 1) in the order named by the workload.
+    static Workload MakeWorkload(const char * name, xsize size, std::mt19937 & random)
+    {
+        Workload workload;
+        workload.mName = name;
+        for (xsize i = 0; i < size; ++i)
+        {
+            workload.mKeys.push_back(int(i * 2));
+        }
+
+        std::string order = name;
+        if (order == "random")
+        {
+            std::shuffle(workload.mKeys.begin(), workload.mKeys.end(), random);
+        }
+        else if (order == "descending")
+        {
+            std::reverse(workload.mKeys.begin(), workload.mKeys.end());
+        }
+        else if (order == "clustered") // ascending runs of 256 keys, the runs in random order
+        {
+            const xsize RunLength = 256;
+            std::vector<xsize> runs;
+            for (xsize start = 0; start < size; start += RunLength)
+            {
+                runs.push_back(start);
+            }
+
+            std::shuffle(runs.begin(), runs.end(), random);
+            workload.mKeys.clear();
+            for (xsize start : runs)
+            {
+                for (xsize i = start; i < start + RunLength && i < size; ++i)
+                {
+                    workload.mKeys.push_back(int(i * 2));
+                }
+            }
+        }
+
+        std::uniform_int_distribution<int> distribution(0, int(size * 2));
+        for (xsize i = 0; i < size; ++i)
+        {
+            workload.mQueries.push_back(distribution(random));
+        }
+
+        workload.mErasures = workload.mKeys;
+        std::shuffle(workload.mErasures.begin(), workload.mErasures.end(), random);
+        return workload;
+    }
+
+    bool RunTreeComparison(xsize count)
+    {
+        static const char * const Orders[] = { "random", "ascending", "descending", "clustered" };
+        std::mt19937 random(20171);
+        bool valid = true;
+
+        std::vector<xsize> sizes;
+        for (xsize size = 1000; size < count; size *= 100)
+        {
+            sizes.push_back(size);
+        }
+        sizes.push_back(count);
+
+        for (xsize size : sizes)
+        {
+            for (const char * order : Orders)
+            {
+                Workload workload = MakeWorkload(order, size, random);
+                std::printf("\n%s keys, %zu elements, Mops/s\n%-18s", order, (size_t)size, "tree");
+                for (const char * phase : PhaseNames)
+                {
+                    std::printf(" %10s", phase);
+                }
+                std::printf(" %10s\n", "bytes/elem");
+
+                valid &= RunAndPrint<XCRBTreeAdapter>(workload);
+                valid &= RunAndPrint<RedBlackTreeAdapter>(workload);
+                valid &= RunAndPrint<AVLTreeAdapter>(workload);
+                valid &= RunAndPrint<StdSetAdapter>(workload);
+            }
+        }
+
+        std::printf("\n%s\n", valid ? "all invariants held" : "SOME INVARIANTS FAILED");
+        return valid;
+    }
+
+} XC_END_NAMESPACE_1
@@ -0,0 +1,93 @@
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <Core.h>
+#include <Containers/ConcurrentSkipList.h>
+
+// Kept out of ConcurrentSkipList.h, as it starts threads: every binary including the header would run
+// them while starting.
+XC_BEGIN_NAMESPACE_1(XC_CONCURRENT_SKIP_LIST_TEST)
+{
+    XC_TEST_CASE(CONCURRENT_SET_TEST)
+    {
+        const int countThreads = 4;
+        const int countKeys = 4000;
+        XC::Containers::ConcurrentSet<int> set;
+        std::atomic<int> countInserted(0);
+
+        // every thread inserts all keys, then erases its share of the odd ones, so the threads race on every key
+        std::thread threads[countThreads];
+        for (int t = 0; t < countThreads; ++t)
+        {
+            threads[t] = std::thread([&set, &countInserted, t, countKeys, countThreads]()
+            {
+                for (int i = 0; i < countKeys; ++i)
+                {
+                    set.Insert(i);
+                }
+
+                ++countInserted;
+                while (countInserted.load() != countThreads)
+                {
+                    std::this_thread::yield();
+                }
+
+                for (int i = 2 * t + 1; i < countKeys; i += 2 * countThreads)
+                {
+                    while (!set.Erase(i))
+                    {
+                    }
+                }
+            });
+        }
+
+        for (int t = 0; t < countThreads; ++t)
+        {
+            threads[t].join();
+        }
+
+        XC::Array<int> snapshot = set.GetSnapshot();
+        XC_TEST_ASSERT(set.GetSize() == countKeys / 2 && snapshot.GetSize() == countKeys / 2);
+        for (XC::xsize i = 0; i < snapshot.GetSize(); ++i)
+        {
+            XC_TEST_ASSERT(snapshot[i] == int(i * 2));
+        }
+
+        XC_TEST_ASSERT(set.Contains(0) && !set.Contains(1) && !set.Insert(2) && set.Erase(2) && !set.Contains(2));
+
+        XC::Containers::ConcurrentMap<int, double> map;
+        double value = 0;
+        XC_TEST_ASSERT(map.Insert(1, 0.5) && !map.Insert(1, 2.0) && map.Find(1, value) && value == 0.5);
+        XC_TEST_ASSERT(!map.Find(2, value));
+    }
+
+    // One guard more than there are slots fails instead of waiting for a slot forever.
+    XC_TEST_CASE(EPOCH_GUARD_TEST)
+    {
+        typedef XC::Memories::EpochDomain EpochDomain;
+        typedef XC::Memories::EpochGuard EpochGuard;
+
+        std::unique_ptr<EpochDomain> domain(new EpochDomain());
+        std::unique_ptr<EpochGuard> guards[EpochDomain::CountSlots];
+        for (XC::xsize i = 0; i < EpochDomain::CountSlots; ++i)
+        {
+            guards[i].reset(new EpochGuard(*domain));
+        }
+
+        bool thrown = false;
+        try
+        {
+            EpochGuard guard(*domain);
+        }
+        catch (const char * message)
+        {
+            thrown = std::strcmp(message, "Too many epoch guards alive") == 0;
+        }
+        XC_TEST_ASSERT(thrown);
+
+        guards[7].reset();
+        EpochGuard guard(*domain);
+    }
+
+} XC_END_NAMESPACE_1
@@ -0,0 +1,115 @@
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <Core.h>
+#include <Containers/MappedArray.h>
+
+// Kept out of MappedArray.h, as it writes a file: every binary including the header would make one
+// while starting.
+XC_TEST_CASE(MAPPED_ARRAY_TEST)
+{
+    const char * path = "XC_MAPPED_ARRAY_TEST.bin";
+
+    {
+        XC::MappedArray<int> table;
+        XC_TEST_ASSERT(table.Create(path));
+        XC_TEST_ASSERT(!table.PopBack());
+        for (int i = 0; i < 1000; ++i)
+        {
+            XC_TEST_ASSERT(table.PushBack(i * i));
+        }
+        XC_TEST_ASSERT(table.GetSize() == 1000 && table.GetCapacity() >= 1000);
+        XC_TEST_ASSERT(table.PushBack(-2) && table.PopBack() && table.GetSize() == 1000);
+    }
+
+    {
+        XC::Array<int> array;
+        XC_TEST_ASSERT(XC::Serialization::LoadFile(path, array));
+        XC_TEST_ASSERT(array.GetSize() == 1000 && array[999] == 999 * 999);
+
+        array.PushBack(-1);
+        XC_TEST_ASSERT(XC::Serialization::SaveFile(path, array));
+    }
+
+    {
+        XC::MappedArray<int> table;
+        XC_TEST_ASSERT(table.Open(path));
+        XC_TEST_ASSERT(table.GetSize() == 1001 && table[10] == 100 && table.GetBack() == -1);
+        XC_TEST_ASSERT(!table.PushBack(0) && !table.PopBack());
+
+        XC::MappedArray<double> wrongType;
+        XC_TEST_ASSERT(!wrongType.Open(path));
+    }
+
+    {
+        XC::Containers::Set<int> set;
+        XC::DEQueue<int> queue;
+        for (int i = 0; i < 100; ++i)
+        {
+            set.Insert((i * 37) % 100);
+            queue.PushFront(i);
+        }
+        XC_TEST_ASSERT(XC::Serialization::SaveFile(path, set));
+
+        XC::Containers::Set<int> loadedSet;
+        XC_TEST_ASSERT(XC::Serialization::LoadFile(path, loadedSet));
+        XC_TEST_ASSERT(loadedSet.GetSize() == 100 && loadedSet.Contains(99) && *loadedSet.GetBegin() == 0);
+
+        XC_TEST_ASSERT(XC::Serialization::SaveFile(path, queue));
+        XC::DEQueue<int> loadedQueue;
+        XC_TEST_ASSERT(XC::Serialization::LoadFile(path, loadedQueue));
+        XC_TEST_ASSERT(loadedQueue.GetSize() == 100 && loadedQueue.GetFront() == 99 && loadedQueue.GetBack() == 0);
+    }
+
+    std::remove(path);
+}
+
+// Reads a string and cannot seek, as a pipe.
+class PipeBuffer : public std::streambuf
+{
+public:
+    explicit PipeBuffer(std::string & bytes)
+    {
+        setg(&bytes[0], &bytes[0], &bytes[0] + bytes.size());
+    }
+};
+
+// A count larger than the payload, or one whose size overflows, fails the load before allocating.
+XC_TEST_CASE(SNAPSHOT_COUNT_TEST)
+{
+    std::uint64_t counts[] = { 5, std::uint64_t(1) << 40, ~std::uint64_t(0) };
+    for (std::uint64_t count : counts)
+    {
+        XC::Serialization::SnapshotHeader header(sizeof(int), 0);
+        header.mCount = count;
+        int payload[4] = { 1, 2, 3, 4 };
+        std::string bytes((const char *)&header, sizeof(header));
+        bytes.append((const char *)payload, sizeof(payload));
+
+        std::istringstream stream(bytes);
+        XC::Array<int> array;
+        array.PushBack(7);
+        XC_TEST_ASSERT(!XC::Serialization::Load(stream, array) && array.IsEmpty());
+
+        std::istringstream queueStream(bytes);
+        XC::DEQueue<int> queue;
+        XC_TEST_ASSERT(!XC::Serialization::Load(queueStream, queue) && queue.IsEmpty());
+
+        PipeBuffer pipe(bytes);
+        std::istream pipeStream(&pipe);
+        XC_TEST_ASSERT(!XC::Serialization::Load(pipeStream, array) && array.IsEmpty());
+    }
+
+    XC::Serialization::SnapshotHeader header(sizeof(int), 4);
+    int payload[4] = { 1, 2, 3, 4 };
+    std::string bytes((const char *)&header, sizeof(header));
+    bytes.append((const char *)payload, sizeof(payload));
+    std::istringstream stream(bytes);
+    XC::Array<int> array;
+    XC_TEST_ASSERT(XC::Serialization::Load(stream, array) && array.GetSize() == 4 && array[3] == 4);
+
+    PipeBuffer pipe(bytes);
+    std::istream pipeStream(&pipe);
+    XC_TEST_ASSERT(XC::Serialization::Load(pipeStream, array) && array.GetSize() == 4 && array[3] == 4);
+}
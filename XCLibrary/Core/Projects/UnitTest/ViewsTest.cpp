@@ -0,0 +1,67 @@
+#include <Core.h>
+
+// Kept out of Views.h, which knows no containers besides what it is handed.
+XC_BEGIN_NAMESPACE_1(XC_VIEWS_TEST)
+{
+    XC_TEST_CASE(VIEWS_TEST)
+    {
+        using namespace XC;
+
+        Array<int> arr;
+        List<int> list;
+        DEQueue<int> queue;
+        for (int i = 0; i < 10; ++i)
+        {
+            arr.PushBack(i);
+            list.PushBack(i * 10);
+            queue.PushBack(i * 100);
+        }
+
+        Array<int> odds = arr | Views::Filter([](int x) { return x % 2 == 1; })
+                              | Views::Transform([](int x) { return x * x; })
+                              | Views::To<Array>();
+        XC_TEST_ASSERT(odds.GetSize() == 5 && odds[0] == 1 && odds[4] == 81);
+
+        List<int> firsts = queue | Views::Take(3) | Views::To<List>();
+        XC_TEST_ASSERT(firsts.GetSize() == 3 && firsts.GetBack() == 200);
+
+        int sum = 0;
+        for (int x : list | Views::Drop(2) | Views::Take(3))
+        {
+            sum += x;
+        }
+        XC_TEST_ASSERT(sum == 20 + 30 + 40);
+
+        sum = 0;
+        for (int x : queue | Views::Stride(3))
+        {
+            sum += x;
+        }
+        XC_TEST_ASSERT(sum == 0 + 300 + 600 + 900);
+
+        xsize countChunks = 0;
+        xsize lastChunkSize = 0;
+        for (auto chunk : arr | Views::Chunk(4))
+        {
+            ++countChunks;
+            lastChunkSize = 0;
+            for (int x : chunk)
+            {
+                lastChunkSize += x >= 0;
+            }
+        }
+        XC_TEST_ASSERT(countChunks == 3 && lastChunkSize == 2);
+
+        for (auto pair : arr | Views::Take(4) | Views::Zip(list))
+        {
+            pair.mFirst += pair.mSecond; // references reach the containers
+        }
+        XC_TEST_ASSERT(arr[3] == 33 && arr[4] == 4);
+
+        for (auto pair : list | Views::Enumerate())
+        {
+            XC_TEST_ASSERT(pair.mSecond == int(pair.mFirst) * 10);
+        }
+    }
+
+} XC_END_NAMESPACE_1
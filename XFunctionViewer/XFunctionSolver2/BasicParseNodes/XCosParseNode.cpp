@@ -1,26 +1,24 @@
 #include <cmath>
 #include "XCosParseNode.h"
+#include "../XBytecode.h"
 #include "../XBasicParseNodes.h"
 #include "../XConstantParseNode.h"
+#include "../XParseNodeArena.h"
 
 using namespace std;
 
 XCosParseNode::XCosParseNode()
 {
-    childs = new XAbstractParseNode *[1];
     childs[0] = nullptr;
 }
 
 XCosParseNode::XCosParseNode(XAbstractParseNode *a)
 {
-    childs = new XAbstractParseNode *[1];
     childs[0] = a;
 }
 
 XCosParseNode::~XCosParseNode()
 {
-    delete childs[0];
-    delete[] childs;
 }
 
 string XCosParseNode::getName() const
@@ -46,24 +44,30 @@ void XCosParseNode::updateValue()
     value = cos(a);
 }
 
-XAbstractParseNode *XCosParseNode::clone() const
+XAbstractParseNode *XCosParseNode::clone(XParseNodeArena &arena) const
 {
-    return new XCosParseNode(childs[0]->clone());
+    return arena.create<XCosParseNode>(childs[0]->clone(arena));
 }
 
-XAbstractParseNode *XCosParseNode::getDifferentiate() const
+XAbstractParseNode *XCosParseNode::getDifferentiate(XParseNodeArena &arena) const
 {
-    XAbstractParseNode *ori = childs[0]->clone();
-    XSinParseNode *sin = new XSinParseNode;
+    XAbstractParseNode *ori = childs[0]->clone(arena);
+    XSinParseNode *sin = arena.create<XSinParseNode>();
     sin->setChild(ori, 0);
-    XMinusParseNode *minus = new XMinusParseNode;
-    XConstantParseNode *zero = new XConstantParseNode;
+    XMinusParseNode *minus = arena.create<XMinusParseNode>();
+    XConstantParseNode *zero = arena.create<XConstantParseNode>();
     zero->setValue(0.0);
     minus->setChild(zero, 0);
     minus->setChild(sin, 1);
-    XAbstractParseNode *diffOri = childs[0]->getDifferentiate();
-    XMultiplyParseNode *ans = new XMultiplyParseNode;
+    XAbstractParseNode *diffOri = childs[0]->getDifferentiate(arena);
+    XMultiplyParseNode *ans = arena.create<XMultiplyParseNode>();
     ans->setChild(minus, 0);
     ans->setChild(diffOri, 1);
     return ans;
-}
\ No newline at end of file
+}
+
+void XCosParseNode::compile(XBytecode &code) const
+{
+    childs[0]->compile(code);
+    code.emit(XBytecode::Cos);
+}
@@ -1,5 +1,5 @@
 #pragma once
-#include "..\XAbstractParseNode.h"
+#include "../XAbstractParseNode.h"
 
 class XCosParseNode :
     public XAbstractParseNode
@@ -14,7 +14,8 @@ public:
     virtual int getCountChilds() const;
     virtual void updateValue();
 
-    virtual XAbstractParseNode *clone() const;
-    virtual XAbstractParseNode *getDifferentiate() const;
+    virtual XAbstractParseNode *clone(XParseNodeArena &arena) const;
+    virtual XAbstractParseNode *getDifferentiate(XParseNodeArena &arena) const;
+    virtual void compile(XBytecode &code) const;
 };
 
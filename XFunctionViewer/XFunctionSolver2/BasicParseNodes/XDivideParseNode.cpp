@@ -1,28 +1,25 @@
 #include "XDivideParseNode.h"
+#include "../XBytecode.h"
 #include "../XBasicParseNodes.h"
 #include "../XConstantParseNode.h"
+#include "../XParseNodeArena.h"
 
 using namespace std;
 
 XDivideParseNode::XDivideParseNode()
 {
-    childs = new XAbstractParseNode *[2];
     childs[0] = nullptr;
     childs[1] = nullptr;
 }
 
 XDivideParseNode::XDivideParseNode(XAbstractParseNode *a, XAbstractParseNode *b)
 {
-    childs = new XAbstractParseNode *[2];
     childs[0] = a;
     childs[1] = b;
 }
 
 XDivideParseNode::~XDivideParseNode()
 {
-    delete childs[0];
-    delete childs[1]; 
-    delete[] childs;
 }
 
 string XDivideParseNode::getName() const
@@ -53,18 +50,25 @@ void XDivideParseNode::updateValue()
     value = a / b;
 }
 
-XAbstractParseNode *XDivideParseNode::clone() const
+XAbstractParseNode *XDivideParseNode::clone(XParseNodeArena &arena) const
 {
-    return new XDivideParseNode(childs[0]->clone(), childs[1]->clone());
+    return arena.create<XDivideParseNode>(childs[0]->clone(arena), childs[1]->clone(arena));
 }
 
-XAbstractParseNode *XDivideParseNode::getDifferentiate() const
+XAbstractParseNode *XDivideParseNode::getDifferentiate(XParseNodeArena &arena) const
 {
-    return new XDivideParseNode(
-        new XMinusParseNode(
-            new XMultiplyParseNode(childs[0]->getDifferentiate(), childs[1]->clone()),
-            new XMultiplyParseNode(childs[0]->clone(), childs[1]->getDifferentiate())
+    return arena.create<XDivideParseNode>(
+        arena.create<XMinusParseNode>(
+            arena.create<XMultiplyParseNode>(childs[0]->getDifferentiate(arena), childs[1]->clone(arena)),
+            arena.create<XMultiplyParseNode>(childs[0]->clone(arena), childs[1]->getDifferentiate(arena))
         ),
-        new XPowerParseNode(childs[1]->clone(), new XConstantParseNode(2))
+        arena.create<XPowerParseNode>(childs[1]->clone(arena), arena.create<XConstantParseNode>(2))
     );
-}
\ No newline at end of file
+}
+
+void XDivideParseNode::compile(XBytecode &code) const
+{
+    childs[0]->compile(code);
+    childs[1]->compile(code);
+    code.emit(XBytecode::Divide);
+}
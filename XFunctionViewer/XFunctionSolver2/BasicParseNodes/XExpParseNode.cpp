@@ -1,25 +1,23 @@
 #include <cmath>
 #include "XExpParseNode.h"
+#include "../XBytecode.h"
 #include "../XBasicParseNodes.h"
+#include "../XParseNodeArena.h"
 
 using namespace std;
 
 XExpParseNode::XExpParseNode()
 {
-    childs = new XAbstractParseNode *[1];
     childs[0] = nullptr;
 }
 
 XExpParseNode::XExpParseNode(XAbstractParseNode *a)
 {
-    childs = new XAbstractParseNode*[1];
     childs[0] = a;
 }
 
 XExpParseNode::~XExpParseNode()
 {
-    delete childs[0];
-    delete[] childs;
 }
 
 string XExpParseNode::getName() const
@@ -46,15 +44,21 @@ void XExpParseNode::updateValue()
     value = exp(a);
 }
 
-XAbstractParseNode *XExpParseNode::clone() const
+XAbstractParseNode *XExpParseNode::clone(XParseNodeArena &arena) const
 {
-    return new XExpParseNode(childs[0]->clone());
+    return arena.create<XExpParseNode>(childs[0]->clone(arena));
 }
 
-XAbstractParseNode *XExpParseNode::getDifferentiate() const
+XAbstractParseNode *XExpParseNode::getDifferentiate(XParseNodeArena &arena) const
 {
-    return new XMultiplyParseNode(
-        new XExpParseNode(childs[0]->clone()),
-        childs[0]->getDifferentiate()
+    return arena.create<XMultiplyParseNode>(
+        arena.create<XExpParseNode>(childs[0]->clone(arena)),
+        childs[0]->getDifferentiate(arena)
     );
-}
\ No newline at end of file
+}
+
+void XExpParseNode::compile(XBytecode &code) const
+{
+    childs[0]->compile(code);
+    code.emit(XBytecode::Exp);
+}
@@ -1,5 +1,5 @@
 #pragma once
-#include "..\XAbstractParseNode.h"
+#include "../XAbstractParseNode.h"
 
 class XExpParseNode :
     public XAbstractParseNode
@@ -13,7 +13,8 @@ public:
     virtual std::string getExpression() const;
     virtual int getCountChilds() const;
     virtual void updateValue();
-    virtual XAbstractParseNode *clone() const;
-    virtual XAbstractParseNode *getDifferentiate() const;
+    virtual XAbstractParseNode *clone(XParseNodeArena &arena) const;
+    virtual XAbstractParseNode *getDifferentiate(XParseNodeArena &arena) const;
+    virtual void compile(XBytecode &code) const;
 };
 
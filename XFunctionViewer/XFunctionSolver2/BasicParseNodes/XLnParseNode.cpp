@@ -1,26 +1,24 @@
 #include <cmath>
 #include "XLnParseNode.h"
+#include "../XBytecode.h"
 #include "../XBasicParseNodes.h"
 #include "../XConstantParseNode.h"
+#include "../XParseNodeArena.h"
 
 using namespace std;
 
 XLnParseNode::XLnParseNode()
 {
-    childs = new XAbstractParseNode *[1];
     childs[0] = nullptr;
 }
 
 XLnParseNode::XLnParseNode(XAbstractParseNode *a)
 {
-    childs = new XAbstractParseNode *[1];
     childs[0] = a;
 }
 
 XLnParseNode::~XLnParseNode()
 {
-    delete childs[0];
-    delete[] childs;
 }
 
 string XLnParseNode::getName() const
@@ -47,18 +45,24 @@ void XLnParseNode::updateValue()
     value = log(a);
 }
 
-XAbstractParseNode * XLnParseNode::clone() const
+XAbstractParseNode * XLnParseNode::clone(XParseNodeArena &arena) const
 {
-    return new XLnParseNode(childs[0]->clone());
+    return arena.create<XLnParseNode>(childs[0]->clone(arena));
 }
 
-XAbstractParseNode * XLnParseNode::getDifferentiate() const
+XAbstractParseNode * XLnParseNode::getDifferentiate(XParseNodeArena &arena) const
 {
-    return new XMultiplyParseNode(
-        new XDivideParseNode(
-            new XConstantParseNode(1),
-            childs[0]->clone()
+    return arena.create<XMultiplyParseNode>(
+        arena.create<XDivideParseNode>(
+            arena.create<XConstantParseNode>(1),
+            childs[0]->clone(arena)
         ),
-        childs[0]->getDifferentiate()
+        childs[0]->getDifferentiate(arena)
     );
-}
\ No newline at end of file
+}
+
+void XLnParseNode::compile(XBytecode &code) const
+{
+    childs[0]->compile(code);
+    code.emit(XBytecode::Ln);
+}
@@ -1,26 +1,23 @@
 #include "XMinusParseNode.h"
+#include "../XBytecode.h"
+#include "../XParseNodeArena.h"
 
 using namespace std;
 
 XMinusParseNode::XMinusParseNode()
 {
-    childs = new XAbstractParseNode *[2];
     childs[0] = nullptr;
     childs[1] = nullptr;
 }
 
 XMinusParseNode::XMinusParseNode(XAbstractParseNode *a, XAbstractParseNode *b)
 {
-    childs = new XAbstractParseNode *[2];
     childs[0] = a;
     childs[1] = b;
 }
 
 XMinusParseNode::~XMinusParseNode()
 {
-    delete childs[0];
-    delete childs[1];
-    delete[] childs;
 }
 
 string XMinusParseNode::getName() const
@@ -51,12 +48,19 @@ void XMinusParseNode::updateValue()
     value = a - b;
 }
 
-XAbstractParseNode *XMinusParseNode::clone() const
+XAbstractParseNode *XMinusParseNode::clone(XParseNodeArena &arena) const
 {
-    return new XMinusParseNode(childs[0]->clone(), childs[1]->clone());
+    return arena.create<XMinusParseNode>(childs[0]->clone(arena), childs[1]->clone(arena));
 }
 
-XAbstractParseNode *XMinusParseNode::getDifferentiate() const
+XAbstractParseNode *XMinusParseNode::getDifferentiate(XParseNodeArena &arena) const
 {
-    return new XMinusParseNode(childs[0]->getDifferentiate(), childs[1]->getDifferentiate());
-}
\ No newline at end of file
+    return arena.create<XMinusParseNode>(childs[0]->getDifferentiate(arena), childs[1]->getDifferentiate(arena));
+}
+
+void XMinusParseNode::compile(XBytecode &code) const
+{
+    childs[0]->compile(code);
+    childs[1]->compile(code);
+    code.emit(XBytecode::Subtract);
+}
@@ -1,27 +1,24 @@
 #include "XMultiplyParseNode.h"
+#include "../XBytecode.h"
 #include "XPlusParseNode.h"
+#include "../XParseNodeArena.h"
 
 using namespace std;
 
 XMultiplyParseNode::XMultiplyParseNode()
 {
-    childs = new XAbstractParseNode *[2];
     childs[0] = nullptr;
     childs[1] = nullptr;
 }
 
 XMultiplyParseNode::XMultiplyParseNode(XAbstractParseNode *a, XAbstractParseNode *b)
 {
-    childs = new XAbstractParseNode *[2];
     childs[0] = a;
     childs[1] = b;
 }
 
 XMultiplyParseNode::~XMultiplyParseNode()
 {
-    delete childs[0];
-    delete childs[1];
-    delete[] childs;
 }
 
 string XMultiplyParseNode::getName() const
@@ -52,20 +49,27 @@ void XMultiplyParseNode::updateValue()
     value = a * b;
 }
 
-XAbstractParseNode *XMultiplyParseNode::clone() const
+XAbstractParseNode *XMultiplyParseNode::clone(XParseNodeArena &arena) const
 {
-    XAbstractParseNode *a = childs[0]->clone();
-    XAbstractParseNode *b = childs[1]->clone();
-    XMultiplyParseNode *ans = new XMultiplyParseNode;
+    XAbstractParseNode *a = childs[0]->clone(arena);
+    XAbstractParseNode *b = childs[1]->clone(arena);
+    XMultiplyParseNode *ans = arena.create<XMultiplyParseNode>();
     ans->setChild(a, 0);
     ans->setChild(b, 1);
     return ans;
 }
 
-XAbstractParseNode *XMultiplyParseNode::getDifferentiate() const
+XAbstractParseNode *XMultiplyParseNode::getDifferentiate(XParseNodeArena &arena) const
 {
-    return new XPlusParseNode(
-        new XMultiplyParseNode(childs[0]->getDifferentiate(), childs[1]->clone()),
-        new XMultiplyParseNode(childs[0]->clone(), childs[1]->getDifferentiate())
+    return arena.create<XPlusParseNode>(
+        arena.create<XMultiplyParseNode>(childs[0]->getDifferentiate(arena), childs[1]->clone(arena)),
+        arena.create<XMultiplyParseNode>(childs[0]->clone(arena), childs[1]->getDifferentiate(arena))
     );
-}
\ No newline at end of file
+}
+
+void XMultiplyParseNode::compile(XBytecode &code) const
+{
+    childs[0]->compile(code);
+    childs[1]->compile(code);
+    code.emit(XBytecode::Multiply);
+}
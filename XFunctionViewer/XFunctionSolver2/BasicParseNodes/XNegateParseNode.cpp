@@ -1,22 +1,20 @@
 #include "XNegateParseNode.h"
+#include "../XBytecode.h"
+#include "../XParseNodeArena.h"
 
 XNegateParseNode::XNegateParseNode()
 {
-    childs = new XAbstractParseNode *[1];
     childs[0] = nullptr;
 }
 
 XNegateParseNode::XNegateParseNode(XAbstractParseNode * a)
 {
-    childs = new XAbstractParseNode *[1];
     childs[0] = a;
 }
 
 
 XNegateParseNode::~XNegateParseNode()
 {
-    delete childs[0];
-    delete childs;
 }
 
 std::string XNegateParseNode::getName() const
@@ -40,14 +38,20 @@ void XNegateParseNode::updateValue()
     value = -1.0 * childs[0]->getValue();
 }
 
-XAbstractParseNode * XNegateParseNode::clone() const
+XAbstractParseNode * XNegateParseNode::clone(XParseNodeArena &arena) const
 {
-    return new XNegateParseNode(childs[0]->clone());
+    return arena.create<XNegateParseNode>(childs[0]->clone(arena));
 }
 
-XAbstractParseNode * XNegateParseNode::getDifferentiate() const
+XAbstractParseNode * XNegateParseNode::getDifferentiate(XParseNodeArena &arena) const
 {
-    return new XNegateParseNode(
-        childs[0]->getDifferentiate()
+    return arena.create<XNegateParseNode>(
+        childs[0]->getDifferentiate(arena)
     );
 }
+
+void XNegateParseNode::compile(XBytecode &code) const
+{
+    childs[0]->compile(code);
+    code.emit(XBytecode::Negate);
+}
@@ -1,26 +1,23 @@
 #include "XPlusParseNode.h"
+#include "../XBytecode.h"
+#include "../XParseNodeArena.h"
 
 using namespace std;
 
 XPlusParseNode::XPlusParseNode()
 {
-    childs = new XAbstractParseNode *[2];
     childs[0] = nullptr;
     childs[1] = nullptr;
 }
 
 XPlusParseNode::XPlusParseNode(XAbstractParseNode *a, XAbstractParseNode *b)
 {
-    childs = new XAbstractParseNode *[2];
     childs[0] = a;
     childs[1] = b;
 }
 
 XPlusParseNode::~XPlusParseNode()
 {
-    delete childs[0];
-    delete childs[1];
-    delete[] childs;
 }
 
 string XPlusParseNode::getName() const
@@ -51,18 +48,25 @@ void XPlusParseNode::updateValue()
     value = a + b;
 }
 
-XAbstractParseNode *XPlusParseNode::clone() const
+XAbstractParseNode *XPlusParseNode::clone(XParseNodeArena &arena) const
 {
-    XPlusParseNode *ans = new XPlusParseNode(childs[0]->clone(), childs[1]->clone());
+    XPlusParseNode *ans = arena.create<XPlusParseNode>(childs[0]->clone(arena), childs[1]->clone(arena));
     return ans;
 }
 
-XAbstractParseNode *XPlusParseNode::getDifferentiate() const
+XAbstractParseNode *XPlusParseNode::getDifferentiate(XParseNodeArena &arena) const
 {
-    XAbstractParseNode *a = childs[0]->getDifferentiate();
-    XAbstractParseNode *b = childs[1]->getDifferentiate();
-    XPlusParseNode *ans = new XPlusParseNode;
+    XAbstractParseNode *a = childs[0]->getDifferentiate(arena);
+    XAbstractParseNode *b = childs[1]->getDifferentiate(arena);
+    XPlusParseNode *ans = arena.create<XPlusParseNode>();
     ans->childs[0] = a;
     ans->childs[1] = b;
     return ans;
-}
\ No newline at end of file
+}
+
+void XPlusParseNode::compile(XBytecode &code) const
+{
+    childs[0]->compile(code);
+    childs[1]->compile(code);
+    code.emit(XBytecode::Add);
+}
@@ -1,29 +1,26 @@
 #include <cmath>
 #include "XPowerParseNode.h"
+#include "../XBytecode.h"
 #include "../XBasicParseNodes.h"
 #include "../XConstantParseNode.h"
+#include "../XParseNodeArena.h"
 
 using namespace std;
 
 XPowerParseNode::XPowerParseNode()
 {
-    childs = new XAbstractParseNode *[2];
     childs[0] = nullptr;
     childs[1] = nullptr;
 }
 
 XPowerParseNode::XPowerParseNode(XAbstractParseNode *a, XAbstractParseNode *b)
 {
-    childs = new XAbstractParseNode *[2];
     childs[0] = a;
     childs[1] = b;
 }
 
 XPowerParseNode::~XPowerParseNode()
 {
-    delete childs[0];
-    delete childs[1];
-    delete[] childs;
 }
 
 string XPowerParseNode::getName() const
@@ -54,20 +51,27 @@ void XPowerParseNode::updateValue()
     value = pow(a, b);
 }
 
-XAbstractParseNode *XPowerParseNode::clone() const
+XAbstractParseNode *XPowerParseNode::clone(XParseNodeArena &arena) const
 {
-    return new XPowerParseNode(childs[0]->clone(), childs[1]->clone());
+    return arena.create<XPowerParseNode>(childs[0]->clone(arena), childs[1]->clone(arena));
 }
 
-XAbstractParseNode *XPowerParseNode::getDifferentiate() const
+XAbstractParseNode *XPowerParseNode::getDifferentiate(XParseNodeArena &arena) const
 {
-    XAbstractParseNode *baser = new XMultiplyParseNode(
-        childs[1]->clone(),
-        new XLnParseNode(childs[0]->clone())
+    XAbstractParseNode *baser = arena.create<XMultiplyParseNode>(
+        childs[1]->clone(arena),
+        arena.create<XLnParseNode>(childs[0]->clone(arena))
     );
 
-    return new XMultiplyParseNode(
-        new XExpParseNode(baser),
-        baser->getDifferentiate()
+    return arena.create<XMultiplyParseNode>(
+        arena.create<XExpParseNode>(baser),
+        baser->getDifferentiate(arena)
     );
-}
\ No newline at end of file
+}
+
+void XPowerParseNode::compile(XBytecode &code) const
+{
+    childs[0]->compile(code);
+    childs[1]->compile(code);
+    code.emit(XBytecode::Power);
+}
@@ -1,25 +1,23 @@
 #include <cmath>
 #include "XSinParseNode.h"
+#include "../XBytecode.h"
 #include "../XBasicParseNodes.h"
+#include "../XParseNodeArena.h"
 
 using namespace std;
 
 XSinParseNode::XSinParseNode()
 {
-    childs = new XAbstractParseNode *[1];
     childs[0] = nullptr;
 }
 
 XSinParseNode::XSinParseNode(XAbstractParseNode *a)
 {
-    childs = new XAbstractParseNode *[1];
     childs[0] = a;
 }
 
 XSinParseNode::~XSinParseNode()
 {
-   delete (childs[0]);
-   delete[] childs;
 }
 
 string XSinParseNode::getName() const
@@ -46,15 +44,21 @@ void XSinParseNode::updateValue()
     value = sin(a);
 }
 
-XAbstractParseNode *XSinParseNode::clone() const
+XAbstractParseNode *XSinParseNode::clone(XParseNodeArena &arena) const
 {
-    return new XSinParseNode(childs[0]->clone());
+    return arena.create<XSinParseNode>(childs[0]->clone(arena));
 }
 
-XAbstractParseNode *XSinParseNode::getDifferentiate() const
+XAbstractParseNode *XSinParseNode::getDifferentiate(XParseNodeArena &arena) const
 {
-    return new XMultiplyParseNode(
-        new XCosParseNode(childs[0]->clone()),
-        childs[0]->getDifferentiate()
+    return arena.create<XMultiplyParseNode>(
+        arena.create<XCosParseNode>(childs[0]->clone(arena)),
+        childs[0]->getDifferentiate(arena)
     );
-}
\ No newline at end of file
+}
+
+void XSinParseNode::compile(XBytecode &code) const
+{
+    childs[0]->compile(code);
+    code.emit(XBytecode::Sin);
+}
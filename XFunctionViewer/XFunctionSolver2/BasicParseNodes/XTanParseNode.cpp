@@ -1,25 +1,23 @@
 #include <cmath>
 #include "XTanParseNode.h"
+#include "../XBytecode.h"
 #include "../XBasicParseNodes.h"
+#include "../XParseNodeArena.h"
 
 using namespace std;
 
 XTanParseNode::XTanParseNode()
 {
-    childs = new XAbstractParseNode *[1];
     childs[0] = nullptr;
 }
 
 XTanParseNode::XTanParseNode(XAbstractParseNode *a)
 {
-    childs = new XAbstractParseNode *[1];
     childs[0] = a;
 }
 
 XTanParseNode::~XTanParseNode()
 {
-    delete childs[0];
-    delete[] childs;
 }
 
 string XTanParseNode::getName() const
@@ -46,18 +44,22 @@ void XTanParseNode::updateValue()
     value = tan(a);
 }
 
-XAbstractParseNode *XTanParseNode::clone() const
+XAbstractParseNode *XTanParseNode::clone(XParseNodeArena &arena) const
 {
-    return new XTanParseNode(childs[0]->clone());
+    return arena.create<XTanParseNode>(childs[0]->clone(arena));
 }
 
-XAbstractParseNode *XTanParseNode::getDifferentiate() const
+XAbstractParseNode *XTanParseNode::getDifferentiate(XParseNodeArena &arena) const
 {
-    XDivideParseNode *des = new XDivideParseNode(
-        new XSinParseNode(childs[0]->clone()),
-        new XCosParseNode(childs[0]->clone())
+    XDivideParseNode *des = arena.create<XDivideParseNode>(
+        arena.create<XSinParseNode>(childs[0]->clone(arena)),
+        arena.create<XCosParseNode>(childs[0]->clone(arena))
     );
-    XAbstractParseNode *ans = des->getDifferentiate();
-    delete des;
-    return ans;
-}
\ No newline at end of file
+    return des->getDifferentiate(arena);
+}
+
+void XTanParseNode::compile(XBytecode &code) const
+{
+    childs[0]->compile(code);
+    code.emit(XBytecode::Tan);
+}
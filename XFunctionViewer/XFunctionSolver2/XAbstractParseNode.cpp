@@ -3,6 +3,8 @@
 
 XAbstractParseNode::XAbstractParseNode()
 {
+    childs[0] = nullptr;
+    childs[1] = nullptr;
 }
 
 XAbstractParseNode::~XAbstractParseNode()
@@ -23,12 +25,12 @@ void XAbstractParseNode::updateValue()
 {
 }
 
-XAbstractParseNode *XAbstractParseNode::clone() const
+XAbstractParseNode *XAbstractParseNode::clone(XParseNodeArena &) const
 {
     return nullptr;
 }
 
-XAbstractParseNode *XAbstractParseNode::getDifferentiate() const
+XAbstractParseNode *XAbstractParseNode::getDifferentiate(XParseNodeArena &) const
 {
     return nullptr;
 }
@@ -40,6 +42,5 @@ void XAbstractParseNode::setValue(double value)
 
 void XAbstractParseNode::setChild(XAbstractParseNode *rhs, int index)
 {
-    delete childs[index];
     childs[index] = rhs;
 }
\ No newline at end of file
@@ -2,6 +2,9 @@
 #define XABSTRACTPARSENODE_H
 #include <string>
 
+class XBytecode;
+class XParseNodeArena;
+
 class XAbstractParseNode
 {
 public:
@@ -12,15 +15,16 @@ public:
     virtual int getCountChilds() const = 0;
     virtual XAbstractParseNode * getChild(int index) const;
     virtual double getValue() const;
-    virtual XAbstractParseNode *clone() const;
-    virtual XAbstractParseNode *getDifferentiate() const;
+    virtual XAbstractParseNode *clone(XParseNodeArena &arena) const;
+    virtual XAbstractParseNode *getDifferentiate(XParseNodeArena &arena) const;
+    virtual void compile(XBytecode &code) const = 0; // appends the instructions computing this node
     virtual void updateValue();
     virtual void setValue(double value);
-    virtual void setChild(XAbstractParseNode *rhs, int index);
+    virtual void setChild(XAbstractParseNode *rhs, int index);  // the child it replaces stays in its arena
 
 protected:
     double value;
-    XAbstractParseNode * *childs;
+    XAbstractParseNode *childs[2];  // as many as getCountChilds, the nodes belong to an XParseNodeArena
 
     friend class XFunctionParser;
 };
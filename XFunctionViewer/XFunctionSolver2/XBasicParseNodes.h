@@ -1,11 +1,11 @@
-#include "BasicParseNodes\XPlusParseNode.h"
-#include "BasicParseNodes\XMinusParseNode.h"
-#include "BasicParseNodes\XMultiplyParseNode.h"
-#include "BasicParseNodes\XDivideParseNode.h"
-#include "BasicParseNodes\XPowerParseNode.h"
-#include "BasicParseNodes\XSinParseNode.h"
-#include "BasicParseNodes\XCosParseNode.h"
-#include "BasicParseNodes\XTanParseNode.h"
-#include "BasicParseNodes\XExpParseNode.h"
-#include "BasicParseNodes\XLnParseNode.h"
-#include "BasicParseNodes\XNegateParseNode.h"
+#include "BasicParseNodes/XPlusParseNode.h"
+#include "BasicParseNodes/XMinusParseNode.h"
+#include "BasicParseNodes/XMultiplyParseNode.h"
+#include "BasicParseNodes/XDivideParseNode.h"
+#include "BasicParseNodes/XPowerParseNode.h"
+#include "BasicParseNodes/XSinParseNode.h"
+#include "BasicParseNodes/XCosParseNode.h"
+#include "BasicParseNodes/XTanParseNode.h"
+#include "BasicParseNodes/XExpParseNode.h"
+#include "BasicParseNodes/XLnParseNode.h"
+#include "BasicParseNodes/XNegateParseNode.h"
@@ -0,0 +1,708 @@
+#include "XBytecode.h"
+#include "XAbstractParseNode.h"
+#include "XDual.h"
+#include "XInterval.h"
+#include "XTaylor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+static const char *operationNames[] =
+{
+    "const", "var", "load", "store", "add", "sub", "mul", "div", "pow",
+    "addc", "subc", "mulc", "divc", "powc", "sqr",
+    "neg", "sin", "cos", "tan", "exp", "ln",
+};
+
+static bool hasConstantOperand(XBytecode::OperationCode code)
+{
+    return code >= XBytecode::AddConstant && code <= XBytecode::PowerConstant;
+}
+
+// A variable as a dual number, carrying the derivative 1 along direction i when its slot is slots[i].
+template <int count>
+struct DualVariables
+{
+    XDual<count> operator()(int slot) const
+    {
+        XDual<count> ans(arguments[slot]);
+        for (int i = 0; i < count; i++)
+        {
+            ans.derivatives[i] = slots[i] == slot ? 1.0 : 0.0;
+        }
+        return ans;
+    }
+
+    const double *arguments;
+    const int *slots;
+};
+
+// A variable as a truncated Taylor series, t added to the one of slot.
+template <int order>
+struct TaylorVariables
+{
+    XTaylor<order> operator()(int slot) const
+    {
+        XTaylor<order> ans(arguments[slot]);
+        if (order > 0 && slot == this->slot)
+        {
+            ans.coefficients[1] = 1.0;
+        }
+        return ans;
+    }
+
+    const double *arguments;
+    int slot;
+};
+
+struct IntervalVariables
+{
+    XInterval operator()(int slot) const
+    {
+        return arguments[slot];
+    }
+
+    const XInterval *arguments;
+};
+
+// The program run on any type with the arithmetic of a double, as dual numbers or intervals, with
+// variables(slot) giving the value of a variable. Written out of the class so that it is
+// instantiated for each type.
+template <class Value, class Variables>
+static Value evaluateOn(const XBytecode &code, const Variables &variables)
+{
+    if (code.isEmpty())
+    {
+        return Value(0.0);
+    }
+
+    const int inlineDepth = 64;
+    Value inlineStack[inlineDepth];
+    Value inlineTemporaries[inlineDepth];
+    vector<Value> heapStack;
+    vector<Value> heapTemporaries;
+    Value *stack = inlineStack;
+    Value *temporaries = inlineTemporaries;
+    if (code.getMaxDepth() >= inlineDepth)
+    {
+        heapStack.resize(code.getMaxDepth() + 1);
+        stack = &heapStack[0];
+    }
+    if (code.getCountTemporaries() > inlineDepth)
+    {
+        heapTemporaries.resize(code.getCountTemporaries());
+        temporaries = &heapTemporaries[0];
+    }
+
+    Value *top = stack;
+    const XBytecode::Instruction *instruction = code.getInstructions();
+    const XBytecode::Instruction *end = instruction + code.getCountInstructions();
+    for (; instruction != end; ++instruction)
+    {
+        switch (instruction->code)
+        {
+        case XBytecode::Constant:
+            *++top = Value(instruction->constant);
+            break;
+        case XBytecode::Variable:
+            *++top = variables(instruction->slot);
+            break;
+        case XBytecode::Load:
+            *++top = temporaries[instruction->slot];
+            break;
+        case XBytecode::Store:
+            temporaries[instruction->slot] = *top;
+            break;
+        case XBytecode::Add:
+            top[-1] = top[-1] + top[0];
+            top--;
+            break;
+        case XBytecode::Subtract:
+            top[-1] = top[-1] - top[0];
+            top--;
+            break;
+        case XBytecode::Multiply:
+            top[-1] = top[-1] * top[0];
+            top--;
+            break;
+        case XBytecode::Divide:
+            top[-1] = top[-1] / top[0];
+            top--;
+            break;
+        case XBytecode::Power:
+            top[-1] = pow(top[-1], top[0]);
+            top--;
+            break;
+        case XBytecode::AddConstant:
+            *top = *top + instruction->constant;
+            break;
+        case XBytecode::SubtractConstant:
+            *top = *top - instruction->constant;
+            break;
+        case XBytecode::MultiplyConstant:
+            *top = *top * instruction->constant;
+            break;
+        case XBytecode::DivideConstant:
+            *top = *top / instruction->constant;
+            break;
+        case XBytecode::PowerConstant:
+            *top = pow(*top, instruction->constant);
+            break;
+        case XBytecode::Square:
+            *top = square(*top);
+            break;
+        case XBytecode::Negate:
+            *top = -*top;
+            break;
+        case XBytecode::Sin:
+            *top = sin(*top);
+            break;
+        case XBytecode::Cos:
+            *top = cos(*top);
+            break;
+        case XBytecode::Tan:
+            *top = tan(*top);
+            break;
+        case XBytecode::Exp:
+            *top = exp(*top);
+            break;
+        case XBytecode::Ln:
+            *top = log(*top);
+            break;
+        }
+    }
+
+    return *top;
+}
+
+template <int count>
+static double evaluateDual(const XBytecode &code, const double *arguments, const int *slots, double *derivatives)
+{
+    DualVariables<count> variables = { arguments, slots };
+    XDual<count> ans = evaluateOn<XDual<count> >(code, variables);
+    for (int i = 0; i < count; i++)
+    {
+        derivatives[i] = ans.derivatives[i];
+    }
+    return ans.value;
+}
+
+// Runs on series of at least the order asked, derivatives[k] = k! coefficients[k].
+template <int order>
+static void evaluateTaylorOn(const XBytecode &code, const double *arguments, int slot, int countDerivatives,
+    double *derivatives)
+{
+    TaylorVariables<order> variables = { arguments, slot };
+    XTaylor<order> ans = evaluateOn<XTaylor<order> >(code, variables);
+    double factorial = 1.0;
+    for (int k = 0; k <= countDerivatives; k++)
+    {
+        factorial *= k > 0 ? k : 1;
+        derivatives[k] = ans.coefficients[k] * factorial;
+    }
+}
+
+XBytecode::XBytecode()
+{
+    depth = 0;
+    maxDepth = 0;
+    countTemporaries = 0;
+}
+
+XBytecode::~XBytecode()
+{
+}
+
+void XBytecode::compile(const XAbstractParseNode *root)
+{
+    clear();
+    if (root != nullptr)
+    {
+        root->compile(*this);
+    }
+}
+
+void XBytecode::clear()
+{
+    instructions.clear();
+    depth = 0;
+    maxDepth = 0;
+    countTemporaries = 0;
+}
+
+void XBytecode::emitConstant(double value)
+{
+    Instruction instruction = { Constant, 0, value };
+    instructions.push_back(instruction);
+    depth++;
+    maxDepth = depth > maxDepth ? depth : maxDepth;
+}
+
+void XBytecode::emitVariable(int slot)
+{
+    Instruction instruction = { Variable, slot, 0.0 };
+    instructions.push_back(instruction);
+    depth++;
+    maxDepth = depth > maxDepth ? depth : maxDepth;
+}
+
+void XBytecode::emitLoad(int slot)
+{
+    Instruction instruction = { Load, slot, 0.0 };
+    instructions.push_back(instruction);
+    depth++;
+    maxDepth = depth > maxDepth ? depth : maxDepth;
+}
+
+void XBytecode::emitStore(int slot)
+{
+    Instruction instruction = { Store, slot, 0.0 };
+    instructions.push_back(instruction);
+    countTemporaries = slot + 1 > countTemporaries ? slot + 1 : countTemporaries;
+}
+
+void XBytecode::emit(OperationCode code)
+{
+    int count = instructions.size();
+    if (getCountOperands(code) == 1)
+    {
+        if (count >= 1 && instructions[count - 1].code == Constant)
+        {
+            instructions[count - 1].constant = apply(code, instructions[count - 1].constant);
+            return;
+        }
+
+        Instruction instruction = { code, 0, 0.0 };
+        instructions.push_back(instruction);
+        return;
+    }
+
+    depth--;
+    if (count >= 2 && instructions[count - 2].code == Constant && instructions[count - 1].code == Constant)
+    {
+        instructions[count - 2].constant = apply(code, instructions[count - 2].constant, instructions[count - 1].constant);
+        instructions.pop_back();
+        return;
+    }
+
+    // a constant right operand goes inline, and so does a constant left operand of + and *,
+    // whose right operand is a single variable that can be pushed first
+    if (count >= 2 && instructions[count - 2].code == Constant && instructions[count - 1].code == Variable
+        && (code == Add || code == Multiply))
+    {
+        Instruction constant = instructions[count - 2];
+        instructions[count - 2] = instructions[count - 1];
+        instructions[count - 1] = constant;
+    }
+
+    if (count >= 1 && instructions[count - 1].code == Constant)
+    {
+        Instruction &instruction = instructions[count - 1];
+        switch (code)
+        {
+        case Add:
+            instruction.code = AddConstant;
+            break;
+        case Subtract:
+            instruction.code = SubtractConstant;
+            break;
+        case Multiply:
+            instruction.code = MultiplyConstant;
+            break;
+        case Divide:
+            instruction.code = DivideConstant;
+            break;
+        default:
+            instruction.code = instruction.constant == 2.0 ? Square : PowerConstant;
+            break;
+        }
+
+        return;
+    }
+
+    Instruction instruction = { code, 0, 0.0 };
+    instructions.push_back(instruction);
+}
+
+// The top of the stack lives in top, so an operation touches memory only for its second operand.
+double XBytecode::evaluate(const double *arguments) const
+{
+    if (instructions.empty())
+    {
+        return 0.0;
+    }
+
+    const int inlineDepth = 64;
+    double inlineStack[inlineDepth];
+    vector<double> heapStack;
+    double *stack = inlineStack;
+    if (maxDepth >= inlineDepth)
+    {
+        heapStack.resize(maxDepth + 1);
+        stack = &heapStack[0];
+    }
+
+    double inlineTemporaries[inlineDepth];
+    vector<double> heapTemporaries;
+    double *temporaries = inlineTemporaries;
+    if (countTemporaries > inlineDepth)
+    {
+        heapTemporaries.resize(countTemporaries);
+        temporaries = &heapTemporaries[0];
+    }
+
+    double *below = stack; // below the top, stack[0] is never read
+    double top = 0.0;
+    const Instruction *instruction = &instructions[0];
+    const Instruction *end = instruction + instructions.size();
+    for (; instruction != end; ++instruction)
+    {
+        switch (instruction->code)
+        {
+        case Constant:
+            *++below = top;
+            top = instruction->constant;
+            break;
+        case Variable:
+            *++below = top;
+            top = arguments[instruction->slot];
+            break;
+        case Load:
+            *++below = top;
+            top = temporaries[instruction->slot];
+            break;
+        case Store:
+            temporaries[instruction->slot] = top;
+            break;
+        case Add:
+            top = *below-- + top;
+            break;
+        case Subtract:
+            top = *below-- - top;
+            break;
+        case Multiply:
+            top = *below-- * top;
+            break;
+        case Divide:
+            top = *below-- / top;
+            break;
+        case Power:
+            top = pow(*below--, top);
+            break;
+        case AddConstant:
+            top += instruction->constant;
+            break;
+        case SubtractConstant:
+            top -= instruction->constant;
+            break;
+        case MultiplyConstant:
+            top *= instruction->constant;
+            break;
+        case DivideConstant:
+            top /= instruction->constant;
+            break;
+        case PowerConstant:
+            top = pow(top, instruction->constant);
+            break;
+        case Square:
+            top *= top;
+            break;
+        case Negate:
+            top = -top;
+            break;
+        case Sin:
+            top = sin(top);
+            break;
+        case Cos:
+            top = cos(top);
+            break;
+        case Tan:
+            top = tan(top);
+            break;
+        case Exp:
+            top = exp(top);
+            break;
+        case Ln:
+            top = log(top);
+            break;
+        }
+    }
+
+    return top;
+}
+
+// The same program run column by column over blocks of points. Every stack level owns a column of
+// the block, an operand is a pointer to the column holding it, so a pushed variable points into the
+// caller's array and nothing is copied until an operation writes its result below. A temporary is
+// a column of its own after the stack and the zeros.
+void XBytecode::evaluateBatch(const double *const *columns, int countColumns, double *results, int count,
+    XVectorMath::Accuracy accuracy) const
+{
+    evaluateBatch(columns, countColumns, &results, 1, count, accuracy);
+}
+
+void XBytecode::evaluateBatch(const double *const *columns, int countColumns, double *const *results, int countResults,
+    int count, XVectorMath::Accuracy accuracy) const
+{
+    if (instructions.empty())
+    {
+        for (int r = 0; r < countResults; r++)
+        {
+            XVectorMath::fill(0.0, results[r], count);
+        }
+        return;
+    }
+
+    const int blockSize = 256;
+    vector<double> storage((maxDepth + 2 + countTemporaries) * blockSize, 0.0);
+    vector<const double *> operands(maxDepth + 1);
+    const double *zeros = &storage[(maxDepth + 1) * blockSize];
+    double *temporaries = &storage[(maxDepth + 2) * blockSize];
+
+    for (int start = 0; start < count; start += blockSize)
+    {
+        int n = count - start < blockSize ? count - start : blockSize;
+        int level = 0;
+        for (int i = 0; i < (int)instructions.size(); i++)
+        {
+            const Instruction &instruction = instructions[i];
+            double *out = &storage[(level - getCountOperands(instruction.code) + 1) * blockSize];
+            const double *top = operands[level];
+            const double *below = level > 0 ? operands[level - 1] : nullptr;
+            switch (instruction.code)
+            {
+            case Constant:
+                XVectorMath::fill(instruction.constant, out, n);
+                break;
+            case Variable:
+                if (instruction.slot < countColumns && columns[instruction.slot] != nullptr)
+                {
+                    operands[++level] = columns[instruction.slot] + start;
+                }
+                else
+                {
+                    operands[++level] = zeros;
+                }
+                continue;
+            case Load:
+                operands[++level] = temporaries + instruction.slot * blockSize;
+                continue;
+            case Store:
+                memcpy(temporaries + instruction.slot * blockSize, top, n * sizeof(double));
+                continue;
+            case Add:
+                XVectorMath::add(below, top, out, n);
+                break;
+            case Subtract:
+                XVectorMath::subtract(below, top, out, n);
+                break;
+            case Multiply:
+                XVectorMath::multiply(below, top, out, n);
+                break;
+            case Divide:
+                XVectorMath::divide(below, top, out, n);
+                break;
+            case Power:
+                XVectorMath::power(below, top, out, n, accuracy);
+                break;
+            case AddConstant:
+                XVectorMath::addConstant(top, instruction.constant, out, n);
+                break;
+            case SubtractConstant:
+                XVectorMath::subtractConstant(top, instruction.constant, out, n);
+                break;
+            case MultiplyConstant:
+                XVectorMath::multiplyConstant(top, instruction.constant, out, n);
+                break;
+            case DivideConstant:
+                XVectorMath::divideConstant(top, instruction.constant, out, n);
+                break;
+            case PowerConstant:
+                XVectorMath::powerConstant(top, instruction.constant, out, n, accuracy);
+                break;
+            case Square:
+                XVectorMath::square(top, out, n);
+                break;
+            case Negate:
+                XVectorMath::negate(top, out, n);
+                break;
+            case Sin:
+                XVectorMath::sin(top, out, n, accuracy);
+                break;
+            case Cos:
+                XVectorMath::cos(top, out, n, accuracy);
+                break;
+            case Tan:
+                XVectorMath::tan(top, out, n, accuracy);
+                break;
+            case Exp:
+                XVectorMath::exp(top, out, n, accuracy);
+                break;
+            case Ln:
+                XVectorMath::ln(top, out, n, accuracy);
+                break;
+            }
+
+            level += 1 - getCountOperands(instruction.code);
+            operands[level] = out;
+        }
+
+        for (int r = 0; r < countResults; r++)
+        {
+            if (operands[r + 1] != results[r] + start)
+            {
+                memcpy(results[r] + start, operands[r + 1], n * sizeof(double));
+            }
+        }
+    }
+}
+
+double XBytecode::evaluateDerivative(const double *arguments, int slot, double &derivative) const
+{
+    return evaluateDual<1>(*this, arguments, &slot, &derivative);
+}
+
+double XBytecode::evaluateGradient(const double *arguments, double gradient[3]) const
+{
+    const int slots[3] = { 0, 1, 2 };
+    return evaluateDual<3>(*this, arguments, slots, gradient);
+}
+
+// A few sizes of series rather than one for each order, as the cost grows with the square of it.
+void XBytecode::evaluateTaylor(const double *arguments, int slot, int order, double *derivatives) const
+{
+    if (order <= 2)
+    {
+        evaluateTaylorOn<2>(*this, arguments, slot, order, derivatives);
+    }
+    else if (order <= 4)
+    {
+        evaluateTaylorOn<4>(*this, arguments, slot, order, derivatives);
+    }
+    else
+    {
+        evaluateTaylorOn<maxTaylorOrder>(*this, arguments, slot, min(order, (int)maxTaylorOrder), derivatives);
+    }
+}
+
+XInterval XBytecode::evaluateInterval(const XInterval *arguments) const
+{
+    IntervalVariables variables = { arguments };
+    return evaluateOn<XInterval>(*this, variables);
+}
+
+bool XBytecode::isEmpty() const
+{
+    return instructions.empty();
+}
+
+int XBytecode::getCountInstructions() const
+{
+    return instructions.size();
+}
+
+int XBytecode::getCountResults() const
+{
+    return depth;
+}
+
+int XBytecode::getMaxDepth() const
+{
+    return maxDepth;
+}
+
+int XBytecode::getCountTemporaries() const
+{
+    return countTemporaries;
+}
+
+const XBytecode::Instruction *XBytecode::getInstructions() const
+{
+    return instructions.empty() ? nullptr : &instructions[0];
+}
+
+string XBytecode::getListing() const
+{
+    string ans;
+    char buffer[64];
+    for (int i = 0; i < (int)instructions.size(); i++)
+    {
+        const Instruction &instruction = instructions[i];
+        if (instruction.code == Constant || hasConstantOperand(instruction.code))
+        {
+            snprintf(buffer, sizeof(buffer), "%s %g\n", operationNames[instruction.code], instruction.constant);
+        }
+        else if (instruction.code == Load || instruction.code == Store)
+        {
+            snprintf(buffer, sizeof(buffer), "%s t%d\n", operationNames[instruction.code], instruction.slot);
+        }
+        else if (instruction.code == Variable && instruction.slot < 3)
+        {
+            snprintf(buffer, sizeof(buffer), "%s %c\n", operationNames[instruction.code], 'x' + instruction.slot);
+        }
+        else if (instruction.code == Variable)
+        {
+            snprintf(buffer, sizeof(buffer), "%s s%d\n", operationNames[instruction.code], instruction.slot);
+        }
+        else
+        {
+            snprintf(buffer, sizeof(buffer), "%s\n", operationNames[instruction.code]);
+        }
+        ans += buffer;
+    }
+    return ans;
+}
+
+int XBytecode::getCountOperands(OperationCode code)
+{
+    switch (code)
+    {
+    case Constant:
+    case Variable:
+    case Load:
+        return 0;
+    case Add:
+    case Subtract:
+    case Multiply:
+    case Divide:
+    case Power:
+        return 2;
+    default:
+        return 1;
+    }
+}
+
+// Folding goes through here, so a folded constant is exactly what the tree would compute.
+double XBytecode::apply(OperationCode code, double a, double b)
+{
+    switch (code)
+    {
+    case Add:
+        return a + b;
+    case Subtract:
+        return a - b;
+    case Multiply:
+        return a * b;
+    case Divide:
+        return a / b;
+    case Power:
+        return pow(a, b);
+    case Negate:
+        return -a;
+    case Sin:
+        return sin(a);
+    case Cos:
+        return cos(a);
+    case Tan:
+        return tan(a);
+    case Exp:
+        return exp(a);
+    case Ln:
+        return log(a);
+    default:
+        return a;
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "XVectorMath.h"
+#include "XInterval.h"
+
+class XAbstractParseNode;
+
+// A parse tree lowered to a flat program for a stack machine whose top is kept in a register.
+// Every node emits its instruction after the ones of its childs, so the program is the reverse polish
+// form of the tree. Subtrees without variables are folded into one constant while emitting, and an
+// operation whose right operand is a constant takes it inline instead of pushing it.
+// Variables are read from an argument array by slot, x is slot 0, y is 1 and z is 2.
+// A value used more than once can be kept in a temporary by Store and pushed again by Load, which is
+// how a program compiled from an XExpressionGraph computes a shared subexpression once.
+class XBytecode
+{
+public:
+    enum OperationCode
+    {
+        Constant,           // push constant
+        Variable,           // push arguments[slot]
+        Load,               // push temporaries[slot]
+        Store,              // temporaries[slot] = top, the top stays
+        Add,
+        Subtract,
+        Multiply,
+        Divide,
+        Power,
+        AddConstant,        // top op constant
+        SubtractConstant,
+        MultiplyConstant,
+        DivideConstant,
+        PowerConstant,
+        Square,             // x ^ 2, one correctly rounded multiplication instead of pow
+        Negate,
+        Sin,
+        Cos,
+        Tan,
+        Exp,
+        Ln,
+    };
+
+    struct Instruction
+    {
+        OperationCode code;
+        int slot;
+        double constant;
+    };
+
+    static const int maxTaylorOrder = 8;
+
+public:
+    XBytecode();
+    ~XBytecode();
+    void compile(const XAbstractParseNode *root);
+    void clear();
+    void emitConstant(double value);
+    void emitVariable(int slot);
+    void emitLoad(int slot);
+    void emitStore(int slot);
+    void emit(OperationCode code);
+    double evaluate(const double *arguments) const;
+    // f and df / d arguments[slot] in one pass with dual numbers
+    double evaluateDerivative(const double *arguments, int slot, double &derivative) const;
+    // f and gradient[s] = df / d arguments[s] for the slots of x, y and z
+    double evaluateGradient(const double *arguments, double gradient[3]) const;
+    // derivatives[k] = d^k f / d arguments[slot]^k for k from 0, f itself, to order, at most
+    // maxTaylorOrder, in one pass with truncated Taylor series
+    void evaluateTaylor(const double *arguments, int slot, int order, double *derivatives) const;
+    // a range holding f over the box where arguments[s] ranges over its interval
+    XInterval evaluateInterval(const XInterval *arguments) const;
+    // results[i] for the point whose slot s is columns[s][i], a null column reads as zeros
+    void evaluateBatch(const double *const *columns, int countColumns, double *results, int count,
+        XVectorMath::Accuracy accuracy = XVectorMath::Exact) const;
+    // results[r][i] for the r-th of several values left on the stack, as by XExpressionGraph::compile
+    // of several roots, in one pass over the columns; the other evaluations give the last value
+    void evaluateBatch(const double *const *columns, int countColumns, double *const *results, int countResults,
+        int count, XVectorMath::Accuracy accuracy = XVectorMath::Exact) const;
+    bool isEmpty() const;
+    int getCountResults() const;  // values left on the stack, 1 for a compiled expression
+    int getCountInstructions() const;
+    int getMaxDepth() const;
+    int getCountTemporaries() const;
+    const Instruction *getInstructions() const;
+    std::string getListing() const;
+
+    static int getCountOperands(OperationCode code);
+    static double apply(OperationCode code, double a, double b = 0.0);
+
+private:
+    std::vector<Instruction> instructions;
+    int depth;
+    int maxDepth;
+    int countTemporaries;
+};
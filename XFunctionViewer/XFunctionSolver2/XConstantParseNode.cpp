@@ -1,4 +1,6 @@
 #include "XConstantParseNode.h"
+#include "XBytecode.h"
+#include "XParseNodeArena.h"
 #include <cstdlib>
 #include <cstring>
 #include <cstdio>
@@ -26,7 +28,7 @@ string XConstantParseNode::getName() const
 string XConstantParseNode::getExpression() const
 {
     char buffer[20];
-    sprintf_s(buffer, "%lf", value);
+    snprintf(buffer, sizeof(buffer), "%lf", value);
     string ans = buffer;
     return ans;
 }
@@ -36,18 +38,21 @@ int XConstantParseNode::getCountChilds() const
     return -2;
 }
 
-XAbstractParseNode *XConstantParseNode::clone() const
+XAbstractParseNode *XConstantParseNode::clone(XParseNodeArena &arena) const
 {
-    XConstantParseNode *ans = new XConstantParseNode;
+    XConstantParseNode *ans = arena.create<XConstantParseNode>();
     ans->setValue(value);
     return ans;
 }
 
-XAbstractParseNode *XConstantParseNode::getDifferentiate() const
+XAbstractParseNode *XConstantParseNode::getDifferentiate(XParseNodeArena &arena) const
 {
-    XConstantParseNode *ans = new XConstantParseNode;
+    XConstantParseNode *ans = arena.create<XConstantParseNode>();
     ans->value = 0.0;
     return ans;
 }
 
-
+void XConstantParseNode::compile(XBytecode &code) const
+{
+    code.emitConstant(value);
+}
@@ -11,7 +11,8 @@ public:
     virtual std::string getName() const;
     virtual std::string getExpression() const;
     virtual int getCountChilds() const;
-    virtual XAbstractParseNode *clone() const;
-    virtual XAbstractParseNode *getDifferentiate() const;
+    virtual XAbstractParseNode *clone(XParseNodeArena &arena) const;
+    virtual XAbstractParseNode *getDifferentiate(XParseNodeArena &arena) const;
+    virtual void compile(XBytecode &code) const;
 };
 
@@ -0,0 +1,220 @@
+#pragma once
+#include <cmath>
+
+// A value together with its derivatives along count directions. Every operation applies the chain
+// rule to the derivatives while it computes the value, which is forward mode automatic
+// differentiation: one pass gives f and its partial derivatives, without a derivative expression.
+template <int count>
+class XDual
+{
+public:
+    XDual()
+    {
+    }
+
+    explicit XDual(double value)
+    {
+        this->value = value;
+        for (int i = 0; i < count; i++)
+        {
+            derivatives[i] = 0.0;
+        }
+    }
+
+    double value;
+    double derivatives[count];
+};
+
+template <int count>
+inline XDual<count> operator +(const XDual<count> &a, const XDual<count> &b)
+{
+    XDual<count> ans;
+    ans.value = a.value + b.value;
+    for (int i = 0; i < count; i++)
+    {
+        ans.derivatives[i] = a.derivatives[i] + b.derivatives[i];
+    }
+    return ans;
+}
+
+template <int count>
+inline XDual<count> operator -(const XDual<count> &a, const XDual<count> &b)
+{
+    XDual<count> ans;
+    ans.value = a.value - b.value;
+    for (int i = 0; i < count; i++)
+    {
+        ans.derivatives[i] = a.derivatives[i] - b.derivatives[i];
+    }
+    return ans;
+}
+
+template <int count>
+inline XDual<count> operator *(const XDual<count> &a, const XDual<count> &b)
+{
+    XDual<count> ans;
+    ans.value = a.value * b.value;
+    for (int i = 0; i < count; i++)
+    {
+        ans.derivatives[i] = a.derivatives[i] * b.value + a.value * b.derivatives[i];
+    }
+    return ans;
+}
+
+template <int count>
+inline XDual<count> operator /(const XDual<count> &a, const XDual<count> &b)
+{
+    XDual<count> ans;
+    ans.value = a.value / b.value;
+    for (int i = 0; i < count; i++)
+    {
+        ans.derivatives[i] = (a.derivatives[i] - ans.value * b.derivatives[i]) / b.value;
+    }
+    return ans;
+}
+
+template <int count>
+inline XDual<count> operator -(const XDual<count> &a)
+{
+    XDual<count> ans;
+    ans.value = -a.value;
+    for (int i = 0; i < count; i++)
+    {
+        ans.derivatives[i] = -a.derivatives[i];
+    }
+    return ans;
+}
+
+template <int count>
+inline XDual<count> operator +(const XDual<count> &a, double b)
+{
+    XDual<count> ans = a;
+    ans.value += b;
+    return ans;
+}
+
+template <int count>
+inline XDual<count> operator -(const XDual<count> &a, double b)
+{
+    XDual<count> ans = a;
+    ans.value -= b;
+    return ans;
+}
+
+template <int count>
+inline XDual<count> operator *(const XDual<count> &a, double b)
+{
+    XDual<count> ans;
+    ans.value = a.value * b;
+    for (int i = 0; i < count; i++)
+    {
+        ans.derivatives[i] = a.derivatives[i] * b;
+    }
+    return ans;
+}
+
+template <int count>
+inline XDual<count> operator /(const XDual<count> &a, double b)
+{
+    XDual<count> ans;
+    ans.value = a.value / b;
+    for (int i = 0; i < count; i++)
+    {
+        ans.derivatives[i] = a.derivatives[i] / b;
+    }
+    return ans;
+}
+
+// f(a) given its value and its derivative outer at a.value, the derivatives are outer * da.
+template <int count>
+inline XDual<count> chain(const XDual<count> &a, double value, double outer)
+{
+    XDual<count> ans;
+    ans.value = value;
+    for (int i = 0; i < count; i++)
+    {
+        ans.derivatives[i] = outer * a.derivatives[i];
+    }
+    return ans;
+}
+
+template <int count>
+inline XDual<count> square(const XDual<count> &a)
+{
+    return chain(a, a.value * a.value, 2.0 * a.value);
+}
+
+// b a^(b - 1) from a^b without a second pow, unless a is 0
+inline double powerDerivative(double a, double b, double power)
+{
+    if (b == 0.0)
+    {
+        return 0.0;
+    }
+    return a != 0.0 ? b * power / a : b * std::pow(a, b - 1.0);
+}
+
+// The power rule, which also holds for a negative base where exp(b ln a) does not.
+template <int count>
+inline XDual<count> pow(const XDual<count> &a, double b)
+{
+    double value = std::pow(a.value, b);
+    return chain(a, value, powerDerivative(a.value, b, value));
+}
+
+// d a^b = b a^(b - 1) da + a^b ln(a) db, each term taken only when its direction varies, so that
+// x ^ y by x is still defined for a negative x.
+template <int count>
+inline XDual<count> pow(const XDual<count> &a, const XDual<count> &b)
+{
+    XDual<count> ans;
+    ans.value = std::pow(a.value, b.value);
+    bool alongBase = false;
+    bool alongExponent = false;
+    for (int i = 0; i < count; i++)
+    {
+        alongBase = alongBase || a.derivatives[i] != 0.0;
+        alongExponent = alongExponent || b.derivatives[i] != 0.0;
+    }
+
+    double byBase = alongBase ? powerDerivative(a.value, b.value, ans.value) : 0.0;
+    double byExponent = alongExponent ? ans.value * std::log(a.value) : 0.0;
+    for (int i = 0; i < count; i++)
+    {
+        ans.derivatives[i] = (a.derivatives[i] != 0.0 ? byBase * a.derivatives[i] : 0.0)
+            + (b.derivatives[i] != 0.0 ? byExponent * b.derivatives[i] : 0.0);
+    }
+    return ans;
+}
+
+template <int count>
+inline XDual<count> sin(const XDual<count> &a)
+{
+    return chain(a, std::sin(a.value), std::cos(a.value));
+}
+
+template <int count>
+inline XDual<count> cos(const XDual<count> &a)
+{
+    return chain(a, std::cos(a.value), -std::sin(a.value));
+}
+
+template <int count>
+inline XDual<count> tan(const XDual<count> &a)
+{
+    double value = std::tan(a.value);
+    return chain(a, value, 1.0 + value * value);
+}
+
+template <int count>
+inline XDual<count> exp(const XDual<count> &a)
+{
+    double value = std::exp(a.value);
+    return chain(a, value, value);
+}
+
+template <int count>
+inline XDual<count> log(const XDual<count> &a)
+{
+    return chain(a, std::log(a.value), 1.0 / a.value);
+}
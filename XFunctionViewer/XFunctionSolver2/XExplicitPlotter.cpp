@@ -0,0 +1,278 @@
+#include "XExplicitPlotter.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+XExplicitPlotter::XExplicitPlotter()
+{
+    f = nullptr;
+    left = -20.0;
+    bottom = -20.0;
+    right = 20.0;
+    top = 20.0;
+    width = 900;
+    height = 900;
+    tolerance = 0.5;
+    spacing = 8.0;
+    maxDepth = 10;
+    countEvaluations = 0;
+}
+
+XExplicitPlotter::~XExplicitPlotter()
+{
+}
+
+void XExplicitPlotter::setFunction(XFunctionParser *f)
+{
+    this->f = f;
+}
+
+void XExplicitPlotter::setArea(double left, double bottom, double right, double top)
+{
+    this->left = left;
+    this->bottom = bottom;
+    this->right = right;
+    this->top = top;
+}
+
+void XExplicitPlotter::setResolution(int width, int height)
+{
+    this->width = width;
+    this->height = height;
+}
+
+void XExplicitPlotter::setTolerance(double pixels)
+{
+    tolerance = pixels;
+}
+
+void XExplicitPlotter::setSpacing(double pixels)
+{
+    spacing = pixels;
+}
+
+void XExplicitPlotter::setMaxDepth(int depth)
+{
+    maxDepth = depth;
+}
+
+// points[i] and gaps[i], the gap from points[i] to points[i + 1], are rebuilt at every level with
+// the midpoints of the open gaps put in.
+void XExplicitPlotter::extract()
+{
+    polylines.clear();
+    countEvaluations = 0;
+    if (f == nullptr || width <= 0 || height <= 0 || !(left < right))
+    {
+        return;
+    }
+
+    int count = max(1, (int)ceil(width / spacing));
+    vector<double> xs(count + 1);
+    vector<double> ys(count + 1);
+    for (int i = 0; i <= count; i++)
+    {
+        xs[i] = left + (right - left) * i / count;
+    }
+    f->getFunctions(&xs[0], nullptr, nullptr, &ys[0], count + 1);
+    countEvaluations += count + 1;
+
+    vector<Point> points(count + 1);
+    for (int i = 0; i <= count; i++)
+    {
+        points[i].x = xs[i];
+        points[i].y = ys[i];
+    }
+    vector<Gap> gaps(count, Open);
+    double minWidth = ldexp((right - left) / width, -maxDepth);
+    double pixelHeight = (top - bottom) / height;
+
+    vector<Point> nextPoints;
+    vector<Gap> nextGaps;
+    while (true)
+    {
+        xs.clear();
+        for (int i = 0; i < (int)gaps.size(); i++)
+        {
+            if (gaps[i] == Open)
+            {
+                xs.push_back((points[i].x + points[i + 1].x) / 2.0);
+            }
+        }
+        if (xs.empty())
+        {
+            break;
+        }
+        ys.resize(xs.size());
+        f->getFunctions(&xs[0], nullptr, nullptr, &ys[0], (int)xs.size());
+        countEvaluations += (int)xs.size();
+
+        nextPoints.clear();
+        nextGaps.clear();
+        int k = 0;
+        for (int i = 0; i < (int)gaps.size(); i++)
+        {
+            nextPoints.push_back(points[i]);
+            if (gaps[i] != Open)
+            {
+                nextGaps.push_back(gaps[i]);
+                continue;
+            }
+
+            const Point &a = points[i];
+            const Point &b = points[i + 1];
+            Point m = { xs[k], ys[k] };
+            k++;
+            nextPoints.push_back(m);
+            bool finite = isfinite(a.y) && isfinite(m.y) && isfinite(b.y);
+            if (!isfinite(a.y) && !isfinite(m.y) && !isfinite(b.y))
+            {
+                nextGaps.push_back(Broken);
+                nextGaps.push_back(Broken);
+                continue;
+            }
+            if (finite)
+            {
+                bool above = a.y > top && m.y > top && b.y > top;
+                bool below = a.y < bottom && m.y < bottom && b.y < bottom;
+                if ((fabs(m.y - (a.y + b.y) / 2.0) <= tolerance * pixelHeight && bounded(a, m, b)) || above || below)
+                {
+                    nextGaps.push_back(Joined);
+                    nextGaps.push_back(Joined);
+                    continue;
+                }
+            }
+            if ((b.x - a.x) / 2.0 > minWidth)
+            {
+                nextGaps.push_back(Open);
+                nextGaps.push_back(Open);
+                continue;
+            }
+            if (!finite)
+            {
+                nextGaps.push_back(isfinite(a.y) && isfinite(m.y) ? Joined : Broken);
+                nextGaps.push_back(isfinite(m.y) && isfinite(b.y) ? Joined : Broken);
+                continue;
+            }
+            // As narrow as it gets. A continuous f changes in both halves, while a jump or a pole
+            // leaves most of the change, or more, in one of them, which is then broken.
+            double before = fabs(m.y - a.y);
+            double after = fabs(b.y - m.y);
+            bool joined = max(before, after) <= max(tolerance * pixelHeight, 0.9 * fabs(b.y - a.y));
+            nextGaps.push_back(joined || before < after ? Joined : Broken);
+            nextGaps.push_back(joined || before >= after ? Joined : Broken);
+        }
+        nextPoints.push_back(points.back());
+        points.swap(nextPoints);
+        gaps.swap(nextGaps);
+    }
+
+    Polyline polyline;
+    for (int i = 0; i < (int)points.size(); i++)
+    {
+        if (isfinite(points[i].y))
+        {
+            polyline.push_back(points[i]);
+        }
+        if (i == (int)gaps.size() || gaps[i] != Joined)
+        {
+            if (polyline.size() > 1)
+            {
+                polylines.push_back(Polyline());
+                simplify(polyline, polylines.back());
+            }
+            polyline.clear();
+        }
+    }
+}
+
+// Whether the range of f over a gap wider than a pixel stays near its samples; between samples further
+// apart than its period f may swing freely while the samples look smooth. The range of a sum or a
+// product may be wider than the true one by about as much as f changes over the gap, hence the margin.
+bool XExplicitPlotter::bounded(const Point &a, const Point &m, const Point &b)
+{
+    double pixelWidth = (right - left) / width;
+    if (b.x - a.x <= pixelWidth)
+    {
+        return true;
+    }
+    double lower = min(min(a.y, m.y), b.y);
+    double upper = max(max(a.y, m.y), b.y);
+    double margin = upper - lower + tolerance * (top - bottom) / height;
+    XInterval range = f->getFunctionInterval(XInterval(a.x, b.x), XInterval(0.0));
+    countEvaluations++;
+    return range.lower >= lower - margin && range.upper <= upper + margin;
+}
+
+const vector<XExplicitPlotter::Polyline> &XExplicitPlotter::getPolylines() const
+{
+    return polylines;
+}
+
+int XExplicitPlotter::getCountEvaluations() const
+{
+    return countEvaluations;
+}
+
+// Douglas-Peucker in pixels: a point stays when it is further than tolerance from the segment between
+// the points kept around it.
+void XExplicitPlotter::simplify(const Polyline &polyline, Polyline &result) const
+{
+    double scaleX = width / (right - left);
+    double scaleY = height / (top - bottom);
+    int count = (int)polyline.size();
+    vector<bool> keep(count, false);
+    keep[0] = true;
+    keep[count - 1] = true;
+    vector<int> ranges;
+    ranges.push_back(0);
+    ranges.push_back(count - 1);
+    while (!ranges.empty())
+    {
+        int last = ranges.back();
+        ranges.pop_back();
+        int first = ranges.back();
+        ranges.pop_back();
+
+        double x0 = polyline[first].x * scaleX;
+        double y0 = polyline[first].y * scaleY;
+        double dx = polyline[last].x * scaleX - x0;
+        double dy = polyline[last].y * scaleY - y0;
+        double length = dx * dx + dy * dy;
+        int furthest = -1;
+        double distance = tolerance;
+        for (int i = first + 1; i < last; i++)
+        {
+            double px = polyline[i].x * scaleX - x0;
+            double py = polyline[i].y * scaleY - y0;
+            double t = length > 0.0 ? max(0.0, min(1.0, (px * dx + py * dy) / length)) : 0.0;
+            double d = hypot(px - t * dx, py - t * dy);
+            if (!(d <= distance))
+            {
+                furthest = i;
+                distance = d;
+                if (isnan(d))
+                {
+                    break;
+                }
+            }
+        }
+        if (furthest >= 0)
+        {
+            keep[furthest] = true;
+            ranges.push_back(first);
+            ranges.push_back(furthest);
+            ranges.push_back(furthest);
+            ranges.push_back(last);
+        }
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        if (keep[i])
+        {
+            result.push_back(polyline[i]);
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <vector>
+#include "XFunctionParser.h"
+
+// The graph of y = f(x) over an area as polylines, sampled where the curve needs it rather than once
+// a pixel. f is first sampled every few pixels, and each gap between samples gets its midpoint; a gap
+// is kept when the midpoint is within tolerance of the chord, which is the second difference of f and
+// so grows with the curvature, and, for a gap wider than a pixel, the range of f over it (see
+// XInterval) stays within tolerance of the samples, which catches what swings between them. A gap
+// whose samples are all above or all below the area is kept as well, anything else is halved. Gaps
+// are halved a level at a time, with the midpoints of a level evaluated in one batch. A gap still not
+// kept after maxDepth halvings below a pixel holds a jump or a pole when most of the change of f is in
+// one of its halves, and then ends the polyline; so does a gap next to a point where f is not finite,
+// as ln left of 0. Each polyline is finally thinned to the fewest points within tolerance of it.
+class XExplicitPlotter
+{
+public:
+    struct Point
+    {
+        double x;
+        double y;
+    };
+
+    typedef std::vector<Point> Polyline;
+
+public:
+    XExplicitPlotter();
+    ~XExplicitPlotter();
+    void setFunction(XFunctionParser *f);
+    void setArea(double left, double bottom, double right, double top);
+    void setResolution(int width, int height);  // in pixels
+    void setTolerance(double pixels);           // 0.5 by default
+    void setSpacing(double pixels);             // of the first samples, 8 by default
+    void setMaxDepth(int depth);                // halvings below a pixel, 10 by default
+    void extract();
+    const std::vector<Polyline> &getPolylines() const;
+    int getCountEvaluations() const;            // of f at points and over ranges, in the last extract
+
+private:
+    enum Gap
+    {
+        Open,
+        Joined,
+        Broken
+    };
+
+    bool bounded(const Point &a, const Point &m, const Point &b);
+    void simplify(const Polyline &polyline, Polyline &result) const;
+
+    XFunctionParser *f;
+    double left;
+    double bottom;
+    double right;
+    double top;
+    int width;
+    int height;
+    double tolerance;
+    double spacing;
+    int maxDepth;
+    int countEvaluations;
+    std::vector<Polyline> polylines;
+};
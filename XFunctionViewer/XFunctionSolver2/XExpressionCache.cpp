@@ -0,0 +1,194 @@
+#include "XExpressionCache.h"
+#include <algorithm>
+#include <cctype>
+
+using namespace std;
+
+XExpressionCache::Expression::Expression()
+{
+    root = nullptr;
+    graphRoot = -1;
+}
+
+XExpressionCache::Expression::~Expression()
+{
+}
+
+shared_ptr<const XExpressionCache::Expression> XExpressionCache::Expression::getDerivative(int slot) const
+{
+    lock_guard<std::mutex> lock(mutex);
+    shared_ptr<const Expression> &ans = derivatives[slot];
+    if (ans == nullptr)
+    {
+        shared_ptr<Expression> derivative = make_shared<Expression>();
+        derivative->symbols = symbols;
+        derivative->graph = graph;
+        derivative->graphRoot = derivative->graph.differentiate(
+            graphRoot >= 0 ? graphRoot : derivative->graph.constant(0.0), slot);
+        derivative->graph.compile(derivative->graphRoot, derivative->bytecode);
+        ans = derivative;
+    }
+    return ans;
+}
+
+shared_ptr<const XExpressionCache::Expression> XExpressionCache::Expression::getDerivative(int slot, int order) const
+{
+    shared_ptr<const Expression> ans = getDerivative(slot);
+    for (int k = 1; k < order; k++)
+    {
+        ans = ans->getDerivative(slot);
+    }
+    return ans;
+}
+
+// The derivatives are taken on one copy of the graph, so the program computes what f and each of
+// them share only once.
+shared_ptr<const XBytecode> XExpressionCache::Expression::getDerivativesProgram(int slot, int order) const
+{
+    lock_guard<std::mutex> lock(mutex);
+    shared_ptr<const XBytecode> &ans = derivativesPrograms[make_pair(slot, order)];
+    if (ans == nullptr)
+    {
+        XExpressionGraph derivativesGraph = graph;
+        vector<int> roots(1, graphRoot >= 0 ? graphRoot : derivativesGraph.constant(0.0));
+        for (int k = 1; k <= order; k++)
+        {
+            roots.push_back(derivativesGraph.differentiate(roots.back(), slot));
+        }
+        shared_ptr<XBytecode> program = make_shared<XBytecode>();
+        derivativesGraph.compile(roots, *program);
+        ans = program;
+    }
+    return ans;
+}
+
+XExpressionCache::XExpressionCache()
+{
+    capacity = 64;
+    countHits = 0;
+    countMisses = 0;
+}
+
+XExpressionCache::~XExpressionCache()
+{
+}
+
+void XExpressionCache::setCapacity(int capacity)
+{
+    lock_guard<std::mutex> lock(mutex);
+    this->capacity = capacity;
+    evict();
+}
+
+int XExpressionCache::getCapacity() const
+{
+    lock_guard<std::mutex> lock(mutex);
+    return capacity;
+}
+
+shared_ptr<const XExpressionCache::Expression> XExpressionCache::find(const string &key)
+{
+    lock_guard<std::mutex> lock(mutex);
+    unordered_map<string, Entries::iterator>::iterator found = index.find(key);
+    if (found == index.end())
+    {
+        countMisses++;
+        return nullptr;
+    }
+    countHits++;
+    entries.splice(entries.begin(), entries, found->second);
+    return found->second->second;
+}
+
+shared_ptr<const XExpressionCache::Expression> XExpressionCache::insert(const string &key,
+    shared_ptr<const Expression> expression)
+{
+    lock_guard<std::mutex> lock(mutex);
+    unordered_map<string, Entries::iterator>::iterator found = index.find(key);
+    if (found != index.end())
+    {
+        entries.splice(entries.begin(), entries, found->second);
+        return found->second->second;
+    }
+    entries.push_front(make_pair(key, expression));
+    index[key] = entries.begin();
+    evict();
+    return expression;
+}
+
+void XExpressionCache::clear()
+{
+    lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+}
+
+int XExpressionCache::getCountExpressions() const
+{
+    lock_guard<std::mutex> lock(mutex);
+    return (int)entries.size();
+}
+
+int XExpressionCache::getCountHits() const
+{
+    lock_guard<std::mutex> lock(mutex);
+    return countHits;
+}
+
+int XExpressionCache::getCountMisses() const
+{
+    lock_guard<std::mutex> lock(mutex);
+    return countMisses;
+}
+
+// Spaces are dropped but where they part two tokens, as in sin x, 2 .5 or 1e -3, and any run of
+// them that stays becomes one space. The bound names follow the source after a line break.
+string XExpressionCache::getKey(const string &source, const XSymbolTable &symbols)
+{
+    string ans;
+    ans.reserve(source.length() + 16);
+    bool space = false;
+    for (int i = 0; i < (int)source.length(); i++)
+    {
+        char c = source[i];
+        if (isspace((unsigned char)c))
+        {
+            space = true;
+            continue;
+        }
+        if (space && !ans.empty())
+        {
+            char last = ans.back();
+            bool word = isalnum((unsigned char)last) || last == '_' || last == '.';
+            bool next = isalnum((unsigned char)c) || c == '_' || c == '.';
+            if ((word && next) || ((last == 'e' || last == 'E') && (c == '+' || c == '-')))
+            {
+                ans += ' ';
+            }
+        }
+        space = false;
+        ans += c;
+    }
+    ans += '\n';
+    for (int s = 0; s < symbols.getCountSlots(); s++)
+    {
+        ans += symbols.getName(s);
+        ans += ',';
+    }
+    return ans;
+}
+
+XExpressionCache &XExpressionCache::getShared()
+{
+    static XExpressionCache shared;
+    return shared;
+}
+
+void XExpressionCache::evict()
+{
+    while ((int)entries.size() > max(capacity, 0))
+    {
+        index.erase(entries.back().first);
+        entries.pop_back();
+    }
+}
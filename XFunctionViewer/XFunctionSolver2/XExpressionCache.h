@@ -0,0 +1,86 @@
+#pragma once
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "XBytecode.h"
+#include "XExpressionGraph.h"
+#include "XLexer.h"
+#include "XParseNodeArena.h"
+#include "XSymbolTable.h"
+
+// Compiled expressions shared by the parsers that set the same source, so a source seen before is
+// neither parsed nor compiled again, and neither are its derivatives. A source is keyed with its
+// spaces normalized and with the names bound in the parser before it, which decide the slots of its
+// variables. The least recently used expressions are dropped past the capacity; a parser keeps the
+// one it uses alive whether or not it is still in the cache.
+// All members may be called from any thread. Expressions are never changed once made, apart from
+// their derivatives, which are made once under a lock of their own.
+class XExpressionCache
+{
+public:
+    class Expression
+    {
+    public:
+        Expression();
+        ~Expression();
+        // made on first use and kept, so every parser asking for it gets the same one
+        std::shared_ptr<const Expression> getDerivative(int slot) const;
+        // the derivative of the derivative and on, order >= 1, each kept by the one before it
+        std::shared_ptr<const Expression> getDerivative(int slot, int order) const;
+        // one program leaving f and its derivatives up to order on the stack, for
+        // XBytecode::evaluateBatch of several results; made on first use and kept
+        std::shared_ptr<const XBytecode> getDerivativesProgram(int slot, int order) const;
+
+        std::string source;
+        std::vector<XToken> polishTokens;  // pointing into source
+        XSymbolTable symbols;              // as bound after parsing
+        XParseNodeArena arena;
+        XAbstractParseNode *root;          // the parse tree, nullptr for a derivative
+        XBytecode bytecode;
+        XExpressionGraph graph;            // the expression again, simplified and shared, derivatives are taken on it
+        int graphRoot;
+
+    private:
+        Expression(const Expression &);
+        Expression &operator=(const Expression &);
+
+        mutable std::mutex mutex;
+        mutable std::map<int, std::shared_ptr<const Expression> > derivatives;
+        mutable std::map<std::pair<int, int>, std::shared_ptr<const XBytecode> > derivativesPrograms;
+    };
+
+public:
+    XExpressionCache();
+    ~XExpressionCache();
+    void setCapacity(int capacity);  // in expressions, 64 by default
+    int getCapacity() const;
+    std::shared_ptr<const Expression> find(const std::string &key);  // nullptr when not cached
+    // the expression cached under key, which is expression unless another was put there first
+    std::shared_ptr<const Expression> insert(const std::string &key, std::shared_ptr<const Expression> expression);
+    void clear();
+    int getCountExpressions() const;
+    int getCountHits() const;
+    int getCountMisses() const;
+
+    static std::string getKey(const std::string &source, const XSymbolTable &symbols);
+    static XExpressionCache &getShared();  // the cache parsers use unless given another
+
+private:
+    typedef std::list<std::pair<std::string, std::shared_ptr<const Expression> > > Entries;
+
+    XExpressionCache(const XExpressionCache &);
+    XExpressionCache &operator=(const XExpressionCache &);
+
+    void evict();
+
+    mutable std::mutex mutex;
+    Entries entries;  // most recently used first
+    std::unordered_map<std::string, Entries::iterator> index;
+    int capacity;
+    int countHits;
+    int countMisses;
+};
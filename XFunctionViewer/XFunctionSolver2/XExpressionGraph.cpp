@@ -0,0 +1,535 @@
+#include "XExpressionGraph.h"
+#include "XBasicParseNodes.h"
+#include "XConstantParseNode.h"
+#include "XParseNodeArena.h"
+#include "XVariableParseNode.h"
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+using namespace std;
+
+static bool isInteger(double value)
+{
+    return value == floor(value) && fabs(value) < 1e15;
+}
+
+size_t XExpressionGraph::NodeHash::operator()(const Node &node) const
+{
+    unsigned long long bits;
+    memcpy(&bits, &node.constant, sizeof(bits));
+    size_t ans = node.code;
+    ans = ans * 1000003u ^ (size_t)node.childs[0];
+    ans = ans * 1000003u ^ (size_t)node.childs[1];
+    ans = ans * 1000003u ^ (size_t)node.slot;
+    ans = ans * 1000003u ^ (size_t)(bits ^ bits >> 32);
+    return ans;
+}
+
+// Constants compare by their bits, so 0 and -0 stay apart and a NaN finds itself.
+bool XExpressionGraph::NodeEqual::operator()(const Node &a, const Node &b) const
+{
+    return a.code == b.code && a.childs[0] == b.childs[0] && a.childs[1] == b.childs[1] && a.slot == b.slot
+        && memcmp(&a.constant, &b.constant, sizeof(double)) == 0;
+}
+
+XExpressionGraph::XExpressionGraph()
+{
+}
+
+XExpressionGraph::~XExpressionGraph()
+{
+}
+
+void XExpressionGraph::clear()
+{
+    nodes.clear();
+    table.clear();
+}
+
+int XExpressionGraph::constant(double value)
+{
+    return make(XBytecode::Constant, -1, -1, 0, value);
+}
+
+int XExpressionGraph::variable(int slot)
+{
+    return make(XBytecode::Variable, -1, -1, slot, 0.0);
+}
+
+int XExpressionGraph::unary(XBytecode::OperationCode code, int a)
+{
+    Node na = nodes[a];
+    if (na.code == XBytecode::Constant)
+    {
+        return constant(XBytecode::apply(code, na.constant));
+    }
+
+    if (code == XBytecode::Negate && na.code == XBytecode::Negate)
+    {
+        return na.childs[0];
+    }
+    if (code == XBytecode::Negate && na.code == XBytecode::Subtract)
+    {
+        return binary(XBytecode::Subtract, na.childs[1], na.childs[0]);
+    }
+    if (code == XBytecode::Ln && na.code == XBytecode::Exp)
+    {
+        return na.childs[0];
+    }
+
+    return make(code, a, -1, 0, 0.0);
+}
+
+// The operands of + and * are put in a canonical order, a constant on the right where the stack
+// machine takes it inline, so that a + b and b + a are one node.
+int XExpressionGraph::binary(XBytecode::OperationCode code, int a, int b)
+{
+    Node na = nodes[a];
+    Node nb = nodes[b];
+    if (na.code == XBytecode::Constant && nb.code == XBytecode::Constant)
+    {
+        return constant(XBytecode::apply(code, na.constant, nb.constant));
+    }
+
+    switch (code)
+    {
+    case XBytecode::Add:
+        if (isConstant(a, 0.0))
+        {
+            return b;
+        }
+        if (isConstant(b, 0.0))
+        {
+            return a;
+        }
+        if (nb.code == XBytecode::Negate)
+        {
+            return binary(XBytecode::Subtract, a, nb.childs[0]);
+        }
+        if (na.code == XBytecode::Negate)
+        {
+            return binary(XBytecode::Subtract, b, na.childs[0]);
+        }
+        if (a == b)
+        {
+            return binary(XBytecode::Multiply, a, constant(2.0));
+        }
+        if (na.code == XBytecode::Constant || (nb.code != XBytecode::Constant && a > b))
+        {
+            swap(a, b);
+        }
+        break;
+    case XBytecode::Subtract:
+        if (isConstant(b, 0.0))
+        {
+            return a;
+        }
+        if (isConstant(a, 0.0))
+        {
+            return unary(XBytecode::Negate, b);
+        }
+        if (a == b)
+        {
+            return constant(0.0);
+        }
+        if (nb.code == XBytecode::Negate)
+        {
+            return binary(XBytecode::Add, a, nb.childs[0]);
+        }
+        if (na.code == XBytecode::Negate)
+        {
+            return unary(XBytecode::Negate, binary(XBytecode::Add, na.childs[0], b));
+        }
+        break;
+    case XBytecode::Multiply:
+        if (na.code == XBytecode::Constant)
+        {
+            swap(a, b);
+            swap(na, nb);
+        }
+        if (nb.code == XBytecode::Constant)
+        {
+            if (nb.constant == 0.0)
+            {
+                return constant(0.0);
+            }
+            if (nb.constant == 1.0)
+            {
+                return a;
+            }
+            if (nb.constant == -1.0)
+            {
+                return unary(XBytecode::Negate, a);
+            }
+            if (na.code == XBytecode::Negate)
+            {
+                return binary(XBytecode::Multiply, na.childs[0], constant(-nb.constant));
+            }
+            if (na.code == XBytecode::Multiply && nodes[na.childs[1]].code == XBytecode::Constant)
+            {
+                return binary(XBytecode::Multiply, na.childs[0], constant(nodes[na.childs[1]].constant * nb.constant));
+            }
+            break;
+        }
+        if (na.code == XBytecode::Negate)
+        {
+            return unary(XBytecode::Negate, binary(XBytecode::Multiply, na.childs[0], b));
+        }
+        if (nb.code == XBytecode::Negate)
+        {
+            return unary(XBytecode::Negate, binary(XBytecode::Multiply, a, nb.childs[0]));
+        }
+        if (a == b)
+        {
+            return binary(XBytecode::Power, a, constant(2.0));
+        }
+        if (a > b)
+        {
+            swap(a, b);
+        }
+        break;
+    case XBytecode::Divide:
+        if (isConstant(b, 1.0))
+        {
+            return a;
+        }
+        if (isConstant(b, -1.0))
+        {
+            return unary(XBytecode::Negate, a);
+        }
+        if (isConstant(a, 0.0))
+        {
+            return constant(0.0);
+        }
+        if (na.code == XBytecode::Negate)
+        {
+            return unary(XBytecode::Negate, binary(XBytecode::Divide, na.childs[0], b));
+        }
+        if (nb.code == XBytecode::Negate)
+        {
+            return unary(XBytecode::Negate, binary(XBytecode::Divide, a, nb.childs[0]));
+        }
+        break;
+    case XBytecode::Power:
+        if (isConstant(b, 1.0))
+        {
+            return a;
+        }
+        if (isConstant(b, 0.0) || isConstant(a, 1.0))
+        {
+            return constant(1.0);
+        }
+        // (a ^ m) ^ n = a ^ (m n) holds for integers only, (x ^ 2) ^ 0.5 is |x|
+        if (nb.code == XBytecode::Constant && na.code == XBytecode::Power && nodes[na.childs[1]].code == XBytecode::Constant
+            && isInteger(nb.constant) && isInteger(nodes[na.childs[1]].constant))
+        {
+            return binary(XBytecode::Power, na.childs[0], constant(nodes[na.childs[1]].constant * nb.constant));
+        }
+        break;
+    default:
+        break;
+    }
+
+    return make(code, a, b, 0, 0.0);
+}
+
+// Reads a program back into nodes, a temporary becomes the node that was stored in it.
+int XExpressionGraph::insert(const XBytecode &code)
+{
+    vector<int> stack;
+    vector<int> temporaries(code.getCountTemporaries(), -1);
+    const XBytecode::Instruction *instructions = code.getInstructions();
+    for (int i = 0; i < code.getCountInstructions(); i++)
+    {
+        const XBytecode::Instruction &instruction = instructions[i];
+        switch (instruction.code)
+        {
+        case XBytecode::Constant:
+            stack.push_back(constant(instruction.constant));
+            break;
+        case XBytecode::Variable:
+            stack.push_back(variable(instruction.slot));
+            break;
+        case XBytecode::Load:
+            stack.push_back(temporaries[instruction.slot]);
+            break;
+        case XBytecode::Store:
+            temporaries[instruction.slot] = stack.back();
+            break;
+        case XBytecode::AddConstant:
+        case XBytecode::SubtractConstant:
+        case XBytecode::MultiplyConstant:
+        case XBytecode::DivideConstant:
+        case XBytecode::PowerConstant:
+            stack.back() = binary((XBytecode::OperationCode)(XBytecode::Add + (instruction.code - XBytecode::AddConstant)),
+                stack.back(), constant(instruction.constant));
+            break;
+        case XBytecode::Square:
+            stack.back() = binary(XBytecode::Power, stack.back(), constant(2.0));
+            break;
+        default:
+            if (XBytecode::getCountOperands(instruction.code) == 2)
+            {
+                int b = stack.back();
+                stack.pop_back();
+                stack.back() = binary(instruction.code, stack.back(), b);
+            }
+            else
+            {
+                stack.back() = unary(instruction.code, stack.back());
+            }
+            break;
+        }
+    }
+
+    return stack.empty() ? constant(0.0) : stack.back();
+}
+
+// d node / d arguments[slot]
+int XExpressionGraph::differentiate(int node, int slot)
+{
+    vector<int> derivatives(nodes.size(), -1);
+    return differentiate(node, slot, derivatives);
+}
+
+const XExpressionGraph::Node &XExpressionGraph::getNode(int index) const
+{
+    return nodes[index];
+}
+
+int XExpressionGraph::getCountNodes() const
+{
+    return nodes.size();
+}
+
+int XExpressionGraph::getCountReachable(int root) const
+{
+    vector<int> uses(nodes.size(), 0);
+    countUses(root, uses);
+    int ans = 0;
+    for (int i = 0; i < (int)uses.size(); i++)
+    {
+        ans += uses[i] > 0 ? 1 : 0;
+    }
+    return ans;
+}
+
+void XExpressionGraph::compile(int root, XBytecode &code) const
+{
+    compile(vector<int>(1, root), code);
+}
+
+// A root counts as a use of its own, so one that another root also needs is stored for it.
+void XExpressionGraph::compile(const vector<int> &roots, XBytecode &code) const
+{
+    code.clear();
+    vector<int> uses(nodes.size(), 0);
+    for (int r = 0; r < (int)roots.size(); r++)
+    {
+        countUses(roots[r], uses);
+    }
+    vector<int> temporaries(nodes.size(), -1);
+    int countTemporaries = 0;
+    for (int r = 0; r < (int)roots.size(); r++)
+    {
+        compile(roots[r], uses, temporaries, countTemporaries, code);
+    }
+}
+
+// The tree repeats a shared node wherever it is used, it is meant for showing the expression
+// and for walking it the way the parse tree of a source is walked.
+XAbstractParseNode *XExpressionGraph::createTree(int root, XParseNodeArena &arena) const
+{
+    const Node &node = nodes[root];
+    switch (node.code)
+    {
+    case XBytecode::Constant:
+        return arena.create<XConstantParseNode>(node.constant);
+    case XBytecode::Variable:
+    {
+        XVariableParseNode *ans = arena.create<XVariableParseNode>();
+        ans->slot = node.slot;
+        return ans;
+    }
+    case XBytecode::Add:
+        return arena.create<XPlusParseNode>(createTree(node.childs[0], arena), createTree(node.childs[1], arena));
+    case XBytecode::Subtract:
+        return arena.create<XMinusParseNode>(createTree(node.childs[0], arena), createTree(node.childs[1], arena));
+    case XBytecode::Multiply:
+        return arena.create<XMultiplyParseNode>(createTree(node.childs[0], arena), createTree(node.childs[1], arena));
+    case XBytecode::Divide:
+        return arena.create<XDivideParseNode>(createTree(node.childs[0], arena), createTree(node.childs[1], arena));
+    case XBytecode::Power:
+        return arena.create<XPowerParseNode>(createTree(node.childs[0], arena), createTree(node.childs[1], arena));
+    case XBytecode::Negate:
+        return arena.create<XNegateParseNode>(createTree(node.childs[0], arena));
+    case XBytecode::Sin:
+        return arena.create<XSinParseNode>(createTree(node.childs[0], arena));
+    case XBytecode::Cos:
+        return arena.create<XCosParseNode>(createTree(node.childs[0], arena));
+    case XBytecode::Tan:
+        return arena.create<XTanParseNode>(createTree(node.childs[0], arena));
+    case XBytecode::Exp:
+        return arena.create<XExpParseNode>(createTree(node.childs[0], arena));
+    case XBytecode::Ln:
+        return arena.create<XLnParseNode>(createTree(node.childs[0], arena));
+    default:
+        return nullptr;
+    }
+}
+
+int XExpressionGraph::make(XBytecode::OperationCode code, int a, int b, int slot, double value)
+{
+    Node node = { code, { a, b }, slot, value };
+    unordered_map<Node, int, NodeHash, NodeEqual>::const_iterator found = table.find(node);
+    if (found != table.end())
+    {
+        return found->second;
+    }
+
+    nodes.push_back(node);
+    table[node] = nodes.size() - 1;
+    return nodes.size() - 1;
+}
+
+bool XExpressionGraph::isConstant(int node, double value) const
+{
+    return nodes[node].code == XBytecode::Constant && nodes[node].constant == value;
+}
+
+// Every rule refers to the node itself where the derivative contains it, d exp(a) = exp(a) da,
+// and the quotient rule is written as (da - (a / b) db) / b for the same reason.
+int XExpressionGraph::differentiate(int node, int slot, vector<int> &derivatives)
+{
+    if (derivatives[node] >= 0)
+    {
+        return derivatives[node];
+    }
+
+    Node n = nodes[node];
+    int a = n.childs[0];
+    int b = n.childs[1];
+    int ans;
+    switch (n.code)
+    {
+    case XBytecode::Constant:
+        ans = constant(0.0);
+        break;
+    case XBytecode::Variable:
+        ans = constant(n.slot == slot ? 1.0 : 0.0);
+        break;
+    case XBytecode::Add:
+        ans = binary(XBytecode::Add, differentiate(a, slot, derivatives), differentiate(b, slot, derivatives));
+        break;
+    case XBytecode::Subtract:
+        ans = binary(XBytecode::Subtract, differentiate(a, slot, derivatives), differentiate(b, slot, derivatives));
+        break;
+    case XBytecode::Multiply:
+        ans = binary(XBytecode::Add,
+            binary(XBytecode::Multiply, differentiate(a, slot, derivatives), b),
+            binary(XBytecode::Multiply, a, differentiate(b, slot, derivatives)));
+        break;
+    case XBytecode::Divide:
+        ans = binary(XBytecode::Divide,
+            binary(XBytecode::Subtract, differentiate(a, slot, derivatives),
+                binary(XBytecode::Multiply, node, differentiate(b, slot, derivatives))),
+            b);
+        break;
+    case XBytecode::Power:
+        if (nodes[b].code == XBytecode::Constant)
+        {
+            double c = nodes[b].constant;
+            ans = binary(XBytecode::Multiply,
+                binary(XBytecode::Multiply, binary(XBytecode::Power, a, constant(c - 1.0)), constant(c)),
+                differentiate(a, slot, derivatives));
+        }
+        else if (nodes[a].code == XBytecode::Constant)
+        {
+            ans = binary(XBytecode::Multiply,
+                binary(XBytecode::Multiply, node, constant(log(nodes[a].constant))),
+                differentiate(b, slot, derivatives));
+        }
+        else
+        {
+            ans = binary(XBytecode::Multiply, node,
+                binary(XBytecode::Add,
+                    binary(XBytecode::Multiply, differentiate(b, slot, derivatives), unary(XBytecode::Ln, a)),
+                    binary(XBytecode::Divide, binary(XBytecode::Multiply, b, differentiate(a, slot, derivatives)), a)));
+        }
+        break;
+    case XBytecode::Negate:
+        ans = unary(XBytecode::Negate, differentiate(a, slot, derivatives));
+        break;
+    case XBytecode::Sin:
+        ans = binary(XBytecode::Multiply, unary(XBytecode::Cos, a), differentiate(a, slot, derivatives));
+        break;
+    case XBytecode::Cos:
+        ans = unary(XBytecode::Negate, binary(XBytecode::Multiply, unary(XBytecode::Sin, a), differentiate(a, slot, derivatives)));
+        break;
+    case XBytecode::Tan:
+        ans = binary(XBytecode::Divide, differentiate(a, slot, derivatives),
+            binary(XBytecode::Power, unary(XBytecode::Cos, a), constant(2.0)));
+        break;
+    case XBytecode::Exp:
+        ans = binary(XBytecode::Multiply, node, differentiate(a, slot, derivatives));
+        break;
+    case XBytecode::Ln:
+        ans = binary(XBytecode::Divide, differentiate(a, slot, derivatives), a);
+        break;
+    default:
+        ans = constant(0.0);
+        break;
+    }
+
+    derivatives[node] = ans;
+    return ans;
+}
+
+void XExpressionGraph::countUses(int node, vector<int> &uses) const
+{
+    if (uses[node]++ > 0)
+    {
+        return;
+    }
+
+    for (int i = 0; i < 2 && nodes[node].childs[i] >= 0; i++)
+    {
+        countUses(nodes[node].childs[i], uses);
+    }
+}
+
+// Post order as the parse nodes compile, except that a node used more than once is stored after
+// its first evaluation and loaded from then on. Constants and variables are cheaper to push again.
+void XExpressionGraph::compile(int node, const vector<int> &uses, vector<int> &temporaries, int &countTemporaries, XBytecode &code) const
+{
+    if (temporaries[node] >= 0)
+    {
+        code.emitLoad(temporaries[node]);
+        return;
+    }
+
+    const Node &n = nodes[node];
+    if (n.code == XBytecode::Constant)
+    {
+        code.emitConstant(n.constant);
+        return;
+    }
+    if (n.code == XBytecode::Variable)
+    {
+        code.emitVariable(n.slot);
+        return;
+    }
+
+    for (int i = 0; i < 2 && n.childs[i] >= 0; i++)
+    {
+        compile(n.childs[i], uses, temporaries, countTemporaries, code);
+    }
+    code.emit(n.code);
+
+    if (uses[node] > 1)
+    {
+        temporaries[node] = countTemporaries++;
+        code.emitStore(temporaries[node]);
+    }
+}
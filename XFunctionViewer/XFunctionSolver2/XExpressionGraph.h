@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+#include "XBytecode.h"
+
+class XAbstractParseNode;
+class XParseNodeArena;
+
+// Expressions as a DAG of hash consed nodes: asking for a node equal to an existing one returns the
+// existing one, so a common subexpression is one node however often it is used. Nodes are built only
+// through constant, variable, unary and binary, which fold constants and apply identities such as
+// x * 1, x + 0, x ^ 1 and ~~x, so whatever is built is already simplified.
+// A node is named by its index and the kinds of node are the stack machine's own operation codes.
+// Derivatives are memoized per node, so the derivative of an expression has a size linear in it,
+// and compile emits every shared node once, keeping its value in a temporary.
+class XExpressionGraph
+{
+public:
+    struct Node
+    {
+        XBytecode::OperationCode code;  // Constant, Variable, Add ... Power, Negate ... Ln
+        int childs[2];                  // -1 where there is no child
+        int slot;                       // of a variable
+        double constant;
+    };
+
+public:
+    XExpressionGraph();
+    ~XExpressionGraph();
+    void clear();
+    int constant(double value);
+    int variable(int slot);
+    int unary(XBytecode::OperationCode code, int a);
+    int binary(XBytecode::OperationCode code, int a, int b);
+    int insert(const XBytecode &code);
+    int differentiate(int node, int slot);
+    void compile(int root, XBytecode &code) const;
+    // one program leaving the value of every root on the stack in turn, sharing what they have in common
+    void compile(const std::vector<int> &roots, XBytecode &code) const;
+    XAbstractParseNode *createTree(int root, XParseNodeArena &arena) const;
+    const Node &getNode(int index) const;
+    int getCountNodes() const;
+    int getCountReachable(int root) const;
+
+private:
+    struct NodeHash
+    {
+        std::size_t operator()(const Node &node) const;
+    };
+
+    struct NodeEqual
+    {
+        bool operator()(const Node &a, const Node &b) const;
+    };
+
+    int make(XBytecode::OperationCode code, int a, int b, int slot, double value);
+    bool isConstant(int node, double value) const;
+    int differentiate(int node, int slot, std::vector<int> &derivatives);
+    void countUses(int node, std::vector<int> &uses) const;
+    void compile(int node, const std::vector<int> &uses, std::vector<int> &temporaries, int &countTemporaries, XBytecode &code) const;
+
+    std::vector<Node> nodes;
+    std::unordered_map<Node, int, NodeHash, NodeEqual> table;
+};
@@ -1,369 +1,302 @@
 #include "XFunctionParser.h"
-#include <cctype>
-#include <stack>
 
 using namespace std;
 
-static    bool isDouble(string &str)
+XFunctionParser::XFunctionParser()
 {
-    if (isdigit(str[0])
-        || str[0] == '-' && isdigit(str[1])
-        || str[0] == '.')
-    {
-        return true;
-    }
-    else
-    {
-        return false;
-    }
+    expression = make_shared<Expression>();
+    cache = &XExpressionCache::getShared();
+    root = nullptr;
+    arguments.assign(symbols.getCountSlots(), 0.0);
+    intervals.assign(symbols.getCountSlots(), XInterval(0.0));
+    compiled = true;
 }
 
-static bool isVaraible(string &str)
+XFunctionParser::~XFunctionParser()
 {
-    if (str == "x" || str == "y" || str == "z")
-    {
-        return true;
-    }
-    else
-    {
-        return false;
-    }
 }
 
-static bool isOperator(string str)
+// The key is taken before parsing, as parsing binds the new names of the source.
+void XFunctionParser::setSource(string source)
 {
-    if (isDouble(str) || isVaraible(str))
-    {
-        return false;
-    }
-    else
+    this->source = source;
+    string key;
+    if (cache != nullptr)
     {
-        return true;
+        key = XExpressionCache::getKey(source, symbols);
+        shared_ptr<const Expression> found = cache->find(key);
+        if (found != nullptr)
+        {
+            setExpression(found);
+            return;
+        }
     }
-}
 
-XFunctionParser::XFunctionParser()
-{
-    root = nullptr;
+    shared_ptr<Expression> made = make_shared<Expression>();
+    made->source = source;
+    made->symbols = symbols;
+    solveSource(*made);
+    genParseTree(*made);
+    made->bytecode.compile(made->root);
+    made->graphRoot = made->graph.insert(made->bytecode);
+    setExpression(cache != nullptr ? cache->insert(key, made) : made);
 }
 
-XFunctionParser::~XFunctionParser()
+void XFunctionParser::setExpression(shared_ptr<const Expression> expression)
 {
-    delete root;
+    this->expression = expression;
+    symbols = expression->symbols;
+    arena.clear();
+    root = nullptr;
+    variables.clear();
+    arguments.assign(symbols.getCountSlots(), 0.0);
+    intervals.assign(symbols.getCountSlots(), XInterval(0.0));
 }
 
-void XFunctionParser::setSource(string source)
+// The tree is cloned from the one parsed, or for a derivative written out from the graph.
+XAbstractParseNode *XFunctionParser::getTree() const
 {
-    this->source = source;
-    solveSource();
-    genParseTree();
+    if (root == nullptr)
+    {
+        if (expression->root != nullptr)
+        {
+            root = expression->root->clone(arena);
+        }
+        else if (expression->graphRoot >= 0)
+        {
+            root = expression->graph.createTree(expression->graphRoot, arena);
+        }
+        if (root != nullptr)
+        {
+            solveArr(root);
+        }
+    }
+    return root;
 }
 
-int XFunctionParser::getPriority(string ope)
+int XFunctionParser::getPriority(XToken::Type type)
 {
-    if (ope == "(")
+    switch (type)
     {
+    case XToken::LeftParenthesis:
         return -1;
-    }
-    else if (ope == "+" || ope == "-")
-    {
+    case XToken::Plus:
+    case XToken::Minus:
         return 0;
-    }
-    else if (ope == "*" || ope == "/")
-    {
+    case XToken::Multiply:
+    case XToken::Divide:
         return 1;
-    }
-    else if (ope == "~")
-    {
+    case XToken::Negate:
         return 200;
-    }
-    else
-    {
+    default:
         return 3;
     }
 }
 
-void XFunctionParser::solveSource()
+void XFunctionParser::solveSource(Expression &expression)
 {
-    vector<string> sourceToken;
-    int cur = 0;
-    while (cur < source.length())
+    vector<XToken> &polishTokens = expression.polishTokens;
+    vector<XToken> stkOpe;
+    XLexer lexer(expression.source.data(), (int)expression.source.length(), &expression.symbols);
+    XToken token;
+    while (lexer.next(token))
     {
-        while (source[cur] == ' ' || source[cur] == ',')
+        if (token.type == XToken::Number || token.type == XToken::Variable)
         {
-            cur++;
+            polishTokens.push_back(token);
         }
-        if (source[cur] == '(' || source[cur] == ')'
-            || source[cur] == 'x' || source[cur] == 'y' || source[cur] == 'z'
-            || source[cur] == '-'  || source[cur] == '~'
-            || source[cur] == '+' || source[cur] == '*' || source[cur] == '/'
-            || source[cur] == '^')
+        else if (token.type == XToken::LeftParenthesis)
         {
-            string str;
-            str += source[cur];
-            sourceToken.push_back(str);
-            cur++;
-            continue;
+            stkOpe.push_back(token);
         }
-
-        if (isdigit(source[cur]) || source[cur] == '.' || source[cur] == '-')
+        else if (token.type == XToken::RightParenthesis)
         {
-            string str;
-            str += source[cur];
-            cur++;
-            while (isdigit(source[cur]) || source[cur] == '.')
+            while (!stkOpe.empty() && stkOpe.back().type != XToken::LeftParenthesis)
             {
-                str += source[cur];
-                cur++;
+                polishTokens.push_back(stkOpe.back());
+                stkOpe.pop_back();
             }
-            sourceToken.push_back(str);
-            continue;
-        }
-
-        if (isalpha(source[cur]))
-        {
-            string str;
-            while (isalpha(source[cur]))
+            if (!stkOpe.empty())
             {
-                str += source[cur];
-                cur++;
+                stkOpe.pop_back();
             }
-            sourceToken.push_back(str);
-            continue;
-        }
-    }
-
-    //for (int j = 0; j < sourceToken.size(); j++) {
-    //    cout << sourceToken[j] << endl;
-    //}
-
-    polishTokenStrings.clear();
-    stack<string> stkOpe;
-    for (int i = 0; i < sourceToken.size(); i++)
-    {
-        if (isDouble(sourceToken[i]) || isVaraible(sourceToken[i]))
-        {
-            polishTokenStrings.push_back(sourceToken[i]);
-        }
-        else if (sourceToken[i] == "(")
-        {
-            stkOpe.push("(");
-        }
-        else if (sourceToken[i] == ")")
-        {
-            while (stkOpe.top() != "(")
+            else
             {
-                string ope = stkOpe.top();
-                polishTokenStrings.push_back(ope);
-                stkOpe.pop();
+                polishTokens.push_back(token);  // unmatched, genParseTree turns it down
             }
-            stkOpe.pop();
         }
         else
         {
-            string sOpe = sourceToken[i];
             while (!stkOpe.empty()
-                && getPriority(sOpe) < getPriority(stkOpe.top()))
+                && getPriority(token.type) < getPriority(stkOpe.back().type))
             {
-                string ope = stkOpe.top();
-                polishTokenStrings.push_back(ope);
-                stkOpe.pop();
+                polishTokens.push_back(stkOpe.back());
+                stkOpe.pop_back();
             }
-            stkOpe.push(sOpe);
+            stkOpe.push_back(token);
         }
     }
     while (!stkOpe.empty())
     {
-        polishTokenStrings.push_back(stkOpe.top());
-        stkOpe.pop();
+        polishTokens.push_back(stkOpe.back());
+        stkOpe.pop_back();
     }
-
-    //for (int i = 0; i < polishTokenStrings.size(); i++) {
-    //    cout << polishTokenStrings[i] << endl;
-    //}
 }
 
-void XFunctionParser::genParseTree()
+// Nodes are made operands first, so the arena holds the tree in the order updateValue finishes them.
+// A malformed source, as x + or (x or x y, leaves the root empty, an operator missing an operand
+// or operands left without one, and so does a parenthesis without its pair.
+void XFunctionParser::genParseTree(Expression &expression)
 {
-    delete root;
-    arrX.clear();
-    arrY.clear();
-    arrZ.clear();
-    stack<XAbstractParseNode *> stk;
-    for (int i = 0; i < polishTokenStrings.size(); i++)
+    const vector<XToken> &polishTokens = expression.polishTokens;
+    XParseNodeArena &arena = expression.arena;
+    vector<XAbstractParseNode *> stk;
+    for (int i = 0; i < (int)polishTokens.size(); i++)
     {
-        string str = polishTokenStrings[i];
-        if (str == "x" || str == "y" || str == "z")
+        const XToken &token = polishTokens[i];
+        XAbstractParseNode *node = nullptr;
+        switch (token.type)
         {
-            XVariableParseNode *node = new XVariableParseNode;
-            node->index = str[0];
-            stk.push(node);
-            if (str[0] == 'x')
-            {
-                arrX.push_back(node);
-            }
-            else if (str[0] == 'y')
-            {
-                arrY.push_back(node);
-            }
-            else
-            {
-                arrZ.push_back(node);
-            }
-        }
-        else if (isdigit(str[0])
-            || str[0] == '.'
-            || str[0] == '-' && isdigit(str[1]))
-        {
-            double val = atof(str.c_str());
-            XConstantParseNode *node = new XConstantParseNode;
-            node->value = val;
-            stk.push(node);
-        }
-        else if (str == "+")
-        {
-            XPlusParseNode *node = new XPlusParseNode;
-            XAbstractParseNode *b = stk.top();
-            stk.pop();
-            XAbstractParseNode *a = stk.top();
-            stk.pop();
-            node->childs[0] = a;
-            node->childs[1] = b;
-            stk.push(node);
-        }
-        else if (str == "-")
-        {
-            XMinusParseNode *node = new XMinusParseNode;
-            XAbstractParseNode *b = stk.top();
-            stk.pop();
-            XAbstractParseNode *a = stk.top();
-            stk.pop();
-            node->childs[0] = a;
-            node->childs[1] = b;
-            stk.push(node);
-        }
-        else if (str == "*")
-        {
-            XMultiplyParseNode *node = new XMultiplyParseNode;
-            XAbstractParseNode *b = stk.top();
-            stk.pop();
-            XAbstractParseNode *a = stk.top();
-            stk.pop();
-            node->childs[0] = a;
-            node->childs[1] = b;
-            stk.push(node);
-        }
-        else if (str == "/")
-        {
-            XDivideParseNode *node = new XDivideParseNode;
-            XAbstractParseNode *b = stk.top();
-            stk.pop();
-            XAbstractParseNode *a = stk.top();
-            stk.pop();
-            node->childs[0] = a;
-            node->childs[1] = b;
-            stk.push(node);
-        }
-        else if (str == "^")
-        {
-            XPowerParseNode *node = new XPowerParseNode;
-            XAbstractParseNode *b = stk.top();
-            stk.pop();
-            XAbstractParseNode *a = stk.top();
-            stk.pop();
-            node->childs[0] = a;
-            node->childs[1] = b;
-            stk.push(node);
-        }
-        else if (str == "~")
-        {
-            XNegateParseNode *node = new XNegateParseNode;
-            node->childs[0] = stk.top();
-            stk.pop();
-            stk.push(node);
-        }
-        else if (str == "sin")
-        {
-            XSinParseNode *node = new XSinParseNode;
-            XAbstractParseNode *a = stk.top();
-            stk.pop();
-            node->childs[0] = a;
-            stk.push(node);
-        }
-        else if (str == "cos")
+        case XToken::Number:
+            node = arena.create<XConstantParseNode>();
+            node->value = token.value;
+            stk.push_back(node);
+            continue;
+        case XToken::Variable:
         {
-            XCosParseNode *node = new XCosParseNode;
-            XAbstractParseNode *a = stk.top();
-            stk.pop();
-            node->childs[0] = a;
-            stk.push(node);
+            XVariableParseNode *variable = arena.create<XVariableParseNode>();
+            variable->slot = token.slot;
+            variable->symbol = expression.symbols.getName(token.slot);
+            stk.push_back(variable);
+            continue;
         }
-        else if (str == "tan")
-        {
-            XTanParseNode *node = new XTanParseNode;
-            XAbstractParseNode *a = stk.top();
-            stk.pop();
-            node->childs[0] = a;
-            stk.push(node);
+        case XToken::Plus:
+            node = arena.create<XPlusParseNode>();
+            break;
+        case XToken::Minus:
+            node = arena.create<XMinusParseNode>();
+            break;
+        case XToken::Multiply:
+            node = arena.create<XMultiplyParseNode>();
+            break;
+        case XToken::Divide:
+            node = arena.create<XDivideParseNode>();
+            break;
+        case XToken::Power:
+            node = arena.create<XPowerParseNode>();
+            break;
+        case XToken::Negate:
+            node = arena.create<XNegateParseNode>();
+            break;
+        case XToken::Sin:
+            node = arena.create<XSinParseNode>();
+            break;
+        case XToken::Cos:
+            node = arena.create<XCosParseNode>();
+            break;
+        case XToken::Tan:
+            node = arena.create<XTanParseNode>();
+            break;
+        case XToken::Exp:
+            node = arena.create<XExpParseNode>();
+            break;
+        case XToken::Ln:
+            node = arena.create<XLnParseNode>();
+            break;
+        default:
+            return;
         }
-        else if (str == "exp")
+
+        if ((int)stk.size() < node->getCountChilds())
         {
-            XExpParseNode *node = new XExpParseNode;
-            XAbstractParseNode *a = stk.top();
-            stk.pop();
-            node->childs[0] = a;
-            stk.push(node);
+            return;
         }
-        else if (str == "ln")
+        // operands come off the stack last first
+        for (int j = node->getCountChilds() - 1; j >= 0; j--)
         {
-            XLnParseNode *node = new XLnParseNode;
-            XAbstractParseNode *a = stk.top();
-            stk.pop();
-            node->childs[0] = a;
-            stk.push(node);
+            node->childs[j] = stk.back();
+            stk.pop_back();
         }
+        stk.push_back(node);
+    }
+    if (stk.size() == 1)
+    {
+        expression.root = stk.back();
     }
-    root = stk.top();
 }
 
 double XFunctionParser::getFunction(double x, double y, double z)
 {
-    for (int i = 0; i < arrX.size(); i++)
+    arguments[0] = x;
+    arguments[1] = y;
+    arguments[2] = z;
+    return getFunction(arguments.data());
+}
+
+double XFunctionParser::getFunction(const double *arguments)
+{
+    if (compiled)
     {
-        arrX[i]->value = x;
+        return expression->bytecode.evaluate(arguments);
     }
 
-    for (int i = 0; i < arrY.size(); i++)
+    XAbstractParseNode *root = getTree();
+    if (root == nullptr)
     {
-        arrY[i]->value = y;
+        return 0.0;  // as the bytecode of no expression
     }
-
-    for (int i = 0; i < arrZ.size(); i++)
+    for (int i = 0; i < (int)variables.size(); i++)
     {
-        arrZ[i]->value = z;
+        variables[i]->value = arguments[variables[i]->slot];
     }
 
     root->updateValue();
     return root->getValue();
 }
 
-void XFunctionParser::solveArr(XAbstractParseNode *r)
+void XFunctionParser::getFunctions(const double *x, const double *y, const double *z, double *results, int count,
+    XVectorMath::Accuracy accuracy)
 {
-    if (typeid(*r) == typeid(XVariableParseNode))
+    const double *columns[3] = { x, y, z };
+    getFunctions(columns, 3, results, count, accuracy);
+}
+
+void XFunctionParser::getFunctions(const double *const *columns, int countColumns, double *results, int count,
+    XVectorMath::Accuracy accuracy)
+{
+    if (compiled)
     {
-        XVariableParseNode *vnd = dynamic_cast<XVariableParseNode *>(r);
-        if (vnd->index == 'x')
-        {
-            arrX.push_back(vnd);
-        }
-        else if (vnd->index == 'y')
-        {
-            arrY.push_back(vnd);
-        }
-        else if (vnd->index == 'z')
+        expression->bytecode.evaluateBatch(columns, countColumns, results, count, accuracy);
+        return;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        for (int s = 0; s < (int)arguments.size(); s++)
         {
-            arrZ.push_back(vnd);
+            arguments[s] = s < countColumns && columns[s] != nullptr ? columns[s][i] : 0.0;
         }
+        results[i] = getFunction(arguments.data());
+    }
+}
+
+XSymbolTable &XFunctionParser::getSymbols()
+{
+    return symbols;
+}
+
+const XSymbolTable &XFunctionParser::getSymbols() const
+{
+    return symbols;
+}
+
+void XFunctionParser::solveArr(XAbstractParseNode *r) const
+{
+    if (typeid(*r) == typeid(XVariableParseNode))
+    {
+        XVariableParseNode *vnd = dynamic_cast<XVariableParseNode *>(r);
+        vnd->symbol = symbols.getName(vnd->slot);
+        variables.push_back(vnd);
         return;
     }
     int ccs = r->getCountChilds();
@@ -373,59 +306,102 @@ void XFunctionParser::solveArr(XAbstractParseNode *r)
     }
 }
 
+// The derivative is taken on the graph, where it stays about as large as the expression, and
+// compiled from there, once for all parsers of the expression (see XExpressionCache).
 XFunctionParser * XFunctionParser::getDifferentiate(string variable)
 {
-    for (int i = 0; i < arrX.size(); i++)
-    {
-        XVariableParseNode *node = (XVariableParseNode *)arrX[i];
-        if (variable == "x")
-        {
-            node->differentiateActive = true;
-        }
-        else
-        {
-            node->differentiateActive = false;
-        }
-    }
-    for (int i = 0; i < arrY.size(); i++)
-    {
-        XVariableParseNode *node = (XVariableParseNode *)arrY[i];
-        if (variable == "y")
-        {
-            node->differentiateActive = true;
-        }
-        else
-        {
-            node->differentiateActive = false;
-        }
-    }
-    for (int i = 0; i < arrZ.size(); i++)
-    {
-        XVariableParseNode *node = (XVariableParseNode *)arrZ[i];
-        if (variable == "z")
-        {
-            node->differentiateActive = true;
-        }
-        else
-        {
-            node->differentiateActive = false;
-        }
-    }
+    return getDifferentiate(variable, 1);
+}
 
-    XAbstractParseNode *newRoot = root->getDifferentiate();
+// Each order is taken on the one before, whose graph holds the lower ones, so they share what they
+// have in common.
+XFunctionParser * XFunctionParser::getDifferentiate(string variable, int order)
+{
     XFunctionParser *ans = new XFunctionParser;
-    ans->root = newRoot;
-    ans->solveArr(newRoot);
+    ans->cache = cache;
+    ans->setExpression(expression->getDerivative(symbols.find(variable), order));
+    ans->compiled = compiled;
     return ans;
 }
 
+double XFunctionParser::getFunctionAndDerivative(string variable, double &derivative, double x, double y, double z)
+{
+    arguments[0] = x;
+    arguments[1] = y;
+    arguments[2] = z;
+    return expression->bytecode.evaluateDerivative(arguments.data(), symbols.find(variable), derivative);
+}
+
+void XFunctionParser::getFunctionAndDerivatives(string variable, int order, double *derivatives, double x, double y,
+    double z)
+{
+    arguments[0] = x;
+    arguments[1] = y;
+    arguments[2] = z;
+    expression->bytecode.evaluateTaylor(arguments.data(), symbols.find(variable), order, derivatives);
+}
+
+void XFunctionParser::getFunctionsAndDerivatives(string variable, int order, const double *const *columns,
+    int countColumns, double *const *results, int count, XVectorMath::Accuracy accuracy)
+{
+    expression->getDerivativesProgram(symbols.find(variable), order)->evaluateBatch(columns, countColumns, results,
+        order + 1, count, accuracy);
+}
+
+double XFunctionParser::getFunctionAndGradient(double gradient[3], double x, double y, double z)
+{
+    arguments[0] = x;
+    arguments[1] = y;
+    arguments[2] = z;
+    return expression->bytecode.evaluateGradient(arguments.data(), gradient);
+}
+
+XInterval XFunctionParser::getFunctionInterval(const XInterval &x, const XInterval &y, const XInterval &z)
+{
+    intervals[0] = x;
+    intervals[1] = y;
+    intervals[2] = z;
+    return getFunctionInterval(intervals.data());
+}
+
+XInterval XFunctionParser::getFunctionInterval(const XInterval *arguments)
+{
+    return expression->bytecode.evaluateInterval(arguments);
+}
+
+const XBytecode &XFunctionParser::getBytecode() const
+{
+    return expression->bytecode;
+}
+
+void XFunctionParser::setCompiled(bool compiled)
+{
+    this->compiled = compiled;
+}
+
+bool XFunctionParser::isCompiled() const
+{
+    return compiled;
+}
+
+void XFunctionParser::setCache(XExpressionCache *cache)
+{
+    this->cache = cache;
+}
+
+XExpressionCache *XFunctionParser::getCache() const
+{
+    return cache;
+}
+
 XAbstractParseNode *XFunctionParser::getRoot() const
 {
-    return root;
+    return getTree();
 }
 
 string XFunctionParser::getInfixExpression() const
 {
+    XAbstractParseNode *root = getTree();
     if (root != nullptr)
     {
         return root->getExpression();
@@ -438,15 +414,17 @@ string XFunctionParser::getInfixExpression() const
 
 string XFunctionParser::getReversePolishExpression() const
 {
-    if (polishTokenStrings.empty())
+    const vector<XToken> &polishTokens = expression->polishTokens;
+    if (polishTokens.empty())
     {
         return "IMPOSSIBLE";
     }
     string ans;
-    ans += polishTokenStrings[0];
-    for (int i = 1; i < polishTokenStrings.size(); i++)
+    ans.append(polishTokens[0].text, polishTokens[0].length);
+    for (int i = 1; i < (int)polishTokens.size(); i++)
     {
-        ans += " " + polishTokenStrings[i];
+        ans += " ";
+        ans.append(polishTokens[i].text, polishTokens[i].length);
     }
     return ans;
 }
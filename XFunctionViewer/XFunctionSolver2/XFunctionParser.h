@@ -1,10 +1,20 @@
 #pragma once
+#include <memory>
 #include <string>
 #include <vector>
 #include "XBasicParseNodes.h"
 #include "XVariableParseNode.h"
 #include "XConstantParseNode.h"
+#include "XBytecode.h"
+#include "XExpressionCache.h"
+#include "XExpressionGraph.h"
+#include "XLexer.h"
+#include "XParseNodeArena.h"
+#include "XSymbolTable.h"
 
+// A source parsed and compiled once is kept in an XExpressionCache, shared by default, and a parser
+// setting it again, or asking for the same derivative, takes the compiled expression from there. The
+// parse tree of a parser is its own copy, made when first asked for.
 class XFunctionParser
 {
 public:
@@ -12,23 +22,60 @@ public:
     ~XFunctionParser();
     void setSource(std::string source);
     double getFunction(double x = 0.0, double y = 0.0, double z = 0.0);
+    double getFunction(const double *arguments);  // arguments[s] for the variable bound to slot s
+    // results[i] = f(x[i], y[i], z[i]), a null array stands for zeros
+    void getFunctions(const double *x, const double *y, const double *z, double *results, int count,
+        XVectorMath::Accuracy accuracy = XVectorMath::Exact);
+    void getFunctions(const double *const *columns, int countColumns, double *results, int count,
+        XVectorMath::Accuracy accuracy = XVectorMath::Exact);
+    // Names stay bound across sources, so they can be bound before setSource to fix their slots.
+    XSymbolTable &getSymbols();
+    const XSymbolTable &getSymbols() const;
     XAbstractParseNode * getRoot() const;
     std::string getInfixExpression() const;
     std::string getReversePolishExpression() const;
     XFunctionParser * getDifferentiate(std::string variable);
+    XFunctionParser * getDifferentiate(std::string variable, int order);  // order >= 1, made once for all parsers
+    // f and its derivative by one variable, or by all three, in one pass with dual numbers
+    double getFunctionAndDerivative(std::string variable, double &derivative, double x = 0.0, double y = 0.0, double z = 0.0);
+    // derivatives[k] = d^k f / d variable^k for k from 0 to order, at most XBytecode::maxTaylorOrder,
+    // in one pass with Taylor series
+    void getFunctionAndDerivatives(std::string variable, int order, double *derivatives, double x = 0.0, double y = 0.0,
+        double z = 0.0);
+    // results[k][i] = d^k f / d variable^k for k from 0 to order at the point whose slot s is
+    // columns[s][i], by one program that computes what f and the derivatives share once
+    void getFunctionsAndDerivatives(std::string variable, int order, const double *const *columns, int countColumns,
+        double *const *results, int count, XVectorMath::Accuracy accuracy = XVectorMath::Exact);
+    double getFunctionAndGradient(double gradient[3], double x = 0.0, double y = 0.0, double z = 0.0);
+    // a range holding every value of f while the variables stay in theirs, from the bytecode
+    XInterval getFunctionInterval(const XInterval &x, const XInterval &y, const XInterval &z = XInterval(0.0));
+    XInterval getFunctionInterval(const XInterval *arguments);
+    const XBytecode &getBytecode() const;
+    void setCompiled(bool compiled); // true by default, false walks the tree in getFunction
+    bool isCompiled() const;
+    void setCache(XExpressionCache *cache);  // nullptr parses every source anew
+    XExpressionCache *getCache() const;
 
 protected:
-    int getPriority(std::string ope);
-    void genParseTree();
-    void solveSource();
-    void solveArr(XAbstractParseNode *t);
+    typedef XExpressionCache::Expression Expression;
+
+    int getPriority(XToken::Type type);
+    void genParseTree(Expression &expression);
+    void solveSource(Expression &expression);
+    void solveArr(XAbstractParseNode *t) const;
+    void setExpression(std::shared_ptr<const Expression> expression);
+    XAbstractParseNode *getTree() const;
 
     std::string source;
-    std::vector<std::string> polishTokenStrings;
-    XAbstractParseNode *root;
-    std::vector<XAbstractParseNode *> arrX;
-    std::vector<XAbstractParseNode *> arrY;
-    std::vector<XAbstractParseNode *> arrZ;
+    std::shared_ptr<const Expression> expression;  // tokens, bytecode and graph of source
+    XExpressionCache *cache;
+    mutable XParseNodeArena arena;   // owns the nodes of the tree
+    mutable XAbstractParseNode *root;
+    mutable std::vector<XVariableParseNode *> variables;
+    std::vector<double> arguments;     // x, y, z and zeros for the other slots, for getFunction
+    std::vector<XInterval> intervals;  // the same for getFunctionInterval
+    XSymbolTable symbols;
+    bool compiled;
 
 private:
     XFunctionParser(XFunctionParser &);
@@ -0,0 +1,399 @@
+#include "XImplicitRenderer.h"
+#include "XInterval.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+static const int steps[] = { 8, 4, 2, 1 };
+
+// a / b rounded down, also for a negative a
+static int floorDivide(int a, int b)
+{
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+// A tile at one level: the block (a, b) is the pixels (baseK + a * step, baseL + b * step) to
+// step - 1 further along each axis.
+struct TileContext
+{
+    XFunctionParser *parser;
+    double unit;
+    int step;
+    int baseK;
+    int baseL;
+    vector<int> candidates;  // blocks as a * blocks + b
+    int blocks;
+};
+
+// The blocks a0 <= a < a0 + width, b0 <= b < b0 + height, dropped as soon as the range of f over
+// them excludes 0 and cut in four otherwise, down to single blocks.
+static void subdivide(TileContext &context, int a0, int b0, int width, int height)
+{
+    double unit = context.unit;
+    int step = context.step;
+    XInterval x((context.baseK + a0 * step - 0.5) * unit, (context.baseK + (a0 + width) * step - 0.5) * unit);
+    XInterval y((context.baseL + b0 * step - 0.5) * unit, (context.baseL + (b0 + height) * step - 0.5) * unit);
+    if (!context.parser->getFunctionInterval(x, y).contains(0.0))
+    {
+        return;
+    }
+
+    if (width == 1 && height == 1)
+    {
+        context.candidates.push_back(a0 * context.blocks + b0);
+        return;
+    }
+
+    int w = (width + 1) / 2;
+    int h = (height + 1) / 2;
+    subdivide(context, a0, b0, w, h);
+    if (width > w)
+    {
+        subdivide(context, a0 + w, b0, width - w, h);
+    }
+    if (height > h)
+    {
+        subdivide(context, a0, b0 + h, w, height - h);
+    }
+    if (width > w && height > h)
+    {
+        subdivide(context, a0 + w, b0 + h, width - w, height - h);
+    }
+}
+
+bool XImplicitRenderer::Key::operator <(const Key &rhs) const
+{
+    if (tileX != rhs.tileX)
+    {
+        return tileX < rhs.tileX;
+    }
+    if (tileY != rhs.tileY)
+    {
+        return tileY < rhs.tileY;
+    }
+    if (step != rhs.step)
+    {
+        return step < rhs.step;
+    }
+    if (unit != rhs.unit)
+    {
+        return unit < rhs.unit;
+    }
+    if (times != rhs.times)
+    {
+        return times < rhs.times;
+    }
+    return source < rhs.source;
+}
+
+XImplicitRenderer::XImplicitRenderer()
+{
+    countThreads = 0;
+    times = 50;
+    cacheSize = 4096;
+    countRunning = 0;
+    stopping = false;
+    cancelled = false;
+    useCount = 0;
+    renderStart = 0;
+}
+
+XImplicitRenderer::~XImplicitRenderer()
+{
+    stop();
+}
+
+// Stopping the workers here could leave a render under way waiting for jobs none of them takes.
+void XImplicitRenderer::setCountThreads(int countThreads)
+{
+    this->countThreads = countThreads;
+}
+
+int XImplicitRenderer::getCountThreads() const
+{
+    int count = countThreads;
+    if (count > 0)
+    {
+        return count;
+    }
+    return max(1, (int)thread::hardware_concurrency());
+}
+
+void XImplicitRenderer::setTimes(int times)
+{
+    this->times = times;
+}
+
+void XImplicitRenderer::setCacheSize(int countTiles)
+{
+    lock_guard<std::mutex> lock(mutex);
+    cacheSize = countTiles;
+}
+
+void XImplicitRenderer::clearCache()
+{
+    lock_guard<std::mutex> lock(mutex);
+    cache.clear();
+    order.clear();
+}
+
+void XImplicitRenderer::cancel()
+{
+    lock_guard<std::mutex> lock(mutex);
+    cancelled = true;
+    jobs.clear();
+    jobsDone.notify_all();
+}
+
+// Each level queues the tiles missing from the cache, waits for the workers to finish them and
+// copies every tile of the view into cells.
+bool XImplicitRenderer::render(const string &source, double unit, int originX, int originY, int width, int height,
+    char *cells, Listener *listener)
+{
+    if ((int)workers.size() != getCountThreads())
+    {
+        stop();
+        start();
+    }
+
+    int tileX0 = floorDivide(originX, tileSize);
+    int tileX1 = floorDivide(originX + width - 1, tileSize);
+    int tileY0 = floorDivide(originY, tileSize);
+    int tileY1 = floorDivide(originY + height - 1, tileSize);
+    int countLevels = sizeof(steps) / sizeof(steps[0]);
+
+    unique_lock<std::mutex> lock(mutex);
+    cancelled = false;
+    renderStart = useCount + 1;
+    for (int level = 0; level < countLevels; level++)
+    {
+        Key key = { source, unit, times, steps[level], 0, 0 };
+        for (key.tileX = tileX0; key.tileX <= tileX1; key.tileX++)
+        {
+            for (key.tileY = tileY0; key.tileY <= tileY1; key.tileY++)
+            {
+                map<Key, Tile>::iterator it = cache.find(key);
+                if (it != cache.end())
+                {
+                    use(it->second);
+                }
+                else
+                {
+                    jobs.push_back(key);
+                }
+            }
+        }
+        // the queue is taken from the back, so the tiles nearest the centre of the view go last
+        double centreX = (originX + width / 2.0) / tileSize - 0.5;
+        double centreY = (originY + height / 2.0) / tileSize - 0.5;
+        sort(jobs.begin(), jobs.end(), [=](const Key &a, const Key &b)
+        {
+            return hypot(a.tileX - centreX, a.tileY - centreY) > hypot(b.tileX - centreX, b.tileY - centreY);
+        });
+        jobsReady.notify_all();
+        jobsDone.wait(lock, [this]()
+        {
+            return jobs.empty() && countRunning == 0;
+        });
+        if (cancelled)
+        {
+            return false;
+        }
+
+        for (int tileX = tileX0; tileX <= tileX1; tileX++)
+        {
+            for (int tileY = tileY0; tileY <= tileY1; tileY++)
+            {
+                key.tileX = tileX;
+                key.tileY = tileY;
+                const vector<char> &tile = cache[key].cells;
+                int i0 = max(originX, tileX * tileSize);
+                int i1 = min(originX + width, (tileX + 1) * tileSize);
+                int j0 = max(originY, tileY * tileSize);
+                int j1 = min(originY + height, (tileY + 1) * tileSize);
+                for (int i = i0; i < i1; i++)
+                {
+                    const char *from = &tile[(i - tileX * tileSize) * tileSize + j0 - tileY * tileSize];
+                    copy(from, from + j1 - j0, cells + (i - originX) * height + j0 - originY);
+                }
+            }
+        }
+
+        if (listener != nullptr)
+        {
+            lock.unlock();
+            listener->levelFinished(steps[level], float(level + 1) / countLevels);
+            lock.lock();
+        }
+    }
+    return true;
+}
+
+void XImplicitRenderer::start()
+{
+    int count = getCountThreads();
+    for (int i = 0; i < count; i++)
+    {
+        workers.push_back(thread(&XImplicitRenderer::work, this));
+    }
+}
+
+void XImplicitRenderer::stop()
+{
+    {
+        lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        jobsReady.notify_all();
+    }
+    for (int i = 0; i < (int)workers.size(); i++)
+    {
+        workers[i].join();
+    }
+    workers.clear();
+    stopping = false;
+}
+
+// A parser is not safe to share between threads, so every worker parses the source for itself.
+void XImplicitRenderer::work()
+{
+    XFunctionParser parser;
+    XRootFinder finders[2];  // along x and along y
+    finders[0].setVariable("x");
+    finders[1].setVariable("y");
+    string parsed;
+    bool hasParsed = false;
+    vector<char> cells;
+    while (true)
+    {
+        Key key;
+        {
+            unique_lock<std::mutex> lock(mutex);
+            jobsReady.wait(lock, [this]()
+            {
+                return stopping || !jobs.empty();
+            });
+            if (stopping)
+            {
+                return;
+            }
+            key = jobs.back();
+            jobs.pop_back();
+            countRunning++;
+        }
+
+        if (!hasParsed || key.source != parsed)
+        {
+            parser.setSource(key.source);
+            finders[0].setFunction(&parser);
+            finders[1].setFunction(&parser);
+            parsed = key.source;
+            hasParsed = true;
+        }
+        finders[0].setTimes(key.times);
+        finders[1].setTimes(key.times);
+        bool finished = renderTile(key, parser, finders, cells);
+
+        lock_guard<std::mutex> lock(mutex);
+        if (finished)
+        {
+            store(key, cells);
+        }
+        countRunning--;
+        if (jobs.empty() && countRunning == 0)
+        {
+            jobsDone.notify_all();
+        }
+    }
+}
+
+// Blocks of the preview levels are marked wherever the curve may pass, which only takes interval
+// evaluations; root finding from all candidates of the tile at once decides single pixels.
+bool XImplicitRenderer::renderTile(const Key &key, XFunctionParser &parser, XRootFinder *finders, vector<char> &cells)
+{
+    TileContext context;
+    context.parser = &parser;
+    context.unit = key.unit;
+    context.step = key.step;
+    context.baseK = key.tileX * tileSize;
+    context.baseL = key.tileY * tileSize;
+    context.blocks = tileSize / key.step;
+    subdivide(context, 0, 0, context.blocks, context.blocks);
+    if (cancelled)
+    {
+        return false;
+    }
+
+    cells.assign(tileSize * tileSize, 0);
+    if (key.step > 1)
+    {
+        for (int c = 0; c < (int)context.candidates.size(); c++)
+        {
+            int a = context.candidates[c] / context.blocks;
+            int b = context.candidates[c] % context.blocks;
+            for (int i = a * key.step; i < (a + 1) * key.step; i++)
+            {
+                fill(&cells[i * tileSize + b * key.step], &cells[i * tileSize + b * key.step] + key.step, 1);
+            }
+        }
+        return true;
+    }
+
+    int count = (int)context.candidates.size();
+    vector<double> xs(count);
+    vector<double> ys(count);
+    for (int c = 0; c < count; c++)
+    {
+        xs[c] = (context.baseK + context.candidates[c] / tileSize) * key.unit;
+        ys[c] = (context.baseL + context.candidates[c] % tileSize) * key.unit;
+    }
+    const double *columns[2] = { xs.data(), ys.data() };
+    vector<XRootFinder::Result> results(count);
+    for (int pass = 0; pass < 2; pass++)
+    {
+        finders[pass].solve(columns, 2, results.data(), count);
+        for (int c = 0; c < count; c++)
+        {
+            double start = pass == 0 ? xs[c] : ys[c];
+            if (results[c].status == XRootFinder::Converged && fabs(results[c].root - start) < key.unit / 2.0)
+            {
+                cells[context.candidates[c]] = 1;
+            }
+        }
+    }
+    return true;
+}
+
+// The least recently used tiles go first, but none the current render has used.
+void XImplicitRenderer::store(const Key &key, vector<char> &cells)
+{
+    pair<map<Key, Tile>::iterator, bool> inserted = cache.insert(make_pair(key, Tile()));
+    Tile &tile = inserted.first->second;
+    tile.cells.swap(cells);
+    if (inserted.second)
+    {
+        tile.position = order.insert(order.end(), key);
+        tile.lastUse = ++useCount;
+    }
+    else
+    {
+        use(tile);
+    }
+    while ((int)cache.size() > cacheSize)
+    {
+        map<Key, Tile>::iterator oldest = cache.find(order.front());
+        if (oldest->second.lastUse >= renderStart)
+        {
+            break;
+        }
+        order.pop_front();
+        cache.erase(oldest);
+    }
+}
+
+// moves the tile to the back of order
+void XImplicitRenderer::use(Tile &tile)
+{
+    tile.lastUse = ++useCount;
+    order.splice(order.end(), order, tile.position);
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "XRootFinder.h"
+
+// Marks the pixels the curve f(x, y) = 0 passes through, as XFIProvider did cell by cell, but split
+// into square tiles of the plane rendered by a pool of threads. The pixel (k, l) of the plane is the
+// square of side unit around (k * unit, l * unit), and tiles are aligned to the plane rather than to
+// the image, so a tile computed for one view is the same tile in any view with the same unit.
+// A render runs in levels from blocks of 8 pixels down to single pixels and reports each finished
+// level, which gives a coarse preview at once; a preview marks the blocks the curve may pass through
+// and only single pixels are searched for roots. Finished tiles are kept in a cache keyed by source,
+// unit, iterations, level and position, so panning back or returning to a zoom reuses them.
+// Inside a tile, boxes whose range of f excludes 0 are dropped (see XInterval) and every cell that
+// is left is accepted when a root found from it along x or along y (see XRootFinder) is within half
+// a cell.
+class XImplicitRenderer
+{
+public:
+    class Listener
+    {
+    public:
+        virtual ~Listener()
+        {
+        }
+        // called on the rendering thread once all tiles of a level are in cells
+        virtual void levelFinished(int step, float process) = 0;
+    };
+
+public:
+    XImplicitRenderer();
+    ~XImplicitRenderer();
+    // 0, the default, for one per core; from any thread, the pool is remade when the next render starts
+    void setCountThreads(int countThreads);
+    int getCountThreads() const;
+    void setTimes(int times);                // root finding iterations from each cell
+    void setCacheSize(int countTiles);
+    void clearCache();
+    // cells[i * height + j] = 1 for the pixel (originX + i, originY + j) of the curve, else 0.
+    // false when cancelled, with cells holding the last finished level.
+    bool render(const std::string &source, double unit, int originX, int originY, int width, int height,
+        char *cells, Listener *listener = nullptr);
+    void cancel();                           // from any thread, ends a render under way
+
+    static const int tileSize = 64;
+
+private:
+    struct Key
+    {
+        std::string source;
+        double unit;
+        int times;
+        int step;
+        int tileX;
+        int tileY;
+
+        bool operator <(const Key &rhs) const;
+    };
+
+    struct Tile
+    {
+        std::vector<char> cells;  // [a * tileSize + b] for the pixel (a, b) of the tile
+        unsigned long long lastUse;
+        std::list<Key>::iterator position;  // in order
+    };
+
+    void start();
+    void stop();
+    void work();
+    bool renderTile(const Key &key, XFunctionParser &parser, XRootFinder *finders, std::vector<char> &cells);
+    void store(const Key &key, std::vector<char> &cells);
+    void use(Tile &tile);
+
+    std::vector<std::thread> workers;
+    std::atomic<int> countThreads;
+    int times;
+    int cacheSize;
+
+    std::mutex mutex;
+    std::condition_variable jobsReady;
+    std::condition_variable jobsDone;
+    std::vector<Key> jobs;
+    int countRunning;
+    bool stopping;
+    std::atomic<bool> cancelled;
+    std::map<Key, Tile> cache;
+    std::list<Key> order;            // of the tiles in cache, least recently used first
+    unsigned long long useCount;
+    unsigned long long renderStart;  // tiles used since then are not evicted
+};
@@ -0,0 +1,280 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// A range [lower, upper] that holds every value an expression takes while its variables stay in their
+// own ranges. An operation on ranges gives a range holding every result of the operation on their
+// values, so one evaluation bounds a function over a whole box; the bound may be wider than the true
+// range, never narrower. Where the function is undefined throughout, as ln on negative numbers,
+// the range is empty, which is both bounds NaN.
+// Bounds are rounded to nearest rather than outward, which is exact enough to decide where to draw.
+class XInterval
+{
+public:
+    XInterval()
+    {
+    }
+
+    explicit XInterval(double value)
+    {
+        lower = value;
+        upper = value;
+    }
+
+    XInterval(double lower, double upper)
+    {
+        this->lower = lower;
+        this->upper = upper;
+    }
+
+    bool isEmpty() const
+    {
+        return !(lower <= upper);
+    }
+
+    bool contains(double value) const
+    {
+        return lower <= value && value <= upper;
+    }
+
+    static XInterval empty()
+    {
+        return XInterval(std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN());
+    }
+
+    static XInterval entire()
+    {
+        return XInterval(-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity());
+    }
+
+    double lower;
+    double upper;
+};
+
+inline XInterval operator +(const XInterval &a, const XInterval &b)
+{
+    return XInterval(a.lower + b.lower, a.upper + b.upper);
+}
+
+inline XInterval operator -(const XInterval &a, const XInterval &b)
+{
+    return XInterval(a.lower - b.upper, a.upper - b.lower);
+}
+
+// 0 * inf is 0 here: a bound at infinity stands for large finite values, whose product with 0 is 0.
+inline double boundProduct(double a, double b)
+{
+    return a == 0.0 || b == 0.0 ? 0.0 : a * b;
+}
+
+inline XInterval operator *(const XInterval &a, const XInterval &b)
+{
+    if (a.isEmpty() || b.isEmpty())
+    {
+        return XInterval::empty();
+    }
+    double p = boundProduct(a.lower, b.lower);
+    double q = boundProduct(a.lower, b.upper);
+    double r = boundProduct(a.upper, b.lower);
+    double s = boundProduct(a.upper, b.upper);
+    return XInterval(std::min(std::min(p, q), std::min(r, s)), std::max(std::max(p, q), std::max(r, s)));
+}
+
+// Dividing by a range that reaches across 0 can give anything, by one that only touches 0 gives
+// one side of the line.
+inline XInterval operator /(const XInterval &a, const XInterval &b)
+{
+    if (a.isEmpty() || b.isEmpty() || (b.lower == 0.0 && b.upper == 0.0))
+    {
+        return XInterval::empty();
+    }
+    const double infinity = std::numeric_limits<double>::infinity();
+    if (b.lower > 0.0 || b.upper < 0.0)
+    {
+        return a * XInterval(1.0 / b.upper, 1.0 / b.lower);
+    }
+    if (b.lower == 0.0)
+    {
+        return a * XInterval(1.0 / b.upper, infinity);
+    }
+    if (b.upper == 0.0)
+    {
+        return a * XInterval(-infinity, 1.0 / b.lower);
+    }
+    return XInterval::entire();
+}
+
+inline XInterval operator -(const XInterval &a)
+{
+    return XInterval(-a.upper, -a.lower);
+}
+
+inline XInterval operator +(const XInterval &a, double b)
+{
+    return XInterval(a.lower + b, a.upper + b);
+}
+
+inline XInterval operator -(const XInterval &a, double b)
+{
+    return XInterval(a.lower - b, a.upper - b);
+}
+
+inline XInterval operator *(const XInterval &a, double b)
+{
+    return a * XInterval(b);
+}
+
+inline XInterval operator /(const XInterval &a, double b)
+{
+    return a / XInterval(b);
+}
+
+inline XInterval square(const XInterval &a)
+{
+    if (a.lower >= 0.0)
+    {
+        return XInterval(a.lower * a.lower, a.upper * a.upper);
+    }
+    if (a.upper <= 0.0)
+    {
+        return XInterval(a.upper * a.upper, a.lower * a.lower);
+    }
+    if (a.isEmpty())
+    {
+        return a;
+    }
+    return XInterval(0.0, std::max(a.lower * a.lower, a.upper * a.upper));
+}
+
+// An integer power is defined for any base and odd powers keep the order, even ones fold it at 0.
+// Any other power takes only the part of the base that is not negative.
+inline XInterval pow(const XInterval &a, double b)
+{
+    if (a.isEmpty())
+    {
+        return a;
+    }
+    if (b == 0.0)
+    {
+        return XInterval(1.0);
+    }
+    if (b == std::floor(b) && std::fabs(b) <= 1048576.0)
+    {
+        if (b < 0.0)
+        {
+            return XInterval(1.0) / pow(a, -b);
+        }
+        double l = std::pow(a.lower, b);
+        double u = std::pow(a.upper, b);
+        if (std::fmod(b, 2.0) != 0.0 || a.lower >= 0.0)
+        {
+            return XInterval(l, u);
+        }
+        if (a.upper <= 0.0)
+        {
+            return XInterval(u, l);
+        }
+        return XInterval(0.0, std::max(l, u));
+    }
+
+    if (a.upper < 0.0)
+    {
+        return XInterval::empty();
+    }
+    double l = std::pow(std::max(a.lower, 0.0), b);
+    double u = std::pow(a.upper, b);
+    return b > 0.0 ? XInterval(l, u) : XInterval(u, l);
+}
+
+// For a base that is not negative a ^ b is monotonic in either operand, so its extremes are at
+// the corners. A negative base has a power only for integers, which could be anything.
+inline XInterval pow(const XInterval &a, const XInterval &b)
+{
+    if (a.isEmpty() || b.isEmpty())
+    {
+        return XInterval::empty();
+    }
+    if (b.lower == b.upper)
+    {
+        return pow(a, b.lower);
+    }
+    if (a.lower < 0.0)
+    {
+        return XInterval::entire();
+    }
+    double p = std::pow(a.lower, b.lower);
+    double q = std::pow(a.lower, b.upper);
+    double r = std::pow(a.upper, b.lower);
+    double s = std::pow(a.upper, b.upper);
+    return XInterval(std::min(std::min(p, q), std::min(r, s)), std::max(std::max(p, q), std::max(r, s)));
+}
+
+// whether phase + k period lies in a for some integer k
+inline bool containsPeriodic(const XInterval &a, double phase, double period)
+{
+    return phase + std::ceil((a.lower - phase) / period) * period <= a.upper;
+}
+
+inline XInterval sin(const XInterval &a)
+{
+    const double pi = 3.14159265358979323846;
+    if (a.isEmpty())
+    {
+        return a;
+    }
+    if (a.upper - a.lower >= 2.0 * pi)
+    {
+        return XInterval(-1.0, 1.0);
+    }
+    double l = std::sin(a.lower);
+    double u = std::sin(a.upper);
+    return XInterval(containsPeriodic(a, -0.5 * pi, 2.0 * pi) ? -1.0 : std::min(l, u),
+        containsPeriodic(a, 0.5 * pi, 2.0 * pi) ? 1.0 : std::max(l, u));
+}
+
+inline XInterval cos(const XInterval &a)
+{
+    const double pi = 3.14159265358979323846;
+    if (a.isEmpty())
+    {
+        return a;
+    }
+    if (a.upper - a.lower >= 2.0 * pi)
+    {
+        return XInterval(-1.0, 1.0);
+    }
+    double l = std::cos(a.lower);
+    double u = std::cos(a.upper);
+    return XInterval(containsPeriodic(a, pi, 2.0 * pi) ? -1.0 : std::min(l, u),
+        containsPeriodic(a, 0.0, 2.0 * pi) ? 1.0 : std::max(l, u));
+}
+
+// tan increases between its poles at pi / 2 + k pi and takes every value across one
+inline XInterval tan(const XInterval &a)
+{
+    const double pi = 3.14159265358979323846;
+    if (a.isEmpty())
+    {
+        return a;
+    }
+    if (a.upper - a.lower >= pi || containsPeriodic(a, 0.5 * pi, pi))
+    {
+        return XInterval::entire();
+    }
+    return XInterval(std::tan(a.lower), std::tan(a.upper));
+}
+
+inline XInterval exp(const XInterval &a)
+{
+    return XInterval(std::exp(a.lower), std::exp(a.upper));
+}
+
+inline XInterval log(const XInterval &a)
+{
+    if (a.upper < 0.0 || a.isEmpty())
+    {
+        return XInterval::empty();
+    }
+    return XInterval(a.lower > 0.0 ? std::log(a.lower) : -std::numeric_limits<double>::infinity(), std::log(a.upper));
+}
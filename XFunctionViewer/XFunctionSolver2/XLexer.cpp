@@ -0,0 +1,164 @@
+#include "XLexer.h"
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace std;
+
+static bool isDigit(char c)
+{
+    return isdigit((unsigned char)c) != 0;
+}
+
+static bool isNameStart(char c)
+{
+    return isalpha((unsigned char)c) != 0 || c == '_';
+}
+
+static bool isNamePart(char c)
+{
+    return isalnum((unsigned char)c) != 0 || c == '_';
+}
+
+XLexer::XLexer(const char *source, int length, XSymbolTable *symbols)
+{
+    cur = source;
+    end = source + length;
+    this->symbols = symbols;
+}
+
+XLexer::~XLexer()
+{
+}
+
+bool XLexer::next(XToken &token)
+{
+    while (cur < end)
+    {
+        token.text = cur;
+        token.length = 1;
+        token.value = 0.0;
+        token.slot = -1;
+        switch (*cur)
+        {
+        case '+':
+            token.type = XToken::Plus;
+            break;
+        case '-':
+            token.type = XToken::Minus;
+            break;
+        case '*':
+            token.type = XToken::Multiply;
+            break;
+        case '/':
+            token.type = XToken::Divide;
+            break;
+        case '^':
+            token.type = XToken::Power;
+            break;
+        case '~':
+            token.type = XToken::Negate;
+            break;
+        case '(':
+            token.type = XToken::LeftParenthesis;
+            break;
+        case ')':
+            token.type = XToken::RightParenthesis;
+            break;
+        default:
+            if (isDigit(*cur) || *cur == '.')
+            {
+                readNumber(token);
+                return true;
+            }
+            if (isNameStart(*cur))
+            {
+                readName(token);
+                return true;
+            }
+            cur++;
+            continue;
+        }
+        cur++;
+        return true;
+    }
+    return false;
+}
+
+// Digits and points, then an exponent if one follows, as in 2.5e-3.
+void XLexer::readNumber(XToken &token)
+{
+    const char *begin = cur;
+    while (cur < end && (isDigit(*cur) || *cur == '.'))
+    {
+        cur++;
+    }
+    if (cur < end && (*cur == 'e' || *cur == 'E'))
+    {
+        const char *exponent = cur + 1;
+        if (exponent < end && (*exponent == '+' || *exponent == '-'))
+        {
+            exponent++;
+        }
+        if (exponent < end && isDigit(*exponent))
+        {
+            cur = exponent;
+            while (cur < end && isDigit(*cur))
+            {
+                cur++;
+            }
+        }
+    }
+
+    token.type = XToken::Number;
+    token.text = begin;
+    token.length = (int)(cur - begin);
+
+    // strtod would read on past the token, as into 1.5.2 or 0x1, so it gets the token alone
+    char buffer[64];
+    if (token.length < (int)sizeof(buffer))
+    {
+        memcpy(buffer, begin, token.length);
+        buffer[token.length] = '\0';
+        token.value = strtod(buffer, nullptr);
+    }
+    else
+    {
+        token.value = strtod(string(begin, token.length).c_str(), nullptr);
+    }
+}
+
+void XLexer::readName(XToken &token)
+{
+    const char *begin = cur;
+    while (cur < end && isNamePart(*cur))
+    {
+        cur++;
+    }
+
+    static const struct
+    {
+        const char *name;
+        XToken::Type type;
+    } functions[] = {
+        { "sin", XToken::Sin },
+        { "cos", XToken::Cos },
+        { "tan", XToken::Tan },
+        { "exp", XToken::Exp },
+        { "ln", XToken::Ln },
+    };
+
+    token.text = begin;
+    token.length = (int)(cur - begin);
+    for (int i = 0; i < (int)(sizeof(functions) / sizeof(functions[0])); i++)
+    {
+        if ((int)strlen(functions[i].name) == token.length && memcmp(functions[i].name, begin, token.length) == 0)
+        {
+            token.type = functions[i].type;
+            return;
+        }
+    }
+    token.type = XToken::Variable;
+    token.slot = symbols->add(begin, token.length);
+}
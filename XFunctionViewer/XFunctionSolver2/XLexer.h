@@ -0,0 +1,39 @@
+#pragma once
+#include "XSymbolTable.h"
+
+// A token points back into the source instead of holding a copy of its characters.
+struct XToken
+{
+    enum Type
+    {
+        Number, Variable,
+        Plus, Minus, Multiply, Divide, Power, Negate,
+        Sin, Cos, Tan, Exp, Ln,
+        LeftParenthesis, RightParenthesis
+    };
+
+    Type type;
+    double value;      // of a number
+    int slot;          // of a variable
+    const char *text;
+    int length;
+};
+
+// Splits a source into tokens in one pass, without allocating. Numbers are read where they stand,
+// names of functions become their own token types and any other name is a variable, bound to a
+// slot in the symbol table. Spaces, commas and characters that start no token are skipped.
+class XLexer
+{
+public:
+    XLexer(const char *source, int length, XSymbolTable *symbols);
+    ~XLexer();
+    bool next(XToken &token);  // false at the end of the source
+
+private:
+    void readNumber(XToken &token);
+    void readName(XToken &token);
+
+    const char *cur;
+    const char *end;
+    XSymbolTable *symbols;
+};
@@ -0,0 +1,259 @@
+#include "XMarchingSquares.h"
+#include <cmath>
+
+using namespace std;
+
+// a crossing index for an edge without a crossing
+static const int none = -1;
+
+XMarchingSquares::XMarchingSquares()
+{
+    f = nullptr;
+    left = -20.0;
+    bottom = -20.0;
+    right = 20.0;
+    top = 20.0;
+    columns = 900;
+    rows = 900;
+    times = 4;
+}
+
+XMarchingSquares::~XMarchingSquares()
+{
+}
+
+void XMarchingSquares::setFunction(XFunctionParser *f)
+{
+    this->f = f;
+}
+
+void XMarchingSquares::setArea(double left, double bottom, double right, double top)
+{
+    this->left = left;
+    this->bottom = bottom;
+    this->right = right;
+    this->top = top;
+}
+
+void XMarchingSquares::setResolution(int columns, int rows)
+{
+    this->columns = columns;
+    this->rows = rows;
+}
+
+void XMarchingSquares::setRefinement(int times)
+{
+    this->times = times;
+}
+
+int XMarchingSquares::getRefinement() const
+{
+    return times;
+}
+
+// Rows of corners are sampled one above the other, so only two rows of values and one row of each
+// kind of edge are kept, however fine the lattice.
+// The corners of a cell are numbered 0 bottom left, 1 bottom right, 2 top right and 3 top left and
+// its edges 0 bottom, 1 right, 2 top and 3 left.
+void XMarchingSquares::extract()
+{
+    points.clear();
+    segments.clear();
+    polylines.clear();
+    if (f == nullptr || columns <= 0 || rows <= 0)
+    {
+        return;
+    }
+
+    double dx = (right - left) / columns;
+    double dy = (top - bottom) / rows;
+    vector<double> xs(columns + 1);
+    for (int i = 0; i <= columns; i++)
+    {
+        xs[i] = left + i * dx;
+    }
+    vector<double> ys(columns + 1);
+    vector<double> below(columns + 1);
+    vector<double> above(columns + 1);
+    vector<int> lowerEdges(columns);
+    vector<int> upperEdges(columns);
+    vector<int> sideEdges(columns + 1);
+
+    fill(ys.begin(), ys.end(), bottom);
+    f->getFunctions(&xs[0], &ys[0], nullptr, &below[0], columns + 1);
+    for (int i = 0; i < columns; i++)
+    {
+        lowerEdges[i] = cross(xs[i], bottom, below[i], xs[i + 1], bottom, below[i + 1], true);
+    }
+
+    for (int j = 0; j < rows; j++)
+    {
+        double y0 = bottom + j * dy;
+        double y1 = bottom + (j + 1) * dy;
+        fill(ys.begin(), ys.end(), y1);
+        f->getFunctions(&xs[0], &ys[0], nullptr, &above[0], columns + 1);
+        for (int i = 0; i < columns; i++)
+        {
+            upperEdges[i] = cross(xs[i], y1, above[i], xs[i + 1], y1, above[i + 1], true);
+        }
+        for (int i = 0; i <= columns; i++)
+        {
+            sideEdges[i] = cross(xs[i], y0, below[i], xs[i], y1, above[i], false);
+        }
+
+        for (int i = 0; i < columns; i++)
+        {
+            double corners[4] = { below[i], below[i + 1], above[i + 1], above[i] };
+            int edges[4] = { lowerEdges[i], sideEdges[i + 1], upperEdges[i], sideEdges[i] };
+            int count = 0;
+            int crossed[4];
+            for (int k = 0; k < 4; k++)
+            {
+                if (edges[k] != none)
+                {
+                    crossed[count++] = k;
+                }
+            }
+
+            if (count == 2)
+            {
+                addSegment(edges[crossed[0]], edges[crossed[1]]);
+            }
+            else if (count == 4)
+            {
+                // a saddle, the value at the centre tells which pair of opposite corners is joined
+                double centre = (corners[0] + corners[1] + corners[2] + corners[3]) / 4.0;
+                if ((centre >= 0.0) == (corners[0] >= 0.0))
+                {
+                    addSegment(edges[0], edges[1]);
+                    addSegment(edges[2], edges[3]);
+                }
+                else
+                {
+                    addSegment(edges[0], edges[3]);
+                    addSegment(edges[1], edges[2]);
+                }
+            }
+        }
+
+        below.swap(above);
+        lowerEdges.swap(upperEdges);
+    }
+
+    joinSegments();
+}
+
+const vector<XMarchingSquares::Polyline> &XMarchingSquares::getPolylines() const
+{
+    return polylines;
+}
+
+// The crossing on the edge from (x0, y0) to (x1, y1), if f changes sign along it; 0 counts as
+// positive, so that a curve through a corner is crossed once. Refinement is Newton along the edge
+// kept inside an interval where f changes sign, halving it when a step would leave. At a root f then
+// gets small, while at a pole the interval closes in on the pole and f grows past its values at the
+// ends, which is how a pole is told from the curve.
+int XMarchingSquares::cross(double x0, double y0, double f0, double x1, double y1, double f1, bool horizontal)
+{
+    if ((f0 >= 0.0) == (f1 >= 0.0) || !isfinite(f0) || !isfinite(f1))
+    {
+        return none;
+    }
+
+    double t = f0 / (f0 - f1);
+    double x = x0 + t * (x1 - x0);
+    double y = y0 + t * (y1 - y0);
+    double &along = horizontal ? x : y;
+    double start = horizontal ? x0 : y0;
+    double end = horizontal ? x1 : y1;
+    for (int k = 0; ; k++)
+    {
+        double derivative;
+        double value = f->getFunctionAndDerivative(horizontal ? "x" : "y", derivative, x, y);
+        if (!(fabs(value) <= max(fabs(f0), fabs(f1))))
+        {
+            return none;
+        }
+        if (k == times || value == 0.0)
+        {
+            break;
+        }
+
+        if ((value >= 0.0) == (f0 >= 0.0))
+        {
+            start = along;
+        }
+        else
+        {
+            end = along;
+        }
+        double next = along - value / derivative;
+        along = next >= min(start, end) && next <= max(start, end) ? next : (start + end) / 2.0;
+    }
+
+    Point point = { x, y };
+    points.push_back(point);
+    return (int)points.size() - 1;
+}
+
+void XMarchingSquares::addSegment(int a, int b)
+{
+    if (a != none && b != none)
+    {
+        segments.push_back(a);
+        segments.push_back(b);
+    }
+}
+
+// Every crossing is on one edge, which belongs to at most two cells, so it ends at most two segments.
+// Chains are walked first from crossings that end only one segment, which gives the open polylines,
+// and what is left are closed ones.
+void XMarchingSquares::joinSegments()
+{
+    int countSegments = (int)segments.size() / 2;
+    vector<int> links(points.size() * 2, none);
+    for (int s = 0; s < countSegments; s++)
+    {
+        for (int e = 0; e < 2; e++)
+        {
+            int p = segments[2 * s + e];
+            links[2 * p + (links[2 * p] == none ? 0 : 1)] = s;
+        }
+    }
+
+    vector<bool> used(countSegments, false);
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (int start = 0; start < (int)points.size(); start++)
+        {
+            bool end = links[2 * start] != none && links[2 * start + 1] == none;
+            if (pass == 0 ? !end : links[2 * start] == none)
+            {
+                continue;
+            }
+
+            Polyline polyline;
+            polyline.push_back(points[start]);
+            int p = start;
+            while (true)
+            {
+                int s = links[2 * p];
+                if (s == none || used[s])
+                {
+                    s = links[2 * p + 1];
+                }
+                if (s == none || used[s])
+                {
+                    break;
+                }
+                used[s] = true;
+                p = segments[2 * s] == p ? segments[2 * s + 1] : segments[2 * s];
+                polyline.push_back(points[p]);
+            }
+            if (polyline.size() > 1)
+            {
+                polylines.push_back(polyline);
+            }
+        }
+    }
+}
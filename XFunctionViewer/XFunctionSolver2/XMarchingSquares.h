@@ -0,0 +1,50 @@
+#pragma once
+#include <vector>
+#include "XFunctionParser.h"
+
+// The curve f(x, y) = 0 as polylines. f is sampled at the corners of a lattice of cells over an
+// area, a row at a time in batches, and the curve crosses an edge of a cell where f changes sign
+// along it. The crossing is placed by linear interpolation and then, if refinement is on, moved by
+// Newton steps along the edge; a crossing where f is larger than at either end of the edge, as at
+// the pole of 1 / x, is dropped. A curve along which f touches 0 without changing sign, as
+// (x - y) ^ 2, is not found. The segments of the cells are joined at their shared crossings into
+// polylines, which are closed when their first and last points are the same.
+class XMarchingSquares
+{
+public:
+    struct Point
+    {
+        double x;
+        double y;
+    };
+
+    typedef std::vector<Point> Polyline;
+
+public:
+    XMarchingSquares();
+    ~XMarchingSquares();
+    void setFunction(XFunctionParser *f);
+    void setArea(double left, double bottom, double right, double top);
+    void setResolution(int columns, int rows);  // in cells
+    void setRefinement(int times);              // Newton steps for each crossing, 0 for none
+    int getRefinement() const;
+    void extract();
+    const std::vector<Polyline> &getPolylines() const;
+
+private:
+    int cross(double x0, double y0, double f0, double x1, double y1, double f1, bool horizontal);
+    void addSegment(int a, int b);
+    void joinSegments();
+
+    XFunctionParser *f;
+    double left;
+    double bottom;
+    double right;
+    double top;
+    int columns;
+    int rows;
+    int times;
+    std::vector<Point> points;     // crossings
+    std::vector<int> segments;     // two crossings each
+    std::vector<Polyline> polylines;
+};
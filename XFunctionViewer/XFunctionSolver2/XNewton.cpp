@@ -1,10 +1,18 @@
 #include "XNewton.h"
+#include <cmath>
+
+using namespace std;
 
 XNewton::XNewton()
 {
     f = nullptr;
     d = nullptr;
     times = 50;
+    automatic = false;
+    tolerance = 0.000001;
+    maxDistance = 0.1;
+    status = XRootFinder::MaxIterations;
+    iterations = 0;
 }
 
 XNewton::~XNewton()
@@ -23,7 +31,7 @@ void XNewton::setVariable(std::string variable)
 {
     this->variable = variable;
     delete d;
-    d = f->getDifferentiate(variable);
+    d = automatic ? nullptr : f->getDifferentiate(variable);
 }
 
 void XNewton::setTimes(int times)
@@ -36,73 +44,98 @@ int XNewton::getTimes() const
     return times;
 }
 
+void XNewton::setAutomaticDifferentiation(bool automatic)
+{
+    this->automatic = automatic;
+    delete d;
+    d = nullptr;
+    if (!automatic && f != nullptr && !variable.empty())
+    {
+        d = f->getDifferentiate(variable);
+    }
+}
+
+bool XNewton::isAutomaticDifferentiation() const
+{
+    return automatic;
+}
+
+// The root, or 0.0 when there is none; getStatus tells a root at 0 from a failure.
 double XNewton::newton(double x, double y, double z)
 {
-    double ans;
-    if (variable == "x")
+    double point[3] = { x, y, z };
+    int slot = f->getSymbols().find(variable);
+    iterations = 0;
+    if (slot < 0 || slot > 2)
     {
-        ans = x;    
-        for (int i = 0; i < times; i++)
-        {
-            double valD = d->getFunction(ans, y, z);
-            double  fVal = f->getFunction(ans, y, z);
-            if (fabs(fVal) < 0.000001)
-            {
-                return ans;
-            }
-            if (fabs(valD) < 0.000001)
-            {
-                return 0.0;
-            }
-            if (fabs(ans - x) > 0.1)
-            {
-                return 0.0;
-            }
-            ans -= fVal / valD;
-        }
+        status = XRootFinder::UnknownVariable;
         return 0.0;
     }
-    else if (variable == "y")
+
+    double start = point[slot];
+    while (iterations < times)
     {
-        ans = y;
-        for (int i = 0; i < times; i++)
+        double valD;
+        double fVal = evaluate(point[0], point[1], point[2], valD);
+        iterations++;
+        if (fabs(fVal) < tolerance)
         {
-            double valD = d->getFunction(x, ans, z);
-            double  fVal = f->getFunction(x, ans, z);
-            if (fabs(fVal) < 0.000001)
-            {
-                return ans;
-            }
-            if (fabs(valD) < 0.000001)
-            {
-                return 0.0;
-            }  
-            if (fabs(ans - y) > 0.1)
-            {
-                return 0.0;
-            }
-            ans -= fVal / valD;
+            status = XRootFinder::Converged;
+            return point[slot];
         }
-        return 0.0;
-    }
-    else
-    {
-        ans = x;
-        for (int i = 0; i < times; i++)
+        if (!isfinite(fVal))
         {
-            double valD = d->getFunction(x, y, ans);
-            if (fabs(valD) < 0.0001)
-            {
-                return 0.0;
-            }
-            ans = ans - f->getFunction(x, y, ans) / valD;
+            status = XRootFinder::NotFinite;
+            return 0.0;
         }
-        return ans;
+        if (fabs(valD) < tolerance)
+        {
+            status = XRootFinder::FlatDerivative;
+            return 0.0;
+        }
+        if (fabs(point[slot] - start) > maxDistance)
+        {
+            status = XRootFinder::Diverged;
+            return 0.0;
+        }
+        point[slot] -= fVal / valD;
     }
+    status = XRootFinder::MaxIterations;
     return 0.0;
 }
 
+XRootFinder::Status XNewton::getStatus() const
+{
+    return status;
+}
+
+int XNewton::getIterations() const
+{
+    return iterations;
+}
+
+void XNewton::setTolerance(double tolerance)
+{
+    this->tolerance = tolerance;
+}
+
+void XNewton::setMaxDistance(double distance)
+{
+    maxDistance = distance;
+}
+
 XFunctionParser *XNewton::getDifferentiateParser() const
 {
     return d;
+}
+
+double XNewton::evaluate(double x, double y, double z, double &derivative) const
+{
+    if (automatic)
+    {
+        return f->getFunctionAndDerivative(variable, derivative, x, y, z);
+    }
+
+    derivative = d->getFunction(x, y, z);
+    return f->getFunction(x, y, z);
 }
\ No newline at end of file
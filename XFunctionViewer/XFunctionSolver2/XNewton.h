@@ -1,6 +1,7 @@
 #pragma once
 
 #include "XFunctionParser.h"
+#include "XRootFinder.h"
 #include <string>
 
 class XNewton
@@ -12,13 +13,28 @@ public:
     void setVariable(std::string variable);
     void setTimes(int times);
     int getTimes() const;
+    // true evaluates f and f' together with dual numbers instead of through a derivative parser
+    void setAutomaticDifferentiation(bool automatic);
+    bool isAutomaticDifferentiation() const;
+    void setTolerance(double tolerance);    // on |f| and |f'|, 1e-6 by default
+    void setMaxDistance(double distance);  // from the start, 0.1 by default
+    // One starting point at a time; XRootFinder solves many and keeps a bracket once it has one.
     double newton(double x = 0.0, double y = 0.0, double z = 0.0);
-    XFunctionParser *getDifferentiateParser() const;
+    XRootFinder::Status getStatus() const;  // of the last newton
+    int getIterations() const;
+    XFunctionParser *getDifferentiateParser() const; // nullptr with automatic differentiation
 
 private:
+    double evaluate(double x, double y, double z, double &derivative) const;
+
     XFunctionParser *f;
     XFunctionParser *d;
     std::string variable;
     int times;
+    bool automatic;
+    double tolerance;
+    double maxDistance;
+    XRootFinder::Status status;
+    int iterations;
 };
 
@@ -0,0 +1,51 @@
+#include "XParseNodeArena.h"
+
+using namespace std;
+
+XParseNodeArena::XParseNodeArena()
+{
+    block = -1;
+    used = 0;
+}
+
+XParseNodeArena::~XParseNodeArena()
+{
+    clear();
+    for (int i = 0; i < (int)blocks.size(); i++)
+    {
+        delete[] blocks[i];
+    }
+}
+
+void XParseNodeArena::clear()
+{
+    for (int i = (int)nodes.size() - 1; i >= 0; i--)
+    {
+        nodes[i]->~XAbstractParseNode();
+    }
+    nodes.clear();
+    block = blocks.empty() ? -1 : 0;
+    used = 0;
+}
+
+int XParseNodeArena::getCountNodes() const
+{
+    return (int)nodes.size();
+}
+
+void *XParseNodeArena::allocate(size_t size)
+{
+    size = (size + alignment - 1) / alignment * alignment;
+    if (block < 0 || used + size > blockSize)
+    {
+        block++;
+        used = 0;
+        if (block == (int)blocks.size())
+        {
+            blocks.push_back(new char[blockSize]);
+        }
+    }
+    void *ans = blocks[block] + used;
+    used += size;
+    return ans;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+#include "XAbstractParseNode.h"
+
+// Owns the nodes of parse trees. Nodes are placed one after another in large blocks, so a tree built
+// bottom up lies in memory in the order it is walked, and they are all destroyed together by clear or
+// by the destruction of the arena; a node is never deleted on its own. The blocks are kept for the
+// next trees after clear.
+class XParseNodeArena
+{
+public:
+    XParseNodeArena();
+    ~XParseNodeArena();
+    void clear();
+    int getCountNodes() const;
+
+    template <class Node, class... Arguments>
+    Node *create(Arguments &&... arguments)
+    {
+        Node *node = new (allocate(sizeof(Node))) Node(std::forward<Arguments>(arguments)...);
+        nodes.push_back(node);
+        return node;
+    }
+
+private:
+    XParseNodeArena(const XParseNodeArena &);
+    XParseNodeArena &operator=(const XParseNodeArena &);
+
+    void *allocate(size_t size);
+
+    static const size_t blockSize = 16384;
+    static const size_t alignment = 16;
+
+    std::vector<char *> blocks;
+    int block;    // the block being filled
+    size_t used;  // bytes of it
+    std::vector<XAbstractParseNode *> nodes;
+};
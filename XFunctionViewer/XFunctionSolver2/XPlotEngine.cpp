@@ -0,0 +1,150 @@
+#include "XPlotEngine.h"
+#include <cmath>
+#include <vector>
+
+using namespace std;
+
+static const unsigned char curveColor = 0;
+static const unsigned char axisColor = 160;
+
+XPlotEngine::XPlotEngine()
+{
+    mode = Implicit;
+    centerX = 0.0;
+    centerY = 0.0;
+    limit = 20.0;
+    width = 900;
+    height = 900;
+    axes = true;
+    unit = 0.0;
+    originX = 0;
+    originY = 0;
+}
+
+XPlotEngine::~XPlotEngine()
+{
+}
+
+void XPlotEngine::setMode(Mode mode)
+{
+    this->mode = mode;
+}
+
+XPlotEngine::Mode XPlotEngine::getMode() const
+{
+    return mode;
+}
+
+void XPlotEngine::setView(double centerX, double centerY, double limit)
+{
+    this->centerX = centerX;
+    this->centerY = centerY;
+    this->limit = limit;
+}
+
+void XPlotEngine::setResolution(int width, int height)
+{
+    this->width = width;
+    this->height = height;
+}
+
+void XPlotEngine::setAxes(bool axes)
+{
+    this->axes = axes;
+}
+
+bool XPlotEngine::render(const string &source, XPlotImage &image)
+{
+    image.resize(width, height);
+    unit = limit / (width / 2.0);
+    originX = (int)lround(centerX / unit) - width / 2;
+    originY = (int)lround(centerY / unit) - height / 2;
+    if (axes)
+    {
+        image.drawLine(0.0, height - 0.5 + originY, width, height - 0.5 + originY, axisColor);
+        image.drawLine(0.5 - originX, 0.0, 0.5 - originX, height, axisColor);
+    }
+
+    parser.setSource(source);
+    if (parser.getBytecode().isEmpty())
+    {
+        return false;
+    }
+
+    double left = (originX - 0.5) * unit;
+    double bottom = (originY - 0.5) * unit;
+    double right = (originX + width - 0.5) * unit;
+    double top = (originY + height - 0.5) * unit;
+    if (mode == Implicit)
+    {
+        vector<char> cells((size_t)width * height);
+        bool finished = renderer.render(source, unit, originX, originY, width, height, cells.data());
+        for (int i = 0; i < width; i++)
+        {
+            for (int j = 0; j < height; j++)
+            {
+                if (cells[(size_t)i * height + j])
+                {
+                    image.setPixel(i, height - 1 - j, curveColor);
+                }
+            }
+        }
+        return finished;
+    }
+    if (mode == Contour)
+    {
+        squares.setFunction(&parser);
+        squares.setArea(left, bottom, right, top);
+        squares.setResolution(width, height);
+        squares.extract();
+        const vector<XMarchingSquares::Polyline> &polylines = squares.getPolylines();
+        for (int k = 0; k < (int)polylines.size(); k++)
+        {
+            drawPolyline(polylines[k], image);
+        }
+        return true;
+    }
+
+    plotter.setFunction(&parser);
+    plotter.setArea(left, bottom, right, top);
+    plotter.setResolution(width, height);
+    plotter.extract();
+    const vector<XExplicitPlotter::Polyline> &polylines = plotter.getPolylines();
+    for (int k = 0; k < (int)polylines.size(); k++)
+    {
+        drawPolyline(polylines[k], image);
+    }
+    return true;
+}
+
+XFunctionParser &XPlotEngine::getParser()
+{
+    return parser;
+}
+
+XImplicitRenderer &XPlotEngine::getImplicitRenderer()
+{
+    return renderer;
+}
+
+XMarchingSquares &XPlotEngine::getMarchingSquares()
+{
+    return squares;
+}
+
+XExplicitPlotter &XPlotEngine::getExplicitPlotter()
+{
+    return plotter;
+}
+
+// A point of the plane at x lies at x / unit - originX + 0.5 across the image, as the pixel k of the
+// plane is centered on k * unit, and likewise up from the bottom for y.
+template <class Polyline>
+void XPlotEngine::drawPolyline(const Polyline &polyline, XPlotImage &image) const
+{
+    for (int p = 1; p < (int)polyline.size(); p++)
+    {
+        image.drawLine(polyline[p - 1].x / unit - originX + 0.5, height - 0.5 - polyline[p - 1].y / unit + originY,
+            polyline[p].x / unit - originX + 0.5, height - 0.5 - polyline[p].y / unit + originY, curveColor);
+    }
+}
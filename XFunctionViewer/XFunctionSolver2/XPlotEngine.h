@@ -0,0 +1,59 @@
+#pragma once
+#include <string>
+#include "XExplicitPlotter.h"
+#include "XFunctionParser.h"
+#include "XImplicitRenderer.h"
+#include "XMarchingSquares.h"
+#include "XPlotImage.h"
+
+// Draws a plot of a source into an XPlotImage, with no window system, for the command line tool and
+// anything else rendering plots away from the GUI. The view is given as in XFIProvider, a center and
+// the half width of the view, and the pixel (i, j) of the image is the pixel (originX + i, originY +
+// height - 1 - j) of the plane (see XImplicitRenderer), so y points up.
+// Implicit draws the cells XImplicitRenderer accepts for f(x, y) = 0, Contour the polylines of
+// XMarchingSquares and Explicit those of XExplicitPlotter for y = f(x). The curve is black over axes
+// in grey.
+class XPlotEngine
+{
+public:
+    enum Mode
+    {
+        Implicit,
+        Contour,
+        Explicit
+    };
+
+public:
+    XPlotEngine();
+    ~XPlotEngine();
+    void setMode(Mode mode);
+    Mode getMode() const;
+    void setView(double centerX, double centerY, double limit);  // 0, 0 and 20 by default
+    void setResolution(int width, int height);                   // 900 by 900 by default
+    void setAxes(bool axes);                                     // true by default
+    // false when the source has no expression, with the image holding only the axes
+    bool render(const std::string &source, XPlotImage &image);
+    XFunctionParser &getParser();
+    XImplicitRenderer &getImplicitRenderer();
+    XMarchingSquares &getMarchingSquares();
+    XExplicitPlotter &getExplicitPlotter();
+
+private:
+    template <class Polyline>
+    void drawPolyline(const Polyline &polyline, XPlotImage &image) const;
+
+    Mode mode;
+    double centerX;
+    double centerY;
+    double limit;
+    int width;
+    int height;
+    bool axes;
+    double unit;
+    int originX;  // the pixel of the plane at the bottom left of the image
+    int originY;
+    XFunctionParser parser;
+    XImplicitRenderer renderer;
+    XMarchingSquares squares;
+    XExplicitPlotter plotter;
+};
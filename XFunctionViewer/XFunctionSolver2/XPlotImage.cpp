@@ -0,0 +1,215 @@
+#include "XPlotImage.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+using namespace std;
+
+static void appendBigEndian(vector<unsigned char> &data, unsigned int value)
+{
+    data.push_back((unsigned char)(value >> 24));
+    data.push_back((unsigned char)(value >> 16));
+    data.push_back((unsigned char)(value >> 8));
+    data.push_back((unsigned char)value);
+}
+
+// the table is made once, by the first thread to get here
+static unsigned int crc32(const unsigned char *data, size_t length)
+{
+    static const struct Table
+    {
+        unsigned int values[256];
+
+        Table()
+        {
+            for (unsigned int n = 0; n < 256; n++)
+            {
+                unsigned int c = n;
+                for (int k = 0; k < 8; k++)
+                {
+                    c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                values[n] = c;
+            }
+        }
+    } table;
+
+    unsigned int c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; i++)
+    {
+        c = table.values[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+    }
+    return c ^ 0xFFFFFFFFu;
+}
+
+// a chunk is its length, its type and data, and the CRC of the type and data
+static void appendChunk(vector<unsigned char> &file, const char *type, const vector<unsigned char> &data)
+{
+    appendBigEndian(file, (unsigned int)data.size());
+    size_t start = file.size();
+    file.insert(file.end(), type, type + 4);
+    file.insert(file.end(), data.begin(), data.end());
+    appendBigEndian(file, crc32(&file[start], file.size() - start));
+}
+
+XPlotImage::XPlotImage()
+{
+    width = 0;
+    height = 0;
+}
+
+XPlotImage::~XPlotImage()
+{
+}
+
+void XPlotImage::resize(int width, int height, unsigned char value)
+{
+    this->width = max(width, 0);
+    this->height = max(height, 0);
+    pixels.assign((size_t)this->width * this->height, value);
+}
+
+void XPlotImage::fill(unsigned char value)
+{
+    std::fill(pixels.begin(), pixels.end(), value);
+}
+
+int XPlotImage::getWidth() const
+{
+    return width;
+}
+
+int XPlotImage::getHeight() const
+{
+    return height;
+}
+
+unsigned char XPlotImage::getPixel(int x, int y) const
+{
+    return pixels[(size_t)y * width + x];
+}
+
+void XPlotImage::setPixel(int x, int y, unsigned char value)
+{
+    if (x >= 0 && x < width && y >= 0 && y < height)
+    {
+        pixels[(size_t)y * width + x] = value;
+    }
+}
+
+// The segment is first cut to the image (Liang-Barsky), so a polyline running far off, as near a
+// pole, costs no more than its visible part; then it is walked in steps of at most a pixel along
+// each axis.
+void XPlotImage::drawLine(double x0, double y0, double x1, double y1, unsigned char value)
+{
+    double dx = x1 - x0;
+    double dy = y1 - y0;
+    double t0 = 0.0;
+    double t1 = 1.0;
+    const double p[4] = { -dx, dx, -dy, dy };
+    const double q[4] = { x0, width - x0, y0, height - y0 };
+    for (int i = 0; i < 4; i++)
+    {
+        if (p[i] == 0.0)
+        {
+            if (!(q[i] >= 0.0))
+            {
+                return;
+            }
+            continue;
+        }
+        double t = q[i] / p[i];
+        if (p[i] < 0.0)
+        {
+            t0 = max(t0, t);
+        }
+        else
+        {
+            t1 = min(t1, t);
+        }
+    }
+    if (!(t0 <= t1))
+    {
+        return;
+    }
+
+    double ax = x0 + t0 * dx;
+    double ay = y0 + t0 * dy;
+    double bx = x0 + t1 * dx;
+    double by = y0 + t1 * dy;
+    int steps = (int)ceil(max(fabs(bx - ax), fabs(by - ay)));
+    for (int k = 0; k <= steps; k++)
+    {
+        double t = steps > 0 ? (double)k / steps : 0.0;
+        int x = (int)floor(ax + t * (bx - ax));
+        int y = (int)floor(ay + t * (by - ay));
+        setPixel(min(x, width - 1), min(y, height - 1), value);
+    }
+}
+
+const unsigned char *XPlotImage::getPixels() const
+{
+    return pixels.data();
+}
+
+bool XPlotImage::writePgm(const string &path) const
+{
+    ofstream file(path.c_str(), ios::binary);
+    file << "P5\n" << width << " " << height << "\n255\n";
+    file.write((const char *)pixels.data(), pixels.size());
+    return file.good();
+}
+
+// The image data is a zlib stream of stored deflate blocks, each row led by filter type 0, none.
+bool XPlotImage::writePng(const string &path) const
+{
+    static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    vector<unsigned char> file(signature, signature + 8);
+
+    vector<unsigned char> header;
+    appendBigEndian(header, width);
+    appendBigEndian(header, height);
+    header.push_back(8);  // bits a sample
+    header.push_back(0);  // grey
+    header.push_back(0);  // deflate
+    header.push_back(0);  // adaptive filtering
+    header.push_back(0);  // not interlaced
+    appendChunk(file, "IHDR", header);
+
+    vector<unsigned char> raw;
+    raw.reserve(pixels.size() + height);
+    for (int y = 0; y < height; y++)
+    {
+        raw.push_back(0);
+        raw.insert(raw.end(), pixels.begin() + (size_t)y * width, pixels.begin() + (size_t)(y + 1) * width);
+    }
+    vector<unsigned char> data;
+    data.push_back(0x78);
+    data.push_back(0x01);
+    size_t position = 0;
+    do
+    {
+        size_t length = min(raw.size() - position, (size_t)65535);
+        data.push_back(position + length == raw.size() ? 1 : 0);
+        data.push_back((unsigned char)length);
+        data.push_back((unsigned char)(length >> 8));
+        data.push_back((unsigned char)~length);
+        data.push_back((unsigned char)(~length >> 8));
+        data.insert(data.end(), raw.begin() + position, raw.begin() + position + length);
+        position += length;
+    } while (position < raw.size());
+    unsigned int a = 1;
+    unsigned int b = 0;
+    for (size_t i = 0; i < raw.size(); i++)
+    {
+        a = (a + raw[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    appendBigEndian(data, b << 16 | a);
+    appendChunk(file, "IDAT", data);
+    appendChunk(file, "IEND", vector<unsigned char>());
+
+    ofstream out(path.c_str(), ios::binary);
+    out.write((const char *)file.data(), file.size());
+    return out.good();
+}
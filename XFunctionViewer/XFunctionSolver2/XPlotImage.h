@@ -0,0 +1,29 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// A grey image to draw plots on without a window system, 0 black and 255 white, rows from the top.
+// It is written as a binary PGM, or as a PNG whose data is stored without compression, so neither
+// needs a library.
+class XPlotImage
+{
+public:
+    XPlotImage();
+    ~XPlotImage();
+    void resize(int width, int height, unsigned char value = 255);
+    void fill(unsigned char value);
+    int getWidth() const;
+    int getHeight() const;
+    unsigned char getPixel(int x, int y) const;
+    void setPixel(int x, int y, unsigned char value);  // ignored outside the image
+    // the pixels the segment passes through, where the pixel (x, y) spans x .. x + 1 and y .. y + 1
+    void drawLine(double x0, double y0, double x1, double y1, unsigned char value);
+    const unsigned char *getPixels() const;            // [y * width + x]
+    bool writePgm(const std::string &path) const;      // false when the file cannot be written
+    bool writePng(const std::string &path) const;
+
+private:
+    std::vector<unsigned char> pixels;
+    int width;
+    int height;
+};
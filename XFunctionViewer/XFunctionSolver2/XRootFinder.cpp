@@ -0,0 +1,305 @@
+#include "XRootFinder.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+XRootFinder::XRootFinder()
+{
+    f = nullptr;
+    method = Newton;
+    times = 50;
+    valueTolerance = 0.000001;
+    stepTolerance = 1e-12;
+    maxDistance = 0.1;
+    accuracy = XVectorMath::Precise;
+}
+
+XRootFinder::~XRootFinder()
+{
+}
+
+void XRootFinder::setFunction(XFunctionParser *f)
+{
+    this->f = f;
+}
+
+void XRootFinder::setVariable(string variable)
+{
+    this->variable = variable;
+}
+
+void XRootFinder::setMethod(Method method)
+{
+    this->method = method;
+}
+
+XRootFinder::Method XRootFinder::getMethod() const
+{
+    return method;
+}
+
+void XRootFinder::setTimes(int times)
+{
+    this->times = times;
+}
+
+int XRootFinder::getTimes() const
+{
+    return times;
+}
+
+void XRootFinder::setTolerance(double valueTolerance, double stepTolerance)
+{
+    this->valueTolerance = valueTolerance;
+    this->stepTolerance = stepTolerance;
+}
+
+void XRootFinder::setMaxDistance(double distance)
+{
+    maxDistance = distance;
+}
+
+void XRootFinder::setAccuracy(XVectorMath::Accuracy accuracy)
+{
+    this->accuracy = accuracy;
+}
+
+// The running lanes are kept packed at the front of the work columns, so each batch only covers
+// them; the column of the variable is rewritten with their points before every batch. Below
+// minBatch lanes a batch costs more than it saves, and each lane takes a scalar pass with Taylor
+// series instead.
+// The lanes go in blocks, so the work of a block stays in the cache and its memory is reused by the next.
+void XRootFinder::solve(const double *const *columns, int countColumns, Result *results, int count)
+{
+    vector<const double *> shifted(countColumns);
+    for (int start = 0; start < count; start += blockSize)
+    {
+        for (int s = 0; s < countColumns; s++)
+        {
+            shifted[s] = columns[s] != nullptr ? columns[s] + start : nullptr;
+        }
+        solveBlock(shifted.data(), countColumns, results + start, count - start < blockSize ? count - start : blockSize);
+    }
+}
+
+void XRootFinder::solveBlock(const double *const *columns, int countColumns, Result *results, int count)
+{
+    int slot = f == nullptr ? -1 : f->getSymbols().find(variable);
+    vector<Lane> lanes(count);
+    vector<int> running(count);
+    for (int i = 0; i < count; i++)
+    {
+        Lane &lane = lanes[i];
+        lane.x = slot >= 0 && slot < countColumns && columns[slot] != nullptr ? columns[slot][i] : 0.0;
+        lane.start = lane.x;
+        lane.bracketed = false;
+        Result result = { lane.x, numeric_limits<double>::quiet_NaN(), 0, slot >= 0 ? MaxIterations : UnknownVariable };
+        results[i] = result;
+        running[i] = i;
+    }
+    if (slot < 0 || count <= 0)
+    {
+        return;
+    }
+
+    int countWork = max(countColumns, slot + 1);
+    vector<vector<double> > work(countWork);
+    vector<const double *> pointers(countWork, nullptr);
+    for (int s = 0; s < countWork; s++)
+    {
+        bool given = s < countColumns && columns[s] != nullptr;
+        if (given || s == slot)
+        {
+            work[s].assign(count, 0.0);
+            pointers[s] = work[s].data();
+        }
+        if (given && s != slot)
+        {
+            copy(columns[s], columns[s] + count, work[s].begin());
+        }
+    }
+
+    int order = method == Halley ? 2 : 1;
+    vector<double> values(count);
+    vector<double> slopes(count);
+    vector<double> curvatures(order > 1 ? count : 0);
+    double *outputs[3] = { values.data(), slopes.data(), curvatures.data() };
+    vector<double> arguments(max(countWork, f->getSymbols().getCountSlots()), 0.0);
+    double derivatives[3];
+    int countRunning = count;
+    for (int k = 0; k < times && countRunning > 0; k++)
+    {
+        if (slot >= 0)
+        {
+            for (int r = 0; r < countRunning; r++)
+            {
+                work[slot][r] = lanes[running[r]].x;
+            }
+        }
+        if (countRunning >= minBatch)
+        {
+            f->getFunctionsAndDerivatives(variable, order, pointers.data(), countWork, outputs, countRunning, accuracy);
+        }
+        else
+        {
+            for (int r = 0; r < countRunning; r++)
+            {
+                for (int s = 0; s < countWork; s++)
+                {
+                    arguments[s] = pointers[s] != nullptr ? work[s][r] : 0.0;
+                }
+                f->getBytecode().evaluateTaylor(arguments.data(), slot, order, derivatives);
+                values[r] = derivatives[0];
+                slopes[r] = derivatives[1];
+                if (order > 1)
+                {
+                    curvatures[r] = derivatives[2];
+                }
+            }
+        }
+
+        int kept = 0;
+        for (int r = 0; r < countRunning; r++)
+        {
+            int i = running[r];
+            if (!update(lanes[i], results[i], values[r], slopes[r], order > 1 ? curvatures[r] : 0.0))
+            {
+                continue;
+            }
+            running[kept] = i;
+            for (int s = 0; s < countWork; s++)
+            {
+                if (pointers[s] != nullptr && s != slot)
+                {
+                    work[s][kept] = work[s][r];
+                }
+            }
+            kept++;
+        }
+        countRunning = kept;
+    }
+}
+
+XRootFinder::Result XRootFinder::solve(double x, double y, double z)
+{
+    const double *columns[3] = { &x, &y, &z };
+    Result result;
+    solve(columns, 3, &result, 1);
+    return result;
+}
+
+// One iteration of a lane with f and its derivatives at its point; false once the lane has a status.
+bool XRootFinder::update(Lane &lane, Result &result, double value, double slope, double curvature)
+{
+    result.root = lane.x;
+    result.value = value;
+    result.iterations++;
+    if (fabs(value) <= valueTolerance)
+    {
+        result.status = Converged;
+        return false;
+    }
+    if (!isfinite(value))
+    {
+        result.status = NotFinite;
+        return false;
+    }
+
+    if (result.iterations > 1)
+    {
+        bracket(lane, value);
+    }
+    lane.previous = lane.x;
+    lane.fPrevious = value;
+    if (lane.bracketed && fabs(lane.b - lane.a) <= stepTolerance * (1.0 + fabs(lane.x)))
+    {
+        result.status = fabs(value) <= lane.fBracket ? Converged : Stalled;
+        return false;
+    }
+
+    double step = value / slope;
+    if (method == Halley)
+    {
+        double denominator = 2.0 * slope * slope - value * curvature;
+        if (denominator != 0.0)
+        {
+            step = 2.0 * value * slope / denominator;
+        }
+    }
+    double next = lane.x - step;
+    if (lane.bracketed)
+    {
+        double low = min(lane.a, lane.b);
+        double high = max(lane.a, lane.b);
+        if (!(next > low && next < high))
+        {
+            next = (lane.a * lane.fb - lane.b * lane.fa) / (lane.fb - lane.fa);
+        }
+        if (!(next > low && next < high))
+        {
+            next = (low + high) / 2.0;
+        }
+    }
+    else if (slope == 0.0 || !isfinite(next))
+    {
+        result.status = FlatDerivative;
+        return false;
+    }
+    else if (maxDistance > 0.0 && fabs(next - lane.start) > maxDistance)
+    {
+        result.status = Diverged;
+        return false;
+    }
+
+    if (next == lane.x)
+    {
+        result.status = Stalled;
+        return false;
+    }
+    lane.x = next;
+    return true;
+}
+
+// The bracket starts at the first sign change between two points in a row; after that each point
+// replaces the end where f has its sign, and an end kept twice in a row has its f halved. Closing in
+// on a root f gets smaller than it was at the first ends, closing in on a pole it grows.
+void XRootFinder::bracket(Lane &lane, double value)
+{
+    if (!lane.bracketed)
+    {
+        if ((value >= 0.0) != (lane.fPrevious >= 0.0))
+        {
+            lane.bracketed = true;
+            lane.a = lane.previous;
+            lane.fa = lane.fPrevious;
+            lane.b = lane.x;
+            lane.fb = value;
+            lane.side = 1;
+            lane.fBracket = max(fabs(lane.fa), fabs(lane.fb));
+        }
+        return;
+    }
+
+    if ((value >= 0.0) == (lane.fa >= 0.0))
+    {
+        lane.a = lane.x;
+        lane.fa = value;
+        if (lane.side == -1)
+        {
+            lane.fb /= 2.0;
+        }
+        lane.side = -1;
+    }
+    else
+    {
+        lane.b = lane.x;
+        lane.fb = value;
+        if (lane.side == 1)
+        {
+            lane.fa /= 2.0;
+        }
+        lane.side = 1;
+    }
+}
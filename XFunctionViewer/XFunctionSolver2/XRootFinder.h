@@ -0,0 +1,94 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "XFunctionParser.h"
+
+// Roots of f along one variable from many starting points at once. Each starting point is a lane,
+// and every iteration evaluates f and its derivatives for all lanes still running in one batch
+// through the bytecode, so the work is spread over the vector units; a lane leaves the batch as soon
+// as it has a status. f and the derivatives are one program (see XExpressionCache), which computes
+// the subexpressions they share once.
+// A lane takes Newton or Halley steps. Once two of its points have f of opposite signs it keeps the
+// bracket between them, and a step that would leave the bracket is replaced by an Illinois step,
+// regula falsi that halves the weight of an end kept twice in a row, so it cannot wander off a root
+// it has found. Without a bracket a lane stops when the derivative vanishes or when it gets further
+// than maxDistance from where it started.
+class XRootFinder
+{
+public:
+    enum Method
+    {
+        Newton,
+        Halley
+    };
+
+    enum Status
+    {
+        Converged,       // |f| within valueTolerance, or a root too steep for it bracketed within
+                         // stepTolerance
+        Stalled,         // a pole bracketed within stepTolerance, or a step that did not move
+        Diverged,        // a step went further than maxDistance from the start
+        FlatDerivative,  // f' vanished before a sign change was found
+        NotFinite,       // f was not finite before a sign change was found
+        MaxIterations,
+        UnknownVariable  // f has no variable of that name (for XNewton, none of x, y and z), nothing
+                         // was solved
+    };
+
+    struct Result
+    {
+        double root;     // the last point, whatever the status
+        double value;    // f there
+        int iterations;  // evaluations of f
+        Status status;
+    };
+
+public:
+    XRootFinder();
+    ~XRootFinder();
+    void setFunction(XFunctionParser *f);
+    void setVariable(std::string variable);
+    void setMethod(Method method);
+    Method getMethod() const;
+    void setTimes(int times);                                     // iterations for each lane, 50 by default
+    int getTimes() const;
+    void setTolerance(double valueTolerance, double stepTolerance);  // 1e-6 and 1e-12, the bracket relative to 1 + |x|
+    void setMaxDistance(double distance);                         // 0.1 by default, 0 for no limit
+    void setAccuracy(XVectorMath::Accuracy accuracy);             // of the batches, Precise by default
+    // Lane i starts from the point whose slot s is columns[s][i], a null column reads as zeros; the
+    // column of the variable holds the starting values.
+    void solve(const double *const *columns, int countColumns, Result *results, int count);
+    Result solve(double x = 0.0, double y = 0.0, double z = 0.0);
+
+private:
+    struct Lane
+    {
+        double x;
+        double start;
+        double previous;  // the point before, and f there
+        double fPrevious;
+        bool bracketed;
+        double a;         // the ends of the bracket, and f there
+        double fa;
+        double b;
+        double fb;
+        int side;         // the end replaced last, -1 for a, 1 for b
+        double fBracket;  // the larger |f| at the first ends
+    };
+
+    static const int blockSize = 4096;
+    static const int minBatch = 16;
+
+    void solveBlock(const double *const *columns, int countColumns, Result *results, int count);
+    bool update(Lane &lane, Result &result, double value, double slope, double curvature);
+    void bracket(Lane &lane, double value);
+
+    XFunctionParser *f;
+    std::string variable;
+    Method method;
+    int times;
+    double valueTolerance;
+    double stepTolerance;
+    double maxDistance;
+    XVectorMath::Accuracy accuracy;
+};
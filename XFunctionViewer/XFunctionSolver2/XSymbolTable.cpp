@@ -0,0 +1,66 @@
+#include "XSymbolTable.h"
+#include <cstring>
+
+using namespace std;
+
+XSymbolTable::XSymbolTable()
+{
+    clear();
+}
+
+XSymbolTable::~XSymbolTable()
+{
+}
+
+void XSymbolTable::clear()
+{
+    names.clear();
+    names.push_back("x");
+    names.push_back("y");
+    names.push_back("z");
+}
+
+// There are a few names at most, so a scan beats hashing and needs no key string.
+int XSymbolTable::find(const char *name, int length) const
+{
+    for (int i = 0; i < (int)names.size(); i++)
+    {
+        if ((int)names[i].length() == length && memcmp(names[i].data(), name, length) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int XSymbolTable::find(const string &name) const
+{
+    return find(name.data(), (int)name.length());
+}
+
+int XSymbolTable::add(const char *name, int length)
+{
+    int slot = find(name, length);
+    if (slot < 0)
+    {
+        slot = (int)names.size();
+        names.push_back(string(name, length));
+    }
+    return slot;
+}
+
+int XSymbolTable::add(const string &name)
+{
+    return add(name.data(), (int)name.length());
+}
+
+const string &XSymbolTable::getName(int slot) const
+{
+    static const string none;
+    return slot >= 0 && slot < (int)names.size() ? names[slot] : none;
+}
+
+int XSymbolTable::getCountSlots() const
+{
+    return (int)names.size();
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Variable names and the argument slots they are bound to. x, y and z are bound to slots 0, 1 and 2
+// from the start, any other name gets the next free slot the first time it is added. Lookups take a
+// name as characters and a length, so a name is compared where it stands in the source.
+class XSymbolTable
+{
+public:
+    XSymbolTable();
+    ~XSymbolTable();
+    void clear();
+    int find(const char *name, int length) const;  // -1 for a name that is not bound
+    int find(const std::string &name) const;
+    int add(const char *name, int length);          // the slot of name, bound to a new one if need be
+    int add(const std::string &name);
+    const std::string &getName(int slot) const;     // empty for a slot no name is bound to
+    int getCountSlots() const;
+
+private:
+    std::vector<std::string> names;  // by slot
+};
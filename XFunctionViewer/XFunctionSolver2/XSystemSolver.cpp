@@ -0,0 +1,384 @@
+#include "XSystemSolver.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+static const char *names[3] = { "x", "y", "z" };
+
+XSystemSolver::XSystemSolver()
+{
+    times = 100;
+    valueTolerance = 1e-10;
+    stepTolerance = 1e-15;
+    maxDistance = 0.0;
+    accuracy = XVectorMath::Precise;
+}
+
+XSystemSolver::~XSystemSolver()
+{
+    for (int i = 0; i < (int)derivatives.size(); i++)
+    {
+        delete derivatives[i];
+    }
+}
+
+void XSystemSolver::setFunctions(const vector<XFunctionParser *> &functions)
+{
+    this->functions = functions;
+    prepare();
+}
+
+void XSystemSolver::setVariables(const vector<string> &variables)
+{
+    slots.clear();
+    for (int i = 0; i < (int)variables.size(); i++)
+    {
+        for (int s = 0; s < 3; s++)
+        {
+            if (variables[i] == names[s] && find(slots.begin(), slots.end(), s) == slots.end())
+            {
+                slots.push_back(s);
+            }
+        }
+    }
+    prepare();
+}
+
+void XSystemSolver::setTimes(int times)
+{
+    this->times = times;
+}
+
+int XSystemSolver::getTimes() const
+{
+    return times;
+}
+
+void XSystemSolver::setTolerance(double valueTolerance, double stepTolerance)
+{
+    this->valueTolerance = valueTolerance;
+    this->stepTolerance = stepTolerance;
+}
+
+void XSystemSolver::setMaxDistance(double distance)
+{
+    maxDistance = distance;
+}
+
+void XSystemSolver::setAccuracy(XVectorMath::Accuracy accuracy)
+{
+    this->accuracy = accuracy;
+}
+
+void XSystemSolver::prepare()
+{
+    for (int i = 0; i < (int)derivatives.size(); i++)
+    {
+        delete derivatives[i];
+    }
+    derivatives.clear();
+    for (int f = 0; f < (int)functions.size(); f++)
+    {
+        for (int v = 0; v < (int)slots.size(); v++)
+        {
+            derivatives.push_back(functions[f]->getDifferentiate(names[slots[v]]));
+        }
+    }
+}
+
+// Each iteration evaluates the functions at the trial points of all running lanes in one batch, and
+// then the Jacobian only at the points of the lanes whose trial was taken; a lane whose trial was
+// turned down retries from the Jacobian it has. values and jacobians hold the functions and the
+// Jacobian at the point of each lane.
+void XSystemSolver::solve(const double *x, const double *y, const double *z, Result *results, int count)
+{
+    const double *given[3] = { x, y, z };
+    int countFunctions = (int)functions.size();
+    int countVariables = (int)slots.size();
+    vector<Lane> lanes(count);
+    for (int i = 0; i < count; i++)
+    {
+        Lane &lane = lanes[i];
+        Result &result = results[i];
+        for (int s = 0; s < 3; s++)
+        {
+            lane.point[s] = given[s] != nullptr ? given[s][i] : 0.0;
+            lane.start[s] = lane.point[s];
+            lane.trial[s] = lane.point[s];
+            result.point[s] = lane.point[s];
+        }
+        lane.cost = 0.0;
+        lane.lambda = 0.001;
+        lane.started = false;
+        result.residual = numeric_limits<double>::quiet_NaN();
+        result.iterations = 0;
+        result.status = MaxIterations;
+    }
+    if (countFunctions == 0 || countVariables == 0 || count <= 0)
+    {
+        return;
+    }
+
+    vector<vector<double> > work(3, vector<double>(count));
+    const double *columns[3] = { work[0].data(), work[1].data(), work[2].data() };
+    vector<double> batch(count);
+    vector<double> trialValues((size_t)count * countFunctions);
+    vector<double> values((size_t)count * countFunctions);
+    vector<double> jacobians((size_t)count * countFunctions * countVariables);
+    vector<int> running(count);
+    vector<int> taken(count);
+    vector<char> done(count, 0);
+    for (int i = 0; i < count; i++)
+    {
+        running[i] = i;
+    }
+
+    int countRunning = count;
+    for (int k = 0; k < times && countRunning > 0; k++)
+    {
+        for (int r = 0; r < countRunning; r++)
+        {
+            for (int s = 0; s < 3; s++)
+            {
+                work[s][r] = lanes[running[r]].trial[s];
+            }
+        }
+        for (int f = 0; f < countFunctions; f++)
+        {
+            functions[f]->getFunctions(columns, 3, batch.data(), countRunning, accuracy);
+            for (int r = 0; r < countRunning; r++)
+            {
+                trialValues[(size_t)r * countFunctions + f] = batch[r];
+            }
+        }
+
+        int countTaken = 0;
+        for (int r = 0; r < countRunning; r++)
+        {
+            int i = running[r];
+            Lane &lane = lanes[i];
+            Result &result = results[i];
+            const double *trial = &trialValues[(size_t)r * countFunctions];
+            result.iterations++;
+            double cost = 0.0;
+            double residual = 0.0;
+            for (int f = 0; f < countFunctions; f++)
+            {
+                cost += trial[f] * trial[f];
+                residual = max(residual, fabs(trial[f]));
+            }
+            if (!isfinite(cost) && !lane.started)
+            {
+                result.status = NotFinite;
+                done[i] = 1;
+                continue;
+            }
+            if (isfinite(cost) && (!lane.started || cost < lane.cost))
+            {
+                if (lane.started)
+                {
+                    lane.lambda = max(lane.lambda / 10.0, 1e-12);
+                }
+                lane.started = true;
+                lane.cost = cost;
+                copy(trial, trial + countFunctions, values.begin() + (size_t)i * countFunctions);
+                for (int s = 0; s < 3; s++)
+                {
+                    lane.point[s] = lane.trial[s];
+                    result.point[s] = lane.point[s];
+                }
+                result.residual = residual;
+                if (residual <= valueTolerance)
+                {
+                    result.status = Converged;
+                    done[i] = 1;
+                    continue;
+                }
+                taken[countTaken++] = i;
+                continue;
+            }
+
+            lane.lambda *= 10.0;
+            if (!computeStep(lane, &values[(size_t)i * countFunctions],
+                &jacobians[(size_t)i * countFunctions * countVariables], result))
+            {
+                done[i] = 1;
+            }
+        }
+
+        for (int c = 0; c < countTaken; c++)
+        {
+            for (int s = 0; s < 3; s++)
+            {
+                work[s][c] = lanes[taken[c]].point[s];
+            }
+        }
+        for (int d = 0; d < (int)derivatives.size() && countTaken > 0; d++)
+        {
+            derivatives[d]->getFunctions(columns, 3, batch.data(), countTaken, accuracy);
+            for (int c = 0; c < countTaken; c++)
+            {
+                jacobians[(size_t)taken[c] * countFunctions * countVariables + d] = batch[c];
+            }
+        }
+        for (int c = 0; c < countTaken; c++)
+        {
+            int i = taken[c];
+            if (!computeStep(lanes[i], &values[(size_t)i * countFunctions],
+                &jacobians[(size_t)i * countFunctions * countVariables], results[i]))
+            {
+                done[i] = 1;
+            }
+        }
+
+        int kept = 0;
+        for (int r = 0; r < countRunning; r++)
+        {
+            if (!done[running[r]])
+            {
+                running[kept++] = running[r];
+            }
+        }
+        countRunning = kept;
+    }
+}
+
+XSystemSolver::Result XSystemSolver::solve(double x, double y, double z)
+{
+    Result result;
+    solve(&x, &y, &z, &result, 1);
+    return result;
+}
+
+// The next trial of a lane from the functions and the Jacobian at its point, solving the damped
+// normal equations by Cholesky; a lambda too small to make them positive definite in floating point
+// is raised. false once the lane has a status.
+bool XSystemSolver::computeStep(Lane &lane, const double *values, const double *jacobian, Result &result)
+{
+    int countFunctions = (int)functions.size();
+    int n = (int)slots.size();
+    double a[3][3];
+    double g[3];
+    double step[3];
+    while (true)
+    {
+        if (!(lane.lambda <= 1e16))
+        {
+            result.status = Stalled;
+            return false;
+        }
+
+        for (int j = 0; j < n; j++)
+        {
+            g[j] = 0.0;
+            for (int l = 0; l < n; l++)
+            {
+                a[j][l] = 0.0;
+            }
+        }
+        for (int f = 0; f < countFunctions; f++)
+        {
+            const double *row = jacobian + f * n;
+            for (int j = 0; j < n; j++)
+            {
+                g[j] += row[j] * values[f];
+                for (int l = 0; l < n; l++)
+                {
+                    a[j][l] += row[j] * row[l];
+                }
+            }
+        }
+        bool finite = true;
+        for (int j = 0; j < n; j++)
+        {
+            finite = finite && isfinite(g[j]) && isfinite(a[j][j]);
+            // an unknown no function depends on stays where it is
+            a[j][j] = a[j][j] > 0.0 ? a[j][j] * (1.0 + lane.lambda) : 1.0;
+        }
+        if (!finite)
+        {
+            result.status = Stalled;
+            return false;
+        }
+
+        // a = L L', L in the lower triangle of a
+        bool positive = true;
+        for (int j = 0; j < n && positive; j++)
+        {
+            for (int l = 0; l < j; l++)
+            {
+                a[j][j] -= a[j][l] * a[j][l];
+            }
+            if (!(a[j][j] > 0.0))
+            {
+                positive = false;
+                break;
+            }
+            a[j][j] = sqrt(a[j][j]);
+            for (int i = j + 1; i < n; i++)
+            {
+                for (int l = 0; l < j; l++)
+                {
+                    a[i][j] -= a[i][l] * a[j][l];
+                }
+                a[i][j] /= a[j][j];
+            }
+        }
+        if (!positive)
+        {
+            lane.lambda = max(lane.lambda * 10.0, 1e-6);
+            continue;
+        }
+        for (int j = 0; j < n; j++)
+        {
+            step[j] = -g[j];
+            for (int l = 0; l < j; l++)
+            {
+                step[j] -= a[j][l] * step[l];
+            }
+            step[j] /= a[j][j];
+        }
+        for (int j = n - 1; j >= 0; j--)
+        {
+            for (int l = j + 1; l < n; l++)
+            {
+                step[j] -= a[l][j] * step[l];
+            }
+            step[j] /= a[j][j];
+        }
+        break;
+    }
+
+    bool moved = false;
+    for (int j = 0; j < n; j++)
+    {
+        int s = slots[j];
+        lane.trial[s] = lane.point[s] + step[j];
+        moved = moved || fabs(step[j]) > stepTolerance * (1.0 + fabs(lane.point[s]));
+        if (!isfinite(lane.trial[s]))
+        {
+            result.status = Stalled;
+            return false;
+        }
+    }
+    if (!moved)
+    {
+        result.status = Stalled;
+        return false;
+    }
+    if (maxDistance > 0.0)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            int s = slots[j];
+            if (fabs(lane.trial[s] - lane.start[s]) > maxDistance)
+            {
+                result.status = Diverged;
+                return false;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "XFunctionParser.h"
+
+// Common roots of several functions of x, y and z, as where two curves cross (f = 0 and g = 0) or
+// where the gradient of f vanishes, from many starting points at once. The unknowns are some of x,
+// y and z, the others keep their starting values. As in XRootFinder each starting point is a lane,
+// every iteration evaluates the functions, and the Jacobian where it is needed, for the running lanes
+// in batches through the bytecode, and a lane leaves the batches once it has a status.
+// The Jacobian is made of the compiled derivatives of every function by every unknown, which the
+// expression cache keeps, and a lane takes Levenberg-Marquardt steps: (J'J + lambda D) step = -J'f,
+// with D the diagonal of J'J. A step that lowers |f| is taken and lambda divided by 10, so close to
+// a root the steps become Newton's, which converge quadratically; a step that does not is retried
+// with lambda multiplied by 10, which turns it towards steepest descent and shortens it. With more
+// functions than unknowns this finds least squares points.
+class XSystemSolver
+{
+public:
+    enum Status
+    {
+        Converged,      // every |f| within valueTolerance
+        Stalled,        // no step lowers |f| any more, at a minimum of |f| that is not a root or
+                        // where the Jacobian is singular
+        Diverged,       // the point went further than maxDistance from the start
+        NotFinite,      // f was not finite at the start
+        MaxIterations
+    };
+
+    struct Result
+    {
+        double point[3];  // x, y and z of the best point, whatever the status
+        double residual;  // the largest |f| there
+        int iterations;   // evaluations of the functions
+        Status status;
+    };
+
+public:
+    XSystemSolver();
+    ~XSystemSolver();
+    void setFunctions(const std::vector<XFunctionParser *> &functions);
+    void setVariables(const std::vector<std::string> &variables);  // the unknowns, among x, y and z
+    void setTimes(int times);                                        // iterations for each lane, 100 by default
+    int getTimes() const;
+    void setTolerance(double valueTolerance, double stepTolerance);  // 1e-10 and 1e-15, the step relative to 1 + |x|
+    void setMaxDistance(double distance);                            // 0, the default, for no limit
+    void setAccuracy(XVectorMath::Accuracy accuracy);                // of the batches, Precise by default
+    // Lane i starts from (x[i], y[i], z[i]), a null array reads as zeros.
+    void solve(const double *x, const double *y, const double *z, Result *results, int count);
+    Result solve(double x = 0.0, double y = 0.0, double z = 0.0);
+
+private:
+    struct Lane
+    {
+        double point[3];
+        double start[3];
+        double trial[3];  // where the functions are evaluated next
+        double cost;      // the sum of f squared at point
+        double lambda;
+        bool started;     // point has been evaluated
+    };
+
+    void prepare();
+    bool computeStep(Lane &lane, const double *values, const double *jacobian, Result &result);
+
+    std::vector<XFunctionParser *> functions;
+    std::vector<XFunctionParser *> derivatives;  // [f * countVariables + v]
+    std::vector<int> slots;                      // of the unknowns
+    int times;
+    double valueTolerance;
+    double stepTolerance;
+    double maxDistance;
+    XVectorMath::Accuracy accuracy;
+};
@@ -0,0 +1,308 @@
+#pragma once
+#include <cmath>
+
+// A value as its Taylor series along one direction, truncated after the term of t ^ order:
+// a(t) = coefficients[0] + coefficients[1] t + ... + coefficients[order] t ^ order. Every operation
+// computes the series of its result from those of its operands by the recurrences of truncated
+// Taylor arithmetic, which is Taylor mode automatic differentiation: one pass gives f and its
+// derivatives up to the order, d^k f = k! coefficients[k], where differentiating k times would build
+// k derivative expressions. A pass costs about order ^ 2 / 2 times an evaluation of f.
+template <int order>
+class XTaylor
+{
+public:
+    XTaylor()
+    {
+    }
+
+    explicit XTaylor(double value)
+    {
+        coefficients[0] = value;
+        for (int k = 1; k <= order; k++)
+        {
+            coefficients[k] = 0.0;
+        }
+    }
+
+    bool isConstant() const
+    {
+        for (int k = 1; k <= order; k++)
+        {
+            if (coefficients[k] != 0.0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    double coefficients[order + 1];
+};
+
+template <int order>
+inline XTaylor<order> operator +(const XTaylor<order> &a, const XTaylor<order> &b)
+{
+    XTaylor<order> ans;
+    for (int k = 0; k <= order; k++)
+    {
+        ans.coefficients[k] = a.coefficients[k] + b.coefficients[k];
+    }
+    return ans;
+}
+
+template <int order>
+inline XTaylor<order> operator -(const XTaylor<order> &a, const XTaylor<order> &b)
+{
+    XTaylor<order> ans;
+    for (int k = 0; k <= order; k++)
+    {
+        ans.coefficients[k] = a.coefficients[k] - b.coefficients[k];
+    }
+    return ans;
+}
+
+// the Cauchy product
+template <int order>
+inline XTaylor<order> operator *(const XTaylor<order> &a, const XTaylor<order> &b)
+{
+    XTaylor<order> ans;
+    for (int k = 0; k <= order; k++)
+    {
+        double sum = 0.0;
+        for (int j = 0; j <= k; j++)
+        {
+            sum += a.coefficients[j] * b.coefficients[k - j];
+        }
+        ans.coefficients[k] = sum;
+    }
+    return ans;
+}
+
+// c = a / b from a = b c, solved term by term
+template <int order>
+inline XTaylor<order> operator /(const XTaylor<order> &a, const XTaylor<order> &b)
+{
+    XTaylor<order> ans;
+    for (int k = 0; k <= order; k++)
+    {
+        double sum = a.coefficients[k];
+        for (int j = 1; j <= k; j++)
+        {
+            sum -= b.coefficients[j] * ans.coefficients[k - j];
+        }
+        ans.coefficients[k] = sum / b.coefficients[0];
+    }
+    return ans;
+}
+
+template <int order>
+inline XTaylor<order> operator -(const XTaylor<order> &a)
+{
+    XTaylor<order> ans;
+    for (int k = 0; k <= order; k++)
+    {
+        ans.coefficients[k] = -a.coefficients[k];
+    }
+    return ans;
+}
+
+template <int order>
+inline XTaylor<order> operator +(const XTaylor<order> &a, double b)
+{
+    XTaylor<order> ans = a;
+    ans.coefficients[0] += b;
+    return ans;
+}
+
+template <int order>
+inline XTaylor<order> operator -(const XTaylor<order> &a, double b)
+{
+    XTaylor<order> ans = a;
+    ans.coefficients[0] -= b;
+    return ans;
+}
+
+template <int order>
+inline XTaylor<order> operator *(const XTaylor<order> &a, double b)
+{
+    XTaylor<order> ans;
+    for (int k = 0; k <= order; k++)
+    {
+        ans.coefficients[k] = a.coefficients[k] * b;
+    }
+    return ans;
+}
+
+template <int order>
+inline XTaylor<order> operator /(const XTaylor<order> &a, double b)
+{
+    XTaylor<order> ans;
+    for (int k = 0; k <= order; k++)
+    {
+        ans.coefficients[k] = a.coefficients[k] / b;
+    }
+    return ans;
+}
+
+template <int order>
+inline XTaylor<order> square(const XTaylor<order> &a)
+{
+    return a * a;
+}
+
+// p = a ^ b from a p' = b a' p, solved term by term, which needs a(0) != 0. At a(0) = 0 a whole
+// power is a product, and otherwise p has no terms below t ^ b and no finite ones above, taking
+// a'(0) != 0.
+template <int order>
+inline XTaylor<order> pow(const XTaylor<order> &a, double b)
+{
+    XTaylor<order> ans;
+    double a0 = a.coefficients[0];
+    ans.coefficients[0] = std::pow(a0, b);
+    if (a0 != 0.0)
+    {
+        for (int k = 1; k <= order; k++)
+        {
+            double sum = 0.0;
+            for (int j = 1; j <= k; j++)
+            {
+                sum += (b * j - (k - j)) * a.coefficients[j] * ans.coefficients[k - j];
+            }
+            ans.coefficients[k] = sum / (k * a0);
+        }
+        return ans;
+    }
+
+    if (b >= 0.0 && b <= 64.0 && b == std::floor(b))
+    {
+        XTaylor<order> base = a;
+        ans = XTaylor<order>(1.0);
+        for (int e = (int)b; e > 0; e >>= 1)
+        {
+            if (e & 1)
+            {
+                ans = ans * base;
+            }
+            base = base * base;
+        }
+        return ans;
+    }
+    double binomial = 1.0;
+    for (int k = 1; k <= order; k++)
+    {
+        binomial *= (b - k + 1) / k;
+        ans.coefficients[k] = binomial * std::pow(a0, b - k) * std::pow(a.coefficients[1], (double)k);
+    }
+    return ans;
+}
+
+// a ^ b with b varying is exp(b ln a); with b constant along the direction the power rule above
+// also holds for a negative base, as with dual numbers.
+template <int order>
+inline XTaylor<order> pow(const XTaylor<order> &a, const XTaylor<order> &b)
+{
+    if (b.isConstant())
+    {
+        return pow(a, b.coefficients[0]);
+    }
+    return exp(b * log(a));
+}
+
+// s' = a' c and c' = -a' s, solved together term by term
+template <int order>
+inline void sinCos(const XTaylor<order> &a, XTaylor<order> &s, XTaylor<order> &c)
+{
+    s.coefficients[0] = std::sin(a.coefficients[0]);
+    c.coefficients[0] = std::cos(a.coefficients[0]);
+    for (int k = 1; k <= order; k++)
+    {
+        double sumS = 0.0;
+        double sumC = 0.0;
+        for (int j = 1; j <= k; j++)
+        {
+            sumS += j * a.coefficients[j] * c.coefficients[k - j];
+            sumC += j * a.coefficients[j] * s.coefficients[k - j];
+        }
+        s.coefficients[k] = sumS / k;
+        c.coefficients[k] = -sumC / k;
+    }
+}
+
+template <int order>
+inline XTaylor<order> sin(const XTaylor<order> &a)
+{
+    XTaylor<order> s;
+    XTaylor<order> c;
+    sinCos(a, s, c);
+    return s;
+}
+
+template <int order>
+inline XTaylor<order> cos(const XTaylor<order> &a)
+{
+    XTaylor<order> s;
+    XTaylor<order> c;
+    sinCos(a, s, c);
+    return c;
+}
+
+// t' = (1 + t ^ 2) a', with the terms of u = 1 + t ^ 2 made as those of t become known
+template <int order>
+inline XTaylor<order> tan(const XTaylor<order> &a)
+{
+    XTaylor<order> t;
+    double u[order + 1];
+    t.coefficients[0] = std::tan(a.coefficients[0]);
+    u[0] = 1.0 + t.coefficients[0] * t.coefficients[0];
+    for (int k = 1; k <= order; k++)
+    {
+        double sum = 0.0;
+        for (int j = 1; j <= k; j++)
+        {
+            sum += j * a.coefficients[j] * u[k - j];
+        }
+        t.coefficients[k] = sum / k;
+        u[k] = 0.0;
+        for (int i = 0; i <= k; i++)
+        {
+            u[k] += t.coefficients[i] * t.coefficients[k - i];
+        }
+    }
+    return t;
+}
+
+// e' = a' e
+template <int order>
+inline XTaylor<order> exp(const XTaylor<order> &a)
+{
+    XTaylor<order> e;
+    e.coefficients[0] = std::exp(a.coefficients[0]);
+    for (int k = 1; k <= order; k++)
+    {
+        double sum = 0.0;
+        for (int j = 1; j <= k; j++)
+        {
+            sum += j * a.coefficients[j] * e.coefficients[k - j];
+        }
+        e.coefficients[k] = sum / k;
+    }
+    return e;
+}
+
+// a l' = a'
+template <int order>
+inline XTaylor<order> log(const XTaylor<order> &a)
+{
+    XTaylor<order> l;
+    l.coefficients[0] = std::log(a.coefficients[0]);
+    for (int k = 1; k <= order; k++)
+    {
+        double sum = 0.0;
+        for (int j = 1; j < k; j++)
+        {
+            sum += j * l.coefficients[j] * a.coefficients[k - j];
+        }
+        l.coefficients[k] = (a.coefficients[k] - sum / k) / a.coefficients[0];
+    }
+    return l;
+}
@@ -1,5 +1,7 @@
 #include "XVariableParseNode.h"
+#include "XBytecode.h"
 #include "XConstantParseNode.h"
+#include "XParseNodeArena.h"
 
 #include <cstdlib>
 #include <iostream>
@@ -8,6 +10,8 @@ using namespace std;
 
 XVariableParseNode::XVariableParseNode()
 {
+    slot = 0;
+    differentiateActive = false;
 }
 
 XVariableParseNode::~XVariableParseNode()
@@ -21,9 +25,15 @@ string XVariableParseNode::getName() const
 
 string XVariableParseNode::getExpression() const
 {
-    string str;
-    str += (char)index;
-    return str;
+    if (!symbol.empty())
+    {
+        return symbol;
+    }
+    if (slot < 3)
+    {
+        return string(1, (char)('x' + slot));
+    }
+    return "s" + to_string(slot);
 }
 
 int XVariableParseNode::getCountChilds() const
@@ -31,18 +41,19 @@ int XVariableParseNode::getCountChilds() const
     return -1;
 }
 
-XAbstractParseNode *XVariableParseNode::clone() const
+XAbstractParseNode *XVariableParseNode::clone(XParseNodeArena &arena) const
 {
-    XVariableParseNode *ans = new XVariableParseNode;
+    XVariableParseNode *ans = arena.create<XVariableParseNode>();
     ans->value = value;
-    ans->index = index;
+    ans->slot = slot;
+    ans->symbol = symbol;
     ans->differentiateActive = differentiateActive;
     return ans;
 }
 
-XAbstractParseNode *XVariableParseNode::getDifferentiate() const
+XAbstractParseNode *XVariableParseNode::getDifferentiate(XParseNodeArena &arena) const
 {
-    XAbstractParseNode *ans = new XConstantParseNode;
+    XAbstractParseNode *ans = arena.create<XConstantParseNode>();
     if (differentiateActive)
     {
         ans->setValue(1.0);
@@ -52,4 +63,9 @@ XAbstractParseNode *XVariableParseNode::getDifferentiate() const
         ans->setValue(0.0);
     }
     return ans;
-}
\ No newline at end of file
+}
+
+void XVariableParseNode::compile(XBytecode &code) const
+{
+    code.emitVariable(slot);
+}
@@ -10,17 +10,29 @@ public:
     virtual std::string getName() const;
     virtual std::string getExpression() const;
     virtual int getCountChilds() const;
-    virtual XAbstractParseNode *clone() const;
-    virtual XAbstractParseNode *getDifferentiate() const;
-    inline char getIndex() const
+    virtual XAbstractParseNode *clone(XParseNodeArena &arena) const;
+    virtual XAbstractParseNode *getDifferentiate(XParseNodeArena &arena) const;
+    virtual void compile(XBytecode &code) const;
+    inline int getSlot() const
     {
-        return index;
+        return slot;
+    }
+    inline const std::string &getSymbol() const
+    {
+        return symbol;
+    }
+    // getDifferentiate gives 1 for an active variable and 0 for any other
+    inline void setDifferentiateActive(bool active)
+    {
+        differentiateActive = active;
     }
 
 protected:
-    char index;
+    int slot;            // of the argument the variable reads
+    std::string symbol;  // its name in the source
     bool differentiateActive;
 
     friend class XFunctionParser;
+    friend class XExpressionGraph;
 };
 
@@ -0,0 +1,144 @@
+#include "XVectorMathKernels.h"
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#endif
+
+// AVX2 needs the processor to have it and the system to save the upper halves of the registers.
+static bool hasAvx2()
+{
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        return false;
+    }
+    __cpuid(info, 1);
+    bool avx = (info[2] & (1 << 28)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!avx || !osxsave || (_xgetbv(0) & 6) != 6)
+    {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#else
+    return false;
+#endif
+}
+
+const XVectorMathKernels &getBaselineKernels()
+{
+    static const XVectorMathKernels kernels = Kernels::make();
+    return kernels;
+}
+
+static const XVectorMathKernels &getKernels()
+{
+    static const XVectorMathKernels *avx2 = hasAvx2() ? getAvx2Kernels() : nullptr;
+    return avx2 != nullptr ? *avx2 : getBaselineKernels();
+}
+
+const char *XVectorMath::getInstructionSet()
+{
+    return getKernels().instructionSet;
+}
+
+int XVectorMath::getCountLanes()
+{
+    return getKernels().countLanes;
+}
+
+void XVectorMath::add(const double *a, const double *b, double *out, int count)
+{
+    getKernels().add(a, b, out, count);
+}
+
+void XVectorMath::subtract(const double *a, const double *b, double *out, int count)
+{
+    getKernels().subtract(a, b, out, count);
+}
+
+void XVectorMath::multiply(const double *a, const double *b, double *out, int count)
+{
+    getKernels().multiply(a, b, out, count);
+}
+
+void XVectorMath::divide(const double *a, const double *b, double *out, int count)
+{
+    getKernels().divide(a, b, out, count);
+}
+
+void XVectorMath::power(const double *a, const double *b, double *out, int count, Accuracy accuracy)
+{
+    getKernels().power(a, b, out, count, accuracy);
+}
+
+void XVectorMath::addConstant(const double *a, double b, double *out, int count)
+{
+    getKernels().addConstant(a, b, out, count);
+}
+
+void XVectorMath::subtractConstant(const double *a, double b, double *out, int count)
+{
+    getKernels().subtractConstant(a, b, out, count);
+}
+
+void XVectorMath::multiplyConstant(const double *a, double b, double *out, int count)
+{
+    getKernels().multiplyConstant(a, b, out, count);
+}
+
+void XVectorMath::divideConstant(const double *a, double b, double *out, int count)
+{
+    getKernels().divideConstant(a, b, out, count);
+}
+
+void XVectorMath::powerConstant(const double *a, double b, double *out, int count, Accuracy accuracy)
+{
+    getKernels().powerConstant(a, b, out, count, accuracy);
+}
+
+void XVectorMath::square(const double *a, double *out, int count)
+{
+    getKernels().square(a, out, count);
+}
+
+void XVectorMath::negate(const double *a, double *out, int count)
+{
+    getKernels().negate(a, out, count);
+}
+
+void XVectorMath::fill(double value, double *out, int count)
+{
+    getKernels().fill(value, out, count);
+}
+
+void XVectorMath::sin(const double *a, double *out, int count, Accuracy accuracy)
+{
+    getKernels().sin(a, out, count, accuracy);
+}
+
+void XVectorMath::cos(const double *a, double *out, int count, Accuracy accuracy)
+{
+    getKernels().cos(a, out, count, accuracy);
+}
+
+void XVectorMath::tan(const double *a, double *out, int count, Accuracy accuracy)
+{
+    getKernels().tan(a, out, count, accuracy);
+}
+
+void XVectorMath::exp(const double *a, double *out, int count, Accuracy accuracy)
+{
+    getKernels().exp(a, out, count, accuracy);
+}
+
+void XVectorMath::ln(const double *a, double *out, int count, Accuracy accuracy)
+{
+    getKernels().ln(a, out, count, accuracy);
+}
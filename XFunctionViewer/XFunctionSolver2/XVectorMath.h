@@ -0,0 +1,43 @@
+#pragma once
+
+// Element wise kernels over arrays of doubles, written once over a pack of lanes (see
+// XVectorMathKernels.h) and compiled for AVX2 (4 lanes) and for SSE2 (2 lanes), or plain doubles
+// where SSE2 does not exist or XVECTORMATH_NO_SIMD is defined. The AVX2 ones are used when the
+// processor has AVX2, which is checked once at run time.
+// The arrays need no alignment and out may be the same array as an input.
+class XVectorMath
+{
+public:
+    // How sin, cos, tan, exp, ln and non integer powers are computed.
+    enum Accuracy
+    {
+        Exact,      // the C library, one element at a time
+        Precise,    // polynomials in the lanes, within a few ulp; exp flushes subnormal results to 0
+                    // and sin, cos, tan leave |x| > 1e5 to the C library
+        Fast,       // shorter polynomials, relative error below about 1e-7, enough for pixels
+                    // pow(a, b) is exp(b ln a) in both, its error is max(1, |b ln a|) times the above
+    };
+
+public:
+    static const char *getInstructionSet();
+    static int getCountLanes();
+
+    static void add(const double *a, const double *b, double *out, int count);
+    static void subtract(const double *a, const double *b, double *out, int count);
+    static void multiply(const double *a, const double *b, double *out, int count);
+    static void divide(const double *a, const double *b, double *out, int count);
+    static void power(const double *a, const double *b, double *out, int count, Accuracy accuracy);
+    static void addConstant(const double *a, double b, double *out, int count);
+    static void subtractConstant(const double *a, double b, double *out, int count);
+    static void multiplyConstant(const double *a, double b, double *out, int count);
+    static void divideConstant(const double *a, double b, double *out, int count);
+    static void powerConstant(const double *a, double b, double *out, int count, Accuracy accuracy);
+    static void square(const double *a, double *out, int count);
+    static void negate(const double *a, double *out, int count);
+    static void fill(double value, double *out, int count);
+    static void sin(const double *a, double *out, int count, Accuracy accuracy);
+    static void cos(const double *a, double *out, int count, Accuracy accuracy);
+    static void tan(const double *a, double *out, int count, Accuracy accuracy);
+    static void exp(const double *a, double *out, int count, Accuracy accuracy);
+    static void ln(const double *a, double *out, int count, Accuracy accuracy);
+};
@@ -0,0 +1,31 @@
+// The kernels of XVectorMath once more with AVX2 packs. The project compiles this file alone with
+// /arch:AVX2, GCC is asked for AVX2 here, and XVectorMath only calls into it on processors that have
+// it. The standard headers come first so that their inline functions are not compiled for AVX2.
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#if !defined(XVECTORMATH_NO_SIMD) && defined(__GNUC__) && !defined(__clang__) && !defined(__AVX2__) \
+    && (defined(__x86_64__) || defined(__i386__))
+#pragma GCC target("avx2")
+#define XVECTORMATH_AVX2
+#elif !defined(XVECTORMATH_NO_SIMD) && defined(__AVX2__)
+#define XVECTORMATH_AVX2
+#endif
+
+#if defined(XVECTORMATH_AVX2)
+#include "XVectorMathKernels.h"
+
+const XVectorMathKernels *getAvx2Kernels()
+{
+    static const XVectorMathKernels kernels = Kernels::make();
+    return &kernels;
+}
+#else
+#include "XVectorMathDispatch.h"
+
+const XVectorMathKernels *getAvx2Kernels()
+{
+    return nullptr;
+}
+#endif
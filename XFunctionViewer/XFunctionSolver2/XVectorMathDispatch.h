@@ -0,0 +1,36 @@
+#pragma once
+#include "XVectorMath.h"
+
+// The kernels of XVectorMath compiled for one instruction set. XVectorMath picks the widest set the
+// processor has when first used and calls through its table from then on.
+struct XVectorMathKernels
+{
+    typedef XVectorMath::Accuracy Accuracy;
+
+    const char *instructionSet;
+    int countLanes;
+    void (*add)(const double *a, const double *b, double *out, int count);
+    void (*subtract)(const double *a, const double *b, double *out, int count);
+    void (*multiply)(const double *a, const double *b, double *out, int count);
+    void (*divide)(const double *a, const double *b, double *out, int count);
+    void (*power)(const double *a, const double *b, double *out, int count, Accuracy accuracy);
+    void (*addConstant)(const double *a, double b, double *out, int count);
+    void (*subtractConstant)(const double *a, double b, double *out, int count);
+    void (*multiplyConstant)(const double *a, double b, double *out, int count);
+    void (*divideConstant)(const double *a, double b, double *out, int count);
+    void (*powerConstant)(const double *a, double b, double *out, int count, Accuracy accuracy);
+    void (*square)(const double *a, double *out, int count);
+    void (*negate)(const double *a, double *out, int count);
+    void (*fill)(double value, double *out, int count);
+    void (*sin)(const double *a, double *out, int count, Accuracy accuracy);
+    void (*cos)(const double *a, double *out, int count, Accuracy accuracy);
+    void (*tan)(const double *a, double *out, int count, Accuracy accuracy);
+    void (*exp)(const double *a, double *out, int count, Accuracy accuracy);
+    void (*ln)(const double *a, double *out, int count, Accuracy accuracy);
+};
+
+// SSE2 where the target has it, plain doubles otherwise (XVectorMath.cpp)
+const XVectorMathKernels &getBaselineKernels();
+// AVX2, nullptr where the compiler cannot target it (XVectorMathAvx2.cpp). Only to be called once
+// the processor is known to have AVX2, the table itself is made by AVX2 code.
+const XVectorMathKernels *getAvx2Kernels();
@@ -0,0 +1,664 @@
+#include "XVectorMathDispatch.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+// The kernels behind XVectorMath. XVectorMath.cpp and XVectorMathAvx2.cpp each include this once and
+// get their own copy, with AVX2 packs where XVECTORMATH_AVX2 is defined before it, with SSE2 packs
+// where the target has them, and with plain doubles otherwise or under XVECTORMATH_NO_SIMD.
+#if defined(XVECTORMATH_AVX2)
+#include <immintrin.h>
+#elif !defined(XVECTORMATH_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define XVECTORMATH_SSE2
+#include <emmintrin.h>
+#endif
+
+// A pack is a few doubles handled at once. Every pack type offers the same operations, so the
+// approximations below are written once and also run on ScalarPack for the tail of an array.
+// A mask is a pack whose lanes are all ones or all zeros, as SIMD compares produce them.
+// Packs are passed by reference, 32 bit MSVC cannot pass aligned types by value.
+namespace
+{
+    typedef unsigned long long Bits;
+
+    inline Bits toBits(double value)
+    {
+        Bits bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    inline double fromBits(Bits bits)
+    {
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    struct ScalarPack
+    {
+        static const int lanes = 1;
+        double v;
+
+        static ScalarPack make(double value) { ScalarPack ans = { value }; return ans; }
+        static ScalarPack load(const double *p) { return make(*p); }
+        static ScalarPack broadcast(double value) { return make(value); }
+        static ScalarPack broadcastBits(Bits bits) { return make(fromBits(bits)); }
+        void store(double *p) const { *p = v; }
+    };
+
+    inline ScalarPack mask(bool condition) { return ScalarPack::broadcastBits(condition ? ~0ull : 0ull); }
+    inline ScalarPack operator +(const ScalarPack &a, const ScalarPack &b) { return ScalarPack::make(a.v + b.v); }
+    inline ScalarPack operator -(const ScalarPack &a, const ScalarPack &b) { return ScalarPack::make(a.v - b.v); }
+    inline ScalarPack operator *(const ScalarPack &a, const ScalarPack &b) { return ScalarPack::make(a.v * b.v); }
+    inline ScalarPack operator /(const ScalarPack &a, const ScalarPack &b) { return ScalarPack::make(a.v / b.v); }
+    inline ScalarPack lessThan(const ScalarPack &a, const ScalarPack &b) { return mask(a.v < b.v); }
+    inline ScalarPack greaterThan(const ScalarPack &a, const ScalarPack &b) { return mask(a.v > b.v); }
+    inline ScalarPack equal(const ScalarPack &a, const ScalarPack &b) { return mask(a.v == b.v); }
+    inline ScalarPack notEqual(const ScalarPack &a, const ScalarPack &b) { return mask(a.v != b.v); }
+    inline ScalarPack minimum(const ScalarPack &a, const ScalarPack &b) { return a.v < b.v ? a : b; }
+    inline ScalarPack maximum(const ScalarPack &a, const ScalarPack &b) { return a.v > b.v ? a : b; }
+    inline ScalarPack bitAnd(const ScalarPack &a, const ScalarPack &b) { return ScalarPack::broadcastBits(toBits(a.v) & toBits(b.v)); }
+    inline ScalarPack bitOr(const ScalarPack &a, const ScalarPack &b) { return ScalarPack::broadcastBits(toBits(a.v) | toBits(b.v)); }
+    inline ScalarPack addBits(const ScalarPack &a, const ScalarPack &b) { return ScalarPack::broadcastBits(toBits(a.v) + toBits(b.v)); }
+    inline ScalarPack subtractBits(const ScalarPack &a, const ScalarPack &b) { return ScalarPack::broadcastBits(toBits(a.v) - toBits(b.v)); }
+    template <int count> inline ScalarPack shiftLeftBits(const ScalarPack &a) { return ScalarPack::broadcastBits(toBits(a.v) << count); }
+    template <int count> inline ScalarPack shiftRightBits(const ScalarPack &a) { return ScalarPack::broadcastBits(toBits(a.v) >> count); }
+
+    inline ScalarPack select(const ScalarPack &condition, const ScalarPack &a, const ScalarPack &b)
+    {
+        Bits bits = toBits(condition.v);
+        return ScalarPack::broadcastBits((bits & toBits(a.v)) | (~bits & toBits(b.v)));
+    }
+
+#if defined(XVECTORMATH_AVX2)
+    struct AvxPack
+    {
+        static const int lanes = 4;
+        __m256d v;
+
+        static AvxPack make(__m256d value) { AvxPack ans; ans.v = value; return ans; }
+        static AvxPack load(const double *p) { return make(_mm256_loadu_pd(p)); }
+        static AvxPack broadcast(double value) { return make(_mm256_set1_pd(value)); }
+        static AvxPack broadcastBits(Bits bits) { return make(_mm256_set1_pd(fromBits(bits))); }
+        void store(double *p) const { _mm256_storeu_pd(p, v); }
+    };
+
+    inline AvxPack operator +(const AvxPack &a, const AvxPack &b) { return AvxPack::make(_mm256_add_pd(a.v, b.v)); }
+    inline AvxPack operator -(const AvxPack &a, const AvxPack &b) { return AvxPack::make(_mm256_sub_pd(a.v, b.v)); }
+    inline AvxPack operator *(const AvxPack &a, const AvxPack &b) { return AvxPack::make(_mm256_mul_pd(a.v, b.v)); }
+    inline AvxPack operator /(const AvxPack &a, const AvxPack &b) { return AvxPack::make(_mm256_div_pd(a.v, b.v)); }
+    inline AvxPack lessThan(const AvxPack &a, const AvxPack &b) { return AvxPack::make(_mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ)); }
+    inline AvxPack greaterThan(const AvxPack &a, const AvxPack &b) { return AvxPack::make(_mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ)); }
+    inline AvxPack equal(const AvxPack &a, const AvxPack &b) { return AvxPack::make(_mm256_cmp_pd(a.v, b.v, _CMP_EQ_OQ)); }
+    inline AvxPack notEqual(const AvxPack &a, const AvxPack &b) { return AvxPack::make(_mm256_cmp_pd(a.v, b.v, _CMP_NEQ_UQ)); }
+    inline AvxPack minimum(const AvxPack &a, const AvxPack &b) { return AvxPack::make(_mm256_min_pd(a.v, b.v)); }
+    inline AvxPack maximum(const AvxPack &a, const AvxPack &b) { return AvxPack::make(_mm256_max_pd(a.v, b.v)); }
+    inline AvxPack bitAnd(const AvxPack &a, const AvxPack &b) { return AvxPack::make(_mm256_and_pd(a.v, b.v)); }
+    inline AvxPack bitOr(const AvxPack &a, const AvxPack &b) { return AvxPack::make(_mm256_or_pd(a.v, b.v)); }
+    inline AvxPack select(const AvxPack &condition, const AvxPack &a, const AvxPack &b) { return AvxPack::make(_mm256_blendv_pd(b.v, a.v, condition.v)); }
+
+    inline AvxPack addBits(const AvxPack &a, const AvxPack &b)
+    {
+        return AvxPack::make(_mm256_castsi256_pd(_mm256_add_epi64(_mm256_castpd_si256(a.v), _mm256_castpd_si256(b.v))));
+    }
+
+    inline AvxPack subtractBits(const AvxPack &a, const AvxPack &b)
+    {
+        return AvxPack::make(_mm256_castsi256_pd(_mm256_sub_epi64(_mm256_castpd_si256(a.v), _mm256_castpd_si256(b.v))));
+    }
+
+    template <int count> inline AvxPack shiftLeftBits(const AvxPack &a)
+    {
+        return AvxPack::make(_mm256_castsi256_pd(_mm256_slli_epi64(_mm256_castpd_si256(a.v), count)));
+    }
+
+    template <int count> inline AvxPack shiftRightBits(const AvxPack &a)
+    {
+        return AvxPack::make(_mm256_castsi256_pd(_mm256_srli_epi64(_mm256_castpd_si256(a.v), count)));
+    }
+
+    typedef AvxPack Pack;
+#elif defined(XVECTORMATH_SSE2)
+    struct SsePack
+    {
+        static const int lanes = 2;
+        __m128d v;
+
+        static SsePack make(__m128d value) { SsePack ans; ans.v = value; return ans; }
+        static SsePack load(const double *p) { return make(_mm_loadu_pd(p)); }
+        static SsePack broadcast(double value) { return make(_mm_set1_pd(value)); }
+        static SsePack broadcastBits(Bits bits) { return make(_mm_set1_pd(fromBits(bits))); }
+        void store(double *p) const { _mm_storeu_pd(p, v); }
+    };
+
+    inline SsePack operator +(const SsePack &a, const SsePack &b) { return SsePack::make(_mm_add_pd(a.v, b.v)); }
+    inline SsePack operator -(const SsePack &a, const SsePack &b) { return SsePack::make(_mm_sub_pd(a.v, b.v)); }
+    inline SsePack operator *(const SsePack &a, const SsePack &b) { return SsePack::make(_mm_mul_pd(a.v, b.v)); }
+    inline SsePack operator /(const SsePack &a, const SsePack &b) { return SsePack::make(_mm_div_pd(a.v, b.v)); }
+    inline SsePack lessThan(const SsePack &a, const SsePack &b) { return SsePack::make(_mm_cmplt_pd(a.v, b.v)); }
+    inline SsePack greaterThan(const SsePack &a, const SsePack &b) { return SsePack::make(_mm_cmpgt_pd(a.v, b.v)); }
+    inline SsePack equal(const SsePack &a, const SsePack &b) { return SsePack::make(_mm_cmpeq_pd(a.v, b.v)); }
+    inline SsePack notEqual(const SsePack &a, const SsePack &b) { return SsePack::make(_mm_cmpneq_pd(a.v, b.v)); }
+    inline SsePack minimum(const SsePack &a, const SsePack &b) { return SsePack::make(_mm_min_pd(a.v, b.v)); }
+    inline SsePack maximum(const SsePack &a, const SsePack &b) { return SsePack::make(_mm_max_pd(a.v, b.v)); }
+    inline SsePack bitAnd(const SsePack &a, const SsePack &b) { return SsePack::make(_mm_and_pd(a.v, b.v)); }
+    inline SsePack bitOr(const SsePack &a, const SsePack &b) { return SsePack::make(_mm_or_pd(a.v, b.v)); }
+
+    inline SsePack select(const SsePack &condition, const SsePack &a, const SsePack &b)
+    {
+        return SsePack::make(_mm_or_pd(_mm_and_pd(condition.v, a.v), _mm_andnot_pd(condition.v, b.v)));
+    }
+
+    inline SsePack addBits(const SsePack &a, const SsePack &b)
+    {
+        return SsePack::make(_mm_castsi128_pd(_mm_add_epi64(_mm_castpd_si128(a.v), _mm_castpd_si128(b.v))));
+    }
+
+    inline SsePack subtractBits(const SsePack &a, const SsePack &b)
+    {
+        return SsePack::make(_mm_castsi128_pd(_mm_sub_epi64(_mm_castpd_si128(a.v), _mm_castpd_si128(b.v))));
+    }
+
+    template <int count> inline SsePack shiftLeftBits(const SsePack &a)
+    {
+        return SsePack::make(_mm_castsi128_pd(_mm_slli_epi64(_mm_castpd_si128(a.v), count)));
+    }
+
+    template <int count> inline SsePack shiftRightBits(const SsePack &a)
+    {
+        return SsePack::make(_mm_castsi128_pd(_mm_srli_epi64(_mm_castpd_si128(a.v), count)));
+    }
+
+    typedef SsePack Pack;
+#else
+    typedef ScalarPack Pack;
+#endif
+
+    // 1.5 * 2^52, adding it rounds to an integer and leaves that integer in the low bits, for |x| < 2^51
+    const double roundingShift = 6755399441055744.0;
+    const Bits roundingShiftBits = 0x4338000000000000ull;
+
+    // Horner's rule over coefficients[0] + coefficients[stride] x + ..., unrolled by the template
+    template <int count, int stride = 1>
+    struct Polynomial
+    {
+        template <typename P>
+        static P evaluate(const P &x, const double *coefficients)
+        {
+            return Polynomial<count - 1, stride>::evaluate(x, coefficients + stride) * x + P::broadcast(coefficients[0]);
+        }
+    };
+
+    template <int stride>
+    struct Polynomial<1, stride>
+    {
+        template <typename P>
+        static P evaluate(const P &, const double *coefficients)
+        {
+            return P::broadcast(coefficients[0]);
+        }
+    };
+
+    // The same polynomial as two chains over x^2, even and odd coefficients, which halves the
+    // latency of the long polynomials; their evaluation is bound by it, not by throughput.
+    template <int count, typename P>
+    inline P evaluatePolynomial(const P &x, const double *coefficients)
+    {
+        P x2 = x * x;
+        return Polynomial<(count + 1) / 2, 2>::evaluate(x2, coefficients) + x * Polynomial<count / 2, 2>::evaluate(x2, coefficients + 1);
+    }
+
+    // 1 / k! for k = 0 ...
+    const double inverseFactorials[] =
+    {
+        1.0, 1.0, 1.0 / 2, 1.0 / 6, 1.0 / 24, 1.0 / 120, 1.0 / 720, 1.0 / 5040, 1.0 / 40320,
+        1.0 / 362880, 1.0 / 3628800, 1.0 / 39916800, 1.0 / 479001600, 1.0 / 6227020800.0,
+    };
+
+    // 2^n for an integer valued n in [-1022, 1023], built in the exponent bits
+    template <typename P>
+    inline P powerOfTwo(const P &n)
+    {
+        P integer = subtractBits(n + P::broadcast(roundingShift), P::broadcastBits(roundingShiftBits));
+        return shiftLeftBits<52>(addBits(integer, P::broadcastBits(1023)));
+    }
+
+    // exp(x) = 2^n e^r with |r| <= ln2 / 2. 2^n is applied in two halves, so that the n = -1022 and
+    // n = 1024 at the ends of the range still have representable factors.
+    template <bool precise, typename P>
+    P approximateExp(const P &x)
+    {
+        const double ln2High = 6.93147180369123816490e-01;
+        const double ln2Low = 1.90821492927058770002e-10;
+        P shifted = x * P::broadcast(1.4426950408889634) + P::broadcast(roundingShift);
+        P n = shifted - P::broadcast(roundingShift);
+        n = minimum(maximum(n, P::broadcast(-1100.0)), P::broadcast(1100.0));
+        P r = (x - n * P::broadcast(ln2High)) - n * P::broadcast(ln2Low);
+        P p = evaluatePolynomial<precise ? 14 : 8>(r, inverseFactorials);
+
+        P half = (n * P::broadcast(0.5) + P::broadcast(roundingShift)) - P::broadcast(roundingShift);
+        P ans = p * powerOfTwo(half) * powerOfTwo(n - half);
+
+        ans = select(greaterThan(x, P::broadcast(709.782712893384)), P::broadcast(std::numeric_limits<double>::infinity()), ans);
+        ans = select(lessThan(x, P::broadcast(-708.3964185322641)), P::broadcast(0.0), ans);
+        return select(notEqual(x, x), x, ans);
+    }
+
+    // ln(x) = e ln2 + ln(m) with m in [sqrt(1/2), sqrt(2)), ln(m) = 2 atanh(s) with s = (m - 1) / (m + 1).
+    template <bool precise, typename P>
+    P approximateLn(const P &x)
+    {
+        static const double atanhCoefficients[] =
+        {
+            1.0, 1.0 / 3, 1.0 / 5, 1.0 / 7, 1.0 / 9, 1.0 / 11, 1.0 / 13, 1.0 / 15, 1.0 / 17, 1.0 / 19,
+        };
+        const double ln2High = 6.93147180369123816490e-01;
+        const double ln2Low = 1.90821492927058770002e-10;
+
+        P tiny = lessThan(x, P::broadcast(std::numeric_limits<double>::min()));
+        P scaled = select(tiny, x * P::broadcast(18014398509481984.0), x); // subnormals times 2^54
+        P biased = bitAnd(shiftRightBits<52>(scaled), P::broadcastBits(0x7FF));
+        P e = bitOr(biased, P::broadcastBits(0x4330000000000000ull)) - P::broadcast(4503599627370496.0 + 1023.0);
+        e = e - select(tiny, P::broadcast(54.0), P::broadcast(0.0));
+        P m = bitOr(bitAnd(scaled, P::broadcastBits(0x000FFFFFFFFFFFFFull)), P::broadcastBits(0x3FF0000000000000ull));
+        P big = greaterThan(m, P::broadcast(1.4142135623730951));
+        m = select(big, m * P::broadcast(0.5), m);
+        e = select(big, e + P::broadcast(1.0), e);
+
+        P s = (m - P::broadcast(1.0)) / (m + P::broadcast(1.0));
+        P lnM = (s + s) * evaluatePolynomial<precise ? 10 : 4>(s * s, atanhCoefficients);
+        P ans = e * P::broadcast(ln2High) + (lnM + e * P::broadcast(ln2Low));
+
+        ans = select(equal(x, P::broadcast(std::numeric_limits<double>::infinity())), x, ans);
+        ans = select(equal(x, P::broadcast(0.0)), P::broadcast(-std::numeric_limits<double>::infinity()), ans);
+        ans = select(lessThan(x, P::broadcast(0.0)), P::broadcast(std::numeric_limits<double>::quiet_NaN()), ans);
+        return select(notEqual(x, x), x, ans);
+    }
+
+    // x = q pi / 2 + r with |r| <= pi / 4, sin(r) and cos(r) by their series, quadrant is q mod 4.
+    // pi / 2 is split in three so that q times the first part is exact for |q| < 2^20.
+    const double largestReducedArgument = 1e5;
+
+    template <bool precise, typename P>
+    void approximateSinCos(const P &x, P &sinR, P &cosR, P &quadrant)
+    {
+        static const double sinCoefficients[] =
+        {
+            1.0, -1.0 / 6, 1.0 / 120, -1.0 / 5040, 1.0 / 362880, -1.0 / 39916800, 1.0 / 6227020800.0, -1.0 / 1307674368000.0,
+        };
+        static const double cosCoefficients[] =
+        {
+            1.0, -1.0 / 2, 1.0 / 24, -1.0 / 720, 1.0 / 40320, -1.0 / 3628800, 1.0 / 479001600,
+            -1.0 / 87178291200.0, 1.0 / 20922789888000.0,
+        };
+
+        P shifted = x * P::broadcast(0.63661977236758134) + P::broadcast(roundingShift);
+        P q = shifted - P::broadcast(roundingShift);
+        P r = x - q * P::broadcast(1.57079632673412561417e+00);
+        r = r - q * P::broadcast(6.07710050630396597660e-11);
+        r = r - q * P::broadcast(2.02226624871116645580e-21);
+        P r2 = r * r;
+        sinR = r * evaluatePolynomial<precise ? 8 : 5>(r2, sinCoefficients);
+        cosR = evaluatePolynomial<precise ? 9 : 6>(r2, cosCoefficients);
+        quadrant = bitOr(bitAnd(shifted, P::broadcastBits(3)), P::broadcastBits(0x4330000000000000ull)) - P::broadcast(4503599627370496.0);
+    }
+
+    template <bool precise, typename P>
+    P approximateSin(const P &x)
+    {
+        P sinR, cosR, quadrant;
+        approximateSinCos<precise>(x, sinR, cosR, quadrant);
+        P odd = bitOr(equal(quadrant, P::broadcast(1.0)), equal(quadrant, P::broadcast(3.0)));
+        P ans = select(odd, cosR, sinR);
+        return select(greaterThan(quadrant, P::broadcast(1.5)), P::broadcast(0.0) - ans, ans);
+    }
+
+    template <bool precise, typename P>
+    P approximateCos(const P &x)
+    {
+        P sinR, cosR, quadrant;
+        approximateSinCos<precise>(x, sinR, cosR, quadrant);
+        P odd = bitOr(equal(quadrant, P::broadcast(1.0)), equal(quadrant, P::broadcast(3.0)));
+        P negative = bitOr(equal(quadrant, P::broadcast(1.0)), equal(quadrant, P::broadcast(2.0)));
+        P ans = select(odd, sinR, cosR);
+        return select(negative, P::broadcast(0.0) - ans, ans);
+    }
+
+    template <bool precise, typename P>
+    P approximateTan(const P &x)
+    {
+        P sinR, cosR, quadrant;
+        approximateSinCos<precise>(x, sinR, cosR, quadrant);
+        P odd = bitOr(equal(quadrant, P::broadcast(1.0)), equal(quadrant, P::broadcast(3.0)));
+        return select(odd, (P::broadcast(0.0) - cosR) / sinR, sinR / cosR);
+    }
+
+    // a ^ n by squaring, n >= 0
+    template <typename P>
+    P integerPower(const P &a, unsigned int n)
+    {
+        P ans = P::broadcast(1.0);
+        P base = a;
+        while (n != 0)
+        {
+            if (n & 1)
+            {
+                ans = ans * base;
+            }
+            base = base * base;
+            n >>= 1;
+        }
+        return ans;
+    }
+
+    template <typename F>
+    void map(const double *a, double *out, int count, F f)
+    {
+        int i = 0;
+        for (; i + Pack::lanes <= count; i += Pack::lanes)
+        {
+            f(Pack::load(a + i)).store(out + i);
+        }
+        for (; i < count; i++)
+        {
+            f(ScalarPack::load(a + i)).store(out + i);
+        }
+    }
+
+    template <typename F>
+    void zip(const double *a, const double *b, double *out, int count, F f)
+    {
+        int i = 0;
+        for (; i + Pack::lanes <= count; i += Pack::lanes)
+        {
+            f(Pack::load(a + i), Pack::load(b + i)).store(out + i);
+        }
+        for (; i < count; i++)
+        {
+            f(ScalarPack::load(a + i), ScalarPack::load(b + i)).store(out + i);
+        }
+    }
+
+    template <typename F>
+    void mapExactly(const double *a, double *out, int count, F f)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            out[i] = f(a[i]);
+        }
+    }
+
+    // The lanes, then the C library for the elements the reduction of sin, cos and tan cannot handle.
+    // Those arguments are copied first because out may overwrite them.
+    template <typename F, typename G>
+    void mapTrigonometric(const double *a, double *out, int count, F f, G library)
+    {
+        const int block = 64;
+        double arguments[block];
+        for (int start = 0; start < count; start += block)
+        {
+            int n = count - start < block ? count - start : block;
+            memcpy(arguments, a + start, n * sizeof(double));
+            map(arguments, out + start, n, f);
+            for (int i = 0; i < n; i++)
+            {
+                if (!(std::fabs(arguments[i]) <= largestReducedArgument))
+                {
+                    out[start + i] = library(arguments[i]);
+                }
+            }
+        }
+    }
+
+    // exp(b ln a) in the lanes, the C library for the elements whose base is not positive
+    template <bool precise>
+    void approximatePower(const double *a, const double *b, double *out, int count)
+    {
+        const int block = 64;
+        double bases[block];
+        double exponents[block];
+        for (int start = 0; start < count; start += block)
+        {
+            int n = count - start < block ? count - start : block;
+            memcpy(bases, a + start, n * sizeof(double));
+            memcpy(exponents, b + start, n * sizeof(double));
+            zip(bases, exponents, out + start, n, [](const auto &x, const auto &y) { return approximateExp<precise>(y * approximateLn<precise>(x)); });
+            for (int i = 0; i < n; i++)
+            {
+                if (!(bases[i] > 0.0))
+                {
+                    out[start + i] = std::pow(bases[i], exponents[i]);
+                }
+            }
+        }
+    }
+
+    // The operations of XVectorMath over Pack, as the file including this compiles it
+    struct Kernels : public XVectorMath
+    {
+        static XVectorMathKernels make();
+
+        static void add(const double *a, const double *b, double *out, int count);
+        static void subtract(const double *a, const double *b, double *out, int count);
+        static void multiply(const double *a, const double *b, double *out, int count);
+        static void divide(const double *a, const double *b, double *out, int count);
+        static void power(const double *a, const double *b, double *out, int count, Accuracy accuracy);
+        static void addConstant(const double *a, double b, double *out, int count);
+        static void subtractConstant(const double *a, double b, double *out, int count);
+        static void multiplyConstant(const double *a, double b, double *out, int count);
+        static void divideConstant(const double *a, double b, double *out, int count);
+        static void powerConstant(const double *a, double b, double *out, int count, Accuracy accuracy);
+        static void square(const double *a, double *out, int count);
+        static void negate(const double *a, double *out, int count);
+        static void fill(double value, double *out, int count);
+        static void sin(const double *a, double *out, int count, Accuracy accuracy);
+        static void cos(const double *a, double *out, int count, Accuracy accuracy);
+        static void tan(const double *a, double *out, int count, Accuracy accuracy);
+        static void exp(const double *a, double *out, int count, Accuracy accuracy);
+        static void ln(const double *a, double *out, int count, Accuracy accuracy);
+    };
+}
+
+
+XVectorMathKernels Kernels::make()
+{
+#if defined(XVECTORMATH_AVX2)
+    const char *instructionSet = "AVX2";
+#elif defined(XVECTORMATH_SSE2)
+    const char *instructionSet = "SSE2";
+#else
+    const char *instructionSet = "scalar";
+#endif
+    XVectorMathKernels kernels =
+    {
+        instructionSet, Pack::lanes, add, subtract, multiply, divide, power, addConstant, subtractConstant,
+        multiplyConstant, divideConstant, powerConstant, square, negate, fill, sin, cos, tan, exp, ln,
+    };
+    return kernels;
+}
+
+void Kernels::add(const double *a, const double *b, double *out, int count)
+{
+    zip(a, b, out, count, [](const auto &x, const auto &y) { return x + y; });
+}
+
+void Kernels::subtract(const double *a, const double *b, double *out, int count)
+{
+    zip(a, b, out, count, [](const auto &x, const auto &y) { return x - y; });
+}
+
+void Kernels::multiply(const double *a, const double *b, double *out, int count)
+{
+    zip(a, b, out, count, [](const auto &x, const auto &y) { return x * y; });
+}
+
+void Kernels::divide(const double *a, const double *b, double *out, int count)
+{
+    zip(a, b, out, count, [](const auto &x, const auto &y) { return x / y; });
+}
+
+void Kernels::power(const double *a, const double *b, double *out, int count, Accuracy accuracy)
+{
+    if (accuracy == Exact)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            out[i] = std::pow(a[i], b[i]);
+        }
+    }
+    else if (accuracy == Precise)
+    {
+        approximatePower<true>(a, b, out, count);
+    }
+    else
+    {
+        approximatePower<false>(a, b, out, count);
+    }
+}
+
+void Kernels::addConstant(const double *a, double b, double *out, int count)
+{
+    map(a, out, count, [b](const auto &x) { return x + std::decay_t<decltype(x)>::broadcast(b); });
+}
+
+void Kernels::subtractConstant(const double *a, double b, double *out, int count)
+{
+    map(a, out, count, [b](const auto &x) { return x - std::decay_t<decltype(x)>::broadcast(b); });
+}
+
+void Kernels::multiplyConstant(const double *a, double b, double *out, int count)
+{
+    map(a, out, count, [b](const auto &x) { return x * std::decay_t<decltype(x)>::broadcast(b); });
+}
+
+void Kernels::divideConstant(const double *a, double b, double *out, int count)
+{
+    map(a, out, count, [b](const auto &x) { return x / std::decay_t<decltype(x)>::broadcast(b); });
+}
+
+// Small integer exponents are multiplied out unless the result must match pow exactly.
+void Kernels::powerConstant(const double *a, double b, double *out, int count, Accuracy accuracy)
+{
+    if (accuracy != Exact && b == std::floor(b) && std::fabs(b) <= 64.0)
+    {
+        unsigned int n = (unsigned int)std::fabs(b);
+        if (b >= 0.0)
+        {
+            map(a, out, count, [n](const auto &x) { return integerPower(x, n); });
+        }
+        else
+        {
+            map(a, out, count, [n](const auto &x) { return std::decay_t<decltype(x)>::broadcast(1.0) / integerPower(x, n); });
+        }
+        return;
+    }
+
+    const int block = 64;
+    double exponents[block];
+    fill(b, exponents, block);
+    for (int start = 0; start < count; start += block)
+    {
+        int n = count - start < block ? count - start : block;
+        power(a + start, exponents, out + start, n, accuracy);
+    }
+}
+
+void Kernels::square(const double *a, double *out, int count)
+{
+    map(a, out, count, [](const auto &x) { return x * x; });
+}
+
+void Kernels::negate(const double *a, double *out, int count)
+{
+    map(a, out, count, [](const auto &x) { return std::decay_t<decltype(x)>::broadcast(0.0) - x; });
+}
+
+void Kernels::fill(double value, double *out, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        out[i] = value;
+    }
+}
+
+void Kernels::sin(const double *a, double *out, int count, Accuracy accuracy)
+{
+    if (accuracy == Exact)
+    {
+        mapExactly(a, out, count, [](double x) { return std::sin(x); });
+    }
+    else if (accuracy == Precise)
+    {
+        mapTrigonometric(a, out, count, [](const auto &x) { return approximateSin<true>(x); }, [](double x) { return std::sin(x); });
+    }
+    else
+    {
+        mapTrigonometric(a, out, count, [](const auto &x) { return approximateSin<false>(x); }, [](double x) { return std::sin(x); });
+    }
+}
+
+void Kernels::cos(const double *a, double *out, int count, Accuracy accuracy)
+{
+    if (accuracy == Exact)
+    {
+        mapExactly(a, out, count, [](double x) { return std::cos(x); });
+    }
+    else if (accuracy == Precise)
+    {
+        mapTrigonometric(a, out, count, [](const auto &x) { return approximateCos<true>(x); }, [](double x) { return std::cos(x); });
+    }
+    else
+    {
+        mapTrigonometric(a, out, count, [](const auto &x) { return approximateCos<false>(x); }, [](double x) { return std::cos(x); });
+    }
+}
+
+void Kernels::tan(const double *a, double *out, int count, Accuracy accuracy)
+{
+    if (accuracy == Exact)
+    {
+        mapExactly(a, out, count, [](double x) { return std::tan(x); });
+    }
+    else if (accuracy == Precise)
+    {
+        mapTrigonometric(a, out, count, [](const auto &x) { return approximateTan<true>(x); }, [](double x) { return std::tan(x); });
+    }
+    else
+    {
+        mapTrigonometric(a, out, count, [](const auto &x) { return approximateTan<false>(x); }, [](double x) { return std::tan(x); });
+    }
+}
+
+void Kernels::exp(const double *a, double *out, int count, Accuracy accuracy)
+{
+    if (accuracy == Exact)
+    {
+        mapExactly(a, out, count, [](double x) { return std::exp(x); });
+    }
+    else if (accuracy == Precise)
+    {
+        map(a, out, count, [](const auto &x) { return approximateExp<true>(x); });
+    }
+    else
+    {
+        map(a, out, count, [](const auto &x) { return approximateExp<false>(x); });
+    }
+}
+
+void Kernels::ln(const double *a, double *out, int count, Accuracy accuracy)
+{
+    if (accuracy == Exact)
+    {
+        mapExactly(a, out, count, [](double x) { return std::log(x); });
+    }
+    else if (accuracy == Precise)
+    {
+        map(a, out, count, [](const auto &x) { return approximateLn<true>(x); });
+    }
+    else
+    {
+        map(a, out, count, [](const auto &x) { return approximateLn<false>(x); });
+    }
+}
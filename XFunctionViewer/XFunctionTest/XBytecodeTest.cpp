@@ -0,0 +1,169 @@
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "../XFunctionSolver2/XFunctionParser.h"
+#include "XTests.h"
+
+using namespace std;
+
+static const char *sources[] =
+{
+    "exp(sin(x) + cos(y)) - sin(exp(x + y))",
+    "sin(x ^ 2 + y ^ 2) - cos(x * y)",
+    "x / sin(x) + y / sin(y) - x * y / sin(x * y)",
+    "sin(sin(x) + cos(y)) - cos(sin(x * y) + cos(x))",
+    "2 * x + 3 * 4 - y ^ 2 + ln(2) * z",
+    "~x + (1 + 2) * (3 - ~4) ^ 2",
+    "x ^ y + 2 ^ x - tan(3) / x",
+    "exp(ln(2)) * x - y / 0.5",
+    "ln(x ^ 2 + 1) * z - 3 / (y + 2 * z)",
+};
+
+// the same double, or both not a number, or within a few roundings of each other
+static bool isClose(double a, double b)
+{
+    return a == b || (std::isnan(a) && std::isnan(b)) || fabs(a - b) <= 1e-12 * fabs(b);
+}
+
+static bool isIdentical(double a, double b)
+{
+    return memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+// the compiled program of the expression and of its derivatives against walking its parse tree
+static bool testTree(const char *source)
+{
+    mt19937 random(36);
+    uniform_real_distribution<double> uniform(-3.0, 3.0);
+    XFunctionParser parser;
+    parser.setSource(source);
+    bool ans = true;
+    for (int i = 0; i < 2000 && ans; i++)
+    {
+        double x = uniform(random), y = uniform(random), z = uniform(random);
+        parser.setCompiled(true);
+        double compiled = parser.getFunction(x, y, z);
+        parser.setCompiled(false);
+        ans &= check(isClose(compiled, parser.getFunction(x, y, z)), source);
+    }
+
+    const char *variables[] = { "x", "y", "z" };
+    for (int v = 0; v < 3; v++)
+    {
+        unique_ptr<XFunctionParser> derivative(parser.getDifferentiate(variables[v]));
+        for (int i = 0; i < 500 && ans; i++)
+        {
+            double x = uniform(random), y = uniform(random), z = uniform(random);
+            derivative->setCompiled(true);
+            double compiled = derivative->getFunction(x, y, z);
+            derivative->setCompiled(false);
+            ans &= check(isClose(compiled, derivative->getFunction(x, y, z)), source);
+        }
+    }
+
+    return ans;
+}
+
+static bool testListing(const char *source, const char *listing)
+{
+    XFunctionParser parser;
+    parser.setSource(source);
+    return check(parser.getBytecode().getListing() == listing, source);
+}
+
+// subtrees without variables fold into one constant, constant operands go inline, and a constant left
+// operand of + and * is swapped behind its variable
+static bool testFolding()
+{
+    bool ans = true;
+    ans &= testListing("sin(1) + ln(2) * 3 - 2 ^ 3", "const -5.07909\n");
+    ans &= testListing("~4 + x", "var x\naddc -4\n");
+    ans &= testListing("2 * 3 + x", "var x\naddc 6\n");
+    ans &= testListing("2 * x", "var x\nmulc 2\n");
+    ans &= testListing("x * 2", "var x\nmulc 2\n");
+    ans &= testListing("2 - x", "const 2\nvar x\nsub\n");
+    ans &= testListing("2 / x", "const 2\nvar x\ndiv\n");
+    ans &= testListing("2 ^ x", "const 2\nvar x\npow\n");
+    ans &= testListing("x - (1 + 2)", "var x\nsubc 3\n");
+    ans &= testListing("x ^ 2", "var x\nsqr\n");
+    ans &= testListing("x ^ (1 + 2)", "var x\npowc 3\n");
+    ans &= testListing("3 * sin(x)", "const 3\nvar x\nsin\nmul\n");
+
+    XFunctionParser parser;
+    parser.setSource("2 * 3 + x");
+    ans &= check(parser.getBytecode().getCountInstructions() == 2 && parser.getFunction(1.5) == 7.5,
+        "a folded sum adds the product of its constants");
+    parser.setSource("2 ^ x * 3");
+    ans &= check(parser.getFunction(3.0) == 24.0, "a constant operand taken inline keeps its side");
+    return ans;
+}
+
+// evaluateBatch in Exact mode runs the same operations as evaluate, point by point, so their results
+// are the same bits, also when the results are written over a column being read
+static bool testBatch(const char *source)
+{
+    const int count = 1003;  // not a multiple of any vector width
+    mt19937 random(37);
+    uniform_real_distribution<double> uniform(-4.0, 4.0);
+    XFunctionParser parser;
+    parser.setSource(source);
+    const XBytecode &code = parser.getBytecode();
+
+    vector<double> x(count), y(count), z(count), results(count);
+    for (int i = 0; i < count; i++)
+    {
+        x[i] = uniform(random);
+        y[i] = uniform(random);
+        z[i] = uniform(random);
+    }
+
+    vector<double> expected(count);
+    for (int i = 0; i < count; i++)
+    {
+        double arguments[3] = { x[i], y[i], z[i] };
+        expected[i] = code.evaluate(arguments);
+    }
+
+    const double *columns[3] = { x.data(), y.data(), z.data() };
+    code.evaluateBatch(columns, 3, results.data(), count, XVectorMath::Exact);
+    bool ans = true;
+    for (int i = 0; i < count && ans; i++)
+    {
+        ans &= check(isIdentical(results[i], expected[i]), source);
+    }
+
+    // results over x, then over z
+    vector<double> aliased(x);
+    const double *aliasedColumns[3] = { aliased.data(), y.data(), z.data() };
+    code.evaluateBatch(aliasedColumns, 3, aliased.data(), count, XVectorMath::Exact);
+    for (int i = 0; i < count && ans; i++)
+    {
+        ans &= check(isIdentical(aliased[i], expected[i]), "evaluateBatch with the results over the column of x");
+    }
+
+    aliased = z;
+    const double *lastColumns[3] = { x.data(), y.data(), aliased.data() };
+    code.evaluateBatch(lastColumns, 3, aliased.data(), count, XVectorMath::Exact);
+    for (int i = 0; i < count && ans; i++)
+    {
+        ans &= check(isIdentical(aliased[i], expected[i]), "evaluateBatch with the results over the column of z");
+    }
+
+    return ans;
+}
+
+bool testBytecode()
+{
+    bool ans = true;
+    for (int i = 0; i < (int)(sizeof(sources) / sizeof(sources[0])); i++)
+    {
+        ans &= testTree(sources[i]);
+        ans &= testBatch(sources[i]);
+    }
+
+    ans &= testFolding();
+    return ans;
+}
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include "../XFunctionSolver2/XDual.h"
+#include "../XFunctionSolver2/XFunctionParser.h"
+#include "XTests.h"
+
+using namespace std;
+
+static const char *sources[] =
+{
+    "exp(sin(x) + cos(y)) - sin(exp(x + y))",
+    "sin(x ^ 2 + y ^ 2) - cos(x * y)",
+    "x / sin(x) + y / sin(y) - x * y / sin(x * y)",
+    "2 * x + 3 * 4 - y ^ 2 + ln(2) * z",
+    "~x + (1 + 2) * (3 - ~4) ^ 2",
+    "x ^ y + 2 ^ x - tan(3) / x",
+    "x ^ 3 - y ^ ~2 + x ^ 0.5 + z ^ x",
+    "tan(x * y) / ln(x ^ 2 + 1) * exp(z)",
+    "(x ^ 2) ^ 3 + x * x",
+    "7",
+};
+
+static bool isClose(double a, double b, double tolerance)
+{
+    return fabs(a - b) <= tolerance * max(1.0, fabs(b));
+}
+
+static double square(double a)
+{
+    return a * a;
+}
+
+// every operation of XDual, written once for doubles and dual numbers
+template <class Value>
+static Value function(const Value &x, const Value &y)
+{
+    return exp(sin(x) * y) / (x * x + 1.0) - cos(y) * log(x + 2.0) + tan(y * 0.5) - pow(x + 3.0, y)
+        + pow(x + 1.5, 2.5) + square(y - 0.25) / 3.0 - -x;
+}
+
+// XDual against central differences of the same function on doubles
+static bool testDualNumbers()
+{
+    mt19937 random(39);
+    uniform_real_distribution<double> uniform(-1.0, 1.0);
+    bool ans = true;
+    for (int i = 0; i < 1000 && ans; i++)
+    {
+        double x = uniform(random), y = uniform(random);
+        XDual<2> dualX(x), dualY(y);
+        dualX.derivatives[0] = 1.0;
+        dualY.derivatives[1] = 1.0;
+        XDual<2> f = function(dualX, dualY);
+
+        double h = 1e-6;
+        double dx = (function(x + h, y) - function(x - h, y)) / (2 * h);
+        double dy = (function(x, y + h) - function(x, y - h)) / (2 * h);
+        ans &= check(f.value == function(x, y), "XDual computes the value as doubles do");
+        ans &= check(isClose(f.derivatives[0], dx, 1e-6) && isClose(f.derivatives[1], dy, 1e-6),
+            "the derivatives of XDual against central differences");
+    }
+
+    // a negative base with an integer exponent has a derivative, though ln of the base does not exist
+    XDual<1> base(-2.0);
+    base.derivatives[0] = 1.0;
+    XDual<1> cube = pow(base, 3.0);
+    ans &= check(cube.value == -8.0 && cube.derivatives[0] == 12.0, "the derivative of x ^ 3 at -2");
+    return ans;
+}
+
+// The dual numbers of the bytecode against the derivative expressions of getDifferentiate. Both
+// compute the same function by different operations, so they agree to a few roundings.
+static bool testBytecode(const char *source)
+{
+    mt19937 random(40);
+    uniform_real_distribution<double> uniform(0.2, 2.5);
+    XFunctionParser parser;
+    parser.setSource(source);
+    unique_ptr<XFunctionParser> derivatives[3];
+    const char *variables[] = { "x", "y", "z" };
+    for (int k = 0; k < 3; k++)
+    {
+        derivatives[k].reset(parser.getDifferentiate(variables[k]));
+    }
+
+    bool ans = true;
+    for (int i = 0; i < 500 && ans; i++)
+    {
+        double x = uniform(random), y = uniform(random), z = uniform(random);
+        double f = parser.getFunction(x, y, z);
+        double gradient[3];
+        ans &= check(parser.getFunctionAndGradient(gradient, x, y, z) == f, source);
+        for (int k = 0; k < 3; k++)
+        {
+            double derivative;
+            ans &= check(parser.getFunctionAndDerivative(variables[k], derivative, x, y, z) == f, source);
+            ans &= check(derivative == gradient[k], source);
+            ans &= check(isClose(derivative, derivatives[k]->getFunction(x, y, z), 1e-10), source);
+        }
+    }
+
+    return ans;
+}
+
+bool testDual()
+{
+    bool ans = testDualNumbers();
+    for (int i = 0; i < (int)(sizeof(sources) / sizeof(sources[0])); i++)
+    {
+        ans &= testBytecode(sources[i]);
+    }
+
+    XFunctionParser parser;
+    parser.setSource("x ^ 3");
+    double derivative;
+    parser.getFunctionAndDerivative("x", derivative, -2.0);
+    return ans && check(derivative == 12.0, "the bytecode derivative of x ^ 3 at -2");
+}
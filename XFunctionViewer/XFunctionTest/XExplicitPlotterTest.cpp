@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "../XFunctionSolver2/XExplicitPlotter.h"
+#include "XTests.h"
+
+using namespace std;
+
+typedef XExplicitPlotter::Polyline Polyline;
+
+static const int width = 900;
+static const int height = 600;
+static const double left = -20.0;
+static const double right = 20.0;
+static const double bottom = -10.0;
+static const double top = 10.0;
+static const double scaleX = width / (right - left);
+static const double scaleY = height / (top - bottom);
+
+// from (px, py) to the segment from (ax, ay) to (bx, by), all in pixels
+static double getSegmentDistance(double px, double py, double ax, double ay, double bx, double by)
+{
+    double dx = bx - ax;
+    double dy = by - ay;
+    double length = dx * dx + dy * dy;
+    double t = length > 0.0 ? max(0.0, min(1.0, ((px - ax) * dx + (py - ay) * dy) / length)) : 0.0;
+    return hypot(px - ax - t * dx, py - ay - t * dy);
+}
+
+// The distance in pixels from (x, y) to the graph of f, measured against the graph sampled every
+// 1 / 128 of a pixel within two pixels of x, which is near enough the graph for curves as steep as
+// 60 pixels a pixel.
+static double getDistance(XFunctionParser &parser, double x, double y)
+{
+    const int count = 512;
+    double radius = 2.0 / scaleX;
+    double distance = HUGE_VAL;
+    double previousX = 0.0;
+    double previousY = 0.0;
+    for (int k = 0; k <= count; k++)
+    {
+        double curveX = x - radius + 2.0 * radius * k / count;
+        double pointX = curveX * scaleX;
+        double pointY = parser.getFunction(curveX) * scaleY;
+        if (k > 0)
+        {
+            distance = min(distance, getSegmentDistance(x * scaleX, y * scaleY, previousX, previousY, pointX, pointY));
+        }
+        previousX = pointX;
+        previousY = pointY;
+    }
+
+    return distance;
+}
+
+// Points a quarter, half and three quarters along every segment in the area lie within maxDistance
+// pixels of the graph; the number of points of the polylines goes to count.
+static bool testDistance(const char *source, double tolerance, double maxDistance, int &count)
+{
+    XFunctionParser parser;
+    parser.setSource(source);
+    XExplicitPlotter plotter;
+    plotter.setFunction(&parser);
+    plotter.setArea(left, bottom, right, top);
+    plotter.setResolution(width, height);
+    plotter.setTolerance(tolerance);
+    plotter.extract();
+
+    const vector<Polyline> &polylines = plotter.getPolylines();
+    bool ans = check(!polylines.empty(), source);
+    count = 0;
+    for (int i = 0; i < (int)polylines.size() && ans; i++)
+    {
+        const Polyline &polyline = polylines[i];
+        count += (int)polyline.size();
+        for (int j = 0; j + 1 < (int)polyline.size() && ans; j++)
+        {
+            for (int k = 1; k < 4 && ans; k++)
+            {
+                double x = polyline[j].x + (polyline[j + 1].x - polyline[j].x) * k / 4.0;
+                double y = polyline[j].y + (polyline[j + 1].y - polyline[j].y) * k / 4.0;
+                if (fabs(y) <= top)
+                {
+                    ans &= check(getDistance(parser, x, y) <= maxDistance, source);
+                }
+            }
+        }
+    }
+
+    return ans;
+}
+
+// Every polyline of f stays on one side of each of its poles, and there are as many polylines as
+// pieces of the graph in the area.
+static bool testPoles(const char *source, const vector<double> &poles)
+{
+    XFunctionParser parser;
+    parser.setSource(source);
+    XExplicitPlotter plotter;
+    plotter.setFunction(&parser);
+    plotter.setArea(left, bottom, right, top);
+    plotter.setResolution(width, height);
+    plotter.extract();
+
+    const vector<Polyline> &polylines = plotter.getPolylines();
+    bool ans = check(polylines.size() == poles.size() + 1, source);
+    for (int i = 0; i < (int)polylines.size() && ans; i++)
+    {
+        for (int j = 0; j < (int)poles.size(); j++)
+        {
+            ans &= check((polylines[i].front().x < poles[j]) == (polylines[i].back().x < poles[j]),
+                "no polyline crosses a pole");
+        }
+    }
+
+    return ans;
+}
+
+bool testExplicitPlotter()
+{
+    // The midpoint of every gap is within tolerance of its chord, and the thinning keeps every point
+    // within tolerance of the polyline; the points in between may be a little further.
+    const char *sources[] = { "sin(x)", "x ^ 2 / 10", "sin(x * x)", "exp(x / 4)", "x ^ 3 / 100 - x", "tan(x)", "1 / x", "ln(x)" };
+    const double tolerances[] = { 0.1, 0.5, 1.0 };
+    bool ans = true;
+    for (int i = 0; i < (int)(sizeof(sources) / sizeof(sources[0])); i++)
+    {
+        int counts[3];
+        for (int t = 0; t < 3; t++)
+        {
+            ans &= testDistance(sources[i], tolerances[t], 1.3 * tolerances[t], counts[t]);
+        }
+        ans &= check(counts[0] > counts[1] && counts[1] >= counts[2], "a larger tolerance takes fewer points");
+    }
+
+    // A period of under 3 pixels, which the first samples, 8 pixels apart, cannot see and the range of
+    // f over their gaps does. The curve is as sharp as it gets within a pixel, so the bound is looser.
+    int count;
+    ans &= testDistance("sin(50 * x)", 0.5, 0.8, count);
+
+    const double pi = acos(-1.0);
+    vector<double> poles;
+    for (int k = -6; k < 6; k++)
+    {
+        poles.push_back(pi / 2.0 + k * pi);
+    }
+    ans &= testPoles("tan(x)", poles);
+    ans &= testPoles("1 / x", vector<double>(1, 0.0));
+    poles.assign(1, -2.0);
+    poles.push_back(2.0);
+    ans &= testPoles("1 / (x ^ 2 - 4)", poles);
+    return ans;
+}
@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include "../XFunctionSolver2/XFunctionParser.h"
+#include "XTests.h"
+
+using namespace std;
+
+static const char *sources[] =
+{
+    "exp(sin(x) + cos(y)) - sin(exp(x + y))",
+    "sin(x ^ 2 + y ^ 2) - cos(x * y)",
+    "x / sin(x) + y / sin(y) - x * y / sin(x * y)",
+    "sin(sin(x) + cos(y)) - cos(sin(x * y) + cos(x))",
+    "2 * x + 3 * 4 - y ^ 2 + ln(2) * z",
+    "~x + (1 + 2) * (3 - ~4) ^ 2",
+    "x ^ y + 2 ^ x - tan(3) / x",
+    "x ^ 3 - y ^ ~2 + x ^ 0.5",
+    "x * 1 + 0 * y + x ^ 1",
+    "tan(x * y) / ln(x ^ 2 + 1)",
+    "(x ^ 2) ^ 3 + x * x",
+    "7",
+    "z",
+};
+
+// gives the variables of a tree their arguments, and makes the one of slot active for getDifferentiate
+static void bind(XAbstractParseNode *node, const double *arguments, int slot)
+{
+    XVariableParseNode *variable = dynamic_cast<XVariableParseNode *>(node);
+    if (variable != nullptr)
+    {
+        variable->setValue(arguments[variable->getSlot()]);
+        variable->setDifferentiateActive(variable->getSlot() == slot);
+        return;
+    }
+
+    for (int i = 0; i < node->getCountChilds(); i++)
+    {
+        bind(node->getChild(i), arguments, slot);
+    }
+}
+
+static bool isClose(double a, double b, double tolerance)
+{
+    return (std::isnan(a) && std::isnan(b)) || fabs(a - b) <= tolerance * max(1.0, fabs(b));
+}
+
+// The derivative taken on the graph against the one the parse nodes take of the tree, which is how
+// the parser differentiated before the graph. They are the same function written differently, so
+// they agree to a few roundings.
+static bool testDerivative(const char *source)
+{
+    mt19937 random(38);
+    uniform_real_distribution<double> uniform(0.2, 2.5);
+    XFunctionParser parser;
+    parser.setSource(source);
+    const char *variables[] = { "x", "y", "z" };
+    bool ans = true;
+    for (int slot = 0; slot < 3; slot++)
+    {
+        unique_ptr<XFunctionParser> derivative(parser.getDifferentiate(variables[slot]));
+        double arguments[3] = { 1.0, 1.0, 1.0 };
+        bind(parser.getRoot(), arguments, slot);
+        XParseNodeArena arena;
+        XAbstractParseNode *tree = parser.getRoot()->getDifferentiate(arena);
+        for (int i = 0; i < 300 && ans; i++)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                arguments[k] = uniform(random);
+            }
+
+            bind(tree, arguments, slot);
+            tree->updateValue();
+            ans &= check(isClose(derivative->getFunction(arguments), tree->getValue(), 1e-10), source);
+        }
+    }
+
+    return ans;
+}
+
+// Memoizing the derivative of every node keeps the derivative of f(f(...f(x))) linear in the depth,
+// where the tree doubles at every level as sin(u) ^ 2 gives 2 sin(u) cos(u) u'.
+static bool testNestedSize()
+{
+    string source = "x";
+    int previous = 0;
+    int growth = 0;
+    bool ans = true;
+    for (int depth = 1; depth <= 12; depth++)
+    {
+        source = "sin(" + source + ") ^ 2";
+        XFunctionParser parser;
+        parser.setSource(source);
+        unique_ptr<XFunctionParser> derivative(parser.getDifferentiate("x"));
+        int size = derivative->getBytecode().getCountInstructions();
+        if (depth == 2)
+        {
+            growth = size - previous;
+        }
+        else if (depth > 2)
+        {
+            ans &= check(size - previous <= growth, "the derivative of sin(..) ^ 2 nested grows by the same size each level");
+        }
+        previous = size;
+
+        double h = 1e-6;
+        double difference = (parser.getFunction(0.7 + h) - parser.getFunction(0.7 - h)) / (2 * h);
+        ans &= check(isClose(derivative->getFunction(0.7), difference, 1e-6), "the derivative of sin(..) ^ 2 nested");
+    }
+
+    return ans && check(previous <= 12 * growth, "the derivative of sin(..) ^ 2 nested 12 times is linear in the depth");
+}
+
+bool testExpressionGraph()
+{
+    bool ans = true;
+    for (int i = 0; i < (int)(sizeof(sources) / sizeof(sources[0])); i++)
+    {
+        ans &= testDerivative(sources[i]);
+    }
+
+    ans &= testNestedSize();
+    return ans;
+}
@@ -0,0 +1,165 @@
+#include <cmath>
+#include <vector>
+#include "../XFunctionSolver2/XImplicitRenderer.h"
+#include "XTests.h"
+
+using namespace std;
+
+static const int size = 200;
+static const int origin = -100;
+static const double unit = 0.04;
+
+// Keeps the cells of every finished level, and cancels the render after the level of cancelStep.
+class Levels : public XImplicitRenderer::Listener
+{
+public:
+    Levels(XImplicitRenderer &renderer, const vector<char> &cells, int cancelStep = 0)
+        : renderer(renderer), cells(cells), cancelStep(cancelStep)
+    {
+    }
+
+    virtual void levelFinished(int step, float process)
+    {
+        steps.push_back(step);
+        processes.push_back(process);
+        levels.push_back(cells);
+        if (step == cancelStep)
+        {
+            renderer.cancel();
+        }
+    }
+
+    XImplicitRenderer &renderer;
+    const vector<char> &cells;
+    int cancelStep;
+    vector<int> steps;
+    vector<float> processes;
+    vector<vector<char> > levels;
+};
+
+// Levels go from blocks of 8 pixels to single ones. A level marks whole blocks aligned to the plane,
+// and every pixel of the curve lies in a block each coarser level marked.
+static bool testLevels(const char *source)
+{
+    XImplicitRenderer renderer;
+    renderer.setCountThreads(2);
+    vector<char> cells(size * size);
+    Levels levels(renderer, cells);
+    bool ans = check(renderer.render(source, unit, origin, origin, size, size, cells.data(), &levels), source);
+    const int steps[] = { 8, 4, 2, 1 };
+    if (!check(levels.steps == vector<int>(steps, steps + 4), "a render reports the levels 8, 4, 2 and 1"))
+    {
+        return false;
+    }
+
+    for (int level = 0; level < 4; level++)
+    {
+        ans &= check(levels.processes[level] == (level + 1) / 4.0f, "a level reports how far the render is");
+        int step = steps[level];
+        const vector<char> &marks = levels.levels[level];
+        for (int i = 0; i < size && ans; i++)
+        {
+            for (int j = 0; j < size && ans; j++)
+            {
+                int blockI = i - ((i + origin) % step + step) % step;
+                int blockJ = j - ((j + origin) % step + step) % step;
+                if (blockI < 0 || blockJ < 0)
+                {
+                    continue;
+                }
+                ans &= check(marks[i * size + j] == marks[blockI * size + blockJ], "a level marks whole blocks");
+                ans &= check(!cells[i * size + j] || marks[i * size + j], "a preview holds every pixel of the curve");
+            }
+        }
+    }
+
+    return ans && check(levels.levels[3] == cells, "the last level is the render");
+}
+
+// The circle of radius 3: every marked pixel is near it and every pixel it passes close to the
+// centre of is marked.
+static bool testCircle()
+{
+    XImplicitRenderer renderer;
+    vector<char> cells(size * size);
+    bool ans = check(renderer.render("x ^ 2 + y ^ 2 - 9", unit, origin, origin, size, size, cells.data()),
+        "a circle renders");
+    int count = 0;
+    for (int i = 0; i < size && ans; i++)
+    {
+        for (int j = 0; j < size && ans; j++)
+        {
+            double distance = fabs(hypot((origin + i) * unit, (origin + j) * unit) - 3.0);
+            ans &= check(!cells[i * size + j] || distance < unit, "a marked pixel is near the circle");
+            ans &= check(cells[i * size + j] || distance >= unit / 3.0, "a pixel on the circle is marked");
+            count += cells[i * size + j];
+        }
+    }
+
+    return ans && check(count > 400, "a circle marks a ring of pixels");
+}
+
+// A render cancelled from its listener returns false with the cells of the last level it finished,
+// and leaves nothing in the cache that a later render would take for finished.
+static bool testCancel(const char *source)
+{
+    XImplicitRenderer renderer;
+    vector<char> cells(size * size);
+    Levels cancelled(renderer, cells, 4);
+    bool ans = check(!renderer.render(source, unit, origin, origin, size, size, cells.data(), &cancelled),
+        "a cancelled render returns false");
+    ans &= check(cancelled.steps.size() == 2 && cells == cancelled.levels[1],
+        "a cancelled render keeps the cells of the last finished level");
+
+    Levels resumed(renderer, cells);
+    ans &= check(renderer.render(source, unit, origin, origin, size, size, cells.data(), &resumed),
+        "a render after a cancelled one finishes");
+    XImplicitRenderer fresh;
+    vector<char> expected(size * size);
+    fresh.render(source, unit, origin, origin, size, size, expected.data());
+    return ans && check(cells == expected, "a render after a cancelled one is the same as without it")
+        && check(resumed.levels[1] == cancelled.levels[1], "the levels a cancelled render finished are reused");
+}
+
+// Tiles are aligned to the plane, so a view moved by some pixels and a view made from the cache of
+// another, with any number of threads, are the same pixels.
+static bool testPanning(const char *source)
+{
+    const int dx = 37;
+    const int dy = -21;
+    XImplicitRenderer single;
+    single.setCountThreads(1);
+    vector<char> cells(size * size);
+    single.render(source, unit, origin, origin, size, size, cells.data());
+
+    XImplicitRenderer pool;
+    pool.setCountThreads(4);
+    vector<char> moved(size * size);
+    pool.render(source, unit, origin + dx, origin + dy, size, size, moved.data());
+    pool.render(source, unit, origin + dx, origin + dy, size, size, moved.data());
+
+    bool ans = true;
+    for (int i = 0; i < size - dx && ans; i++)
+    {
+        for (int j = -dy; j < size && ans; j++)
+        {
+            ans &= check(moved[i * size + j] == cells[(i + dx) * size + j + dy], source);
+        }
+    }
+
+    return ans;
+}
+
+bool testImplicitRenderer()
+{
+    const char *sources[] = { "sin(x ^ 2 + y ^ 2) - cos(x * y)", "x / sin(x) + y / sin(y) - x * y / sin(x * y)" };
+    bool ans = testCircle();
+    for (int i = 0; i < 2; i++)
+    {
+        ans &= testLevels(sources[i]);
+        ans &= testCancel(sources[i]);
+        ans &= testPanning(sources[i]);
+    }
+
+    return ans;
+}
@@ -0,0 +1,86 @@
+#include <cmath>
+#include <random>
+#include "../XFunctionSolver2/XFunctionParser.h"
+#include "XTests.h"
+
+using namespace std;
+
+static const char *sources[] =
+{
+    "sin(sin(x) + cos(y)) - cos(sin(x * y) + cos(x))",
+    "sin(x ^ 2 + y ^ 2) - cos(x * y)",
+    "exp(sin(x) + cos(y)) - sin(exp(x + y))",
+    "x / sin(x) + y / sin(y) - x * y / sin(x * y)",
+    "x ^ 2 + y ^ 2 - 100",
+    "tan(x * y) - 1",
+    "ln(x) * y ^ 3 - 2",
+    "(x - y) ^ 2",
+    "x ^ y - 2",
+    "y - x ^ 3 / 100 + ~5",
+    "x ^ 0.5 - y",
+    "1 / (x - y) - 3",
+    "x ^ ~2 + y ^ 3 * x",
+};
+
+// The bounds are rounded to nearest rather than outward (see XInterval.h), and so is the value at a
+// point, so a value may stand outside the range by a few roundings, which is what this allows.
+static double getSlack(double value)
+{
+    return 1e-9 * (1.0 + fabs(value));
+}
+
+// Points of random boxes, their corners and a grid inside, against the range of the box: every value
+// that is a number lies in it, within the slack, and a box whose range is empty has no such value.
+static bool testEnclosure(const char *source)
+{
+    mt19937 random(41);
+    uniform_real_distribution<double> corner(-6.0, 6.0);
+    uniform_real_distribution<double> width(0.0, 2.0);
+    XFunctionParser parser;
+    parser.setSource(source);
+    bool ans = true;
+    for (int box = 0; box < 2000 && ans; box++)
+    {
+        double x0 = corner(random), y0 = corner(random);
+        double wx = width(random) * (box % 3 == 0 ? 1.0 : 0.05);
+        double wy = width(random) * (box % 5 == 0 ? 1.0 : 0.05);
+        XInterval range = parser.getFunctionInterval(XInterval(x0, x0 + wx), XInterval(y0, y0 + wy));
+        const int steps = 6;
+        for (int i = 0; i <= steps && ans; i++)
+        {
+            for (int j = 0; j <= steps && ans; j++)
+            {
+                double x = i == steps ? x0 + wx : x0 + wx * i / steps;
+                double y = j == steps ? y0 + wy : y0 + wy * j / steps;
+                double value = parser.getFunction(x, y);
+                if (std::isnan(value))
+                {
+                    continue;
+                }
+
+                ans &= check(!range.isEmpty() && range.lower - getSlack(value) <= value
+                    && value <= range.upper + getSlack(value), source);
+            }
+        }
+    }
+
+    return ans;
+}
+
+bool testInterval()
+{
+    bool ans = true;
+    for (int i = 0; i < (int)(sizeof(sources) / sizeof(sources[0])); i++)
+    {
+        ans &= testEnclosure(sources[i]);
+    }
+
+    XFunctionParser parser;
+    parser.setSource("ln(x)");
+    ans &= check(parser.getFunctionInterval(XInterval(-2.0, -1.0), XInterval(0.0)).isEmpty(),
+        "ln over negative numbers is empty");
+    parser.setSource("1 / x");
+    XInterval range = parser.getFunctionInterval(XInterval(-1.0, 1.0), XInterval(0.0));
+    ans &= check(std::isinf(range.lower) && std::isinf(range.upper), "1 / x over a range holding 0 is unbounded");
+    return ans;
+}
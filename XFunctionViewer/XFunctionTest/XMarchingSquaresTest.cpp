@@ -0,0 +1,78 @@
+#include <cmath>
+#include <vector>
+#include "../XFunctionSolver2/XMarchingSquares.h"
+#include "XTests.h"
+
+using namespace std;
+
+typedef XMarchingSquares::Point Point;
+typedef XMarchingSquares::Polyline Polyline;
+
+// A circle of radius 5 inside the area is one closed polyline. Refined crossings lie on it up to the
+// roundings of Newton's steps, the interpolated ones within the sag of a chord across a cell.
+static bool testCircle(int refinement, double tolerance)
+{
+    XFunctionParser parser;
+    parser.setSource("x ^ 2 + y ^ 2 - 25");
+    XMarchingSquares squares;
+    squares.setFunction(&parser);
+    squares.setArea(-7.0, -7.0, 7.0, 7.0);
+    squares.setResolution(200, 200);
+    squares.setRefinement(refinement);
+    squares.extract();
+
+    const vector<Polyline> &polylines = squares.getPolylines();
+    if (!check(polylines.size() == 1 && polylines[0].size() > 100, "a circle is one polyline"))
+    {
+        return false;
+    }
+
+    const Polyline &circle = polylines[0];
+    bool ans = check(circle.front().x == circle.back().x && circle.front().y == circle.back().y,
+        "the polyline of a circle is closed");
+    for (int i = 0; i < (int)circle.size() && ans; i++)
+    {
+        ans &= check(fabs(hypot(circle[i].x, circle[i].y) - 5.0) <= tolerance, "the polyline of a circle lies on it");
+    }
+
+    return ans;
+}
+
+// 1 / x - y changes sign across x = 0 without a root there, so no segment may join the two branches
+// of the hyperbola, whether or not the pole falls on a line of the lattice.
+static bool testPole(int columns)
+{
+    XFunctionParser parser;
+    parser.setSource("1 / x - y");
+    XMarchingSquares squares;
+    squares.setFunction(&parser);
+    squares.setArea(-3.0, -3.0, 3.0, 3.0);
+    squares.setResolution(columns, columns);
+    squares.extract();
+
+    const vector<Polyline> &polylines = squares.getPolylines();
+    bool ans = check(polylines.size() == 2, "the hyperbola of 1 / x - y is two polylines");
+    for (int i = 0; i < (int)polylines.size() && ans; i++)
+    {
+        const Polyline &branch = polylines[i];
+        for (int j = 0; j < (int)branch.size() && ans; j++)
+        {
+            ans &= check(fabs(1.0 / branch[j].x - branch[j].y) <= 1e-9 * (1.0 + fabs(branch[j].y)),
+                "the polylines of 1 / x - y lie on the hyperbola");
+            ans &= check(j == 0 || (branch[j - 1].x > 0.0) == (branch[j].x > 0.0),
+                "no segment of 1 / x - y crosses its pole");
+        }
+    }
+
+    return ans;
+}
+
+bool testMarchingSquares()
+{
+    bool ans = true;
+    ans &= testCircle(4, 1e-12);
+    ans &= testCircle(0, 1e-3);
+    ans &= testPole(100);
+    ans &= testPole(101);
+    return ans;
+}
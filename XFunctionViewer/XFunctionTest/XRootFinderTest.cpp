@@ -0,0 +1,180 @@
+#include <cmath>
+#include <vector>
+#include "../XFunctionSolver2/XRootFinder.h"
+#include "XTests.h"
+
+using namespace std;
+
+typedef XRootFinder::Result Result;
+
+// Lanes of 1 / (x - y) + x that end in every status. For y = 3 it has the roots (3 +- sqrt 5) / 2, for
+// y = 1 only a pole at 1, which Newton's steps from 0.9 bracket and close in on; f' vanishes at 2, and
+// the first step from 5 goes further than maxDistance.
+static const int countLanes = 6;
+static const double starts[countLanes] = { 2.6, 0.3, 0.9, 2.0, 1.0, 5.0 };
+static const double ys[countLanes] = { 3.0, 3.0, 1.0, 1.0, 1.0, 1.0 };
+static const XRootFinder::Status statuses[countLanes] =
+{
+    XRootFinder::Converged,
+    XRootFinder::Converged,
+    XRootFinder::Stalled,
+    XRootFinder::FlatDerivative,
+    XRootFinder::NotFinite,
+    XRootFinder::Diverged
+};
+
+static bool checkLane(const Result &result, int lane, int times)
+{
+    bool ans = true;
+    switch (statuses[lane])
+    {
+    case XRootFinder::Converged:
+        ans &= check(result.status == XRootFinder::Converged && fabs(result.value) <= 1e-6, "a lane converges to a root");
+        ans &= check(fabs(result.root - (3.0 + (lane == 0 ? 1 : -1) * sqrt(5.0)) / 2.0) <= 1e-6,
+            "a lane converges to the root near its start");
+        break;
+    case XRootFinder::Stalled:
+        if (times < 100)
+        {
+            return check(result.status == XRootFinder::MaxIterations && result.iterations == times,
+                "a lane stops after the iterations it is given");
+        }
+        ans &= check(result.status == XRootFinder::Stalled && fabs(result.root - 1.0) <= 1e-9,
+            "a lane that brackets a pole stalls at it");
+        break;
+    default:
+        ans &= check(result.status == statuses[lane] && result.root == starts[lane] && result.iterations == 1,
+            "a lane stops at the point where it got its status");
+        break;
+    }
+
+    return ans;
+}
+
+// The lanes several times over go through batches, each lane alone through Taylor series; both give
+// every lane its own status.
+static bool testStatuses(int times)
+{
+    XFunctionParser parser;
+    parser.setSource("1 / (x - y) + x");
+    XRootFinder finder;
+    finder.setFunction(&parser);
+    finder.setVariable("x");
+    finder.setMaxDistance(2.0);
+    finder.setTimes(times);
+
+    const int copies = 4;
+    vector<double> x, y;
+    for (int i = 0; i < countLanes * copies; i++)
+    {
+        x.push_back(starts[i % countLanes]);
+        y.push_back(ys[i % countLanes]);
+    }
+    const double *columns[2] = { x.data(), y.data() };
+    vector<Result> results(x.size());
+    finder.solve(columns, 2, results.data(), (int)x.size());
+
+    bool ans = true;
+    for (int i = 0; i < (int)x.size() && ans; i++)
+    {
+        ans &= checkLane(results[i], i % countLanes, times);
+    }
+    for (int lane = 0; lane < countLanes && ans; lane++)
+    {
+        ans &= checkLane(finder.solve(starts[lane], ys[lane]), lane, times);
+    }
+
+    finder.setVariable("t");
+    finder.solve(columns, 2, results.data(), (int)x.size());
+    for (int i = 0; i < (int)x.size() && ans; i++)
+    {
+        ans &= check(results[i].status == XRootFinder::UnknownVariable && results[i].iterations == 0,
+            "no lane runs for a variable f does not have");
+    }
+
+    return ans;
+}
+
+// ln y as the root of exp(x) - y from 0: Halley's steps get there as Newton's do, in no more
+// iterations, and in fewer over all the lanes.
+static bool testHalley()
+{
+    XFunctionParser parser;
+    parser.setSource("exp(x) - y");
+    XRootFinder finder;
+    finder.setFunction(&parser);
+    finder.setVariable("x");
+    finder.setMaxDistance(0.0);
+
+    vector<double> y;
+    for (int i = 0; i < 40; i++)
+    {
+        y.push_back(1.5 + i);
+    }
+    const double *columns[2] = { nullptr, y.data() };
+    vector<Result> newton(y.size());
+    vector<Result> halley(y.size());
+    finder.solve(columns, 2, newton.data(), (int)y.size());
+    finder.setMethod(XRootFinder::Halley);
+    finder.solve(columns, 2, halley.data(), (int)y.size());
+
+    bool ans = true;
+    int newtonIterations = 0;
+    int halleyIterations = 0;
+    for (int i = 0; i < (int)y.size() && ans; i++)
+    {
+        ans &= check(newton[i].status == XRootFinder::Converged && fabs(newton[i].root - log(y[i])) <= 1e-6,
+            "Newton's steps find ln y");
+        ans &= check(halley[i].status == XRootFinder::Converged && fabs(halley[i].root - log(y[i])) <= 1e-6,
+            "Halley's steps find ln y");
+        ans &= check(halley[i].iterations <= newton[i].iterations, "Halley's steps take no more iterations");
+        newtonIterations += newton[i].iterations;
+        halleyIterations += halley[i].iterations;
+    }
+
+    return ans && check(halleyIterations < newtonIterations, "Halley's steps take fewer iterations");
+}
+
+// Newton's step for x / sqrt(1 + x ^ 2) goes from x to ~x ^ 3, which runs away from the root at 0 for
+// |x| > 1. The first step crosses the root, and the steps that would leave that bracket are replaced,
+// so the lanes converge all the same.
+static bool testBracket(XRootFinder::Method method)
+{
+    XFunctionParser parser;
+    parser.setSource("x / (1 + x ^ 2) ^ 0.5");
+    XRootFinder finder;
+    finder.setFunction(&parser);
+    finder.setVariable("x");
+    finder.setMethod(method);
+    finder.setMaxDistance(0.0);
+
+    vector<double> x;
+    for (int i = 0; i < 32; i++)
+    {
+        x.push_back((i % 2 == 0 ? 1.0 : -1.0) * (1.1 + 0.1 * i));
+    }
+    const double *columns[1] = { x.data() };
+    vector<Result> results(x.size());
+    finder.solve(columns, 1, results.data(), (int)x.size());
+
+    bool ans = true;
+    for (int i = 0; i < (int)x.size() && ans; i++)
+    {
+        ans &= check(results[i].status == XRootFinder::Converged && fabs(results[i].root) <= 1e-6,
+            "a lane that crossed a root converges in the bracket");
+        ans &= check(results[i].iterations <= 20, "the steps in a bracket converge quickly");
+    }
+
+    return ans;
+}
+
+bool testRootFinder()
+{
+    bool ans = true;
+    ans &= testStatuses(200);
+    ans &= testStatuses(20);
+    ans &= testHalley();
+    ans &= testBracket(XRootFinder::Newton);
+    ans &= testBracket(XRootFinder::Halley);
+    return ans;
+}
@@ -0,0 +1,220 @@
+#include <cmath>
+#include <vector>
+#include "../XFunctionSolver2/XSystemSolver.h"
+#include "XTests.h"
+
+using namespace std;
+
+typedef XSystemSolver::Result Result;
+
+static double getCost(const vector<XFunctionParser *> &functions, double x, double y)
+{
+    double cost = 0.0;
+    for (int f = 0; f < (int)functions.size(); f++)
+    {
+        double value = functions[f]->getFunction(x, y);
+        cost += value * value;
+    }
+
+    return cost;
+}
+
+// The circle of radius 5 and the line y = x - 1 cross at (3, 4) and (-4, -3). From every point of a
+// grid around them the lanes converge to one of them, in a batch as one at a time. (Far along x = -y,
+// where the Jacobian is singular, the steps crawl and may not get there within 100 iterations.)
+static bool testCrossing()
+{
+    XFunctionParser circle;
+    XFunctionParser line;
+    circle.setSource("x ^ 2 + y ^ 2 - 25");
+    line.setSource("y - x + 1");
+    XSystemSolver solver;
+    solver.setFunctions({ &circle, &line });
+    solver.setVariables({ "x", "y" });
+
+    vector<double> x, y;
+    for (int i = 0; i < 21; i++)
+    {
+        for (int j = 0; j < 21; j++)
+        {
+            x.push_back(-10.0 + i);
+            y.push_back(-10.0 + j + 0.5);
+        }
+    }
+    vector<Result> results(x.size());
+    solver.solve(x.data(), y.data(), nullptr, results.data(), (int)x.size());
+
+    bool ans = true;
+    int found[2] = { 0, 0 };
+    for (int i = 0; i < (int)x.size() && ans; i++)
+    {
+        const Result &result = results[i];
+        bool first = fabs(result.point[0] - 3.0) <= 1e-9 && fabs(result.point[1] - 4.0) <= 1e-9;
+        bool second = fabs(result.point[0] + 4.0) <= 1e-9 && fabs(result.point[1] + 3.0) <= 1e-9;
+        ans &= check(result.status == XSystemSolver::Converged && result.residual <= 1e-10 && (first || second),
+            "a lane converges to where the circle and the line cross");
+        found[first ? 0 : 1]++;
+
+        Result alone = solver.solve(x[i], y[i]);
+        ans &= check(alone.status == result.status && alone.point[0] == result.point[0]
+            && alone.point[1] == result.point[1] && alone.iterations == result.iterations,
+            "a lane in a batch is the lane alone");
+    }
+
+    return ans && check(found[0] > 0 && found[1] > 0, "the lanes find both crossings");
+}
+
+// The largest |f| after each iteration, from far off and near by. Once it is under 0.1 the steps
+// are Newton's, and each one squares it, about, until it is within tolerance.
+static bool testQuadratic(const vector<XFunctionParser *> &functions, const vector<string> &variables,
+    double x, double y, double z, int maxIterations)
+{
+    XSystemSolver solver;
+    solver.setFunctions(functions);
+    solver.setVariables(variables);
+    bool ans = true;
+    double residual = HUGE_VAL;
+    for (int times = 1; ; times++)
+    {
+        solver.setTimes(times);
+        Result result = solver.solve(x, y, z);
+        if (result.status == XSystemSolver::Converged)
+        {
+            return ans && check(result.iterations <= maxIterations, "Levenberg-Marquardt converges in few iterations");
+        }
+        if (!check(result.status == XSystemSolver::MaxIterations && times < maxIterations,
+            "Levenberg-Marquardt runs until it converges"))
+        {
+            return false;
+        }
+
+        ans &= check(residual >= 0.1 || result.residual <= 10.0 * residual * residual,
+            "Levenberg-Marquardt converges quadratically near a root");
+        residual = result.residual;
+    }
+}
+
+// Newton's steps for x / sqrt(1 + x ^ 2) go from x to ~x ^ 3 and run away for |x| > 1. The steps that
+// raise |f| are turned down and retried shorter, so the lanes get to (0, 0) all the same.
+static bool testDamping()
+{
+    XFunctionParser flat;
+    XFunctionParser line;
+    flat.setSource("x / (1 + x ^ 2) ^ 0.5");
+    line.setSource("y - x");
+    XSystemSolver solver;
+    solver.setFunctions({ &flat, &line });
+    solver.setVariables({ "x", "y" });
+
+    vector<double> x = { 1.5, 3.0, 10.0, -5.0 };
+    vector<Result> results(x.size());
+    solver.solve(x.data(), x.data(), nullptr, results.data(), (int)x.size());
+    bool ans = true;
+    for (int i = 0; i < (int)x.size() && ans; i++)
+    {
+        ans &= check(results[i].status == XSystemSolver::Converged && fabs(results[i].point[0]) <= 1e-10
+            && results[i].iterations <= 30, "damped steps converge where Newton's run away");
+    }
+
+    return ans;
+}
+
+// A system with no common root: the lane stalls where the sum of squares is lowest around it.
+static bool testLeastSquares()
+{
+    XFunctionParser circle;
+    XFunctionParser line;
+    XFunctionParser other;
+    circle.setSource("x ^ 2 + y ^ 2 - 25");
+    line.setSource("y - x + 1");
+    other.setSource("x + y - 3");
+    vector<XFunctionParser *> functions = { &circle, &line, &other };
+    XSystemSolver solver;
+    solver.setFunctions(functions);
+    solver.setVariables({ "x", "y" });
+    Result result = solver.solve(1.0, 1.0);
+
+    bool ans = check(result.status == XSystemSolver::Stalled && result.residual > 1.0,
+        "a system without a root stalls");
+    double cost = getCost(functions, result.point[0], result.point[1]);
+    const double h = 1e-4;
+    for (int k = 0; k < 8; k++)
+    {
+        double angle = k * acos(-1.0) / 4.0;
+        ans &= check(cost <= getCost(functions, result.point[0] + h * cos(angle), result.point[1] + h * sin(angle)),
+            "a stalled lane is at a least squares point");
+    }
+
+    // with two functions of one unknown the other stays where it started
+    functions.pop_back();
+    solver.setFunctions(functions);
+    solver.setVariables({ "x" });
+    result = solver.solve(3.0, 3.0);
+    ans &= check(result.status == XSystemSolver::Stalled && result.point[1] == 3.0, "a lane moves its unknowns only");
+    cost = getCost(functions, result.point[0], 3.0);
+    return ans && check(cost <= getCost(functions, result.point[0] + h, 3.0)
+        && cost <= getCost(functions, result.point[0] - h, 3.0), "a stalled lane is at a least squares point");
+}
+
+// NotFinite, Diverged and MaxIterations, and the gradient of sin x cos y, which vanishes at (pi / 2, 0).
+static bool testStatuses()
+{
+    XFunctionParser logarithm;
+    XFunctionParser line;
+    logarithm.setSource("ln(x) + y");
+    line.setSource("x - y - 1");
+    XSystemSolver solver;
+    solver.setFunctions({ &logarithm, &line });
+    solver.setVariables({ "x", "y" });
+    bool ans = check(solver.solve(-1.0, 0.0).status == XSystemSolver::NotFinite, "a lane that starts at no number");
+
+    Result result = solver.solve(0.1, 5.0);
+    ans &= check(result.status == XSystemSolver::Converged
+        && fabs(log(result.point[0]) + result.point[1]) <= 1e-10, "a lane steers clear of where ln is no number");
+
+    solver.setMaxDistance(0.5);
+    ans &= check(solver.solve(0.1, 5.0).status == XSystemSolver::Diverged, "a lane that goes too far diverges");
+    solver.setMaxDistance(0.0);
+    solver.setTimes(2);
+    ans &= check(solver.solve(0.1, 5.0).status == XSystemSolver::MaxIterations, "a lane runs out of iterations");
+
+    XFunctionParser parser;
+    parser.setSource("sin(x) * cos(y)");
+    XFunctionParser *dx = parser.getDifferentiate("x");
+    XFunctionParser *dy = parser.getDifferentiate("y");
+    XSystemSolver gradient;
+    gradient.setFunctions({ dx, dy });
+    gradient.setVariables({ "x", "y" });
+    result = gradient.solve(1.4, 0.2);
+    ans &= check(result.status == XSystemSolver::Converged && fabs(result.point[0] - acos(0.0)) <= 1e-9
+        && fabs(result.point[1]) <= 1e-9, "the gradient of sin x cos y vanishes at (pi / 2, 0)");
+    delete dx;
+    delete dy;
+    return ans;
+}
+
+bool testSystemSolver()
+{
+    bool ans = testCrossing();
+
+    XFunctionParser circle;
+    XFunctionParser line;
+    circle.setSource("x ^ 2 + y ^ 2 - 25");
+    line.setSource("y - x + 1");
+    vector<XFunctionParser *> functions = { &circle, &line };
+    ans &= testQuadratic(functions, { "x", "y" }, 100.0, -30.0, 0.0, 12);
+
+    XFunctionParser sum;
+    XFunctionParser product;
+    XFunctionParser sphere;
+    sum.setSource("x + y + z - 6");
+    product.setSource("x * y * z - 6");
+    sphere.setSource("x ^ 2 + y ^ 2 + z ^ 2 - 14");
+    functions.assign({ &sum, &product, &sphere });
+    ans &= testQuadratic(functions, { "x", "y", "z" }, 0.5, 2.5, 2.7, 8);
+
+    ans &= testDamping();
+    ans &= testLeastSquares();
+    ans &= testStatuses();
+    return ans;
+}
@@ -0,0 +1,93 @@
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "../XFunctionSolver2/XFunctionParser.h"
+#include "XTests.h"
+
+using namespace std;
+
+static const char *sources[] =
+{
+    "sin(x) * exp(x / 3) + x ^ 3",
+    "ln(x ^ 2 + 1) / (x + 3)",
+    "tan(x) * cos(2 * x)",
+    "x ^ y + y ^ x",
+    "(x + 1) ^ 2.5 - (x + 2) ^ 0.5",
+    "x ^ 4",
+    "x ^ 0.5",
+    "1 / (1 + x ^ 2)",
+    "exp(~x ^ 2) * sin(3 * x)",
+    "y * sin(x * y) - ~x",
+};
+
+// Within a few roundings of the size of the expected value, where that is finite. The derivative of
+// x ^ y goes through ln x, so at x = 0 the expression is not a number where the series is finite.
+static bool isClose(double a, double expected)
+{
+    return !std::isfinite(expected) || fabs(a - expected) <= 1e-9 * (1.0 + fabs(expected));
+}
+
+// The truncated Taylor series of the bytecode against the derivative expressions of getDifferentiate,
+// taken order after order, at orders 2 and 3, one point at a time and in a batch.
+static bool testOrders(const char *source)
+{
+    const int maxOrder = 3;
+    XFunctionParser parser;
+    parser.setSource(source);
+    unique_ptr<XFunctionParser> derivatives[maxOrder + 1];
+    for (int k = 1; k <= maxOrder; k++)
+    {
+        derivatives[k].reset(parser.getDifferentiate("x", k));
+    }
+
+    mt19937 random(50);
+    uniform_real_distribution<double> uniform(-2.0, 2.0);
+    vector<double> x = { 0.0, 0.3, 1.7, -0.6 };
+    vector<double> y(x.size(), 1.3);
+    for (int i = 0; i < 100; i++)
+    {
+        x.push_back(uniform(random));
+        y.push_back(uniform(random));
+    }
+
+    int count = (int)x.size();
+    bool ans = true;
+    for (int order = 2; order <= maxOrder; order++)
+    {
+        vector<vector<double> > batch(order + 1, vector<double>(count));
+        double *results[maxOrder + 1];
+        for (int k = 0; k <= order; k++)
+        {
+            results[k] = batch[k].data();
+        }
+        const double *columns[2] = { x.data(), y.data() };
+        parser.getFunctionsAndDerivatives("x", order, columns, 2, results, count);
+
+        for (int i = 0; i < count && ans; i++)
+        {
+            double series[maxOrder + 1];
+            parser.getFunctionAndDerivatives("x", order, series, x[i], y[i]);
+            for (int k = 0; k <= order; k++)
+            {
+                double expected = k == 0 ? parser.getFunction(x[i], y[i]) : derivatives[k]->getFunction(x[i], y[i]);
+                ans &= check(isClose(series[k], expected), source);
+                ans &= check(isClose(results[k][i], expected), source);
+            }
+        }
+    }
+
+    return ans;
+}
+
+bool testTaylor()
+{
+    bool ans = true;
+    for (int i = 0; i < (int)(sizeof(sources) / sizeof(sources[0])); i++)
+    {
+        ans &= testOrders(sources[i]);
+    }
+
+    return ans;
+}
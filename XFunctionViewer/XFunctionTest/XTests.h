@@ -0,0 +1,18 @@
+#pragma once
+
+// prints what when condition is false, and returns condition
+bool check(bool condition, const char *what);
+
+// Each checks one part of XFunctionSolver2, prints a line for every check that fails and returns
+// false if any did.
+bool testBytecode();  // programs against the parse tree, constant folding and batches
+bool testVectorMath();  // Precise and Fast against the C library, AVX2 against the baseline kernels
+bool testExpressionGraph();  // derivatives on the graph against the parse tree, and their size
+bool testDual();  // dual numbers against central differences and getDifferentiate
+bool testTaylor();  // Taylor series of orders 2 and 3 against getDifferentiate order after order
+bool testInterval();  // interval bounds holding the values at points inside their boxes
+bool testMarchingSquares();  // polylines of a circle and of a curve with a pole
+bool testImplicitRenderer();  // the levels of a render, cancelling it and reusing its tiles
+bool testRootFinder();  // the status of each lane, Halley's steps and the bracket
+bool testExplicitPlotter();  // the distance of a graph from its polylines, and its poles
+bool testSystemSolver();  // Levenberg-Marquardt converging to roots and least squares points
@@ -0,0 +1,195 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "../XFunctionSolver2/XVectorMathDispatch.h"
+#include "XTests.h"
+
+using namespace std;
+
+typedef void (*Unary)(const double *a, double *out, int count, XVectorMath::Accuracy accuracy);
+
+// doubles in the order of their values as integers, so that neighbouring doubles are one apart
+static int64_t getOrdered(double value)
+{
+    int64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits < 0 ? INT64_MIN - bits : bits;
+}
+
+static double getUlps(double value, double expected)
+{
+    if (value == expected || (std::isnan(value) && std::isnan(expected)))
+    {
+        return 0.0;
+    }
+    if (std::isnan(value) || std::isnan(expected) || std::isinf(value) || std::isinf(expected))
+    {
+        return INFINITY;
+    }
+    int64_t a = getOrdered(value), b = getOrdered(expected);
+    return a > b ? (double)(uint64_t(a) - uint64_t(b)) : (double)(uint64_t(b) - uint64_t(a));
+}
+
+static double getRelativeError(double value, double expected)
+{
+    if (value == expected)
+    {
+        return 0.0;
+    }
+    if (!std::isfinite(value) || !std::isfinite(expected))
+    {
+        return INFINITY;
+    }
+    return fabs(value - expected) / fabs(expected);
+}
+
+// count points from low to high, evenly or, when geometric, evenly in the logarithm
+static vector<double> sweep(double low, double high, int count, bool geometric = false)
+{
+    vector<double> ans(count);
+    for (int i = 0; i < count; i++)
+    {
+        double t = (double)i / (count - 1);
+        ans[i] = geometric ? low * pow(high / low, t) : low + (high - low) * t;
+    }
+    return ans;
+}
+
+// The worst error of a kernel against the C library over the points, in ulp for Precise and relative
+// for Fast. Results the C library gives as subnormals are left out, Precise exp flushes them to 0.
+static bool testUnary(Unary kernel, double (*exact)(double), const vector<double> &points,
+    XVectorMath::Accuracy accuracy, double bound, const string &what)
+{
+    vector<double> results(points.size());
+    kernel(points.data(), results.data(), (int)points.size(), accuracy);
+    double worst = 0.0;
+    for (int i = 0; i < (int)points.size(); i++)
+    {
+        double expected = exact(points[i]);
+        if (expected != 0.0 && fabs(expected) < 2.2250738585072014e-308)
+        {
+            continue;
+        }
+        double error = accuracy == XVectorMath::Precise ? getUlps(results[i], expected) : getRelativeError(results[i], expected);
+        worst = max(worst, error);
+    }
+    return check(worst <= bound, what.c_str());
+}
+
+// pow is exp(b ln a), whose error grows with |b ln a|, so the error of each point is taken over that
+static bool testPower(const XVectorMathKernels &kernels, XVectorMath::Accuracy accuracy, double bound, const string &what)
+{
+    vector<double> bases = sweep(1e-3, 1e3, 400, true);
+    vector<double> exponents = sweep(-40.0, 40.0, 301);
+    int count = (int)(bases.size() * exponents.size());
+    vector<double> a(count), b(count), results(count);
+    for (int i = 0; i < count; i++)
+    {
+        a[i] = bases[i % bases.size()];
+        b[i] = exponents[i / bases.size()];
+    }
+
+    kernels.power(a.data(), b.data(), results.data(), count, accuracy);
+    double worst = 0.0;
+    for (int i = 0; i < count; i++)
+    {
+        double expected = pow(a[i], b[i]);
+        double error = accuracy == XVectorMath::Precise ? getUlps(results[i], expected) : getRelativeError(results[i], expected);
+        worst = max(worst, error / max(1.0, fabs(b[i] * log(a[i]))));
+    }
+    return check(worst <= bound, what.c_str());
+}
+
+static bool testAccuracy(const XVectorMathKernels &kernels)
+{
+    struct Function
+    {
+        const char *name;
+        Unary kernel;
+        double (*exact)(double);
+        vector<double> points;
+        double ulps;      // Precise
+        double relative;  // Fast
+    };
+
+    vector<double> angles = sweep(-100.0, 100.0, 200001);
+    vector<double> far = sweep(100.0, 1e5, 100001);
+    angles.insert(angles.end(), far.begin(), far.end());
+    vector<double> powers = sweep(-745.0, 709.0, 200001);
+    vector<double> logarithms = sweep(1e-300, 1e300, 200001, true);
+    vector<double> nearOne = sweep(0.5, 2.0, 100001);
+    logarithms.insert(logarithms.end(), nearOne.begin(), nearOne.end());
+
+    Function functions[] =
+    {
+        { "sin", kernels.sin, ::sin, angles, 4.0, 1e-7 },
+        { "cos", kernels.cos, ::cos, angles, 4.0, 1e-7 },
+        { "tan", kernels.tan, ::tan, angles, 6.0, 1e-7 },
+        { "exp", kernels.exp, ::exp, powers, 4.0, 1e-7 },
+        { "ln", kernels.ln, ::log, logarithms, 6.0, 1e-7 },
+    };
+
+    bool ans = true;
+    for (int i = 0; i < (int)(sizeof(functions) / sizeof(functions[0])); i++)
+    {
+        const Function &function = functions[i];
+        string name = string(kernels.instructionSet) + " " + function.name;
+        ans &= testUnary(function.kernel, function.exact, function.points, XVectorMath::Precise, function.ulps,
+            name + " Precise within its ulp");
+        ans &= testUnary(function.kernel, function.exact, function.points, XVectorMath::Fast, function.relative,
+            name + " Fast within its relative error");
+    }
+
+    ans &= testPower(kernels, XVectorMath::Precise, 4.0, string(kernels.instructionSet) + " pow Precise within its ulp");
+    ans &= testPower(kernels, XVectorMath::Fast, 1e-7, string(kernels.instructionSet) + " pow Fast within its relative error");
+    return ans;
+}
+
+// The AVX2 kernels run the same operations on wider packs, so they give the bits of the baseline ones.
+static bool testSameKernels(const XVectorMathKernels &baseline, const XVectorMathKernels &avx2)
+{
+    vector<double> a = sweep(-50.0, 50.0, 10007);
+    vector<double> b = sweep(-3.0, 3.0, 10007);
+    vector<double> positive = sweep(1e-5, 1e5, 10007, true);
+    int count = (int)a.size();
+    vector<double> expected(count), results(count);
+    bool ans = true;
+    for (int accuracy = XVectorMath::Exact; accuracy <= XVectorMath::Fast; accuracy++)
+    {
+        XVectorMath::Accuracy mode = (XVectorMath::Accuracy)accuracy;
+        Unary baselines[] = { baseline.sin, baseline.cos, baseline.tan, baseline.exp, baseline.ln };
+        Unary wides[] = { avx2.sin, avx2.cos, avx2.tan, avx2.exp, avx2.ln };
+        for (int k = 0; k < 5; k++)
+        {
+            const vector<double> &points = k == 4 ? positive : a;
+            baselines[k](points.data(), expected.data(), count, mode);
+            wides[k](points.data(), results.data(), count, mode);
+            ans &= check(memcmp(expected.data(), results.data(), count * sizeof(double)) == 0,
+                "the AVX2 sin, cos, tan, exp and ln give the bits of the baseline ones");
+        }
+
+        baseline.power(positive.data(), b.data(), expected.data(), count, mode);
+        avx2.power(positive.data(), b.data(), results.data(), count, mode);
+        ans &= check(memcmp(expected.data(), results.data(), count * sizeof(double)) == 0,
+            "the AVX2 pow gives the bits of the baseline one");
+    }
+
+    return ans;
+}
+
+bool testVectorMath()
+{
+    const XVectorMathKernels &baseline = getBaselineKernels();
+    bool ans = testAccuracy(baseline);
+    // only a processor with AVX2 may call into the AVX2 kernels, XVectorMath uses them when it has
+    const XVectorMathKernels *avx2 = XVectorMath::getCountLanes() == 4 ? getAvx2Kernels() : nullptr;
+    if (avx2 != nullptr)
+    {
+        ans &= testAccuracy(*avx2);
+        ans &= testSameKernels(baseline, *avx2);
+    }
+
+    return ans;
+}
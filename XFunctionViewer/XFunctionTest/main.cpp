@@ -0,0 +1,32 @@
+// Checks the numerical code of XFunctionSolver2 and exits with 1 if any check failed. Uses
+// XFunctionSolver2 and the standard library only; besides the Visual Studio project, on Linux it
+// builds with
+//     g++ -std=c++14 -O2 -pthread -I../XFunctionSolver2 *.cpp ../XFunctionSolver2/*.cpp
+//         ../XFunctionSolver2/BasicParseNodes/*.cpp -o xtest
+#include <cstdio>
+#include "XTests.h"
+
+bool check(bool condition, const char *what)
+{
+    if (!condition)
+    {
+        printf("failed: %s\n", what);
+    }
+
+    return condition;
+}
+
+int main()
+{
+    bool (*const tests[])() = { testBytecode, testVectorMath, testExpressionGraph, testDual, testTaylor, testInterval, testMarchingSquares, testImplicitRenderer, testRootFinder, testExplicitPlotter, testSystemSolver };
+    const char *const names[] = { "bytecode", "vectormath", "graph", "dual", "taylor", "interval", "squares", "implicit", "roots", "explicit", "system" };
+    bool passed = true;
+    for (int i = 0; i < (int)(sizeof(tests) / sizeof(tests[0])); i++)
+    {
+        bool ok = tests[i]();
+        printf("%-10s %s\n", names[i], ok ? "ok" : "FAILED");
+        passed &= ok;
+    }
+
+    return passed ? 0 : 1;
+}
@@ -17,7 +17,15 @@ XFIProvider::XFIProvider(QObject *parent)
 {
     parser = new XFunctionParser;
     newton = new XNewton;
+    newton->setAutomaticDifferentiation(true);
+    squares = new XMarchingSquares;
+    renderer = new XImplicitRenderer;
+    contour = false;
     limit = 20;
+    centerX = 0;
+    centerY = 0;
+    originX = -arrayLen / 2;
+    originY = -arrayLen / 2;
 
     source = "exp(sin(x) + cos(y)) - sin(exp(x + y))";
 
@@ -26,6 +34,8 @@ XFIProvider::XFIProvider(QObject *parent)
 
 XFIProvider::~XFIProvider()
 {
+    delete renderer;
+    delete squares;
     delete newton;
     delete parser;
     delete image;
@@ -41,6 +51,21 @@ void XFIProvider::genImage()
     painter.fillRect(0, 0, 900, 900, Qt::GlobalColor::white);
 
     painter.setPen(QPen(QColor(255, 0, 0)));
+    if (contour)
+    {
+        painter.setRenderHint(QPainter::Antialiasing);
+        const std::vector<XMarchingSquares::Polyline> &polylines = squares->getPolylines();
+        for (int k = 0; k < polylines.size(); k++)
+        {
+            QPolygonF polygon;
+            for (int p = 0; p < polylines[k].size(); p++)
+            {
+                polygon << QPointF(polylines[k][p].x / unit - originX, polylines[k][p].y / unit - originY);
+            }
+            painter.drawPolyline(polygon);
+        }
+        painter.setRenderHint(QPainter::Antialiasing, false);
+    }
     for (int i = 0; i < arrayLen; i++)
     {
         for (int j = 0; j < arrayLen; j++)
@@ -53,8 +78,8 @@ void XFIProvider::genImage()
     }
 
     painter.setPen(QPen(QColor(0, 0, 0)));
-    painter.drawLine(0, 450, 900, 450);
-    painter.drawLine(450, 0, 450, 900);
+    painter.drawLine(0, -originY, arrayLen, -originY);
+    painter.drawLine(-originX, 0, -originX, arrayLen);
     painter.end();
 }
 
@@ -68,10 +93,30 @@ void XFIProvider::setSource(QString source)
     this->source = source.toStdString();
 }
 
+void XFIProvider::setCenter(float centerX, float centerY)
+{
+    this->centerX = centerX;
+    this->centerY = centerY;
+}
+
+void XFIProvider::setLimit(float limit)
+{
+    this->limit = limit;
+}
+
+void XFIProvider::cancel()
+{
+    renderer->cancel();
+}
+
 void XFIProvider::draw()
 {
-    genMp();
+    if (!genMp())
+    {
+        return;
+    }
     genImage();
+    emit imageUpdated(*image);
     emit createFinished();
 }
 
@@ -80,7 +125,30 @@ XNewton *XFIProvider::getNewton() const
     return newton;
 }
 
-void XFIProvider::genMp()
+XMarchingSquares *XFIProvider::getMarchingSquares() const
+{
+    return squares;
+}
+
+void XFIProvider::setContour(bool contour)
+{
+    this->contour = contour;
+}
+
+bool XFIProvider::isContour() const
+{
+    return contour;
+}
+
+XImplicitRenderer *XFIProvider::getRenderer() const
+{
+    return renderer;
+}
+
+// The view is the pixels originX + i, originY + j of the plane, with the center in the middle.
+// Rendering goes to the tiles of XImplicitRenderer, whose finished levels come back through
+// levelFinished as previews. Redrawing the same source takes it compiled from XExpressionCache.
+bool XFIProvider::genMp()
 {
     parser->setSource(source);
     newton->setFunction(parser);
@@ -88,53 +156,30 @@ void XFIProvider::genMp()
     memset(mp, 0, sizeof(mp));
 
     unit = limit / (arrayLen / 2);
+    originX = lround(centerX / unit) - arrayLen / 2;
+    originY = lround(centerY / unit) - arrayLen / 2;
 
-    int mi = arrayLen / 2 - limit / unit;
-    int ma = arrayLen / 2 + limit / unit;
-
-    newton->setVariable("x");
-
-    for (int i = mi; i < ma; i++)
+    if (contour)
     {
-        for (int j = mi; j < ma; j++)
-        {
-            double x = (i - arrayLen / 2) * unit;
-            double y = (j - arrayLen / 2) * unit;
-
-            if (fabs(newton->newton(x, y) - x) < unit / 2.0)
-            {
-                mp[i][j] = 1;
-            }
-
-        }
-
-        if (i % 20 == 0)
-        {
-            float process = float(i * ma) / (ma * ma) / 2.0;
-            emit processUpdated(process);
-        }
+        squares->setFunction(parser);
+        squares->setArea((originX - 0.5) * unit, (originY - 0.5) * unit,
+            (originX + arrayLen - 0.5) * unit, (originY + arrayLen - 0.5) * unit);
+        squares->extract();
+        return true;
     }
 
-    newton->setVariable("y");
-    for (int i = mi; i < ma; i++)
-    {
-        for (int j = mi; j < ma; j++)
-        {
-            double x = (i - arrayLen / 2) *   unit;
-            double y = (j - arrayLen / 2) *    unit;
-
-            if (fabs(newton->newton(x, y) - y) < unit / 2.0)
-            {
-                mp[i][j] = 1;
-            }
-        }
+    renderer->setTimes(newton->getTimes());
+    return renderer->render(source, unit, originX, originY, arrayLen, arrayLen, &mp[0][0], this);
+}
 
-        if (i % 20 == 0)
-        {
-            float process = float(i * ma) / (ma * ma) / 2.0 + 0.5;
-            emit processUpdated(process);
-        }
+void XFIProvider::levelFinished(int step, float process)
+{
+    if (step > 1)
+    {
+        genImage();
+        emit imageUpdated(*image);
     }
+    emit processUpdated(process);
 }
 
 QImage *XFIProvider::getImage() const
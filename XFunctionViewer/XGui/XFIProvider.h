@@ -5,12 +5,14 @@
 #include <qimage.h>
 #include <string>
 #include "../XFunctionSolver2/XNewton.h"
+#include "../XFunctionSolver2/XMarchingSquares.h"
+#include "../XFunctionSolver2/XImplicitRenderer.h"
 #include <qpushbutton.h>
 #include <qthread.h>
 #include <qmessagebox.h>
 //#pragma comment (lib, "XFunctionSolver2.lib")
 
-class XFIProvider : public QObject
+class XFIProvider : public QObject, public XImplicitRenderer::Listener
 {
     Q_OBJECT
 
@@ -19,7 +21,15 @@ public:
     ~XFIProvider();
     XNewton *getNewton() const;
     XFunctionParser *getParser() const;
+    XMarchingSquares *getMarchingSquares() const;
+    XImplicitRenderer *getRenderer() const;
+    // true draws the curve as polylines from marching squares instead of the cells Newton accepts
+    void setContour(bool contour);
+    bool isContour() const;
     void setSource(QString source);
+    void setCenter(float centerX, float centerY);
+    void setLimit(float limit);  // the half width of the view
+    void cancel();               // from any thread, ends a draw under way
     QImage *getImage() const;
 
 public slots:
@@ -28,17 +38,24 @@ public slots:
 signals:
     void createFinished();
     void processUpdated(float process);
+    void imageUpdated(QImage image);  // a copy, first coarse and then finer, ending with the final image
 
 private:
-    void genMp();
+    bool genMp();
     void genImage();
+    virtual void levelFinished(int step, float process);
     std::string source;
     XFunctionParser *parser;
     XNewton *newton;
+    XMarchingSquares *squares;
+    XImplicitRenderer *renderer;
+    bool contour;
     float limit;
     float unit;
     float centerX;
     float centerY;
+    int originX;  // the pixel of the plane at the top left of the image
+    int originY;
     char mp[900][900];
     const int arrayLen = 900;
     QImage *image;
@@ -45,6 +45,7 @@ MainWindow::MainWindow(QWidget *parent)
     connect(this, &MainWindow::operateFI, provider, &XFIProvider::draw);
     connect(provider, &XFIProvider::createFinished, this, &MainWindow::createFIFinished);
     connect(provider, &XFIProvider::processUpdated, this, &MainWindow::processUpdated);
+    connect(provider, &XFIProvider::imageUpdated, this, &MainWindow::imageUpdated);
 
     FPIProvider = new XFPIProvider(this);
     thread.start();
@@ -58,6 +59,7 @@ MainWindow::~MainWindow()
 
 void MainWindow::createButtonClicked()
 {
+    provider->cancel();
     provider->setSource(lineEdit->text());
     emit operateFI();
 }
@@ -75,8 +77,6 @@ void MainWindow::genFPIButtonClicked()
 
 void MainWindow::createFIFinished()
 {
-    QImage *image = provider->getImage();
-    widget->setImage(image);
  //.   QMessageBox::information(this, "", QString::fromStdString(provider->getParser()->getInfixExpression()));
 
 }
@@ -84,4 +84,10 @@ void MainWindow::createFIFinished()
 void MainWindow::processUpdated(float process)
 {
     setWindowTitle(QString::number(process));
+}
+
+void MainWindow::imageUpdated(QImage image)
+{
+    this->image = image;
+    widget->setImage(&this->image);
 }
\ No newline at end of file
@@ -20,6 +20,7 @@ public:
     void genFPIButtonClicked();
     void createFIFinished();
     void processUpdated(float process);
+    void imageUpdated(QImage image);
 
 
 signals:
@@ -34,6 +35,7 @@ private:
     XNewton *newton;
     QPushButton *createButton;
     XImageWidget *widget;
+    QImage image;  // the provider's latest, shown by widget
 };
 
 #endif // MAINWINDOW_H
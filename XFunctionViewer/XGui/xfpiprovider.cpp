@@ -38,7 +38,7 @@ void XFPIProvider::genImage(XAbstractParseNode *root, QRectF area)
         }
         else if (typeid(*root) == typeid(XVariableParseNode))
         {
-            painter->drawText(startPoint, QString(QChar(static_cast<XVariableParseNode *>(root)->getIndex())));
+            painter->drawText(startPoint, QString::fromStdString(static_cast<XVariableParseNode *>(root)->getSymbol()));
         }
         return;
     }
@@ -0,0 +1,329 @@
+// Renders the expressions of a file, one a line, to images and reports how long each took to parse,
+// differentiate, evaluate, solve for roots and render, so the solver can be timed the same way on any
+// machine and plots can be drawn without the GUI. Uses XFunctionSolver2 and the standard library
+// only; besides the Visual Studio project, on Linux it builds with
+//     g++ -std=c++14 -O2 -pthread -I../XFunctionSolver2 main.cpp ../XFunctionSolver2/*.cpp
+//         ../XFunctionSolver2/BasicParseNodes/*.cpp -o xplot
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "../XFunctionSolver2/XFunctionParser.h"
+#include "../XFunctionSolver2/XNewton.h"
+#include "../XFunctionSolver2/XPlotEngine.h"
+#include "../XFunctionSolver2/XRootFinder.h"
+
+using namespace std;
+
+struct Options
+{
+    XPlotEngine::Mode mode;
+    int width;
+    int height;
+    double centerX;
+    double centerY;
+    double limit;
+    string format;  // pgm, png or none
+    string output;  // directory of the images
+    int countThreads;
+    int repeat;
+    string input;
+};
+
+struct Timing
+{
+    double parse;     // setSource without the cache, in microseconds
+    double derive;    // d/dx and d/dy, in microseconds
+    double evaluate;  // f at the center of every pixel in one batch, in nanoseconds a pixel
+    double solve;     // a root along x from the center of every pixel, all in one XRootFinder, in nanoseconds a pixel
+    double newton;    // the same one pixel at a time with XNewton and dual numbers, in nanoseconds a pixel
+    double render;    // in milliseconds
+    double write;     // in milliseconds
+};
+
+static double now()
+{
+    return chrono::duration<double, micro>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// count numbers parted by separator, as 900x600 or 0,0,20, and nothing else
+static bool parseNumbers(const char *value, char separator, double *numbers, int count)
+{
+    for (int k = 0; k < count; k++)
+    {
+        char *end;
+        numbers[k] = strtod(value, &end);
+        if (end == value || *end != (k + 1 < count ? separator : '\0'))
+        {
+            return false;
+        }
+        value = end + 1;
+    }
+    return true;
+}
+
+static void printUsage()
+{
+    fprintf(stderr,
+        "usage: xplot [options] expressions.txt\n"
+        "  --mode implicit|contour|explicit  f(x, y) = 0 by cells or by marching squares, or y = f(x)\n"
+        "                                    (implicit)\n"
+        "  --size WIDTHxHEIGHT               in pixels (900x900)\n"
+        "  --view X,Y,LIMIT                  the center and the half width of the view (0,0,20)\n"
+        "  --format pgm|png|none             of the images, none to only time (pgm)\n"
+        "  --output DIRECTORY                where plot-0001 and on are written (.)\n"
+        "  --threads N                       for implicit plots, 0 for one per core (0)\n"
+        "  --repeat N                        times each step, the fastest is reported (1)\n"
+        "Empty lines and lines starting with # are skipped, see expressions.txt.\n");
+}
+
+static bool parseOptions(int argc, char *argv[], Options &options)
+{
+    options.mode = XPlotEngine::Implicit;
+    options.width = 900;
+    options.height = 900;
+    options.centerX = 0.0;
+    options.centerY = 0.0;
+    options.limit = 20.0;
+    options.format = "pgm";
+    options.output = ".";
+    options.countThreads = 0;
+    options.repeat = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        string option = argv[i];
+        if (option.compare(0, 2, "--") != 0)
+        {
+            if (!options.input.empty())
+            {
+                return false;
+            }
+            options.input = option;
+            continue;
+        }
+        if (i + 1 == argc)
+        {
+            return false;
+        }
+        const char *value = argv[++i];
+        if (option == "--mode")
+        {
+            if (strcmp(value, "implicit") == 0)
+            {
+                options.mode = XPlotEngine::Implicit;
+            }
+            else if (strcmp(value, "contour") == 0)
+            {
+                options.mode = XPlotEngine::Contour;
+            }
+            else if (strcmp(value, "explicit") == 0)
+            {
+                options.mode = XPlotEngine::Explicit;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        else if (option == "--size")
+        {
+            double size[2];
+            if (!parseNumbers(value, 'x', size, 2) || !(size[0] >= 1.0 && size[1] >= 1.0 && size[0] * size[1] <= 1e8))
+            {
+                return false;
+            }
+            options.width = (int)size[0];
+            options.height = (int)size[1];
+        }
+        else if (option == "--view")
+        {
+            double view[3];
+            if (!parseNumbers(value, ',', view, 3) || !(view[2] > 0.0))
+            {
+                return false;
+            }
+            options.centerX = view[0];
+            options.centerY = view[1];
+            options.limit = view[2];
+        }
+        else if (option == "--format")
+        {
+            options.format = value;
+            if (options.format != "pgm" && options.format != "png" && options.format != "none")
+            {
+                return false;
+            }
+        }
+        else if (option == "--output")
+        {
+            options.output = value;
+        }
+        else if (option == "--threads")
+        {
+            options.countThreads = max(0, atoi(value));
+        }
+        else if (option == "--repeat")
+        {
+            options.repeat = max(1, atoi(value));
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return !options.input.empty();
+}
+
+// Each step runs repeat times and keeps its fastest run. Parsing and differentiating go around the
+// expression cache, so they are timed in full every time; the render clears the tiles the implicit
+// renderer keeps for the same reason.
+static Timing measure(const string &source, const Options &options, XPlotEngine &engine, XPlotImage &image)
+{
+    Timing timing = { 1e300, 1e300, 1e300, 1e300, 1e300, 1e300, 0.0 };
+
+    int count = options.width * options.height;
+    vector<double> xs(count);
+    vector<double> ys(count);
+    vector<double> results(count);
+    vector<XRootFinder::Result> roots(count);
+    double unit = options.limit / (options.width / 2.0);
+    for (int i = 0; i < options.width; i++)
+    {
+        for (int j = 0; j < options.height; j++)
+        {
+            xs[i * options.height + j] = options.centerX + (i - options.width / 2) * unit;
+            ys[i * options.height + j] = options.centerY + (j - options.height / 2) * unit;
+        }
+    }
+
+    for (int r = 0; r < options.repeat; r++)
+    {
+        XFunctionParser parser;
+        parser.setCache(nullptr);
+        double start = now();
+        parser.setSource(source);
+        timing.parse = min(timing.parse, now() - start);
+
+        start = now();
+        XFunctionParser *dx = parser.getDifferentiate("x");
+        XFunctionParser *dy = parser.getDifferentiate("y");
+        timing.derive = min(timing.derive, now() - start);
+        delete dx;
+        delete dy;
+
+        start = now();
+        parser.getFunctions(xs.data(), ys.data(), nullptr, results.data(), count);
+        timing.evaluate = min(timing.evaluate, (now() - start) * 1000.0 / count);
+
+        XRootFinder finder;
+        finder.setFunction(&parser);
+        finder.setVariable("x");
+        const double *columns[2] = { xs.data(), ys.data() };
+        start = now();
+        finder.solve(columns, 2, roots.data(), count);
+        timing.solve = min(timing.solve, (now() - start) * 1000.0 / count);
+
+        XNewton newton;
+        newton.setFunction(&parser);
+        newton.setVariable("x");
+        newton.setAutomaticDifferentiation(true);
+        start = now();
+        for (int i = 0; i < count; i++)
+        {
+            results[i] = newton.newton(xs[i], ys[i]);
+        }
+        timing.newton = min(timing.newton, (now() - start) * 1000.0 / count);
+
+        engine.getImplicitRenderer().clearCache();
+        start = now();
+        engine.render(source, image);
+        timing.render = min(timing.render, (now() - start) / 1000.0);
+    }
+    return timing;
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage();
+        return 2;
+    }
+    ifstream input(options.input.c_str());
+    if (!input)
+    {
+        fprintf(stderr, "xplot: cannot read %s\n", options.input.c_str());
+        return 1;
+    }
+
+    XPlotEngine engine;
+    engine.setMode(options.mode);
+    engine.setView(options.centerX, options.centerY, options.limit);
+    engine.setResolution(options.width, options.height);
+    engine.getImplicitRenderer().setCountThreads(options.countThreads);
+    XPlotImage image;
+
+    printf("%4s  %10s  %10s  %10s  %10s  %10s  %10s  %10s  %s\n", "#", "parse us", "derive us", "eval ns/px", "solve ns/px",
+        "newton ns/px", "render ms", "write ms", "expression");
+    Timing total = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    int count = 0;
+    int failed = 0;
+    string line;
+    while (getline(input, line))
+    {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == string::npos || line[first] == '#')
+        {
+            continue;
+        }
+        string source = line.substr(first, line.find_last_not_of(" \t\r") + 1 - first);
+        count++;
+
+        // a malformed line is reported and skipped before anything is timed
+        engine.getParser().setSource(source);
+        if (engine.getParser().getBytecode().isEmpty())
+        {
+            printf("%4d  %s: no expression\n", count, source.c_str());
+            failed++;
+            continue;
+        }
+        Timing timing = measure(source, options, engine, image);
+        if (options.format != "none")
+        {
+            char name[32];
+            snprintf(name, sizeof(name), "/plot-%04d.%s", count, options.format.c_str());
+            string path = options.output + name;
+            double start = now();
+            bool written = options.format == "png" ? image.writePng(path) : image.writePgm(path);
+            timing.write = (now() - start) / 1000.0;
+            if (!written)
+            {
+                fprintf(stderr, "xplot: cannot write %s\n", path.c_str());
+                return 1;
+            }
+        }
+        printf("%4d  %10.1f  %10.1f  %10.2f  %10.1f  %10.1f  %10.2f  %10.2f  %s\n", count, timing.parse, timing.derive,
+            timing.evaluate, timing.solve, timing.newton, timing.render, timing.write, source.c_str());
+        total.parse += timing.parse;
+        total.derive += timing.derive;
+        total.evaluate += timing.evaluate;
+        total.solve += timing.solve;
+        total.newton += timing.newton;
+        total.render += timing.render;
+        total.write += timing.write;
+    }
+
+    int countRendered = count - failed;
+    if (countRendered > 0)
+    {
+        printf("%4s  %10.1f  %10.1f  %10.2f  %10.1f  %10.1f  %10.2f  %10.2f  %d expressions, ns/px averaged\n", "all",
+            total.parse, total.derive, total.evaluate / countRendered, total.solve / countRendered,
+            total.newton / countRendered, total.render, total.write, countRendered);
+    }
+    return failed > 0 ? 1 : 0;
+}